@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: MIT
+pragma solidity ^0.8.20;
+
+// Share-based vault: packed structs, modifiers and nested internal calls
+contract Vault {
+    struct Position {
+        uint128 shares;
+        uint64 since;
+        bool active;
+    }
+
+    address public owner;
+    bool public paused;
+    uint256 public totalShares;
+    uint256 public totalAssets;
+    mapping(address => Position) public positions;
+
+    event Deposit(address indexed who, uint256 assets, uint256 shares);
+    event Withdraw(address indexed who, uint256 assets, uint256 shares);
+
+    modifier onlyOwner() {
+        require(msg.sender == owner, "not owner");
+        _;
+    }
+
+    modifier whenActive() {
+        require(!paused, "paused");
+        _;
+    }
+
+    constructor() {
+        owner = msg.sender;
+    }
+
+    function deposit() external payable whenActive returns (uint256 shares) {
+        shares = _toShares(msg.value);
+        require(shares > 0, "nothing to deposit");
+        _credit(msg.sender, shares);
+        totalAssets += msg.value;
+        emit Deposit(msg.sender, msg.value, shares);
+    }
+
+    function withdraw(uint256 shares) external whenActive returns (uint256 assets) {
+        Position storage position = positions[msg.sender];
+        require(position.active && position.shares >= shares, "insufficient shares");
+        assets = _toAssets(shares);
+        _debit(msg.sender, shares);
+        totalAssets -= assets;
+        emit Withdraw(msg.sender, assets, shares);
+        (bool ok, ) = msg.sender.call{value: assets}("");
+        require(ok, "transfer failed");
+    }
+
+    function setPaused(bool value) external onlyOwner {
+        paused = value;
+    }
+
+    function transferOwnership(address next) external onlyOwner {
+        require(next != address(0), "zero address");
+        owner = next;
+    }
+
+    function preview(uint256 assets) external view returns (uint256) {
+        return _toShares(assets);
+    }
+
+    function _toShares(uint256 assets) internal view returns (uint256) {
+        return totalShares == 0 ? assets : assets * totalShares / totalAssets;
+    }
+
+    function _toAssets(uint256 shares) internal view returns (uint256) {
+        return totalShares == 0 ? 0 : shares * totalAssets / totalShares;
+    }
+
+    function _credit(address who, uint256 shares) internal {
+        Position storage position = positions[who];
+        position.shares += uint128(shares);
+        if (!position.active) {
+            position.active = true;
+            position.since = uint64(block.timestamp);
+        }
+        totalShares += shares;
+    }
+
+    function _debit(address who, uint256 shares) internal {
+        Position storage position = positions[who];
+        position.shares -= uint128(shares);
+        if (position.shares == 0) {
+            position.active = false;
+        }
+        totalShares -= shares;
+    }
+}
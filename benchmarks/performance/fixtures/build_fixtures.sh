@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+# Regenerate the peephole benchmark fixtures from the Solidity sources here
+# Needs solc 0.8.20 or later on PATH
+# Writes <Contract>.bin-runtime (unoptimized) and <Contract>.opt.bin-runtime
+# (solc --optimize), the hex text `solc --bin-runtime` emits
+
+set -euo pipefail
+
+cd "$(dirname "$0")"
+BUILD_DIR="$(mktemp -d)"
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+solc --version | tail -1
+for source in *.sol; do
+    solc --bin-runtime -o "$BUILD_DIR/plain" --overwrite "$source"
+    solc --bin-runtime --optimize -o "$BUILD_DIR/optimized" --overwrite "$source"
+done
+for runtime in "$BUILD_DIR"/plain/*.bin-runtime; do
+    cp "$runtime" "$(basename "$runtime")"
+done
+for runtime in "$BUILD_DIR"/optimized/*.bin-runtime; do
+    cp "$runtime" "$(basename "$runtime" .bin-runtime).opt.bin-runtime"
+done
+ls -l *.bin-runtime
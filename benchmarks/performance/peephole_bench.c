@@ -0,0 +1,482 @@
+// OMEGA Bootstrap - EVM Peephole Benchmark
+// Purpose: Measure peephole throughput and savings over a contract bytecode corpus
+// Compile (from the repository root):
+//   gcc -std=c99 -O2 -Ibootstrap -o peephole_bench benchmarks/performance/peephole_bench.c
+//       bootstrap/omega_peephole.c
+// Run: ./peephole_bench [runtime.bin|runtime.hex ...]
+// Without arguments the corpus is the EIP-1167 proxy runtime, the
+// `solc --bin-runtime` fixtures in benchmarks/performance/fixtures (run from
+// the repository root; build_fixtures.sh there regenerates them), and
+// contracts assembled from unoptimized solc output idioms (dispatcher,
+// checked storage updates, internal calls with return tags, revert strings,
+// CBOR metadata). Real contracts are reported one by one and totalled apart
+// from the synthetic ones. Pass runtime files to measure only those.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "omega_peephole.h"
+
+#define SYNTHETIC_CONTRACTS 64
+#define ROUNDS 50
+#define MAX_CODE (24 * 1024)   // EIP-170 contract size limit
+#define FIXTURE_DIR "benchmarks/performance/fixtures"
+#define FIXTURE_SUFFIX ".bin-runtime"
+#define MAX_FIXTURES 256
+
+typedef struct {
+    uint8_t* code;
+    size_t size;
+    char name[64];
+    bool synthetic;
+} Contract;
+
+static double now_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e6 + (double)now.tv_nsec / 1e3;
+}
+
+static uint32_t rng_state = 0x12345678;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// ============================================================================
+// ASSEMBLER
+// ============================================================================
+
+// Bytes plus tag references, resolved once all tags are placed. Tags are
+// pushed with PUSH2 like solc does for code over 255 bytes.
+typedef struct {
+    uint8_t code[MAX_CODE + 256];
+    size_t size;
+    int fixups[4096];          // code offsets of PUSH2 immediates
+    int fixup_tags[4096];
+    int fixup_count;
+    int tags[1024];            // tag -> JUMPDEST offset
+    int tag_count;
+} Assembler;
+
+static void emit(Assembler* as, const char* hex) {
+    for (const char* p = hex; p[0] && p[1]; p += 2) {
+        unsigned byte;
+        sscanf(p, "%2x", &byte);
+        as->code[as->size++] = (uint8_t)byte;
+    }
+}
+
+static int new_tag(Assembler* as) {
+    as->tags[as->tag_count] = -1;
+    return as->tag_count++;
+}
+
+static void push_tag(Assembler* as, int tag) {
+    as->code[as->size++] = 0x61;   // PUSH2
+    as->fixups[as->fixup_count] = (int)as->size;
+    as->fixup_tags[as->fixup_count++] = tag;
+    as->size += 2;
+}
+
+static void place_tag(Assembler* as, int tag) {
+    as->tags[tag] = (int)as->size;
+    as->code[as->size++] = 0x5b;   // JUMPDEST
+}
+
+static void emit_body(Assembler* as, int functions, const int* entry) {
+    int statements = 4 + (int)(next_random() % 24);
+    for (int s = 0; s < statements; s++) {
+        int tag;
+        switch (next_random() % 12) {
+            case 0:   // local read into a temporary that is dropped
+                emit(as, "600080549050");                 // PUSH1 0 DUP1 SLOAD SWAP1 POP
+                emit(as, "60006000915050");               // zero-initialized pair
+                break;
+            case 1:   // checked addition then store
+                emit(as, "6001548160015401600155");
+                emit(as, "8150");                         // DUP2 POP
+                break;
+            case 2:   // constant expression left in by the front end
+                emit(as, "6020601f01");                   // 0x20 + 0x1f
+                emit(as, "600160a01b");                   // 1 << 160 (too wide to fold)
+                emit(as, "50509090");                     // POP POP SWAP1 SWAP1
+                break;
+            case 3:   // jump to the very next block
+                tag = new_tag(as);
+                push_tag(as, tag);
+                emit(as, "56");
+                place_tag(as, tag);
+                break;
+            case 4:   // boolean condition re-normalized before a branch
+                tag = new_tag(as);
+                emit(as, "33600054141515");               // CALLER == owner, normalized
+                push_tag(as, tag);
+                emit(as, "57600080fd");                   // JUMPI; revert
+                place_tag(as, tag);
+                break;
+            case 5:   // internal call: return tag pushed long before the jump
+                if (functions > 1) {
+                    tag = new_tag(as);
+                    push_tag(as, tag);
+                    emit(as, "60043560243582");           // arguments
+                    push_tag(as, entry[next_random() % functions]);
+                    emit(as, "56");
+                    place_tag(as, tag);
+                    emit(as, "9150");
+                }
+                break;
+            case 6:   // revert string (selector constant is too wide to fold)
+                emit(as, "60405162461bcd60e51b815260206004820152");
+                emit(as, "600e60248201527f696e73756666696369656e74");
+                emit(as, "0000000000000000000000000000000000000000");
+                emit(as, "604482015260640160405180910390fd");
+                break;
+            case 7:   // mapping slot computation
+                emit(as, "336000908152602081905260409020");
+                emit(as, "54610100600202018080");         // SLOAD + 0x100 * 2
+                emit(as, "5050");
+                break;
+            case 8:   // bool return value normalized for ABI encoding
+                emit(as, "600050");                       // default return slot, overwritten
+                emit(as, "6001151560405190815260200160405180910390f3");
+                break;
+            case 9:   // mask arithmetic
+                emit(as, "60ff60ff1660001960ff18");
+                emit(as, "50");
+                break;
+            case 10:  // event topic and log
+                emit(as, "7fddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef");
+                emit(as, "6040518082815260200191505060405180910390a1");
+                break;
+            default:  // plain arithmetic the optimizer must leave alone
+                emit(as, "6004358060243501");
+                emit(as, "81811015");
+                emit(as, "9091");
+                break;
+        }
+    }
+}
+
+// A runtime object laid out the way unoptimized solc emits it
+static void make_contract(Contract* contract, int index) {
+    Assembler* as = calloc(1, sizeof(Assembler));
+    int functions = 2 + (int)(next_random() % 20);
+    int entry[32];
+    int fallback = new_tag(as);
+
+    emit(as, "6080604052");                               // free memory pointer
+    int payable = new_tag(as);
+    emit(as, "348015");                                   // CALLVALUE DUP1 ISZERO
+    push_tag(as, payable);
+    emit(as, "57600080fd");
+    place_tag(as, payable);
+    emit(as, "50");
+    emit(as, "60043610");                                 // CALLDATASIZE < 4
+    push_tag(as, fallback);
+    emit(as, "57600035");                                 // JUMPI; CALLDATALOAD
+    emit(as, "60e01c");                                   // selector
+    for (int f = 0; f < functions; f++) {
+        entry[f] = new_tag(as);
+        char selector[32];
+        snprintf(selector, sizeof(selector), "8063%08x14", (unsigned)next_random());
+        emit(as, selector);
+        push_tag(as, entry[f]);
+        emit(as, "57");
+    }
+    place_tag(as, fallback);
+    emit(as, "600080fd");
+
+    for (int f = 0; f < functions && as->size < MAX_CODE - 4096; f++) {
+        place_tag(as, entry[f]);
+        emit_body(as, functions, entry);
+        emit(as, next_random() % 2 ? "5056" : "00");      // return via tag or STOP
+    }
+
+    // Unplaced entries (size budget) fall back to the revert block
+    for (int t = 0; t < as->tag_count; t++) {
+        if (as->tags[t] < 0) {
+            as->tags[t] = as->tags[fallback];
+        }
+    }
+    for (int i = 0; i < as->fixup_count; i++) {
+        int target = as->tags[as->fixup_tags[i]];
+        as->code[as->fixups[i]] = (uint8_t)(target >> 8);
+        as->code[as->fixups[i] + 1] = (uint8_t)target;
+    }
+
+    // CBOR metadata: ipfs hash and compiler version, length-suffixed
+    emit(as, "fe");
+    size_t cbor = as->size;
+    emit(as, "a2646970667358221220");
+    for (int i = 0; i < 32; i++) {
+        as->code[as->size++] = (uint8_t)next_random();
+    }
+    emit(as, "64736f6c6343000814");
+    size_t cbor_length = as->size - cbor;
+    as->code[as->size++] = (uint8_t)(cbor_length >> 8);
+    as->code[as->size++] = (uint8_t)cbor_length;
+
+    contract->size = as->size;
+    contract->code = malloc(as->size);
+    memcpy(contract->code, as->code, as->size);
+    snprintf(contract->name, sizeof(contract->name), "synthetic-%02d", index);
+    contract->synthetic = true;
+    free(as);
+}
+
+// ============================================================================
+// CORPUS
+// ============================================================================
+
+static bool parse_hex(const char* text, size_t length, Contract* contract) {
+    contract->code = malloc(length / 2 + 1);
+    contract->size = 0;
+    size_t i = 0;
+    if (length >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        i = 2;
+    }
+    int high = -1;
+    for (; i < length; i++) {
+        char c = text[i];
+        if (isspace((unsigned char)c)) {
+            continue;
+        }
+        if (!isxdigit((unsigned char)c)) {
+            return false;
+        }
+        int digit = isdigit((unsigned char)c) ? c - '0' : (tolower((unsigned char)c) - 'a' + 10);
+        if (high < 0) {
+            high = digit;
+        } else {
+            contract->code[contract->size++] = (uint8_t)(high << 4 | digit);
+            high = -1;
+        }
+    }
+    return high < 0;
+}
+
+static bool load_contract(const char* path, Contract* contract) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* data = malloc((size_t)length + 1);
+    size_t read = fread(data, 1, (size_t)length, file);
+    fclose(file);
+
+    const char* name = strrchr(path, '/');
+    snprintf(contract->name, sizeof(contract->name), "%s", name ? name + 1 : path);
+    if (!parse_hex(data, read, contract)) {
+        // Not hex text: raw bytecode
+        free(contract->code);
+        contract->code = (uint8_t*)data;
+        contract->size = read;
+        return true;
+    }
+    free(data);
+    return true;
+}
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Load every *.bin-runtime file in `dir`, sorted by name, into `corpus`;
+// returns how many were loaded
+static int load_fixtures(const char* dir, Contract* corpus, int capacity) {
+    DIR* handle = opendir(dir);
+    if (!handle) {
+        return 0;
+    }
+    char* names[MAX_FIXTURES];
+    int found = 0;
+    struct dirent* entry;
+    size_t suffix = strlen(FIXTURE_SUFFIX);
+    while ((entry = readdir(handle)) != NULL && found < capacity && found < MAX_FIXTURES) {
+        size_t length = strlen(entry->d_name);
+        if (length > suffix && strcmp(entry->d_name + length - suffix, FIXTURE_SUFFIX) == 0) {
+            names[found] = malloc(strlen(dir) + length + 2);
+            sprintf(names[found], "%s/%s", dir, entry->d_name);
+            found++;
+        }
+    }
+    closedir(handle);
+    qsort(names, (size_t)found, sizeof(char*), compare_names);
+
+    int loaded = 0;
+    for (int i = 0; i < found; i++) {
+        if (load_contract(names[i], &corpus[loaded])) {
+            loaded++;
+        } else {
+            fprintf(stderr, "⚠️  Cannot read %s\n", names[i]);
+        }
+        free(names[i]);
+    }
+    return loaded;
+}
+
+// Every static jump in the output must still land on a JUMPDEST, and no
+// JUMPDEST may disappear
+static bool verify_jumps(const uint8_t* before, size_t before_size,
+                         const uint8_t* after, size_t after_size) {
+    int dests[2] = {0, 0};
+    int bad[2] = {0, 0};
+    const uint8_t* codes[2] = { before, after };
+    size_t sizes[2] = { before_size, after_size };
+    for (int c = 0; c < 2; c++) {
+        const uint8_t* code = codes[c];
+        uint8_t* is_dest = calloc(sizes[c] + 1, 1);
+        for (size_t pass = 0; pass < 2; pass++) {
+            size_t offset = 0;
+            long last_push = -1;
+            while (offset < sizes[c]) {
+                uint8_t op = code[offset];
+                int width = op >= 0x60 && op <= 0x7f ? op - 0x5f : 0;
+                if (op == 0xfe) {
+                    break;               // metadata follows
+                }
+                if (pass == 0 && op == 0x5b) {
+                    is_dest[offset] = 1;
+                    dests[c]++;
+                }
+                if (pass == 1 && (op == 0x56 || op == 0x57) && last_push >= 0 &&
+                    ((size_t)last_push >= sizes[c] || !is_dest[last_push])) {
+                    bad[c]++;
+                }
+                last_push = -1;
+                if (width > 0 && width <= 4 && offset + width < sizes[c]) {
+                    last_push = 0;
+                    for (int b = 1; b <= width; b++) {
+                        last_push = (last_push << 8) | code[offset + b];
+                    }
+                }
+                offset += 1 + width;
+            }
+        }
+        free(is_dest);
+    }
+    return dests[0] == dests[1] && bad[1] <= bad[0];
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? argc - 1 : 1 + MAX_FIXTURES + SYNTHETIC_CONTRACTS;
+    Contract* corpus = calloc((size_t)count, sizeof(Contract));
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            if (!load_contract(argv[i], &corpus[i - 1])) {
+                fprintf(stderr, "❌ Cannot read %s\n", argv[i]);
+                return 1;
+            }
+        }
+    } else {
+        // EIP-1167 minimal proxy runtime: already tight, must come back unchanged
+        parse_hex("363d3d373d3d3d363d73bebebebebebebebebebebebebebebebebebebebe"
+                  "5af43d82803e903d91602b57fd5bf3", 90, &corpus[0]);
+        snprintf(corpus[0].name, sizeof(corpus[0].name), "eip1167-proxy");
+        int fixtures = load_fixtures(FIXTURE_DIR, corpus + 1, MAX_FIXTURES);
+        if (fixtures == 0) {
+            printf("ℹ️  No solc fixtures in %s (run build_fixtures.sh there)\n", FIXTURE_DIR);
+        }
+        count = 1 + fixtures + SYNTHETIC_CONTRACTS;
+        for (int i = 1 + fixtures; i < count; i++) {
+            make_contract(&corpus[i], i - fixtures);
+        }
+    }
+
+    PeepholeOptimizer optimizer;
+    if (!peephole_init(&optimizer)) {
+        fprintf(stderr, "❌ Cannot compile the pattern table\n");
+        return 1;
+    }
+    printf("🔬 Peephole optimizer: %d contracts, %d patterns in a %d-node trie\n",
+           count, optimizer.rule_count, optimizer.node_count);
+
+    // Totals per corpus half: [0] real contracts, [1] synthetic ones
+    size_t total_in[2] = {0, 0};
+    size_t total_out[2] = {0, 0};
+    long total_gas[2] = {0, 0};
+    int contracts[2] = {0, 0};
+    int skipped = 0;
+    uint8_t* out = malloc(MAX_CODE * 4);
+    for (int i = 0; i < count; i++) {
+        Contract* contract = &corpus[i];
+        uint8_t* optimized = contract->size > MAX_CODE * 4 ? malloc(contract->size) : out;
+        PeepholeResult result = peephole_optimize(&optimizer, contract->code, contract->size,
+                                                  optimized);
+        if (!verify_jumps(contract->code, contract->size, optimized, result.output_size)) {
+            fprintf(stderr, "❌ %s: jump targets broken\n", contract->name);
+            return 1;
+        }
+        if (result.skipped) {
+            skipped++;
+            printf("   ⏭️  %s: %s\n", contract->name, result.skipped);
+        } else if (!contract->synthetic) {
+            printf("   %-24s %6zu -> %6zu bytes, %ld gas, %d jumps relocated\n",
+                   contract->name, result.input_size, result.output_size,
+                   result.gas_saved, result.relocated);
+        }
+        int half = contract->synthetic ? 1 : 0;
+        total_in[half] += result.input_size;
+        total_out[half] += result.output_size;
+        total_gas[half] += result.gas_saved;
+        contracts[half]++;
+        if (optimized != out) {
+            free(optimized);
+        }
+    }
+
+    printf("\n%-28s %8s %8s %8s\n", "Pattern", "hits", "bytes", "gas");
+    for (int r = 0; r < optimizer.rule_count; r++) {
+        const PeepholeStats* stats = &optimizer.stats[r];
+        printf("%-28s %8ld %8ld %8ld\n", stats->name, stats->hits, stats->bytes_saved,
+               stats->gas_saved);
+    }
+    printf("\n");
+    const char* labels[2] = { "real", "synthetic" };
+    for (int half = 0; half < 2; half++) {
+        if (contracts[half] == 0) {
+            continue;
+        }
+        printf("📦 %-9s %3d contract(s): %zu -> %zu bytes (%.1f%% smaller), %ld static gas saved\n",
+               labels[half], contracts[half], total_in[half], total_out[half],
+               total_in[half] ? 100.0 * (double)(total_in[half] - total_out[half]) / (double)total_in[half] : 0.0,
+               total_gas[half]);
+    }
+    printf("⏭️  %d skipped\n", skipped);
+
+    // Throughput
+    double started = now_us();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < count; i++) {
+            if (corpus[i].size <= MAX_CODE * 4) {
+                peephole_optimize(&optimizer, corpus[i].code, corpus[i].size, out);
+            }
+        }
+    }
+    double elapsed = now_us() - started;
+    printf("⏱️  %.1f µs per pass over the corpus, %.1f MB/s\n",
+           elapsed / ROUNDS, (double)(total_in[0] + total_in[1]) * ROUNDS / elapsed);
+    printf("✅ Jump targets verified\n");
+
+    for (int i = 0; i < count; i++) {
+        free(corpus[i].code);
+    }
+    free(corpus);
+    free(out);
+    peephole_free(&optimizer);
+    return 0;
+}
@@ -0,0 +1,159 @@
+// OMEGA Bootstrap - Incremental Relexing Benchmark
+// Purpose: Show that single-character edits relex in time independent of file size
+// Compile (from the repository root):
+//   gcc -std=c99 -O2 -Ibootstrap -o relex_bench benchmarks/performance/relex_bench.c
+//       bootstrap/omega_relex.c bootstrap/omega_lexer.c bootstrap/omega_intern.c
+// Run: ./relex_bench [--verify]
+// --verify compares the stream against a full lex after every edit.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "omega_intern.h"
+#include "omega_lexer.h"
+#include "omega_relex.h"
+
+#define EDITS_PER_SIZE 2000
+#define VERIFIED_EDITS 200     // full lexes are slow on the large documents
+
+static const char* SAMPLE_LINES[] = {
+    "    function transfer(address to, uint256 amount) public returns (bool) {",
+    "        require(balances[msg.sender] >= amount, \"insufficient\");",
+    "        balances[msg.sender] = balances[msg.sender] - amount; // debit",
+    "        balances[to] = balances[to] + amount;",
+    "        emit Transfer(msg.sender, to, amount);",
+    "        /* block comment */ return true;",
+    "    }",
+    "",
+};
+
+static double now_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e6 + (double)now.tv_nsec / 1e3;
+}
+
+static char* make_document(int lines, int* length) {
+    int line_count = (int)(sizeof(SAMPLE_LINES) / sizeof(SAMPLE_LINES[0]));
+    size_t capacity = (size_t)lines * 80 + 64;
+    char* text = malloc(capacity);
+    size_t used = (size_t)sprintf(text, "blockchain Bench {\n");
+    for (int i = 0; i < lines; i++) {
+        used += (size_t)sprintf(text + used, "%s\n", SAMPLE_LINES[i % line_count]);
+    }
+    used += (size_t)sprintf(text + used, "}\n");
+    *length = (int)used;
+    return text;
+}
+
+static bool same_token(Token a, Token b) {
+    return a.type == b.type && a.value == b.value && a.line == b.line &&
+           a.column == b.column && a.offset == b.offset && a.length == b.length;
+}
+
+// Compare the stream with a fresh full lex of `source`.
+static bool verify(const TokenStream* stream, const char* source, int length, InternTable* interns) {
+    Lexer lexer = create_lexer_at(source, length, interns, 0, 1, 1);
+    int index = 0;
+    Token expected;
+    do {
+        expected = next_token(&lexer);
+        if (index >= token_stream_count(stream) ||
+            !same_token(expected, token_stream_get(stream, index))) {
+            fprintf(stderr, "❌ Mismatch at token %d (line %d, column %d)\n",
+                    index, expected.line, expected.column);
+            return false;
+        }
+        index++;
+    } while (expected.type != TOK_EOF);
+    return index == token_stream_count(stream);
+}
+
+// Typing session: insert a character, then delete it again, at positions
+// walking through the middle of the document.
+static int run_size(int lines, bool check) {
+    InternTable* interns = intern_create();
+    int length;
+    char* source = make_document(lines, &length);
+    char* edited = malloc((size_t)length + 2);
+    TokenStream stream;
+    token_stream_init(&stream, interns);
+
+    double started = now_us();
+    token_stream_lex(&stream, source, length);
+    double full_us = now_us() - started;
+
+    // No quotes: an unbalanced quote legitimately relexes to the next one,
+    // which editors avoid by inserting quotes in pairs
+    const char typed[] = "a1 (;/=";
+    double relex_us = 0;
+    long lexed = 0;
+    int position = length / 2;
+
+    int rounds = check ? VERIFIED_EDITS : EDITS_PER_SIZE;
+    for (int i = 0; i < rounds; i++) {
+        position = (position + 37) % (length - 1);
+        char ch = typed[i % (int)(sizeof(typed) - 1)];
+
+        // Insert
+        memcpy(edited, source, (size_t)position);
+        edited[position] = ch;
+        memcpy(edited + position + 1, source + position, (size_t)(length - position));
+        TextEdit insert = { position, position, position + 1 };
+        RelexStats stats;
+
+        started = now_us();
+        token_stream_relex(&stream, source, edited, length + 1, &insert, &stats);
+        if (i > 0) {
+            // The first edit moves the gap in from the end of the document
+            relex_us += now_us() - started;
+            lexed += stats.lexed_bytes;
+        }
+        if (check && !verify(&stream, edited, length + 1, interns)) {
+            return 1;
+        }
+
+        // Delete it again
+        TextEdit erase = { position, position + 1, position };
+        started = now_us();
+        token_stream_relex(&stream, edited, source, length, &erase, &stats);
+        if (i > 0) {
+            relex_us += now_us() - started;
+            lexed += stats.lexed_bytes;
+        }
+        if (check && !verify(&stream, source, length, interns)) {
+            return 1;
+        }
+    }
+
+    int edits = (rounds - 1) * 2;
+    printf("%8d lines %10d bytes | full lex %9.1f µs | relex %6.2f µs/edit, %5.1f bytes/edit\n",
+           lines, length, full_us, relex_us / edits, (double)lexed / edits);
+
+    token_stream_free(&stream);
+    free(edited);
+    free(source);
+    intern_destroy(interns);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    bool check = argc > 1 && strcmp(argv[1], "--verify") == 0;
+    static const int sizes[] = { 1000, 10000, 100000 };
+
+    printf("🔬 Incremental relexing: %d single-character edits per size%s\n",
+           (check ? VERIFIED_EDITS : EDITS_PER_SIZE) * 2, check ? " (verified)" : "");
+    for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+        if (run_size(sizes[i], check) != 0) {
+            return 1;
+        }
+    }
+    if (check) {
+        printf("✅ Relexed streams match full lexes\n");
+    }
+    return 0;
+}
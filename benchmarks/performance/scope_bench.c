@@ -0,0 +1,292 @@
+// OMEGA Bootstrap - Scoped Symbol Table Benchmark
+// Purpose: Compare hashed scope lookup with the scope walk of symbol_table.mega on deep nesting
+// Compile (from the repository root):
+//   gcc -std=c99 -O2 -Ibootstrap -o scope_bench benchmarks/performance/scope_bench.c
+//       bootstrap/omega_scope.c bootstrap/omega_intern.c
+// Run: ./scope_bench [--verify]
+// --verify checks every lookup and unused-symbol list against the scope walk.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "omega_intern.h"
+#include "omega_scope.h"
+
+#define VOCABULARY 96           // distinct names; most scopes shadow some
+#define NAMES_PER_SCOPE 6
+#define LOOKUPS_PER_SCOPE 24
+#define NAME_MAX_LENGTH 24
+
+static double now_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e6 + (double)now.tv_nsec / 1e3;
+}
+
+// ============================================================================
+// SCOPE WALK (lookup_symbol in src/semantic/symbol_table.mega)
+// ============================================================================
+
+typedef struct {
+    const char* name;
+    int line;
+    bool used;
+} WalkSymbol;
+
+typedef struct {
+    WalkSymbol* symbols;
+    int symbol_count;
+    int* scope_first;
+    int depth;
+} WalkTable;
+
+static void walk_push(WalkTable* table) {
+    table->scope_first[++table->depth] = table->symbol_count;
+}
+
+static void walk_pop(WalkTable* table) {
+    table->symbol_count = table->scope_first[table->depth--];
+}
+
+static void walk_define(WalkTable* table, const char* name, int line) {
+    WalkSymbol* symbol = &table->symbols[table->symbol_count++];
+    symbol->name = name;
+    symbol->line = line;
+    symbol->used = false;
+}
+
+// Innermost scope first, each scope in declaration order
+static WalkSymbol* walk_use(WalkTable* table, const char* name) {
+    for (int depth = table->depth; depth >= 0; depth--) {
+        int end = depth == table->depth ? table->symbol_count : table->scope_first[depth + 1];
+        for (int i = table->scope_first[depth]; i < end; i++) {
+            if (strcmp(table->symbols[i].name, name) == 0) {
+                table->symbols[i].used = true;
+                return &table->symbols[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+// ============================================================================
+// WORKLOAD
+// ============================================================================
+
+// Declarations and lookups are fixed up front so both tables see the same
+// sequence: descend `depth` scopes declaring and resolving names, then
+// resolve again in each scope on the way back out.
+typedef struct {
+    char names[VOCABULARY * 2][NAME_MAX_LENGTH];   // second half never declared
+    uint32_t ids[VOCABULARY * 2];
+    int* declared;          // [depth][NAMES_PER_SCOPE] vocabulary indexes
+    int* looked_up;         // [depth][LOOKUPS_PER_SCOPE]
+} Workload;
+
+static void make_workload(Workload* work, int depth, InternTable* interns) {
+    for (int i = 0; i < VOCABULARY * 2; i++) {
+        snprintf(work->names[i], NAME_MAX_LENGTH, i < VOCABULARY ? "local_%d" : "missing_%d", i);
+        work->ids[i] = intern_cstr(interns, work->names[i]);
+    }
+    work->declared = malloc(sizeof(int) * (size_t)depth * NAMES_PER_SCOPE);
+    work->looked_up = malloc(sizeof(int) * (size_t)depth * LOOKUPS_PER_SCOPE);
+    unsigned seed = 12345;
+    for (int d = 0; d < depth; d++) {
+        // Consecutive names, so a scope never declares one twice
+        int start = (d * 7) % VOCABULARY;
+        for (int k = 0; k < NAMES_PER_SCOPE; k++) {
+            work->declared[d * NAMES_PER_SCOPE + k] = (start + k) % VOCABULARY;
+        }
+        for (int k = 0; k < LOOKUPS_PER_SCOPE; k++) {
+            seed = seed * 1103515245u + 12345u;
+            // One lookup in eight misses every scope
+            int name = (int)((seed >> 8) % VOCABULARY);
+            work->looked_up[d * LOOKUPS_PER_SCOPE + k] = (seed >> 24) % 8 == 0 ? VOCABULARY + name : name;
+        }
+    }
+}
+
+static void free_workload(Workload* work) {
+    free(work->declared);
+    free(work->looked_up);
+}
+
+// Sum of the lines found, so the compiler keeps every lookup.
+static long run_walk(const Workload* work, int depth, WalkTable* table, long* unused) {
+    long sum = 0;
+    table->symbol_count = 0;
+    table->depth = 0;
+    table->scope_first[0] = 0;
+    for (int d = 0; d < depth; d++) {
+        walk_push(table);
+        for (int k = 0; k < NAMES_PER_SCOPE; k++) {
+            walk_define(table, work->names[work->declared[d * NAMES_PER_SCOPE + k]], d * NAMES_PER_SCOPE + k);
+        }
+        for (int k = 0; k < LOOKUPS_PER_SCOPE; k++) {
+            const WalkSymbol* found = walk_use(table, work->names[work->looked_up[d * LOOKUPS_PER_SCOPE + k]]);
+            sum += found ? found->line : -1;
+        }
+    }
+    for (int d = depth - 1; d >= 0; d--) {
+        for (int k = 0; k < LOOKUPS_PER_SCOPE; k += 2) {
+            const WalkSymbol* found = walk_use(table, work->names[work->looked_up[d * LOOKUPS_PER_SCOPE + k]]);
+            sum += found ? found->line : -1;
+        }
+        for (int i = table->scope_first[table->depth]; i < table->symbol_count; i++) {
+            *unused += !table->symbols[i].used;
+        }
+        walk_pop(table);
+    }
+    return sum;
+}
+
+static long run_hashed(const Workload* work, int depth, ScopeTable* table, long* unused) {
+    long sum = 0;
+    uint32_t names[NAMES_PER_SCOPE];
+    for (int d = 0; d < depth; d++) {
+        scope_push(table);
+        for (int k = 0; k < NAMES_PER_SCOPE; k++) {
+            scope_define(table, work->ids[work->declared[d * NAMES_PER_SCOPE + k]], 0, 0, d * NAMES_PER_SCOPE + k);
+        }
+        for (int k = 0; k < LOOKUPS_PER_SCOPE; k++) {
+            int index = scope_use(table, work->ids[work->looked_up[d * LOOKUPS_PER_SCOPE + k]]);
+            sum += index >= 0 ? scope_symbol(table, index)->line : -1;
+        }
+    }
+    for (int d = depth - 1; d >= 0; d--) {
+        for (int k = 0; k < LOOKUPS_PER_SCOPE; k += 2) {
+            int index = scope_use(table, work->ids[work->looked_up[d * LOOKUPS_PER_SCOPE + k]]);
+            sum += index >= 0 ? scope_symbol(table, index)->line : -1;
+        }
+        *unused += scope_unused(table, names, NAMES_PER_SCOPE);
+        scope_pop(table);
+    }
+    return sum;
+}
+
+// Step both tables through the workload together, comparing as they go.
+static bool verify(const Workload* work, int depth, WalkTable* walk, ScopeTable* hashed) {
+    walk->symbol_count = 0;
+    walk->depth = 0;
+    walk->scope_first[0] = 0;
+    uint32_t names[NAMES_PER_SCOPE];
+    for (int d = 0; d < depth; d++) {
+        walk_push(walk);
+        scope_push(hashed);
+        for (int k = 0; k < NAMES_PER_SCOPE; k++) {
+            int name = work->declared[d * NAMES_PER_SCOPE + k];
+            walk_define(walk, work->names[name], d * NAMES_PER_SCOPE + k);
+            if (scope_define(hashed, work->ids[name], 0, 0, d * NAMES_PER_SCOPE + k) < 0 ||
+                scope_define(hashed, work->ids[name], 0, 0, 0) != SCOPE_REDEFINED) {
+                fprintf(stderr, "❌ Declaring '%s' at depth %d\n", work->names[name], d);
+                return false;
+            }
+        }
+        for (int k = 0; k < LOOKUPS_PER_SCOPE; k++) {
+            int name = work->looked_up[d * LOOKUPS_PER_SCOPE + k];
+            const WalkSymbol* expected = walk_use(walk, work->names[name]);
+            int index = scope_use(hashed, work->ids[name]);
+            if ((expected == NULL) != (index < 0) ||
+                (expected && scope_symbol(hashed, index)->line != expected->line)) {
+                fprintf(stderr, "❌ Lookup of '%s' at depth %d\n", work->names[name], d);
+                return false;
+            }
+        }
+    }
+    for (int d = depth - 1; d >= 0; d--) {
+        int count = scope_unused(hashed, names, NAMES_PER_SCOPE);
+        int expected = 0;
+        for (int k = 0; k < NAMES_PER_SCOPE; k++) {
+            const WalkSymbol* symbol = &walk->symbols[walk->scope_first[walk->depth] + k];
+            if (symbol->used) {
+                continue;
+            }
+            if (expected >= count || names[expected] != work->ids[work->declared[d * NAMES_PER_SCOPE + k]]) {
+                fprintf(stderr, "❌ Unused symbols at depth %d\n", d);
+                return false;
+            }
+            expected++;
+        }
+        if (expected != count) {
+            fprintf(stderr, "❌ Unused symbol count at depth %d\n", d);
+            return false;
+        }
+        walk_pop(walk);
+        scope_pop(hashed);
+    }
+    return hashed->symbol_count == 0 && hashed->depth == 0;
+}
+
+static int run_depth(int depth, int rounds, bool check) {
+    InternTable* interns = intern_create();
+    Workload work;
+    make_workload(&work, depth, interns);
+
+    WalkTable walk;
+    walk.symbols = malloc(sizeof(WalkSymbol) * (size_t)depth * NAMES_PER_SCOPE);
+    walk.scope_first = malloc(sizeof(int) * (size_t)(depth + 1));
+    ScopeTable hashed;
+    if (!scope_table_init(&hashed)) {
+        fprintf(stderr, "❌ Out of memory\n");
+        return 1;
+    }
+
+    if (check && !verify(&work, depth, &walk, &hashed)) {
+        return 1;
+    }
+
+    long walk_unused = 0;
+    double started = now_us();
+    long walk_sum = 0;
+    for (int r = 0; r < rounds; r++) {
+        walk_sum += run_walk(&work, depth, &walk, &walk_unused);
+    }
+    double walk_us = now_us() - started;
+
+    long hashed_unused = 0;
+    started = now_us();
+    long hashed_sum = 0;
+    for (int r = 0; r < rounds; r++) {
+        hashed_sum += run_hashed(&work, depth, &hashed, &hashed_unused);
+    }
+    double hashed_us = now_us() - started;
+
+    if (walk_sum != hashed_sum || walk_unused != hashed_unused) {
+        fprintf(stderr, "❌ Results differ at depth %d\n", depth);
+        return 1;
+    }
+
+    double lookups = (double)rounds * depth * (LOOKUPS_PER_SCOPE + LOOKUPS_PER_SCOPE / 2);
+    printf("%6d scopes | scope walk %9.1f ns/lookup | hashed %6.1f ns/lookup | %7.1fx\n",
+           depth, walk_us * 1e3 / lookups, hashed_us * 1e3 / lookups, walk_us / hashed_us);
+
+    scope_table_free(&hashed);
+    free(walk.symbols);
+    free(walk.scope_first);
+    free_workload(&work);
+    intern_destroy(interns);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    bool check = argc > 1 && strcmp(argv[1], "--verify") == 0;
+    static const int depths[] = { 16, 256, 4096 };
+    static const int rounds[] = { 20000, 200, 2 };
+
+    printf("🔬 Scoped symbol lookup: %d declarations and %d lookups per scope%s\n",
+           NAMES_PER_SCOPE, LOOKUPS_PER_SCOPE + LOOKUPS_PER_SCOPE / 2, check ? " (verified)" : "");
+    for (int i = 0; i < (int)(sizeof(depths) / sizeof(depths[0])); i++) {
+        if (run_depth(depths[i], rounds[i], check) != 0) {
+            return 1;
+        }
+    }
+    if (check) {
+        printf("✅ Hashed lookups match the scope walk\n");
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+// OMEGA Bootstrap - Call Graph
+// Node storage, name index and reachability.
+
+#include "omega_callgraph.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+bool callgraph_init(CallGraph* graph) {
+    memset(graph, 0, sizeof(CallGraph));
+    graph->name_mask = 255;
+    graph->names = calloc(graph->name_mask + 1, sizeof(CallGraphName));
+    return graph->names != NULL;
+}
+
+void callgraph_free(CallGraph* graph) {
+    free(graph->nodes);
+    free(graph->edges);
+    free(graph->names);
+    memset(graph, 0, sizeof(CallGraph));
+}
+
+static uint32_t pointer_hash(const char* name) {
+    uintptr_t value = (uintptr_t)name;
+    value ^= value >> 17;
+    value *= 0x9E3779B1u;
+    return (uint32_t)(value ^ (value >> 15));
+}
+
+static CallGraphName* name_slot(CallGraphName* names, uint32_t mask, const char* name) {
+    uint32_t slot = pointer_hash(name) & mask;
+    while (names[slot].name && names[slot].name != name) {
+        slot = (slot + 1) & mask;
+    }
+    return &names[slot];
+}
+
+static bool grow_names(CallGraph* graph) {
+    uint32_t mask = graph->name_mask * 2 + 1;
+    CallGraphName* names = calloc(mask + 1, sizeof(CallGraphName));
+    if (!names) {
+        return false;
+    }
+    for (uint32_t i = 0; i <= graph->name_mask; i++) {
+        if (graph->names[i].name) {
+            *name_slot(names, mask, graph->names[i].name) = graph->names[i];
+        }
+    }
+    free(graph->names);
+    graph->names = names;
+    graph->name_mask = mask;
+    return true;
+}
+
+int callgraph_add(CallGraph* graph, const char* name, int module, CallGraphKind kind,
+                  bool root, int size, int line) {
+    if (graph->count == graph->capacity) {
+        int capacity = graph->capacity ? graph->capacity * 2 : 128;
+        CallGraphNode* nodes = realloc(graph->nodes, sizeof(CallGraphNode) * capacity);
+        if (!nodes) {
+            return -1;
+        }
+        graph->nodes = nodes;
+        graph->capacity = capacity;
+    }
+    if ((uint32_t)(graph->name_count + 1) * 2 > graph->name_mask && !grow_names(graph)) {
+        return -1;
+    }
+
+    int index = graph->count++;
+    CallGraphNode* node = &graph->nodes[index];
+    node->name = name;
+    node->module = module;
+    node->kind = kind;
+    node->root = root;
+    node->live = false;
+    node->size = size;
+    node->line = line;
+
+    // Prepend to the chain of nodes sharing the name
+    CallGraphName* slot = name_slot(graph->names, graph->name_mask, name);
+    if (!slot->name) {
+        slot->name = name;
+        slot->first = -1;
+        graph->name_count++;
+    }
+    node->next_named = slot->first;
+    slot->first = index;
+    return index;
+}
+
+bool callgraph_add_edge(CallGraph* graph, int from, int to) {
+    if (graph->edge_count == graph->edge_capacity) {
+        int capacity = graph->edge_capacity ? graph->edge_capacity * 2 : 256;
+        int* edges = realloc(graph->edges, sizeof(int) * 2 * capacity);
+        if (!edges) {
+            return false;
+        }
+        graph->edges = edges;
+        graph->edge_capacity = capacity;
+    }
+    graph->edges[graph->edge_count * 2] = from;
+    graph->edges[graph->edge_count * 2 + 1] = to;
+    graph->edge_count++;
+    return true;
+}
+
+int callgraph_find(const CallGraph* graph, const char* name) {
+    const CallGraphName* slot = name_slot(graph->names, graph->name_mask, name);
+    return slot->name ? slot->first : -1;
+}
+
+int callgraph_mark_live(CallGraph* graph) {
+    // Bucket the edges by source (CSR) so the walk touches each edge once
+    int* offsets = calloc((size_t)graph->count + 1, sizeof(int));
+    int* targets = malloc(sizeof(int) * ((size_t)graph->edge_count + 1));
+    int* stack = malloc(sizeof(int) * ((size_t)graph->count + 1));
+    if (!offsets || !targets || !stack) {
+        // Without memory for the walk keep everything
+        for (int i = 0; i < graph->count; i++) {
+            graph->nodes[i].live = true;
+        }
+        free(offsets);
+        free(targets);
+        free(stack);
+        return graph->count;
+    }
+    for (int e = 0; e < graph->edge_count; e++) {
+        offsets[graph->edges[e * 2] + 1]++;
+    }
+    for (int i = 0; i < graph->count; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    int* fill = stack;   // reused as per-node write cursors before the walk
+    memcpy(fill, offsets, sizeof(int) * (size_t)graph->count);
+    for (int e = 0; e < graph->edge_count; e++) {
+        targets[fill[graph->edges[e * 2]]++] = graph->edges[e * 2 + 1];
+    }
+
+    int top = 0;
+    int live = 0;
+    for (int i = 0; i < graph->count; i++) {
+        graph->nodes[i].live = graph->nodes[i].root;
+        if (graph->nodes[i].root) {
+            stack[top++] = i;
+            live++;
+        }
+    }
+    while (top > 0) {
+        int node = stack[--top];
+        for (int e = offsets[node]; e < offsets[node + 1]; e++) {
+            int next = targets[e];
+            if (!graph->nodes[next].live) {
+                graph->nodes[next].live = true;
+                stack[top++] = next;
+                live++;
+            }
+        }
+    }
+
+    free(offsets);
+    free(targets);
+    free(stack);
+    return live;
+}
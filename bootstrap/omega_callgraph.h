@@ -0,0 +1,63 @@
+// OMEGA Bootstrap - Call Graph
+// Purpose: Cross-module reachability for unreachable function and struct elimination
+// Platform: Windows, Linux, macOS (standard C99)
+// Nodes are functions, structs and each module's top-level code (constructors,
+// modifiers, state initializers). An edge means "mentions": a node is live
+// if it is reachable from a root, i.e. an entry point of the program. Names
+// are interned, so lookups compare pointers.
+
+#ifndef OMEGA_CALLGRAPH_H
+#define OMEGA_CALLGRAPH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    CALLGRAPH_FUNCTION,
+    CALLGRAPH_STRUCT,
+    CALLGRAPH_MODULE        // top-level code of a module
+} CallGraphKind;
+
+typedef struct {
+    const char* name;       // interned; the module path for CALLGRAPH_MODULE
+    int module;             // caller's module index
+    CallGraphKind kind;
+    bool root;
+    bool live;              // set by callgraph_mark_live
+    int size;               // source bytes the node stands for
+    int line;
+    int next_named;         // next node with the same name, or -1
+} CallGraphNode;
+
+typedef struct {
+    const char* name;
+    int first;              // first node with this name
+} CallGraphName;
+
+typedef struct {
+    CallGraphNode* nodes;
+    int count;
+    int capacity;
+    int* edges;             // (from, to) pairs
+    int edge_count;
+    int edge_capacity;
+    CallGraphName* names;   // open addressing on the interned pointer
+    uint32_t name_mask;
+    int name_count;
+} CallGraph;
+
+bool callgraph_init(CallGraph* graph);
+void callgraph_free(CallGraph* graph);
+
+// Returns the node index, or -1 when out of memory.
+int callgraph_add(CallGraph* graph, const char* name, int module, CallGraphKind kind,
+                  bool root, int size, int line);
+bool callgraph_add_edge(CallGraph* graph, int from, int to);
+
+// First node named `name` (follow next_named for the rest), or -1.
+int callgraph_find(const CallGraph* graph, const char* name);
+
+// Mark everything reachable from the roots; returns the live node count.
+int callgraph_mark_live(CallGraph* graph);
+
+#endif // OMEGA_CALLGRAPH_H
@@ -0,0 +1,947 @@
+// OMEGA Bootstrap - Target Code Generation
+// Output arenas, type translation, the three generators and the thread per target.
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "omega_codegen.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define CODEGEN_CHUNK_SIZE (64 * 1024)
+#define SCRATCH_MAX 512
+
+static const char* const target_names[TARGET_COUNT] = { "EVM", "Solana", "Cosmos" };
+static const char* const target_flags[TARGET_COUNT] = { "evm", "solana", "cosmos" };
+static const char* const target_extensions[TARGET_COUNT] = { ".sol", ".rs", ".go" };
+
+static double monotonic_ms(void) {
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart * 1e3 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e3 + (double)now.tv_nsec / 1e6;
+#endif
+}
+
+// ============================================================================
+// OUTPUT ARENAS
+// ============================================================================
+
+typedef struct CodegenChunk {
+    struct CodegenChunk* next;
+    size_t length;
+    size_t capacity;
+    char data[];
+} CodegenChunk;
+
+// Append-only text owned by one generator. Chunks never move, so appending
+// never copies earlier output.
+typedef struct {
+    CodegenChunk* head;
+    CodegenChunk* tail;
+    size_t size;
+    bool failed;            // out of memory; the output is not written
+} CodegenArena;
+
+// Room for `length` more bytes at the tail, or NULL.
+static char* arena_reserve(CodegenArena* arena, size_t length) {
+    if (arena->failed) {
+        return NULL;
+    }
+    CodegenChunk* tail = arena->tail;
+    if (!tail || tail->capacity - tail->length < length) {
+        size_t capacity = length > CODEGEN_CHUNK_SIZE ? length : CODEGEN_CHUNK_SIZE;
+        CodegenChunk* chunk = malloc(sizeof(CodegenChunk) + capacity);
+        if (!chunk) {
+            arena->failed = true;
+            return NULL;
+        }
+        chunk->next = NULL;
+        chunk->length = 0;
+        chunk->capacity = capacity;
+        if (tail) {
+            tail->next = chunk;
+        } else {
+            arena->head = chunk;
+        }
+        arena->tail = tail = chunk;
+    }
+    return tail->data + tail->length;
+}
+
+static void arena_append(CodegenArena* arena, const char* text, size_t length) {
+    char* at = arena_reserve(arena, length);
+    if (at) {
+        memcpy(at, text, length);
+        arena->tail->length += length;
+        arena->size += length;
+    }
+}
+
+static void arena_puts(CodegenArena* arena, const char* text) {
+    arena_append(arena, text, strlen(text));
+}
+
+static void arena_printf(CodegenArena* arena, const char* format, ...) {
+    va_list args, retry;
+    va_start(args, format);
+    va_copy(retry, args);
+    // Usually fits in the tail chunk; otherwise format again into a new one
+    CodegenChunk* tail = arena->tail;
+    size_t room = tail && !arena->failed ? tail->capacity - tail->length : 0;
+    int length = vsnprintf(room > 0 ? tail->data + tail->length : NULL, room, format, args);
+    if (length >= 0 && (size_t)length >= room) {
+        char* at = arena_reserve(arena, (size_t)length + 1);
+        if (at) {
+            vsnprintf(at, (size_t)length + 1, format, retry);
+        } else {
+            length = -1;
+        }
+    }
+    if (length > 0) {
+        arena->tail->length += (size_t)length;
+        arena->size += (size_t)length;
+    }
+    va_end(retry);
+    va_end(args);
+}
+
+static bool arena_write(const CodegenArena* arena, const char* path) {
+    if (arena->failed) {
+        return false;
+    }
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = true;
+    for (const CodegenChunk* chunk = arena->head; chunk && ok; chunk = chunk->next) {
+        ok = fwrite(chunk->data, 1, chunk->length, file) == chunk->length;
+    }
+    return fclose(file) == 0 && ok;
+}
+
+static void arena_free(CodegenArena* arena) {
+    CodegenChunk* chunk = arena->head;
+    while (chunk) {
+        CodegenChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    memset(arena, 0, sizeof(CodegenArena));
+}
+
+// ============================================================================
+// NAMES AND TYPES
+// ============================================================================
+
+// Bounded text for one translated type or identifier; longer text is cut.
+typedef struct {
+    char text[SCRATCH_MAX];
+    size_t length;
+} Scratch;
+
+static void scratch_append(Scratch* out, const char* text, size_t length) {
+    if (out->length + length >= SCRATCH_MAX) {
+        length = SCRATCH_MAX - 1 - out->length;
+    }
+    memcpy(out->text + out->length, text, length);
+    out->length += length;
+    out->text[out->length] = '\0';
+}
+
+static void scratch_puts(Scratch* out, const char* text) {
+    scratch_append(out, text, strlen(text));
+}
+
+static void scratch_char(Scratch* out, char c) {
+    scratch_append(out, &c, 1);
+}
+
+typedef struct {
+    const char* omega;
+    const char* native;
+} TypeName;
+
+// As in src/codegen/solana_generator.mega
+static const TypeName SOLANA_TYPES[] = {
+    { "uint", "u64" }, { "uint8", "u8" }, { "uint16", "u16" }, { "uint32", "u32" },
+    { "uint64", "u64" }, { "uint128", "u128" }, { "uint256", "U256" },
+    { "int", "i64" }, { "int8", "i8" }, { "int16", "i16" }, { "int32", "i32" },
+    { "int64", "i64" }, { "int128", "i128" }, { "int256", "I256" },
+    { "bool", "bool" }, { "string", "String" }, { "bytes", "Vec<u8>" },
+    { "bytes32", "[u8; 32]" }, { "address", "Pubkey" },
+    { NULL, NULL }
+};
+
+// As in src/target_code_generator.mega
+static const TypeName COSMOS_TYPES[] = {
+    { "uint", "uint64" }, { "uint8", "uint8" }, { "uint16", "uint16" }, { "uint32", "uint32" },
+    { "uint64", "uint64" }, { "uint128", "sdk.Uint" }, { "uint256", "sdk.Uint" },
+    { "int", "int64" }, { "int8", "int8" }, { "int16", "int16" }, { "int32", "int32" },
+    { "int64", "int64" }, { "int128", "sdk.Int" }, { "int256", "sdk.Int" },
+    { "bool", "bool" }, { "string", "string" }, { "bytes", "[]byte" },
+    { "bytes32", "[32]byte" }, { "address", "sdk.AccAddress" },
+    { NULL, NULL }
+};
+
+static const char* const RUST_KEYWORDS[] = {
+    "as", "async", "await", "break", "const", "continue", "crate", "dyn", "else", "enum",
+    "extern", "false", "fn", "for", "if", "impl", "in", "let", "loop", "match", "mod", "move",
+    "mut", "pub", "ref", "return", "self", "Self", "static", "struct", "super", "trait", "true",
+    "try", "type", "unsafe", "use", "where", "while", "yield", NULL
+};
+
+static const char* const GO_KEYWORDS[] = {
+    "break", "case", "chan", "const", "continue", "default", "defer", "else", "fallthrough",
+    "for", "func", "go", "goto", "if", "import", "interface", "map", "package", "range",
+    "return", "select", "struct", "switch", "type", "var", NULL
+};
+
+typedef struct {
+    const CodegenModule* module;
+    const int* overloads;   // per function, see number_overloads
+    CodegenTarget target;
+    CodegenArena* out;
+} Generator;
+
+// A name that is a keyword of the target language gets a trailing '_'.
+static void avoid_keyword(const Generator* gen, Scratch* name) {
+    const char* const* keywords = gen->target == TARGET_SOLANA ? RUST_KEYWORDS :
+                                  gen->target == TARGET_COSMOS ? GO_KEYWORDS : NULL;
+    for (int i = 0; keywords && keywords[i]; i++) {
+        if (strcmp(keywords[i], name->text) == 0) {
+            scratch_char(name, '_');
+            return;
+        }
+    }
+}
+
+static bool same_name(const char* name, const char* text, size_t length) {
+    return strncmp(name, text, length) == 0 && name[length] == '\0';
+}
+
+static bool is_enum(const CodegenModule* module, const char* text, size_t length) {
+    for (int i = 0; i < module->enum_count; i++) {
+        if (same_name(module->enums[i], text, length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Offset of the "=>" at bracket depth 0 in text[0, length), or length.
+static size_t top_level_arrow(const char* text, size_t length) {
+    int depth = 0;
+    for (size_t i = 0; i + 1 < length; i++) {
+        if (text[i] == '(' || text[i] == '[') {
+            depth++;
+        } else if (text[i] == ')' || text[i] == ']') {
+            depth--;
+        } else if (depth == 0 && text[i] == '=' && text[i + 1] == '>') {
+            return i;
+        }
+    }
+    return length;
+}
+
+// Spell the canonical type text[0, length) for the generator's target.
+// Enums become uint8, since their members are not collected; structs and
+// other user types keep their names.
+static void translate_type(const Generator* gen, const char* text, size_t length, Scratch* out) {
+    if (length > 9 && strncmp(text, "mapping(", 8) == 0 && text[length - 1] == ')') {
+        const char* inner = text + 8;
+        size_t inner_length = length - 9;
+        size_t arrow = top_level_arrow(inner, inner_length);
+        if (arrow < inner_length) {
+            Scratch key = { "", 0 };
+            Scratch value = { "", 0 };
+            translate_type(gen, inner, arrow, &key);
+            translate_type(gen, inner + arrow + 2, inner_length - arrow - 2, &value);
+            if (gen->target == TARGET_EVM) {
+                scratch_puts(out, "mapping(");
+                scratch_puts(out, key.text);
+                scratch_puts(out, " => ");
+                scratch_puts(out, value.text);
+                scratch_puts(out, ")");
+            } else if (gen->target == TARGET_SOLANA) {
+                scratch_puts(out, "Vec<(");
+                scratch_puts(out, key.text);
+                scratch_puts(out, ", ");
+                scratch_puts(out, value.text);
+                scratch_puts(out, ")>");
+            } else {
+                // Go map keys must be comparable; addresses and big integers
+                // are keyed by their string form
+                bool comparable = strncmp(key.text, "sdk.", 4) != 0 && strncmp(key.text, "[]", 2) != 0;
+                scratch_puts(out, "map[");
+                scratch_puts(out, comparable ? key.text : "string");
+                scratch_puts(out, "]");
+                scratch_puts(out, value.text);
+            }
+            return;
+        }
+    }
+
+    if (length > 2 && text[length - 1] == ']') {
+        size_t open = length - 1;
+        while (open > 0 && text[open] != '[') {
+            open--;
+        }
+        if (open > 0) {
+            Scratch element = { "", 0 };
+            translate_type(gen, text, open, &element);
+            const char* size = text + open + 1;
+            size_t size_length = length - open - 2;
+            if (gen->target == TARGET_EVM) {
+                scratch_puts(out, element.text);
+                scratch_append(out, text + open, length - open);
+            } else if (gen->target == TARGET_SOLANA) {
+                scratch_puts(out, size_length == 0 ? "Vec<" : "[");
+                scratch_puts(out, element.text);
+                if (size_length > 0) {
+                    scratch_puts(out, "; ");
+                    scratch_append(out, size, size_length);
+                }
+                scratch_puts(out, size_length == 0 ? ">" : "]");
+            } else {
+                scratch_puts(out, "[");
+                scratch_append(out, size, size_length);
+                scratch_puts(out, "]");
+                scratch_puts(out, element.text);
+            }
+            return;
+        }
+    }
+
+    if (is_enum(gen->module, text, length)) {
+        text = "uint8";
+        length = 5;
+    }
+    const TypeName* names = gen->target == TARGET_SOLANA ? SOLANA_TYPES :
+                            gen->target == TARGET_COSMOS ? COSMOS_TYPES : NULL;
+    for (int i = 0; names && names[i].omega; i++) {
+        if (same_name(names[i].omega, text, length)) {
+            scratch_puts(out, names[i].native);
+            return;
+        }
+    }
+    scratch_append(out, text, length);
+}
+
+static void translate_cstr(const Generator* gen, const char* type, Scratch* out) {
+    translate_type(gen, type, strlen(type), out);
+}
+
+// Walks the top-level parameter types of a canonical signature.
+typedef struct {
+    const char* at;
+    const char* end;
+} ParameterCursor;
+
+static ParameterCursor parameters_of(const char* signature) {
+    ParameterCursor cursor = { NULL, NULL };
+    const char* open = strchr(signature, '(');
+    const char* close = strrchr(signature, ')');
+    if (open && close && close > open) {
+        cursor.at = open + 1;
+        cursor.end = close;
+    }
+    return cursor;
+}
+
+static bool next_parameter(ParameterCursor* cursor, const char** type, size_t* length) {
+    if (cursor->at >= cursor->end) {
+        return false;
+    }
+    int depth = 0;
+    const char* p = cursor->at;
+    for (; p < cursor->end; p++) {
+        if (*p == '(' || *p == '[') {
+            depth++;
+        } else if (*p == ')' || *p == ']') {
+            depth--;
+        } else if (*p == ',' && depth == 0) {
+            break;
+        }
+    }
+    *type = cursor->at;
+    *length = (size_t)(p - cursor->at);
+    cursor->at = p < cursor->end ? p + 1 : p;
+    return true;
+}
+
+typedef enum {
+    CASE_AS_WRITTEN,
+    CASE_PASCAL,            // Go exported names
+    CASE_CAMEL,             // Go unexported names
+    CASE_SNAKE              // Rust modules
+} NameCase;
+
+static void append_name(Scratch* out, const char* name, NameCase style) {
+    bool upper_next = style == CASE_PASCAL;
+    for (const char* c = name; *c; c++) {
+        unsigned char ch = (unsigned char)*c;
+        if (style == CASE_SNAKE) {
+            if (isupper(ch) && c > name && (islower((unsigned char)c[-1]) || isdigit((unsigned char)c[-1]))) {
+                scratch_char(out, '_');
+            }
+            scratch_char(out, (char)tolower(ch));
+        } else if ((style == CASE_PASCAL || style == CASE_CAMEL) && ch == '_' && c[1]) {
+            upper_next = style == CASE_PASCAL || out->length > 0;
+        } else if (upper_next) {
+            scratch_char(out, (char)toupper(ch));
+            upper_next = false;
+        } else if (style == CASE_CAMEL && out->length == 0) {
+            scratch_char(out, (char)tolower(ch));
+        } else {
+            scratch_char(out, (char)ch);
+        }
+    }
+}
+
+// Rust and Go have no overloading: the second transfer(...) of a contract
+// becomes transfer_1. Events are module-level types there, so they are
+// numbered across contracts.
+static void function_name(const Generator* gen, int index, NameCase style, Scratch* out) {
+    append_name(out, gen->module->functions[index].name, style);
+    if (gen->overloads[index] > 0 && gen->target != TARGET_EVM) {
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "_%d", gen->overloads[index]);
+        scratch_puts(out, suffix);
+    }
+    avoid_keyword(gen, out);
+}
+
+static bool same_overload_set(const CodegenFunction* a, const CodegenFunction* b) {
+    return a->is_event == b->is_event && (a->is_event || a->contract == b->contract) &&
+           strcmp(a->name, b->name) == 0;
+}
+
+// How many earlier functions each function shares a name with, in its
+// contract (events: in the module). Hashed once before the generators
+// start, so naming stays linear in the number of functions.
+static int* number_overloads(const CodegenModule* module) {
+    int count = module->function_count;
+    uint32_t size = 16;
+    while (size < (uint32_t)count * 2) {
+        size *= 2;
+    }
+    int* overloads = calloc((size_t)count + 1, sizeof(int));
+    int* slots = calloc(size, sizeof(int));     // latest function of a set + 1; 0 is empty
+    if (!overloads || !slots) {
+        free(overloads);
+        free(slots);
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        const CodegenFunction* function = &module->functions[i];
+        uint32_t hash = 2166136261u;
+        for (const unsigned char* c = (const unsigned char*)function->name; *c; c++) {
+            hash = (hash ^ *c) * 16777619u;
+        }
+        hash ^= function->is_event ? 0x9E3779B9u : (uint32_t)(function->contract + 1) * 0x85EBCA6Bu;
+        uint32_t slot = hash & (size - 1);
+        while (slots[slot] != 0 && !same_overload_set(&module->functions[slots[slot] - 1], function)) {
+            slot = (slot + 1) & (size - 1);
+        }
+        if (slots[slot] != 0) {
+            overloads[i] = overloads[slots[slot] - 1] + 1;
+        }
+        slots[slot] = i + 1;
+    }
+    free(slots);
+    return overloads;
+}
+
+static const CodegenField* type_fields(const CodegenModule* module, const CodegenType* type) {
+    return module->fields + type->first_field;
+}
+
+// ============================================================================
+// EVM (Solidity)
+// ============================================================================
+
+static bool is_contract(const CodegenModule* module, const char* text, size_t length) {
+    for (int i = 0; i < module->contract_count; i++) {
+        if (same_name(module->contracts[i].name, text, length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_imported_value_type(const CodegenModule* module, const char* text, size_t length) {
+    for (int i = 0; i < module->value_type_count; i++) {
+        if (same_name(module->value_types[i], text, length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// text[from, length) is empty or a decimal number no greater than `max`.
+static bool optional_width(const char* text, size_t from, size_t length, int max) {
+    int width = 0;
+    for (size_t i = from; i < length; i++) {
+        if (!isdigit((unsigned char)text[i]) || (width = width * 10 + (text[i] - '0')) > max) {
+            return false;
+        }
+    }
+    return from == length || width > 0;
+}
+
+// Elementary value types, enums and contracts, the module's own or imported.
+static bool is_value_type(const CodegenModule* module, const char* type, size_t length) {
+    if (same_name("bool", type, length) || same_name("address", type, length)) {
+        return true;
+    }
+    if (length >= 4 && strncmp(type, "uint", 4) == 0) {
+        return optional_width(type, 4, length, 256);
+    }
+    if (length >= 3 && strncmp(type, "int", 3) == 0) {
+        return optional_width(type, 3, length, 256);
+    }
+    if (length > 5 && strncmp(type, "bytes", 5) == 0) {
+        return optional_width(type, 5, length, 32);
+    }
+    return is_enum(module, type, length) || is_contract(module, type, length) ||
+           is_imported_value_type(module, type, length);
+}
+
+// Everything but a value type is passed in memory: strings, bytes, arrays,
+// and user-defined types not known to be value types, which covers structs
+// imported from other modules. Mappings cannot live in memory and are left
+// without a location.
+static bool needs_data_location(const Generator* gen, const char* type, size_t length) {
+    if (length > 8 && strncmp(type, "mapping(", 8) == 0) {
+        return false;
+    }
+    return !is_value_type(gen->module, type, length);
+}
+
+static void evm_function(const Generator* gen, int index, const char* indent) {
+    const CodegenFunction* function = &gen->module->functions[index];
+    arena_printf(gen->out, "%s%s %s(", indent, function->is_event ? "event" : "function", function->name);
+    ParameterCursor cursor = parameters_of(function->signature);
+    const char* type;
+    size_t length;
+    for (int arg = 0; next_parameter(&cursor, &type, &length); arg++) {
+        Scratch native = { "", 0 };
+        translate_type(gen, type, length, &native);
+        bool memory = !function->is_event && needs_data_location(gen, type, length);
+        arena_printf(gen->out, "%s%s%s arg%d", arg > 0 ? ", " : "", native.text, memory ? " memory" : "", arg);
+    }
+    if (function->is_event) {
+        arena_puts(gen->out, ");\n");
+    } else if (function->contract < 0) {
+        // Free functions take no visibility
+        arena_printf(gen->out, ") {\n%s}\n", indent);
+    } else {
+        arena_printf(gen->out, ") %s {\n%s}\n", function->is_public ? "public" : "internal", indent);
+    }
+}
+
+static void generate_evm(const Generator* gen) {
+    const CodegenModule* module = gen->module;
+    arena_puts(gen->out, "// SPDX-License-Identifier: MIT\npragma solidity ^0.8.19;\n\n");
+    arena_printf(gen->out, "// Generated by OMEGA Bootstrap from %s\n", module->source);
+
+    for (int s = 0; s < module->struct_count; s++) {
+        const CodegenType* type = &module->structs[s];
+        arena_printf(gen->out, "\nstruct %s {\n", type->name);
+        for (int f = 0; f < type->field_count; f++) {
+            Scratch native = { "", 0 };
+            translate_cstr(gen, type_fields(module, type)[f].type, &native);
+            arena_printf(gen->out, "    %s %s;\n", native.text, type_fields(module, type)[f].name);
+        }
+        arena_puts(gen->out, "}\n");
+    }
+    for (int i = 0; i < module->function_count; i++) {
+        if (module->functions[i].contract < 0) {
+            arena_puts(gen->out, "\n");
+            evm_function(gen, i, "");
+        }
+    }
+
+    for (int c = 0; c < module->contract_count; c++) {
+        const CodegenType* contract = &module->contracts[c];
+        arena_printf(gen->out, "\ncontract %s {\n", contract->name);
+        for (int f = 0; f < contract->field_count; f++) {
+            Scratch native = { "", 0 };
+            translate_cstr(gen, type_fields(module, contract)[f].type, &native);
+            arena_printf(gen->out, "    %s %s;\n", native.text, type_fields(module, contract)[f].name);
+        }
+        // Events as one group, then each function after a blank line
+        bool separate = contract->field_count > 0;
+        for (int pass = 0; pass < 2; pass++) {
+            bool events = pass == 0;
+            bool group_started = false;
+            for (int i = 0; i < module->function_count; i++) {
+                if (module->functions[i].contract != c || module->functions[i].is_event != events) {
+                    continue;
+                }
+                if (separate && (!events || !group_started)) {
+                    arena_puts(gen->out, "\n");
+                }
+                evm_function(gen, i, "    ");
+                separate = true;
+                group_started = true;
+            }
+        }
+        arena_puts(gen->out, "}\n");
+    }
+}
+
+// ============================================================================
+// SOLANA (Anchor)
+// ============================================================================
+
+// "arg0: Pubkey, arg1: U256", or one field per line for an event. `after`
+// says whether other arguments come first.
+static void solana_parameters(const Generator* gen, const char* signature, bool as_fields, bool after) {
+    ParameterCursor cursor = parameters_of(signature);
+    const char* type;
+    size_t length;
+    for (int arg = 0; next_parameter(&cursor, &type, &length); arg++) {
+        Scratch native = { "", 0 };
+        translate_type(gen, type, length, &native);
+        if (as_fields) {
+            arena_printf(gen->out, "    pub arg%d: %s,\n", arg, native.text);
+        } else {
+            arena_printf(gen->out, "%sarg%d: %s", arg > 0 || after ? ", " : "", arg, native.text);
+        }
+    }
+}
+
+static void solana_struct(const Generator* gen, const CodegenType* type, const char* attribute,
+                          const char* suffix) {
+    arena_printf(gen->out, "\n%s\npub struct %s%s {\n", attribute, type->name, suffix);
+    for (int f = 0; f < type->field_count; f++) {
+        Scratch field = { "", 0 };
+        Scratch native = { "", 0 };
+        scratch_puts(&field, type_fields(gen->module, type)[f].name);
+        avoid_keyword(gen, &field);
+        translate_cstr(gen, type_fields(gen->module, type)[f].type, &native);
+        arena_printf(gen->out, "    pub %s: %s,\n", field.text, native.text);
+    }
+    arena_puts(gen->out, "}\n");
+}
+
+static void generate_solana(const Generator* gen) {
+    const CodegenModule* module = gen->module;
+    arena_printf(gen->out, "// Generated by OMEGA Bootstrap from %s\n", module->source);
+    arena_puts(gen->out, "use anchor_lang::prelude::*;\n");
+
+    for (int s = 0; s < module->struct_count; s++) {
+        solana_struct(gen, &module->structs[s], "#[derive(AnchorSerialize, AnchorDeserialize, Clone)]", "");
+    }
+    for (int i = 0; i < module->function_count; i++) {
+        const CodegenFunction* function = &module->functions[i];
+        Scratch name = { "", 0 };
+        function_name(gen, i, function->is_event ? CASE_AS_WRITTEN : CASE_SNAKE, &name);
+        if (function->is_event) {
+            arena_printf(gen->out, "\n#[event]\npub struct %s {\n", name.text);
+            solana_parameters(gen, function->signature, true, false);
+            arena_puts(gen->out, "}\n");
+        } else if (function->contract < 0) {
+            arena_printf(gen->out, "\npub fn %s(", name.text);
+            solana_parameters(gen, function->signature, false, false);
+            arena_puts(gen->out, ") -> Result<()> {\n    Ok(())\n}\n");
+        }
+    }
+
+    for (int c = 0; c < module->contract_count; c++) {
+        const CodegenType* contract = &module->contracts[c];
+        solana_struct(gen, contract, "#[account]", "State");
+        arena_printf(gen->out, "\n#[derive(Accounts)]\npub struct %sAccounts<'info> {\n"
+                     "    #[account(mut)]\n    pub state: Account<'info, %sState>,\n"
+                     "    pub signer: Signer<'info>,\n}\n", contract->name, contract->name);
+
+        // Private functions are helpers on the state, public ones instructions
+        bool helpers = false;
+        for (int i = 0; i < module->function_count; i++) {
+            const CodegenFunction* function = &module->functions[i];
+            if (function->contract != c || function->is_event || function->is_public) {
+                continue;
+            }
+            if (!helpers) {
+                arena_printf(gen->out, "\nimpl %sState {\n", contract->name);
+                helpers = true;
+            }
+            Scratch name = { "", 0 };
+            function_name(gen, i, CASE_SNAKE, &name);
+            arena_printf(gen->out, "    fn %s(&mut self", name.text);
+            solana_parameters(gen, function->signature, false, true);
+            arena_puts(gen->out, ") -> Result<()> {\n        Ok(())\n    }\n");
+        }
+        if (helpers) {
+            arena_puts(gen->out, "}\n");
+        }
+
+        Scratch module_name = { "", 0 };
+        append_name(&module_name, contract->name, CASE_SNAKE);
+        avoid_keyword(gen, &module_name);
+        arena_printf(gen->out, "\n#[program]\npub mod %s {\n    use super::*;\n", module_name.text);
+        for (int i = 0; i < module->function_count; i++) {
+            const CodegenFunction* function = &module->functions[i];
+            if (function->contract != c || function->is_event || !function->is_public) {
+                continue;
+            }
+            Scratch name = { "", 0 };
+            function_name(gen, i, CASE_SNAKE, &name);
+            arena_printf(gen->out, "\n    pub fn %s(ctx: Context<%sAccounts>", name.text, contract->name);
+            solana_parameters(gen, function->signature, false, true);
+            arena_puts(gen->out, ") -> Result<()> {\n        Ok(())\n    }\n");
+        }
+        arena_puts(gen->out, "}\n");
+    }
+}
+
+// ============================================================================
+// COSMOS (Go, Cosmos SDK)
+// ============================================================================
+
+static bool cosmos_type_uses_sdk(const Generator* gen, const char* type, size_t length) {
+    Scratch native = { "", 0 };
+    translate_type(gen, type, length, &native);
+    return strstr(native.text, "sdk.") != NULL;
+}
+
+// Go rejects unused imports, so the SDK is imported only when referenced.
+static bool cosmos_uses_sdk(const Generator* gen) {
+    const CodegenModule* module = gen->module;
+    for (int i = 0; i < module->function_count; i++) {
+        const CodegenFunction* function = &module->functions[i];
+        if (function->contract >= 0 && !function->is_event) {
+            return true;    // keeper methods take an sdk.Context
+        }
+        ParameterCursor cursor = parameters_of(function->signature);
+        const char* type;
+        size_t length;
+        while (next_parameter(&cursor, &type, &length)) {
+            if (cosmos_type_uses_sdk(gen, type, length)) {
+                return true;
+            }
+        }
+    }
+    for (int c = 0; c < module->contract_count + module->struct_count; c++) {
+        const CodegenType* type = c < module->contract_count ? &module->contracts[c] :
+                                  &module->structs[c - module->contract_count];
+        for (int f = 0; f < type->field_count; f++) {
+            const char* field_type = type_fields(module, type)[f].type;
+            if (cosmos_type_uses_sdk(gen, field_type, strlen(field_type))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void cosmos_struct(const Generator* gen, const char* name, const char* suffix,
+                          const CodegenType* type) {
+    arena_printf(gen->out, "\ntype %s%s struct {\n", name, suffix);
+    for (int f = 0; f < type->field_count; f++) {
+        Scratch field = { "", 0 };
+        Scratch native = { "", 0 };
+        append_name(&field, type_fields(gen->module, type)[f].name, CASE_PASCAL);
+        translate_cstr(gen, type_fields(gen->module, type)[f].type, &native);
+        arena_printf(gen->out, "    %s %s\n", field.text, native.text);
+    }
+    arena_puts(gen->out, "}\n");
+}
+
+static void generate_cosmos(const Generator* gen) {
+    const CodegenModule* module = gen->module;
+    Scratch package = { "", 0 };
+    for (const char* c = module->name; *c; c++) {
+        if (isalnum((unsigned char)*c) && (package.length > 0 || isalpha((unsigned char)*c))) {
+            scratch_char(&package, (char)tolower((unsigned char)*c));
+        }
+    }
+    arena_printf(gen->out, "// Generated by OMEGA Bootstrap from %s\n", module->source);
+    if (package.length == 0) {
+        scratch_puts(&package, "omega");
+    }
+    avoid_keyword(gen, &package);
+    arena_printf(gen->out, "package %s\n", package.text);
+    if (cosmos_uses_sdk(gen)) {
+        arena_puts(gen->out, "\nimport (\n    sdk \"github.com/cosmos/cosmos-sdk/types\"\n)\n");
+    }
+
+    for (int s = 0; s < module->struct_count; s++) {
+        cosmos_struct(gen, module->structs[s].name, "", &module->structs[s]);
+    }
+    for (int c = 0; c < module->contract_count; c++) {
+        cosmos_struct(gen, module->contracts[c].name, "Keeper", &module->contracts[c]);
+    }
+
+    for (int i = 0; i < module->function_count; i++) {
+        const CodegenFunction* function = &module->functions[i];
+        Scratch name = { "", 0 };
+        function_name(gen, i, function->is_public || function->is_event ? CASE_PASCAL : CASE_CAMEL, &name);
+        ParameterCursor cursor = parameters_of(function->signature);
+        const char* type;
+        size_t length;
+        if (function->is_event) {
+            arena_printf(gen->out, "\ntype Event%s struct {\n", name.text);
+            for (int arg = 0; next_parameter(&cursor, &type, &length); arg++) {
+                Scratch native = { "", 0 };
+                translate_type(gen, type, length, &native);
+                arena_printf(gen->out, "    Arg%d %s\n", arg, native.text);
+            }
+            arena_puts(gen->out, "}\n");
+            continue;
+        }
+        if (function->contract >= 0) {
+            arena_printf(gen->out, "\nfunc (k *%sKeeper) %s(ctx sdk.Context",
+                         module->contracts[function->contract].name, name.text);
+        } else {
+            arena_printf(gen->out, "\nfunc %s(", name.text);
+        }
+        for (int arg = 0; next_parameter(&cursor, &type, &length); arg++) {
+            Scratch native = { "", 0 };
+            translate_type(gen, type, length, &native);
+            arena_printf(gen->out, "%sarg%d %s", arg > 0 || function->contract >= 0 ? ", " : "", arg, native.text);
+        }
+        arena_puts(gen->out, ") error {\n    return nil\n}\n");
+    }
+}
+
+// ============================================================================
+// RUNNING TARGETS
+// ============================================================================
+
+typedef struct {
+    const CodegenModule* module;
+    const int* overloads;
+    CodegenResult* result;
+} CodegenJob;
+
+static void run_job(CodegenJob* job) {
+    CodegenResult* result = job->result;
+    double started = monotonic_ms();
+    CodegenArena arena;
+    memset(&arena, 0, sizeof(arena));
+    Generator gen = { job->module, job->overloads, result->target, &arena };
+
+    switch (result->target) {
+        case TARGET_EVM: generate_evm(&gen); break;
+        case TARGET_SOLANA: generate_solana(&gen); break;
+        default: generate_cosmos(&gen); break;
+    }
+
+    result->ok = arena_write(&arena, result->path);
+    result->size = result->ok ? arena.size : 0;
+    arena_free(&arena);
+    result->elapsed_ms = monotonic_ms() - started;
+}
+
+#if !defined(_WIN32)
+static void* job_main(void* arg) {
+    run_job(arg);
+    return NULL;
+}
+#endif
+
+bool codegen_parse_targets(const char* text, unsigned* targets) {
+    *targets = 0;
+    while (*text) {
+        size_t length = strcspn(text, ",");
+        bool known = same_name("all", text, length);
+        if (known) {
+            *targets |= TARGET_ALL;
+        }
+        for (int t = 0; t < TARGET_COUNT && !known; t++) {
+            if (same_name(target_flags[t], text, length)) {
+                *targets |= 1u << t;
+                known = true;
+            }
+        }
+        if (!known) {
+            return false;
+        }
+        text += length + (text[length] == ',');
+    }
+    return *targets != 0;
+}
+
+const char* codegen_target_name(CodegenTarget target) {
+    return (unsigned)target < TARGET_COUNT ? target_names[target] : "?";
+}
+
+const char* codegen_target_extension(CodegenTarget target) {
+    return (unsigned)target < TARGET_COUNT ? target_extensions[target] : "";
+}
+
+int codegen_run(const CodegenModule* module, unsigned targets, const char* stem,
+                CodegenResult results[TARGET_COUNT]) {
+    int* overloads = number_overloads(module);
+    CodegenJob jobs[TARGET_COUNT];
+    int count = 0;
+    int failed = 0;
+    for (int t = 0; t < TARGET_COUNT; t++) {
+        if (!(targets & (1u << t))) {
+            continue;
+        }
+        memset(&results[t], 0, sizeof(CodegenResult));
+        results[t].target = (CodegenTarget)t;
+        int length = snprintf(results[t].path, sizeof(results[t].path), "%s%s", stem, target_extensions[t]);
+        if (!overloads || length < 0 || (size_t)length >= sizeof(results[t].path)) {
+            failed++;
+            continue;
+        }
+        jobs[count].module = module;
+        jobs[count].overloads = overloads;
+        jobs[count].result = &results[t];
+        count++;
+    }
+
+    // A thread per extra target; the calling thread takes the first. A
+    // thread that cannot start leaves its target to the caller.
+#if !defined(_WIN32)
+    pthread_t threads[TARGET_COUNT];
+    bool started[TARGET_COUNT] = { false };
+    for (int i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, job_main, &jobs[i]) == 0;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!started[i]) {
+            run_job(&jobs[i]);
+        }
+    }
+    for (int i = 1; i < count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        run_job(&jobs[i]);
+    }
+#endif
+
+    free(overloads);
+    for (int i = 0; i < count; i++) {
+        failed += !jobs[i].result->ok;
+    }
+    return failed;
+}
@@ -0,0 +1,93 @@
+// OMEGA Bootstrap - Target Code Generation
+// Purpose: Emit EVM (Solidity), Solana (Anchor) and Cosmos (Go) sources from one parse
+// Platform: Windows, Linux, macOS (C99; targets run concurrently on POSIX threads,
+//           one after another on Windows)
+// The compiler parses and analyzes a module once and describes it as a
+// CodegenModule: contracts with their state, structs, enums, functions and
+// events. Its strings belong to the parser and the intern table, and no
+// generator writes to it, so every target runs on its own thread over the
+// same description. A generator appends its output to an arena only it
+// allocates from, then writes the arena to its file; the threads share
+// nothing mutable, and --target all takes about as long as the slowest
+// target.
+// Output is the declaration skeleton the generators in src/codegen start
+// from: storage, types, events and every function with an empty body.
+// Parameters are named arg0, arg1, ... because signatures keep only types.
+
+#ifndef OMEGA_CODEGEN_H
+#define OMEGA_CODEGEN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define CODEGEN_PATH_MAX 4096
+
+typedef enum {
+    TARGET_EVM,
+    TARGET_SOLANA,
+    TARGET_COSMOS,
+    TARGET_COUNT
+} CodegenTarget;
+
+#define TARGET_ALL ((1u << TARGET_COUNT) - 1)
+
+typedef struct {
+    const char* name;
+    const char* type;       // canonical, e.g. "mapping(address=>uint256)"
+} CodegenField;
+
+typedef struct {
+    const char* name;
+    const char* signature;  // canonical, e.g. "transfer(address,uint256)"
+    int contract;           // index into contracts; -1 at top level
+    bool is_event;
+    bool is_public;
+} CodegenFunction;
+
+// Contract or struct; fields are CodegenModule.fields[first_field, +field_count),
+// in storage layout order (packed unless @nopack). A contract's fields are its
+// state.
+typedef struct {
+    const char* name;
+    int first_field;
+    int field_count;
+} CodegenType;
+
+typedef struct {
+    const char* source;     // path as compiled
+    const char* name;       // module name, from the file name
+    const CodegenType* contracts;
+    int contract_count;
+    const CodegenType* structs;
+    int struct_count;
+    const char* const* enums;
+    int enum_count;
+    const char* const* value_types; // imported enums and contracts
+    int value_type_count;
+    const CodegenField* fields;
+    const CodegenFunction* functions;
+    int function_count;
+} CodegenModule;
+
+typedef struct {
+    CodegenTarget target;
+    char path[CODEGEN_PATH_MAX];
+    size_t size;            // bytes written
+    double elapsed_ms;      // generating and writing, on the target's thread
+    bool ok;
+} CodegenResult;
+
+// Parse "evm", "solana", "cosmos", "all" or a comma-separated list into a
+// mask of (1 << CodegenTarget); false if a name is unknown.
+bool codegen_parse_targets(const char* text, unsigned* targets);
+
+const char* codegen_target_name(CodegenTarget target);      // "EVM", "Solana", "Cosmos"
+const char* codegen_target_extension(CodegenTarget target); // ".sol", ".rs", ".go"
+
+// Generate every target in `targets` and write it to `stem` plus the
+// target's extension. results[target] is filled for each requested target.
+// Returns how many failed.
+int codegen_run(const CodegenModule* module, unsigned targets, const char* stem,
+                CodegenResult results[TARGET_COUNT]);
+
+#endif // OMEGA_CODEGEN_H
@@ -0,0 +1,45 @@
+// OMEGA Bootstrap - Content Hash
+// Two XXH64 lanes over 16-byte blocks, a zero-padded tail and a final avalanche.
+
+#include "omega_hash.h"
+
+#include <string.h>
+
+#define HASH_PRIME1 0x9E3779B185EBCA87ull
+#define HASH_PRIME2 0xC2B2AE3D27D4EB4Full
+#define HASH_PRIME3 0x165667B19E3779F9ull
+
+static uint64_t hash_round(uint64_t lane, uint64_t input) {
+    lane += input * HASH_PRIME2;
+    lane = (lane << 31) | (lane >> 33);
+    return lane * HASH_PRIME1;
+}
+
+static uint64_t hash_avalanche(uint64_t value) {
+    value ^= value >> 33;
+    value *= HASH_PRIME2;
+    value ^= value >> 29;
+    value *= HASH_PRIME3;
+    return value ^ (value >> 32);
+}
+
+void content_hash(const void* data, size_t size, uint64_t out[2]) {
+    const uint8_t* bytes = data;
+    uint64_t first = HASH_PRIME1 + HASH_PRIME2;
+    uint64_t second = HASH_PRIME2 ^ (uint64_t)size;
+    size_t whole = size & ~(size_t)15;
+    uint64_t words[2];
+    for (size_t i = 0; i < whole; i += 16) {
+        memcpy(words, bytes + i, 16);
+        first = hash_round(first, words[0]);
+        second = hash_round(second, words[1]);
+    }
+    // Zero-padded tail; the size is already mixed in
+    uint8_t tail[16] = { 0 };
+    memcpy(tail, bytes + whole, size - whole);
+    memcpy(words, tail, 16);
+    first = hash_round(first, words[0]);
+    second = hash_round(second, words[1]);
+    out[0] = hash_avalanche(first + second * HASH_PRIME3);
+    out[1] = hash_avalanche(second ^ ((first << 27) | (first >> 37)));
+}
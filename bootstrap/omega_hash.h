@@ -0,0 +1,17 @@
+// OMEGA Bootstrap - Content Hash
+// Purpose: Fingerprint source files for the parse cache and module interfaces
+// Platform: Windows, Linux, macOS (standard C99)
+// A 128-bit non-cryptographic hash built from the lane round and avalanche
+// of XXH64, two lanes wide. Caches hash every source on every compile, so it
+// has to run far faster than the lexer it lets them skip. Equal digests are
+// taken to mean equal bytes; nothing here resists a deliberate collision.
+
+#ifndef OMEGA_HASH_H
+#define OMEGA_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+void content_hash(const void* data, size_t size, uint64_t out[2]);
+
+#endif // OMEGA_HASH_H
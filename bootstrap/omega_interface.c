@@ -0,0 +1,306 @@
+// OMEGA Bootstrap - Module Interfaces
+// Serialization, validation and memory mapping of .omi files.
+
+#if !defined(_WIN32)
+#define _XOPEN_SOURCE 700
+#endif
+
+#include "omega_interface.h"
+#include "omega_hash.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// BUILDER
+// ============================================================================
+
+void interface_builder_init(InterfaceBuilder* builder) {
+    memset(builder, 0, sizeof(InterfaceBuilder));
+}
+
+void interface_builder_free(InterfaceBuilder* builder) {
+    free(builder->symbols);
+    free(builder->strings);
+    memset(builder, 0, sizeof(InterfaceBuilder));
+}
+
+static bool add_string(InterfaceBuilder* builder, const char* text, uint32_t* offset) {
+    uint32_t length = (uint32_t)strlen(text) + 1;
+    if (builder->strings_size + length > builder->strings_capacity) {
+        uint32_t capacity = builder->strings_capacity ? builder->strings_capacity : 1024;
+        while (builder->strings_size + length > capacity) {
+            capacity *= 2;
+        }
+        char* strings = realloc(builder->strings, capacity);
+        if (!strings) {
+            return false;
+        }
+        builder->strings = strings;
+        builder->strings_capacity = capacity;
+    }
+    memcpy(builder->strings + builder->strings_size, text, length);
+    *offset = builder->strings_size;
+    builder->strings_size += length;
+    return true;
+}
+
+bool interface_builder_add(InterfaceBuilder* builder, SymbolKind kind, bool is_public,
+                           const char* name, const char* signature, int line) {
+    if (builder->symbol_count == builder->symbol_capacity) {
+        int capacity = builder->symbol_capacity ? builder->symbol_capacity * 2 : 64;
+        InterfaceSymbol* symbols = realloc(builder->symbols, sizeof(InterfaceSymbol) * capacity);
+        if (!symbols) {
+            return false;
+        }
+        builder->symbols = symbols;
+        builder->symbol_capacity = capacity;
+    }
+
+    InterfaceSymbol symbol;
+    if (!add_string(builder, name, &symbol.name)) {
+        return false;
+    }
+    // Types without a signature reuse their name
+    if (strcmp(signature, name) == 0) {
+        symbol.signature = symbol.name;
+    } else if (!add_string(builder, signature, &symbol.signature)) {
+        return false;
+    }
+    symbol.kind = (uint16_t)kind;
+    symbol.flags = is_public ? SYMBOL_PUBLIC : 0;
+    symbol.line = (uint32_t)line;
+    builder->symbols[builder->symbol_count++] = symbol;
+    return true;
+}
+
+void* interface_builder_serialize(const InterfaceBuilder* builder, const char* source_path,
+                                  const char* source, size_t source_size, size_t* size) {
+    InterfaceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INTERFACE_MAGIC, 4);
+    header.version = INTERFACE_VERSION;
+    content_hash(source, source_size, header.source_hash);
+    header.source_size = (int64_t)source_size;
+    // No stamp (-1) never matches, so the source is hashed on every open
+    struct stat info;
+    bool stamped = stat(source_path, &info) == 0;
+    header.source_file_size = stamped ? (int64_t)info.st_size : -1;
+    header.source_mtime = stamped ? (int64_t)info.st_mtime : -1;
+    header.symbol_count = (uint32_t)builder->symbol_count;
+    header.strings_size = builder->strings_size;
+
+    size_t symbols_size = sizeof(InterfaceSymbol) * (size_t)builder->symbol_count;
+    *size = sizeof(header) + symbols_size + builder->strings_size;
+    char* data = malloc(*size);
+    if (!data) {
+        return NULL;
+    }
+    memcpy(data, &header, sizeof(header));
+    if (symbols_size > 0) {
+        memcpy(data + sizeof(header), builder->symbols, symbols_size);
+    }
+    if (builder->strings_size > 0) {
+        memcpy(data + sizeof(header) + symbols_size, builder->strings, builder->strings_size);
+    }
+    return data;
+}
+
+bool interface_write_file(const char* path, const void* data, size_t size) {
+    char temp[4096 + 32];
+    int written = snprintf(temp, sizeof(temp), "%s.%ld.tmp", path, (long)getpid());
+    if (written < 0 || (size_t)written >= sizeof(temp)) {
+        return false;
+    }
+
+    FILE* file = fopen(temp, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(data, 1, size, file) == size;
+    ok = fclose(file) == 0 && ok;
+
+#ifdef _WIN32
+    // rename() does not replace existing files on Windows
+    if (ok) {
+        remove(path);
+    }
+#endif
+    if (!ok || rename(temp, path) != 0) {
+        remove(temp);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// LOADING
+// ============================================================================
+
+// Check the header and that every offset stays inside the buffer.
+static bool interface_bind(ModuleInterface* iface) {
+    if (iface->size < sizeof(InterfaceHeader)) {
+        return false;
+    }
+    const InterfaceHeader* header = iface->data;
+    if (memcmp(header->magic, INTERFACE_MAGIC, 4) != 0 || header->version != INTERFACE_VERSION) {
+        return false;
+    }
+    size_t expected = sizeof(InterfaceHeader) +
+                      sizeof(InterfaceSymbol) * (size_t)header->symbol_count +
+                      header->strings_size;
+    if (expected != iface->size ||
+        (header->strings_size > 0 && ((const char*)iface->data)[iface->size - 1] != '\0')) {
+        return false;
+    }
+
+    iface->header = header;
+    iface->symbols = (const InterfaceSymbol*)(header + 1);
+    iface->strings = (const char*)(iface->symbols + header->symbol_count);
+    for (uint32_t i = 0; i < header->symbol_count; i++) {
+        if (iface->symbols[i].name >= header->strings_size ||
+            iface->symbols[i].signature >= header->strings_size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ModuleInterface* interface_from_buffer(void* data, size_t size) {
+    ModuleInterface* iface = calloc(1, sizeof(ModuleInterface));
+    if (!iface) {
+        free(data);
+        return NULL;
+    }
+    iface->data = data;
+    iface->size = size;
+    iface->mapped = false;
+    if (!interface_bind(iface)) {
+        interface_close(iface);
+        return NULL;
+    }
+    return iface;
+}
+
+// Whether the source at `path` is still the one `header` describes. An
+// unchanged stamp that predates the interface file (`written`) is enough;
+// otherwise the source must still have source_size bytes hashing to
+// source_hash. It is read in text mode like the compiler reads it, so on
+// Windows a CRLF source may come out shorter than the file.
+static bool source_matches(const char* path, const InterfaceHeader* header, int64_t written) {
+    struct stat info;
+    if (stat(path, &info) != 0 || (int64_t)info.st_size < header->source_size) {
+        return false;
+    }
+    if ((int64_t)info.st_size == header->source_file_size &&
+        (int64_t)info.st_mtime == header->source_mtime && header->source_mtime < written) {
+        return true;
+    }
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    char* data = malloc((size_t)info.st_size + 1);
+    bool read = data && fread(data, 1, (size_t)info.st_size + 1, file) == (size_t)header->source_size;
+    fclose(file);
+    uint64_t digest[2];
+    if (read) {
+        content_hash(data, (size_t)header->source_size, digest);
+    }
+    free(data);
+    return read && digest[0] == header->source_hash[0] && digest[1] == header->source_hash[1];
+}
+
+ModuleInterface* interface_open(const char* path, const char* source_path) {
+    struct stat info;
+    if (stat(path, &info) != 0 || info.st_size <= 0) {
+        return NULL;
+    }
+
+    ModuleInterface* iface = calloc(1, sizeof(ModuleInterface));
+    if (!iface) {
+        return NULL;
+    }
+    iface->size = (size_t)info.st_size;
+
+#ifdef _WIN32
+    FILE* file = fopen(path, "rb");
+    iface->data = file ? malloc(iface->size) : NULL;
+    if (!iface->data || fread(iface->data, 1, iface->size, file) != iface->size) {
+        if (file) fclose(file);
+        interface_close(iface);
+        return NULL;
+    }
+    fclose(file);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        free(iface);
+        return NULL;
+    }
+    void* data = mmap(NULL, iface->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        free(iface);
+        return NULL;
+    }
+    iface->data = data;
+    iface->mapped = true;
+#endif
+
+    if (!interface_bind(iface) ||
+        !source_matches(source_path, iface->header, (int64_t)info.st_mtime)) {
+        interface_close(iface);
+        return NULL;
+    }
+    return iface;
+}
+
+void interface_close(ModuleInterface* iface) {
+    if (!iface) {
+        return;
+    }
+#ifndef _WIN32
+    if (iface->mapped) {
+        munmap(iface->data, iface->size);
+    } else
+#endif
+    {
+        free(iface->data);
+    }
+    free(iface);
+}
+
+int interface_find(const ModuleInterface* iface, const char* name) {
+    for (uint32_t i = 0; i < iface->header->symbol_count; i++) {
+        if (strcmp(iface->strings + iface->symbols[i].name, name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+const char* interface_string(const ModuleInterface* iface, uint32_t offset) {
+    return iface->strings + offset;
+}
+
+void interface_path_for(const char* dir, const char* source_path, char* out, size_t out_size) {
+    const char* name = strrchr(source_path, '/');
+    name = name ? name + 1 : source_path;
+    size_t stem = strcspn(name, ".");
+    uint64_t digest[2];
+    content_hash(source_path, strlen(source_path), digest);
+    snprintf(out, out_size, "%s/%.*s-%016llx.omi", dir, (int)stem, name,
+             (unsigned long long)digest[0]);
+}
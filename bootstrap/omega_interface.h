@@ -0,0 +1,114 @@
+// OMEGA Bootstrap - Module Interfaces
+// Purpose: Compact binary summaries (.omi) of what a module declares
+// Platform: Windows, Linux, macOS (C99; mmap on POSIX, buffered read on Windows)
+// An interface lists a module's functions, events, structs and top-level
+// types with their canonical signatures. Importers read it instead of
+// re-lexing and re-parsing the imported source. Interfaces live in a cache
+// directory, not the source tree, named after the source's canonical path
+// (io.mega -> <dir>/io-<16 hex digits>.omi).
+// An interface is trusted while its source has the recorded content hash
+// (omega_hash.h). The source's on-disk size and modification time are
+// recorded too: when both still match and the source is strictly older than
+// the interface file, the source is not read at all. A source modified in
+// the same second the interface was written is always hashed, because an
+// edit that keeps the size can land within the timestamp's resolution.
+//
+// Layout (native endianness; interfaces are a local build cache):
+//   InterfaceHeader
+//   InterfaceSymbol[symbol_count]
+//   char strings[strings_size]     NUL-terminated, referenced by offset
+
+#ifndef OMEGA_INTERFACE_H
+#define OMEGA_INTERFACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define INTERFACE_MAGIC "OMI1"
+#define INTERFACE_VERSION 3
+#define INTERFACE_DEFAULT_DIR "target/interfaces"
+
+typedef enum {
+    SYMBOL_FUNCTION = 1,
+    SYMBOL_EVENT = 2,
+    SYMBOL_STRUCT = 3,
+    SYMBOL_TYPE = 4,       // blockchain, contract, library or enum
+    SYMBOL_IMPORT = 5,     // imported name; only in object files (omega_object.h)
+    SYMBOL_PRUNED = 6      // unreachable import declaration; only in object files
+} SymbolKind;
+
+#define SYMBOL_PUBLIC 0x1
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint64_t source_hash[2];    // content_hash of the source compiled
+    int64_t source_size;        // bytes hashed
+    int64_t source_file_size;   // on disk, as stat reported it
+    int64_t source_mtime;       // seconds
+    uint32_t symbol_count;
+    uint32_t strings_size;
+} InterfaceHeader;
+
+typedef struct {
+    uint32_t name;         // string offset
+    uint32_t signature;    // string offset, e.g. "println(string)"
+    uint16_t kind;         // SymbolKind
+    uint16_t flags;        // SYMBOL_PUBLIC
+    uint32_t line;
+} InterfaceSymbol;
+
+typedef struct {
+    const InterfaceHeader* header;
+    const InterfaceSymbol* symbols;
+    const char* strings;
+    void* data;
+    size_t size;
+    bool mapped;           // data is an mmap'd file rather than heap memory
+} ModuleInterface;
+
+// Accumulates symbols and serializes them.
+typedef struct {
+    InterfaceSymbol* symbols;
+    int symbol_count;
+    int symbol_capacity;
+    char* strings;
+    uint32_t strings_size;
+    uint32_t strings_capacity;
+} InterfaceBuilder;
+
+void interface_builder_init(InterfaceBuilder* builder);
+void interface_builder_free(InterfaceBuilder* builder);
+bool interface_builder_add(InterfaceBuilder* builder, SymbolKind kind, bool is_public,
+                           const char* name, const char* signature, int line);
+
+// Serialize into a heap buffer stamped with the size and hash of `source`,
+// the text the declarations were parsed from, and the current on-disk size
+// and modification time of `source_path`.
+void* interface_builder_serialize(const InterfaceBuilder* builder, const char* source_path,
+                                  const char* source, size_t source_size, size_t* size);
+
+// Write atomically (temp file + rename) so concurrent builds never see a
+// partial interface.
+bool interface_write_file(const char* path, const void* data, size_t size);
+
+// Map an interface file; NULL if it is missing, corrupt or stale for
+// `source_path`. Freshness costs a stat of the source unless its stamp
+// changed or is too recent to trust, in which case the source is hashed.
+ModuleInterface* interface_open(const char* path, const char* source_path);
+
+// Adopt a serialized heap buffer (used when the interface cannot be written).
+ModuleInterface* interface_from_buffer(void* data, size_t size);
+
+void interface_close(ModuleInterface* iface);
+
+// Index of the first symbol named `name`, or -1.
+int interface_find(const ModuleInterface* iface, const char* name);
+const char* interface_string(const ModuleInterface* iface, uint32_t offset);
+
+// /abs/path/io.mega -> <dir>/io-<hash of the path>.omi; `source_path` should
+// be canonical so every spelling of an import shares one file.
+void interface_path_for(const char* dir, const char* source_path, char* out, size_t out_size);
+
+#endif // OMEGA_INTERFACE_H
@@ -0,0 +1,234 @@
+// OMEGA Bootstrap - String Interning
+// Open-addressing hash table (FNV-1a, linear probing) over an append-only
+// string arena. A shared table serializes calls with a test-and-test-and-set
+// spinlock; critical sections are a probe and at most one copy.
+
+#include "omega_intern.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define INTERN_INITIAL_SLOTS 1024
+#define INTERN_CHUNK_SIZE (64 * 1024)
+
+static uint32_t intern_hash(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+InternTable* intern_create(void) {
+    InternTable* table = calloc(1, sizeof(InternTable));
+    if (!table) {
+        return NULL;
+    }
+
+    table->slots = calloc(INTERN_INITIAL_SLOTS, sizeof(uint32_t));
+    table->slot_mask = INTERN_INITIAL_SLOTS - 1;
+    table->capacity = INTERN_INITIAL_SLOTS / 2;
+    table->hashes = malloc(sizeof(uint32_t) * (table->capacity + 1));
+    table->strings = malloc(sizeof(const char*) * (table->capacity + 1));
+    table->lengths = malloc(sizeof(uint32_t) * (table->capacity + 1));
+
+    if (!table->slots || !table->hashes || !table->strings || !table->lengths) {
+        intern_destroy(table);
+        return NULL;
+    }
+
+    table->strings[0] = "";
+    table->lengths[0] = 0;
+    table->hashes[0] = 0;
+    return table;
+}
+
+void intern_destroy(InternTable* table) {
+    if (!table) {
+        return;
+    }
+    for (int i = 0; i < table->chunk_count; i++) {
+        free(table->chunks[i]);
+    }
+    free(table->chunks);
+    free(table->slots);
+    free(table->hashes);
+    free(table->strings);
+    free(table->lengths);
+    free(table);
+}
+
+void intern_set_shared(InternTable* table, bool shared) {
+    table->shared = shared;
+}
+
+// The lock is not part of the table's contents, so lookups through a const
+// pointer take it as well.
+static void intern_lock(const InternTable* table) {
+#if defined(__GNUC__)
+    if (table->shared) {
+        int* lock = (int*)&table->lock;
+        while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+            while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+            }
+        }
+    }
+#else
+    (void)table;
+#endif
+}
+
+static void intern_unlock(const InternTable* table) {
+#if defined(__GNUC__)
+    if (table->shared) {
+        __atomic_store_n((int*)&table->lock, 0, __ATOMIC_RELEASE);
+    }
+#else
+    (void)table;
+#endif
+}
+
+static const char* intern_store(InternTable* table, const char* text, size_t length) {
+    if (table->arena == NULL || table->arena_used + length + 1 > table->arena_size) {
+        size_t size = length + 1 > INTERN_CHUNK_SIZE ? length + 1 : INTERN_CHUNK_SIZE;
+        char** chunks = realloc(table->chunks, sizeof(char*) * (table->chunk_count + 1));
+        if (!chunks) {
+            return NULL;
+        }
+        table->chunks = chunks;
+
+        char* chunk = malloc(size);
+        if (!chunk) {
+            return NULL;
+        }
+        table->chunks[table->chunk_count++] = chunk;
+        table->arena = chunk;
+        table->arena_used = 0;
+        table->arena_size = size;
+    }
+
+    char* stored = table->arena + table->arena_used;
+    memcpy(stored, text, length);
+    stored[length] = '\0';
+    table->arena_used += length + 1;
+    return stored;
+}
+
+static int intern_grow(InternTable* table) {
+    // Per-ID arrays and the slot table grow together so the load factor
+    // never exceeds 1/2.
+    uint32_t new_capacity = table->capacity * 2;
+    uint32_t* hashes = realloc(table->hashes, sizeof(uint32_t) * (new_capacity + 1));
+    if (!hashes) return 0;
+    table->hashes = hashes;
+    const char** strings = realloc(table->strings, sizeof(const char*) * (new_capacity + 1));
+    if (!strings) return 0;
+    table->strings = strings;
+    uint32_t* lengths = realloc(table->lengths, sizeof(uint32_t) * (new_capacity + 1));
+    if (!lengths) return 0;
+    table->lengths = lengths;
+
+    uint32_t slot_count = (table->slot_mask + 1) * 2;
+    uint32_t* slots = calloc(slot_count, sizeof(uint32_t));
+    if (!slots) return 0;
+
+    uint32_t mask = slot_count - 1;
+    for (uint32_t id = 1; id <= table->count; id++) {
+        uint32_t slot = table->hashes[id] & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = id;
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->slot_mask = mask;
+    table->capacity = new_capacity;
+    return 1;
+}
+
+static uint32_t find_id(const InternTable* table, const char* text, size_t length) {
+    uint32_t hash = intern_hash(text, length);
+    uint32_t slot = hash & table->slot_mask;
+
+    while (table->slots[slot] != 0) {
+        uint32_t id = table->slots[slot];
+        if (table->hashes[id] == hash && table->lengths[id] == length &&
+            memcmp(table->strings[id], text, length) == 0) {
+            return id;
+        }
+        slot = (slot + 1) & table->slot_mask;
+    }
+
+    return 0;
+}
+
+uint32_t intern_find(const InternTable* table, const char* text, size_t length) {
+    intern_lock(table);
+    uint32_t id = find_id(table, text, length);
+    intern_unlock(table);
+    return id;
+}
+
+static uint32_t insert_id(InternTable* table, const char* text, size_t length) {
+    uint32_t hash = intern_hash(text, length);
+    uint32_t slot = hash & table->slot_mask;
+
+    while (table->slots[slot] != 0) {
+        uint32_t id = table->slots[slot];
+        if (table->hashes[id] == hash && table->lengths[id] == length &&
+            memcmp(table->strings[id], text, length) == 0) {
+            return id;
+        }
+        slot = (slot + 1) & table->slot_mask;
+    }
+
+    if (table->count + 1 > table->capacity) {
+        if (!intern_grow(table)) {
+            return 0;
+        }
+        slot = hash & table->slot_mask;
+        while (table->slots[slot] != 0) {
+            slot = (slot + 1) & table->slot_mask;
+        }
+    }
+
+    const char* stored = intern_store(table, text, length);
+    if (!stored) {
+        return 0;
+    }
+
+    uint32_t id = ++table->count;
+    table->hashes[id] = hash;
+    table->strings[id] = stored;
+    table->lengths[id] = (uint32_t)length;
+    table->slots[slot] = id;
+    return id;
+}
+
+uint32_t intern_string(InternTable* table, const char* text, size_t length) {
+    intern_lock(table);
+    uint32_t id = insert_id(table, text, length);
+    intern_unlock(table);
+    return id;
+}
+
+uint32_t intern_cstr(InternTable* table, const char* text) {
+    return intern_string(table, text, strlen(text));
+}
+
+const char* intern_text(const InternTable* table, uint32_t id) {
+    intern_lock(table);
+    const char* text = id == 0 || id > table->count ? "" : table->strings[id];
+    intern_unlock(table);
+    return text;
+}
+
+uint32_t intern_length(const InternTable* table, uint32_t id) {
+    intern_lock(table);
+    uint32_t length = id == 0 || id > table->count ? 0 : table->lengths[id];
+    intern_unlock(table);
+    return length;
+}
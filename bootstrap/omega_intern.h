@@ -0,0 +1,49 @@
+// OMEGA Bootstrap - String Interning
+// Purpose: Map identifier and signature strings to small stable integer IDs
+// Platform: Windows, Linux, macOS (standard C99)
+// IDs start at 1; 0 is reserved for "no string". Interned text is never moved
+// or freed until intern_destroy, so returned pointers stay valid.
+// A table is single-threaded unless marked shared, in which case every call
+// takes a spinlock (the compile pipeline lexes and parses concurrently).
+
+#ifndef OMEGA_INTERN_H
+#define OMEGA_INTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t* slots;        // open-addressing table of IDs (0 = empty)
+    uint32_t slot_mask;
+    uint32_t* hashes;       // hash per ID, indexed by ID
+    const char** strings;   // text per ID, indexed by ID
+    uint32_t* lengths;      // length per ID, indexed by ID
+    uint32_t count;         // number of interned strings (highest ID)
+    uint32_t capacity;      // allocated entries in the per-ID arrays
+    char* arena;            // current chunk for string storage
+    size_t arena_used;
+    size_t arena_size;
+    char** chunks;          // all chunks, for cleanup
+    int chunk_count;
+    bool shared;            // lock around every call (intern_set_shared)
+    int lock;
+} InternTable;
+
+InternTable* intern_create(void);
+void intern_destroy(InternTable* table);
+
+// Switch locking on or off; only while no other thread uses the table.
+void intern_set_shared(InternTable* table, bool shared);
+
+// Intern `length` bytes starting at `text`; returns the existing ID if present.
+uint32_t intern_string(InternTable* table, const char* text, size_t length);
+uint32_t intern_cstr(InternTable* table, const char* text);
+
+// Look up an ID without inserting; returns 0 if the string is unknown.
+uint32_t intern_find(const InternTable* table, const char* text, size_t length);
+
+const char* intern_text(const InternTable* table, uint32_t id);
+uint32_t intern_length(const InternTable* table, uint32_t id);
+
+#endif // OMEGA_INTERN_H
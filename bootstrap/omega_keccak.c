@@ -0,0 +1,437 @@
+// OMEGA Bootstrap - Keccak-256
+// Scalar Keccak-f[1600] plus a four-lane AVX2 permutation used by the
+// batched API. The AVX2 path is selected at runtime, so the same binary runs
+// on CPUs without it. Build with -DOMEGA_NO_AVX2 to force the scalar path.
+
+#include "omega_keccak.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(OMEGA_NO_AVX2) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define OMEGA_KECCAK_AVX2 1
+#include <immintrin.h>
+#endif
+
+#define KECCAK_ROUNDS 24
+#define KECCAK_RATE_LANES (KECCAK256_RATE / 8)
+
+static const uint64_t keccak_round_constants[KECCAK_ROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static const int keccak_rotations[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+    27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+static const int keccak_pi_lanes[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+    15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+static uint64_t rotl64(uint64_t x, int n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+static uint64_t load_le64(const uint8_t* p) {
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) |
+           ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
+           ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+static void store_le64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+void keccak_f1600(uint64_t state[25]) {
+    uint64_t bc[5];
+
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        // Theta
+        for (int i = 0; i < 5; i++) {
+            bc[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^ state[i + 20];
+        }
+        for (int i = 0; i < 5; i++) {
+            uint64_t t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) {
+                state[j + i] ^= t;
+            }
+        }
+
+        // Rho and Pi
+        uint64_t t = state[1];
+        for (int i = 0; i < 24; i++) {
+            int j = keccak_pi_lanes[i];
+            uint64_t saved = state[j];
+            state[j] = rotl64(t, keccak_rotations[i]);
+            t = saved;
+        }
+
+        // Chi
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = state[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                state[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+
+        // Iota
+        state[0] ^= keccak_round_constants[round];
+    }
+}
+
+static size_t keccak_block_count(size_t length) {
+    // Padding always adds at least one byte, so an exact multiple of the
+    // rate needs an extra block.
+    return length / KECCAK256_RATE + 1;
+}
+
+// Load rate block `block` of a message as lanes, applying pad10*1 with the
+// Keccak domain byte on the final block.
+static void keccak_load_block(const uint8_t* message, size_t length, size_t block,
+                              uint64_t lanes[KECCAK_RATE_LANES]) {
+    size_t offset = block * KECCAK256_RATE;
+
+    if (offset + KECCAK256_RATE <= length) {
+        for (int i = 0; i < KECCAK_RATE_LANES; i++) {
+            lanes[i] = load_le64(message + offset + 8 * i);
+        }
+        return;
+    }
+
+    uint8_t padded[KECCAK256_RATE];
+    size_t remaining = length - offset;
+    memset(padded, 0, sizeof(padded));
+    if (remaining > 0) {
+        memcpy(padded, message + offset, remaining);
+    }
+    padded[remaining] ^= 0x01;
+    padded[KECCAK256_RATE - 1] ^= 0x80;
+
+    for (int i = 0; i < KECCAK_RATE_LANES; i++) {
+        lanes[i] = load_le64(padded + 8 * i);
+    }
+}
+
+void keccak256(const uint8_t* data, size_t length, uint8_t out[KECCAK256_DIGEST_SIZE]) {
+    uint64_t state[25];
+    uint64_t lanes[KECCAK_RATE_LANES];
+    memset(state, 0, sizeof(state));
+
+    size_t blocks = keccak_block_count(length);
+    for (size_t b = 0; b < blocks; b++) {
+        keccak_load_block(data, length, b, lanes);
+        for (int i = 0; i < KECCAK_RATE_LANES; i++) {
+            state[i] ^= lanes[i];
+        }
+        keccak_f1600(state);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        store_le64(out + 8 * i, state[i]);
+    }
+}
+
+// ============================================================================
+// AVX2 FOUR-LANE PATH
+// ============================================================================
+
+#ifdef OMEGA_KECCAK_AVX2
+
+__attribute__((target("avx2")))
+static __m256i rotl256(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_sll_epi64(x, _mm_cvtsi32_si128(n)),
+                           _mm256_srl_epi64(x, _mm_cvtsi32_si128(64 - n)));
+}
+
+__attribute__((target("avx2")))
+static void keccak_f1600_x4(__m256i state[25]) {
+    __m256i bc[5];
+    const __m256i ones = _mm256_set1_epi64x(-1);
+
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        for (int i = 0; i < 5; i++) {
+            bc[i] = _mm256_xor_si256(
+                _mm256_xor_si256(state[i], state[i + 5]),
+                _mm256_xor_si256(_mm256_xor_si256(state[i + 10], state[i + 15]), state[i + 20]));
+        }
+        for (int i = 0; i < 5; i++) {
+            __m256i t = _mm256_xor_si256(bc[(i + 4) % 5], rotl256(bc[(i + 1) % 5], 1));
+            for (int j = 0; j < 25; j += 5) {
+                state[j + i] = _mm256_xor_si256(state[j + i], t);
+            }
+        }
+
+        __m256i t = state[1];
+        for (int i = 0; i < 24; i++) {
+            int j = keccak_pi_lanes[i];
+            __m256i saved = state[j];
+            state[j] = rotl256(t, keccak_rotations[i]);
+            t = saved;
+        }
+
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = state[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                __m256i not_next = _mm256_xor_si256(bc[(i + 1) % 5], ones);
+                state[j + i] = _mm256_xor_si256(state[j + i],
+                                                _mm256_and_si256(not_next, bc[(i + 2) % 5]));
+            }
+        }
+
+        state[0] = _mm256_xor_si256(state[0],
+                                    _mm256_set1_epi64x((long long)keccak_round_constants[round]));
+    }
+}
+
+// Hash four messages that share the same block count.
+__attribute__((target("avx2")))
+static void keccak256_x4(const uint8_t* const messages[4], const size_t lengths[4],
+                         size_t blocks, uint8_t* out[4]) {
+    __m256i state[25];
+    uint64_t lanes[4][KECCAK_RATE_LANES];
+
+    for (int i = 0; i < 25; i++) {
+        state[i] = _mm256_setzero_si256();
+    }
+
+    for (size_t b = 0; b < blocks; b++) {
+        for (int m = 0; m < 4; m++) {
+            keccak_load_block(messages[m], lengths[m], b, lanes[m]);
+        }
+        for (int i = 0; i < KECCAK_RATE_LANES; i++) {
+            __m256i v = _mm256_set_epi64x((long long)lanes[3][i], (long long)lanes[2][i],
+                                          (long long)lanes[1][i], (long long)lanes[0][i]);
+            state[i] = _mm256_xor_si256(state[i], v);
+        }
+        keccak_f1600_x4(state);
+    }
+
+    uint64_t words[4];
+    for (int i = 0; i < 4; i++) {
+        _mm256_storeu_si256((__m256i*)words, state[i]);
+        for (int m = 0; m < 4; m++) {
+            store_le64(out[m] + 8 * i, words[m]);
+        }
+    }
+}
+
+#endif // OMEGA_KECCAK_AVX2
+
+bool keccak_has_avx2(void) {
+#ifdef OMEGA_KECCAK_AVX2
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached == 1;
+#else
+    return false;
+#endif
+}
+
+#ifdef OMEGA_KECCAK_AVX2
+// A message's block count travels with its index, so the comparator needs
+// no shared state and concurrent batches do not interfere.
+typedef struct {
+    size_t blocks;
+    size_t index;
+} KeccakBatchItem;
+
+static int compare_by_blocks(const void* a, const void* b) {
+    const KeccakBatchItem* ia = a;
+    const KeccakBatchItem* ib = b;
+    if (ia->blocks != ib->blocks) {
+        return (ia->blocks > ib->blocks) - (ia->blocks < ib->blocks);
+    }
+    return (ia->index > ib->index) - (ia->index < ib->index);
+}
+#endif
+
+void keccak256_batch(const uint8_t* const* messages, const size_t* lengths,
+                     size_t count, uint8_t (*out)[KECCAK256_DIGEST_SIZE]) {
+#ifdef OMEGA_KECCAK_AVX2
+    if (count >= 4 && keccak_has_avx2()) {
+        KeccakBatchItem* order = malloc(sizeof(KeccakBatchItem) * count);
+        if (order) {
+            for (size_t i = 0; i < count; i++) {
+                order[i].blocks = keccak_block_count(lengths[i]);
+                order[i].index = i;
+            }
+
+            // Group messages by block count so every lane of a 4-wide
+            // permutation absorbs the same number of blocks.
+            qsort(order, count, sizeof(KeccakBatchItem), compare_by_blocks);
+
+            size_t i = 0;
+            while (i < count) {
+                if (i + 4 <= count && order[i].blocks == order[i + 3].blocks) {
+                    const uint8_t* group[4];
+                    size_t group_lengths[4];
+                    uint8_t* group_out[4];
+                    for (int m = 0; m < 4; m++) {
+                        group[m] = messages[order[i + m].index];
+                        group_lengths[m] = lengths[order[i + m].index];
+                        group_out[m] = out[order[i + m].index];
+                    }
+                    keccak256_x4(group, group_lengths, order[i].blocks, group_out);
+                    i += 4;
+                } else {
+                    keccak256(messages[order[i].index], lengths[order[i].index], out[order[i].index]);
+                    i++;
+                }
+            }
+
+            free(order);
+            return;
+        }
+    }
+#endif
+
+    for (size_t i = 0; i < count; i++) {
+        keccak256(messages[i], lengths[i], out[i]);
+    }
+}
+
+// ============================================================================
+// SELECTOR CACHE
+// ============================================================================
+
+SelectorCache* selector_cache_create(InternTable* interns) {
+    SelectorCache* cache = calloc(1, sizeof(SelectorCache));
+    if (!cache) {
+        return NULL;
+    }
+    cache->interns = interns;
+    return cache;
+}
+
+void selector_cache_destroy(SelectorCache* cache) {
+    if (!cache) {
+        return;
+    }
+    free(cache->entries);
+    free(cache->pending);
+    free(cache);
+}
+
+static SelectorEntry* selector_cache_entry(SelectorCache* cache, uint32_t id) {
+    if (id >= cache->capacity) {
+        uint32_t capacity = cache->capacity ? cache->capacity : 256;
+        while (capacity <= id) {
+            capacity *= 2;
+        }
+        SelectorEntry* entries = realloc(cache->entries, sizeof(SelectorEntry) * capacity);
+        if (!entries) {
+            return NULL;
+        }
+        memset(entries + cache->capacity, 0,
+               sizeof(SelectorEntry) * (capacity - cache->capacity));
+        cache->entries = entries;
+        cache->capacity = capacity;
+    }
+    return &cache->entries[id];
+}
+
+void selector_cache_request(SelectorCache* cache, uint32_t signature_id) {
+    SelectorEntry* entry = selector_cache_entry(cache, signature_id);
+    if (!entry || signature_id == 0) {
+        return;
+    }
+    if (entry->ready || entry->pending) {
+        cache->hits++;
+        return;
+    }
+
+    if (cache->pending_count == cache->pending_capacity) {
+        uint32_t capacity = cache->pending_capacity ? cache->pending_capacity * 2 : 64;
+        uint32_t* pending = realloc(cache->pending, sizeof(uint32_t) * capacity);
+        if (!pending) {
+            return;
+        }
+        cache->pending = pending;
+        cache->pending_capacity = capacity;
+    }
+
+    entry->pending = true;
+    cache->pending[cache->pending_count++] = signature_id;
+}
+
+void selector_cache_flush(SelectorCache* cache) {
+    uint32_t count = cache->pending_count;
+    if (count == 0) {
+        return;
+    }
+
+    const uint8_t** messages = malloc(sizeof(const uint8_t*) * count);
+    size_t* lengths = malloc(sizeof(size_t) * count);
+    uint8_t (*digests)[KECCAK256_DIGEST_SIZE] = malloc(KECCAK256_DIGEST_SIZE * (size_t)count);
+    if (!messages || !lengths || !digests) {
+        free(messages);
+        free(lengths);
+        free(digests);
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t id = cache->pending[i];
+        messages[i] = (const uint8_t*)intern_text(cache->interns, id);
+        lengths[i] = intern_length(cache->interns, id);
+    }
+
+    keccak256_batch(messages, lengths, count, digests);
+
+    for (uint32_t i = 0; i < count; i++) {
+        SelectorEntry* entry = &cache->entries[cache->pending[i]];
+        memcpy(entry->digest, digests[i], KECCAK256_DIGEST_SIZE);
+        entry->ready = true;
+        entry->pending = false;
+    }
+
+    cache->hashed += count;
+    cache->pending_count = 0;
+    free(messages);
+    free(lengths);
+    free(digests);
+}
+
+const uint8_t* selector_cache_digest(SelectorCache* cache, uint32_t signature_id) {
+    if (signature_id >= cache->capacity || !cache->entries[signature_id].ready) {
+        return NULL;
+    }
+    return cache->entries[signature_id].digest;
+}
+
+const uint8_t* selector_cache_topic(SelectorCache* cache, uint32_t signature_id) {
+    const uint8_t* digest = selector_cache_digest(cache, signature_id);
+    if (!digest) {
+        selector_cache_request(cache, signature_id);
+        selector_cache_flush(cache);
+        digest = selector_cache_digest(cache, signature_id);
+    }
+    return digest;
+}
+
+uint32_t selector_cache_selector(SelectorCache* cache, uint32_t signature_id) {
+    const uint8_t* digest = selector_cache_topic(cache, signature_id);
+    if (!digest) {
+        return 0;
+    }
+    return ((uint32_t)digest[0] << 24) | ((uint32_t)digest[1] << 16) |
+           ((uint32_t)digest[2] << 8) | (uint32_t)digest[3];
+}
@@ -0,0 +1,72 @@
+// OMEGA Bootstrap - Keccak-256
+// Purpose: Native Keccak-f[1600] for EVM function selectors and event topics
+// Platform: Windows, Linux, macOS (standard C99, optional AVX2 on x86-64)
+// Note: this is the original Keccak padding (0x01) used by Ethereum,
+// not FIPS-202 SHA3-256.
+
+#ifndef OMEGA_KECCAK_H
+#define OMEGA_KECCAK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "omega_intern.h"
+
+#define KECCAK256_DIGEST_SIZE 32
+#define KECCAK256_RATE 136
+#define EVM_SELECTOR_SIZE 4
+
+void keccak_f1600(uint64_t state[25]);
+void keccak256(const uint8_t* data, size_t length, uint8_t out[KECCAK256_DIGEST_SIZE]);
+
+// Hash `count` independent messages in one call. Messages with the same
+// number of rate blocks are hashed four at a time when AVX2 is available.
+void keccak256_batch(const uint8_t* const* messages, const size_t* lengths,
+                     size_t count, uint8_t (*out)[KECCAK256_DIGEST_SIZE]);
+
+// True when keccak256_batch will use the AVX2 multi-lane path.
+bool keccak_has_avx2(void);
+
+// ============================================================================
+// SELECTOR CACHE
+// ============================================================================
+// Digests keyed by interned signature ID, e.g. "transfer(address,uint256)".
+// Signatures are queued with selector_cache_request and hashed together by
+// selector_cache_flush, so each signature is hashed once per build.
+
+typedef struct {
+    uint8_t digest[KECCAK256_DIGEST_SIZE];
+    bool ready;
+    bool pending;
+} SelectorEntry;
+
+typedef struct {
+    InternTable* interns;     // borrowed; owns the signature text
+    SelectorEntry* entries;   // indexed by intern ID
+    uint32_t capacity;
+    uint32_t* pending;        // IDs queued for the next flush
+    uint32_t pending_count;
+    uint32_t pending_capacity;
+    uint32_t hashed;          // signatures hashed so far
+    uint32_t hits;            // requests satisfied without hashing
+} SelectorCache;
+
+SelectorCache* selector_cache_create(InternTable* interns);
+void selector_cache_destroy(SelectorCache* cache);
+
+void selector_cache_request(SelectorCache* cache, uint32_t signature_id);
+void selector_cache_flush(SelectorCache* cache);
+
+// Returns the full 32-byte digest (event topic) or NULL if not yet hashed.
+const uint8_t* selector_cache_digest(SelectorCache* cache, uint32_t signature_id);
+
+// Returns the full digest, hashing the signature on demand if it was never
+// requested; NULL only if hashing ran out of memory.
+const uint8_t* selector_cache_topic(SelectorCache* cache, uint32_t signature_id);
+
+// Returns the 4-byte function selector as a big-endian integer.
+// Hashes the signature on demand if it was never requested.
+uint32_t selector_cache_selector(SelectorCache* cache, uint32_t signature_id);
+
+#endif // OMEGA_KECCAK_H
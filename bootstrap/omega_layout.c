@@ -0,0 +1,568 @@
+// OMEGA Bootstrap - Storage Layout and Static Gas
+// Slot assignment, first-fit packing and a token-level gas walker.
+
+#include "omega_layout.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// TYPE SIZES
+// ============================================================================
+
+static bool has_prefix(const char* text, const char* prefix) {
+    return strncmp(text, prefix, strlen(prefix)) == 0;
+}
+
+// Parse the decimal suffix of "uint128"/"bytes4"; -1 if not all digits.
+static int numeric_suffix(const char* text) {
+    if (*text == '\0') {
+        return -1;
+    }
+    int value = 0;
+    for (const char* p = text; *p; p++) {
+        if (!isdigit((unsigned char)*p) || value > 1000) {
+            return -1;
+        }
+        value = value * 10 + (*p - '0');
+    }
+    return value;
+}
+
+static int type_size(const char* type, bool* whole_slot, bool* hashed,
+                     UserTypeSize user_size, void* context, int depth) {
+    *whole_slot = false;
+    *hashed = false;
+    size_t length = strlen(type);
+
+    if (has_prefix(type, "mapping")) {
+        *whole_slot = true;
+        *hashed = true;
+        return STORAGE_SLOT_SIZE;
+    }
+
+    if (length > 0 && type[length - 1] == ']') {
+        const char* open = strrchr(type, '[');
+        char element[256];
+        if (!open || (size_t)(open - type) >= sizeof(element) || depth > 8) {
+            *whole_slot = true;
+            return STORAGE_SLOT_SIZE;
+        }
+        *whole_slot = true;
+        if (open[1] == ']') {
+            *hashed = true;     // dynamic array: length here, elements hashed
+            return STORAGE_SLOT_SIZE;
+        }
+
+        memcpy(element, type, (size_t)(open - type));
+        element[open - type] = '\0';
+        char count_text[16];
+        size_t count_length = (size_t)(type + length - 1 - (open + 1));
+        if (count_length == 0 || count_length >= sizeof(count_text)) {
+            return STORAGE_SLOT_SIZE;
+        }
+        memcpy(count_text, open + 1, count_length);
+        count_text[count_length] = '\0';
+        int count = numeric_suffix(count_text);
+        if (count <= 0) {
+            return STORAGE_SLOT_SIZE;   // length from a constant we cannot see
+        }
+
+        bool element_whole;
+        bool element_hashed;
+        int size = type_size(element, &element_whole, &element_hashed, user_size, context, depth + 1);
+        if (element_whole) {
+            return size * count;
+        }
+        int per_slot = STORAGE_SLOT_SIZE / size;
+        return ((count + per_slot - 1) / per_slot) * STORAGE_SLOT_SIZE;
+    }
+
+    if (strcmp(type, "bool") == 0) {
+        return 1;
+    }
+    if (has_prefix(type, "address")) {
+        return 20;
+    }
+    if (strcmp(type, "string") == 0 || strcmp(type, "bytes") == 0) {
+        *whole_slot = true;
+        return STORAGE_SLOT_SIZE;
+    }
+
+    int bits = -1;
+    if (has_prefix(type, "uint")) {
+        bits = type[4] ? numeric_suffix(type + 4) : 256;
+    } else if (has_prefix(type, "int")) {
+        bits = type[3] ? numeric_suffix(type + 3) : 256;
+    }
+    if (bits > 0 && bits <= 256 && bits % 8 == 0) {
+        return bits / 8;
+    }
+    if (has_prefix(type, "bytes")) {
+        int bytes = numeric_suffix(type + 5);
+        if (bytes > 0 && bytes <= 32) {
+            return bytes;
+        }
+    }
+
+    if (user_size) {
+        int size = user_size(context, type, whole_slot);
+        if (size > 0) {
+            return size;
+        }
+    }
+
+    // Unknown (float, string-like or external types): one unshared slot
+    *whole_slot = true;
+    return STORAGE_SLOT_SIZE;
+}
+
+void layout_size_field(LayoutField* field, UserTypeSize user_size, void* context) {
+    field->size = type_size(field->type, &field->whole_slot, &field->hashed, user_size, context, 0);
+    if (field->whole_slot && field->size % STORAGE_SLOT_SIZE != 0) {
+        field->size += STORAGE_SLOT_SIZE - field->size % STORAGE_SLOT_SIZE;
+    }
+    field->slot = 0;
+    field->offset = 0;
+}
+
+// ============================================================================
+// SLOT ASSIGNMENT
+// ============================================================================
+
+int layout_assign(LayoutField* fields, int count) {
+    int slot = 0;
+    int offset = 0;
+
+    for (int i = 0; i < count; i++) {
+        LayoutField* field = &fields[i];
+        if (field->whole_slot) {
+            if (offset > 0) {
+                slot++;
+            }
+            field->slot = slot;
+            field->offset = 0;
+            slot += field->size / STORAGE_SLOT_SIZE;
+            offset = 0;
+            continue;
+        }
+        if (offset + field->size > STORAGE_SLOT_SIZE) {
+            slot++;
+            offset = 0;
+        }
+        field->slot = slot;
+        field->offset = offset;
+        offset += field->size;
+    }
+
+    return offset > 0 ? slot + 1 : slot;
+}
+
+#define LAYOUT_MAX_BINS 256
+
+// First-fit packing of the small fields. With `decreasing` the fields are
+// taken largest first (fewest slots); otherwise in declaration order, which
+// moves fewer fields. `bin_of[i]` receives the bin of field i.
+static int first_fit(const LayoutField* fields, int count, bool decreasing, int* bin_of) {
+    int bin_used[LAYOUT_MAX_BINS];
+    int bin_count = 0;
+
+    for (int pass = STORAGE_SLOT_SIZE; pass >= 1; pass--) {
+        for (int i = 0; i < count; i++) {
+            if (fields[i].whole_slot || (decreasing && fields[i].size != pass)) {
+                continue;
+            }
+            int bin = 0;
+            while (bin < bin_count && bin_used[bin] + fields[i].size > STORAGE_SLOT_SIZE) {
+                bin++;
+            }
+            if (bin == bin_count) {
+                if (bin_count == LAYOUT_MAX_BINS) {
+                    bin--;      // absurdly many small fields: overfill the last bin
+                } else {
+                    bin_used[bin_count++] = 0;
+                }
+            }
+            bin_used[bin] += fields[i].size;
+            bin_of[i] = bin;
+        }
+        if (!decreasing) {
+            break;
+        }
+    }
+    return bin_count;
+}
+
+// Emit the fields bin by bin; whole-slot fields go where they were declared
+// relative to the bins opened before them.
+static int emit_bins(const LayoutField* fields, int count, const int* bin_of, int bin_count,
+                     LayoutField* out) {
+    int placed = 0;
+    int emitted_bins = 0;
+    for (int i = 0; i <= count; i++) {
+        // Bins opened by fields before i are complete once i is whole-slot
+        int open_bins = 0;
+        for (int j = 0; j < i; j++) {
+            if (!fields[j].whole_slot && bin_of[j] + 1 > open_bins) {
+                open_bins = bin_of[j] + 1;
+            }
+        }
+        if (i < count && !fields[i].whole_slot) {
+            continue;
+        }
+        if (i == count) {
+            open_bins = bin_count;
+        }
+        for (; emitted_bins < open_bins; emitted_bins++) {
+            for (int j = 0; j < count; j++) {
+                if (!fields[j].whole_slot && bin_of[j] == emitted_bins) {
+                    out[placed++] = fields[j];
+                }
+            }
+        }
+        if (i < count) {
+            out[placed++] = fields[i];
+        }
+    }
+    return placed;
+}
+
+int layout_pack(const LayoutField* fields, int count, LayoutField* out) {
+    int* bin_of = malloc(sizeof(int) * (count > 0 ? count : 1) * 2);
+    LayoutField* candidate = malloc(sizeof(LayoutField) * (count > 0 ? count : 1));
+    if (!bin_of || !candidate) {
+        free(bin_of);
+        free(candidate);
+        memcpy(out, fields, sizeof(LayoutField) * count);
+        return layout_assign(out, count);
+    }
+
+    // Declaration-order first fit, unless largest-first saves a slot
+    int ordered_bins = first_fit(fields, count, false, bin_of);
+    emit_bins(fields, count, bin_of, ordered_bins, out);
+    int slots = layout_assign(out, count);
+
+    int sorted_bins = first_fit(fields, count, true, bin_of + count);
+    emit_bins(fields, count, bin_of + count, sorted_bins, candidate);
+    int sorted_slots = layout_assign(candidate, count);
+    if (sorted_slots < slots) {
+        memcpy(out, candidate, sizeof(LayoutField) * count);
+        slots = sorted_slots;
+    }
+
+    free(bin_of);
+    free(candidate);
+    return slots;
+}
+
+// ============================================================================
+// GAS ESTIMATION
+// ============================================================================
+
+typedef enum {
+    OP_ADD, OP_MUL, OP_SUB, OP_DIV, OP_MOD,
+    OP_LT, OP_GT, OP_EQ, OP_ISZERO, OP_AND, OP_OR, OP_XOR, OP_NOT,
+    OP_KECCAK256, OP_KECCAK256_WORD, OP_CALLDATALOAD, OP_MSTORE,
+    OP_JUMP, OP_JUMPI, OP_JUMPDEST, OP_PUSH, OP_DUP,
+    OP_LOG, OP_LOG_TOPIC, OP_LOG_BYTE,
+    OP_COUNT
+} Opcode;
+
+// Static costs from the Yellow Paper fee schedule
+static const int OPCODE_GAS[OP_COUNT] = {
+    [OP_ADD] = 3, [OP_MUL] = 5, [OP_SUB] = 3, [OP_DIV] = 5, [OP_MOD] = 5,
+    [OP_LT] = 3, [OP_GT] = 3, [OP_EQ] = 3, [OP_ISZERO] = 3,
+    [OP_AND] = 3, [OP_OR] = 3, [OP_XOR] = 3, [OP_NOT] = 3,
+    [OP_KECCAK256] = 30, [OP_KECCAK256_WORD] = 6, [OP_CALLDATALOAD] = 3, [OP_MSTORE] = 3,
+    [OP_JUMP] = 8, [OP_JUMPI] = 10, [OP_JUMPDEST] = 1, [OP_PUSH] = 3, [OP_DUP] = 3,
+    [OP_LOG] = 375, [OP_LOG_TOPIC] = 375, [OP_LOG_BYTE] = 8,
+};
+
+// Storage access pricing (EIP-2929 / EIP-2200). Writes assume a non-zero
+// slot being updated, the common case after deployment.
+#define COLD_SLOAD_GAS 2100
+#define WARM_ACCESS_GAS 100
+#define SSTORE_RESET_GAS 2900
+
+#define GAS_TRACKED_KEYS 256
+
+// A storage location touched by the function: a plain slot, or a hashed
+// element identified by its field and the first token of its key.
+typedef struct {
+    int slot;
+    const char* key;
+    bool dirty;
+} TouchedSlot;
+
+typedef struct {
+    GasEstimate estimate;
+    TouchedSlot touched[GAS_TRACKED_KEYS];
+    int touched_count;
+} GasWalker;
+
+static void charge(GasWalker* walker, Opcode op, int times) {
+    walker->estimate.gas += (long)OPCODE_GAS[op] * times;
+}
+
+static TouchedSlot* touch(GasWalker* walker, int slot, const char* key, bool* cold) {
+    for (int i = 0; i < walker->touched_count; i++) {
+        TouchedSlot* touched = &walker->touched[i];
+        if (touched->slot == slot && touched->key == key) {
+            *cold = false;
+            return touched;
+        }
+    }
+    *cold = true;
+    if (walker->touched_count == GAS_TRACKED_KEYS) {
+        return NULL;    // untracked: every further access is priced cold
+    }
+    TouchedSlot* touched = &walker->touched[walker->touched_count++];
+    touched->slot = slot;
+    touched->key = key;
+    touched->dirty = false;
+    return touched;
+}
+
+static void storage_read(GasWalker* walker, int slot, const char* key) {
+    bool cold;
+    touch(walker, slot, key, &cold);
+    walker->estimate.gas += cold ? COLD_SLOAD_GAS : WARM_ACCESS_GAS;
+    walker->estimate.sloads++;
+}
+
+static void storage_write(GasWalker* walker, int slot, const char* key) {
+    bool cold;
+    TouchedSlot* touched = touch(walker, slot, key, &cold);
+    if (touched && touched->dirty) {
+        walker->estimate.gas += WARM_ACCESS_GAS;
+    } else {
+        walker->estimate.gas += SSTORE_RESET_GAS + (cold ? COLD_SLOAD_GAS : 0);
+    }
+    if (touched) {
+        touched->dirty = true;
+    }
+    walker->estimate.sstores++;
+}
+
+static const LayoutField* find_state(const LayoutField* state, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (state[i].name == name || strcmp(state[i].name, name) == 0) {
+            return &state[i];
+        }
+    }
+    return NULL;
+}
+
+// Index just past the balanced group opening at `index`.
+static int skip_group(const Token* tokens, int index, int end, TokenType open, TokenType close) {
+    int depth = 0;
+    for (int i = index; i < end; i++) {
+        if (tokens[i].type == open) {
+            depth++;
+        } else if (tokens[i].type == close && --depth == 0) {
+            return i + 1;
+        }
+    }
+    return end;
+}
+
+static bool is_compound_operator(TokenType type) {
+    return type == TOK_PLUS || type == TOK_MINUS || type == TOK_STAR ||
+           type == TOK_SLASH || type == TOK_PERCENT || type == TOK_AMP ||
+           type == TOK_PIPE || type == TOK_CARET;
+}
+
+static void state_access(GasWalker* walker, const Token* tokens, int index, int end,
+                         const LayoutField* field) {
+    // Follow index groups: balances[a][b] hashes once per level
+    int next = index + 1;
+    const char* key = NULL;
+    int levels = 0;
+    while (next < end && tokens[next].type == TOK_LBRACKET) {
+        if (key == NULL && next + 1 < end) {
+            key = tokens[next + 1].value;
+        }
+        levels++;
+        next = skip_group(tokens, next, end, TOK_LBRACKET, TOK_RBRACKET);
+    }
+    // Member access on a struct field stays within its slots
+    while (next + 1 < end && tokens[next].type == TOK_DOT && tokens[next + 1].type == TOK_IDENTIFIER) {
+        next += 2;
+    }
+
+    bool assign = next < end && tokens[next].type == TOK_EQ;
+    bool compound = next + 1 < end && is_compound_operator(tokens[next].type) &&
+                    tokens[next + 1].type == TOK_EQ;
+
+    if (field->hashed && levels > 0) {
+        // Slot = keccak256(key . slot): two memory words per level
+        charge(walker, OP_MSTORE, 2 * levels);
+        charge(walker, OP_KECCAK256, levels);
+        charge(walker, OP_KECCAK256_WORD, 2 * levels);
+    }
+
+    // Sub-word fields are read-modify-write: the slot is loaded before the store
+    bool partial = !field->whole_slot && field->size < STORAGE_SLOT_SIZE;
+    if (!assign || compound || partial) {
+        storage_read(walker, field->slot, key);
+    }
+    if (partial) {
+        charge(walker, OP_AND, 2);
+        charge(walker, OP_OR, 1);
+    }
+    if (assign || compound) {
+        storage_write(walker, field->slot, key);
+    }
+}
+
+// Count the arguments of a parenthesized list starting at `index`.
+static int count_arguments(const Token* tokens, int index, int end) {
+    if (index >= end || tokens[index].type != TOK_LPAREN) {
+        return 0;
+    }
+    if (index + 1 < end && tokens[index + 1].type == TOK_RPAREN) {
+        return 0;
+    }
+    int depth = 0;
+    int arguments = 1;
+    for (int i = index; i < end; i++) {
+        TokenType type = tokens[i].type;
+        if (type == TOK_LPAREN || type == TOK_LBRACKET) {
+            depth++;
+        } else if (type == TOK_RPAREN || type == TOK_RBRACKET) {
+            if (--depth == 0) {
+                break;
+            }
+        } else if (type == TOK_COMMA && depth == 1) {
+            arguments++;
+        }
+    }
+    return arguments;
+}
+
+GasEstimate estimate_gas(const Token* tokens, int start, int end,
+                         const LayoutField* state, int state_count, bool is_public) {
+    GasWalker walker;
+    memset(&walker, 0, sizeof(walker));
+
+    if (is_public) {
+        // Selector dispatch: CALLDATALOAD, PUSH4, EQ, PUSH2, JUMPI, JUMPDEST
+        charge(&walker, OP_CALLDATALOAD, 1);
+        charge(&walker, OP_PUSH, 2);
+        charge(&walker, OP_EQ, 1);
+        charge(&walker, OP_JUMPI, 1);
+        charge(&walker, OP_JUMPDEST, 1);
+    }
+
+    for (int i = start; i < end; i++) {
+        const Token* token = &tokens[i];
+        bool calls = i + 1 < end && tokens[i + 1].type == TOK_LPAREN;
+        bool member = i > start && tokens[i - 1].type == TOK_DOT &&
+                      !(i - 2 >= start && (strcmp(tokens[i - 2].value, "self") == 0 ||
+                                           strcmp(tokens[i - 2].value, "this") == 0));
+
+        switch (token->type) {
+            case TOK_IDENTIFIER: {
+                const LayoutField* field = member || calls ? NULL :
+                                           find_state(state, state_count, token->value);
+                if (field) {
+                    state_access(&walker, tokens, i, end, field);
+                } else if (calls && (strcmp(token->value, "require") == 0 ||
+                                     strcmp(token->value, "assert") == 0)) {
+                    charge(&walker, OP_ISZERO, 1);
+                    charge(&walker, OP_JUMPI, 1);
+                    charge(&walker, OP_JUMPDEST, 1);
+                } else if (calls && !member) {
+                    // Internal call: push return address, jump there and back
+                    charge(&walker, OP_PUSH, 2);
+                    charge(&walker, OP_JUMP, 2);
+                    charge(&walker, OP_JUMPDEST, 2);
+                } else {
+                    charge(&walker, OP_DUP, 1);
+                }
+                break;
+            }
+            case TOK_NUMBER:
+            case TOK_STRING:
+                charge(&walker, OP_PUSH, 1);
+                break;
+            case TOK_PLUS:
+                charge(&walker, OP_ADD, 1);
+                break;
+            case TOK_MINUS:
+                charge(&walker, OP_SUB, 1);
+                break;
+            case TOK_STAR:
+                charge(&walker, OP_MUL, 1);
+                break;
+            case TOK_SLASH:
+                charge(&walker, OP_DIV, 1);
+                break;
+            case TOK_PERCENT:
+                charge(&walker, OP_MOD, 1);
+                break;
+            case TOK_LT:
+                charge(&walker, OP_LT, 1);
+                break;
+            case TOK_GT:
+                charge(&walker, OP_GT, 1);
+                break;
+            case TOK_LTE:
+                charge(&walker, OP_GT, 1);
+                charge(&walker, OP_ISZERO, 1);
+                break;
+            case TOK_GTE:
+                charge(&walker, OP_LT, 1);
+                charge(&walker, OP_ISZERO, 1);
+                break;
+            case TOK_EQEQ:
+                charge(&walker, OP_EQ, 1);
+                break;
+            case TOK_NEQ:
+                charge(&walker, OP_EQ, 1);
+                charge(&walker, OP_ISZERO, 1);
+                break;
+            case TOK_AMP:
+                charge(&walker, OP_AND, 1);
+                break;
+            case TOK_PIPE:
+                charge(&walker, OP_OR, 1);
+                break;
+            case TOK_CARET:
+                charge(&walker, OP_XOR, 1);
+                break;
+            case TOK_TILDE:
+                charge(&walker, OP_NOT, 1);
+                break;
+            case TOK_KEYWORD:
+                if (strcmp(token->value, "if") == 0) {
+                    charge(&walker, OP_ISZERO, 1);
+                    charge(&walker, OP_JUMPI, 1);
+                    charge(&walker, OP_JUMPDEST, 1);
+                } else if (strcmp(token->value, "for") == 0 || strcmp(token->value, "while") == 0) {
+                    charge(&walker, OP_ISZERO, 1);
+                    charge(&walker, OP_JUMPI, 1);
+                    charge(&walker, OP_JUMP, 1);
+                    charge(&walker, OP_JUMPDEST, 2);
+                    walker.estimate.unbounded = true;
+                } else if (strcmp(token->value, "emit") == 0 && i + 1 < end) {
+                    // LOG1: event topic plus one ABI word per argument
+                    int arguments = count_arguments(tokens, i + 2, end);
+                    charge(&walker, OP_LOG, 1);
+                    charge(&walker, OP_LOG_TOPIC, 1);
+                    charge(&walker, OP_LOG_BYTE, 32 * arguments);
+                    charge(&walker, OP_MSTORE, arguments);
+                    i++;    // the event name is not a call
+                } else if (strcmp(token->value, "return") == 0) {
+                    charge(&walker, OP_JUMP, 1);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return walker.estimate;
+}
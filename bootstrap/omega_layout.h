@@ -0,0 +1,62 @@
+// OMEGA Bootstrap - Storage Layout and Static Gas
+// Purpose: EVM storage slot assignment, field packing and per-function gas estimates
+// Platform: Windows, Linux, macOS (standard C99)
+// Slots follow the Solidity rules: fields are placed in declaration order,
+// a field that does not fit in the rest of the current 32-byte slot starts a
+// new one, and structs, arrays, mappings and strings always occupy whole
+// slots. Packing moves sub-32-byte fields into earlier slots with room
+// (first fit, or largest first when that saves more) so that fewer slots are
+// touched by SLOAD/SSTORE; it is only applied when it saves a slot.
+// Gas estimates walk a function body's tokens with a fixed opcode cost
+// table (post-Berlin cold/warm storage pricing); they ignore loop trip
+// counts and callee bodies.
+
+#ifndef OMEGA_LAYOUT_H
+#define OMEGA_LAYOUT_H
+
+#include <stdbool.h>
+
+#include "omega_lexer.h"
+
+#define STORAGE_SLOT_SIZE 32
+
+typedef struct {
+    const char* name;
+    const char* type;      // canonical type text, e.g. "uint128", "mapping(address=>uint256)"
+    int size;              // bytes; a multiple of 32 for whole-slot fields
+    bool whole_slot;       // starts a slot and the next field starts a new one
+    bool hashed;           // mapping or dynamic array: element slots are keccak-derived
+    int slot;              // assigned by layout_assign / layout_pack
+    int offset;            // byte offset inside the slot
+} LayoutField;
+
+// Size of a user type (struct, enum, contract) in bytes, or 0 if unknown.
+typedef int (*UserTypeSize)(void* context, const char* name, bool* whole_slot);
+
+// Fill size/whole_slot/hashed from `field->type`.
+void layout_size_field(LayoutField* field, UserTypeSize user_size, void* context);
+
+// Assign slots in declaration order; returns the number of slots used.
+int layout_assign(LayoutField* fields, int count);
+
+// Write a packed ordering of `fields` to `out` (same count) with slots
+// assigned; returns the number of slots used.
+int layout_pack(const LayoutField* fields, int count, LayoutField* out);
+
+// ============================================================================
+// GAS ESTIMATION
+// ============================================================================
+
+typedef struct {
+    long gas;
+    int sloads;
+    int sstores;
+    bool unbounded;        // contains a loop; the estimate covers one iteration
+} GasEstimate;
+
+// Estimate tokens[start, end) of a function body against the storage layout
+// of its contract's state. `is_public` adds the external dispatch cost.
+GasEstimate estimate_gas(const Token* tokens, int start, int end,
+                         const LayoutField* state, int state_count, bool is_public);
+
+#endif // OMEGA_LAYOUT_H
@@ -0,0 +1,462 @@
+// OMEGA Bootstrap - Lexer
+// Hand-written scanner shared by omega_minimal and the incremental relexer.
+
+#include "omega_lexer.h"
+
+#include <string.h>
+
+// Character classes, indexed by unsigned byte. The source is validated as
+// UTF-8 before lexing, so bytes >= 0x80 are always part of a well-formed
+// multi-byte sequence: they are identifier characters, and strings and
+// comments carry them through unchanged. No locale-dependent <ctype.h>
+// calls, so every platform classifies bytes identically.
+enum {
+    CHAR_SPACE       = 1 << 0,
+    CHAR_DIGIT       = 1 << 1,
+    CHAR_HEX         = 1 << 2,
+    CHAR_IDENT_START = 1 << 3,
+    CHAR_IDENT       = 1 << 4
+};
+
+static unsigned char char_classes[256];
+
+#define char_is(ch, cls) ((char_classes[(unsigned char)(ch)] & (cls)) != 0)
+
+static void init_char_classes(void) {
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    
+    const char* spaces = " \t\n\v\f\r";
+    for (const char* p = spaces; *p; p++) {
+        char_classes[(unsigned char)*p] |= CHAR_SPACE;
+    }
+    for (int c = '0'; c <= '9'; c++) {
+        char_classes[c] |= CHAR_DIGIT | CHAR_HEX | CHAR_IDENT;
+    }
+    for (int c = 'a'; c <= 'f'; c++) {
+        char_classes[c] |= CHAR_HEX;
+        char_classes[c - 'a' + 'A'] |= CHAR_HEX;
+    }
+    for (int c = 'a'; c <= 'z'; c++) {
+        char_classes[c] |= CHAR_IDENT_START | CHAR_IDENT;
+        char_classes[c - 'a' + 'A'] |= CHAR_IDENT_START | CHAR_IDENT;
+    }
+    char_classes['_'] |= CHAR_IDENT_START | CHAR_IDENT;
+    for (int c = 0x80; c <= 0xFF; c++) {
+        char_classes[c] |= CHAR_IDENT_START | CHAR_IDENT;
+    }
+    
+    initialized = true;
+}
+
+Lexer create_lexer(const char* source, InternTable* interns) {
+    return create_lexer_at(source, (int)strlen(source), interns, 0, 1, 1);
+}
+
+Lexer create_lexer_at(const char* source, int length, InternTable* interns,
+                      int position, int line, int column) {
+    init_char_classes();
+    
+    Lexer lexer;
+    lexer.source = source;
+    lexer.position = position;
+    lexer.line = line;
+    lexer.column = column;
+    lexer.length = length;
+    lexer.interns = interns;
+    lexer.token_start = position;
+    return lexer;
+}
+
+static const char* lexer_text(Lexer* lexer, int start, int length) {
+    uint32_t id = intern_string(lexer->interns, lexer->source + start, length);
+    return intern_text(lexer->interns, id);
+}
+
+static char peek(Lexer* lexer, int offset) {
+    int pos = lexer->position + offset;
+    if (pos >= lexer->length) {
+        return '\0';
+    }
+    return lexer->source[pos];
+}
+
+static char advance(Lexer* lexer) {
+    if (lexer->position >= lexer->length) {
+        return '\0';
+    }
+    
+    char ch = lexer->source[lexer->position];
+    lexer->position++;
+    
+    if (ch == '\n') {
+        lexer->line++;
+        lexer->column = 1;
+    } else {
+        lexer->column++;
+    }
+    
+    return ch;
+}
+
+static void skip_whitespace(Lexer* lexer) {
+    while (char_is(peek(lexer, 0), CHAR_SPACE)) {
+        advance(lexer);
+    }
+}
+
+static void skip_line_comment(Lexer* lexer) {
+    // Skip // comments
+    while (peek(lexer, 0) != '\n' && peek(lexer, 0) != '\0') {
+        advance(lexer);
+    }
+}
+
+static void skip_block_comment(Lexer* lexer) {
+    // Skip /* */ comments
+    advance(lexer); // Skip /
+    advance(lexer); // Skip *
+    
+    while (!(peek(lexer, 0) == '*' && peek(lexer, 1) == '/')) {
+        if (peek(lexer, 0) == '\0') {
+            break;
+        }
+        advance(lexer);
+    }
+    
+    if (peek(lexer, 0) == '*') {
+        advance(lexer);
+        advance(lexer);
+    }
+}
+
+static Token read_string(Lexer* lexer) {
+    Token token;
+    token.type = TOK_STRING;
+    token.line = lexer->line;
+    token.column = lexer->column;
+    
+    advance(lexer); // Skip opening quote
+    
+    int start = lexer->position;
+    while (peek(lexer, 0) != '"' && peek(lexer, 0) != '\0') {
+        if (peek(lexer, 0) == '\\') {
+            advance(lexer); // Skip escape char
+        }
+        advance(lexer);
+    }
+    
+    token.value = lexer_text(lexer, start, lexer->position - start);
+    
+    if (peek(lexer, 0) == '"') {
+        advance(lexer); // Skip closing quote
+    }
+    
+    return token;
+}
+
+static Token read_number(Lexer* lexer) {
+    Token token;
+    token.type = TOK_NUMBER;
+    token.line = lexer->line;
+    token.column = lexer->column;
+    
+    int start = lexer->position;
+    
+    while (char_is(peek(lexer, 0), CHAR_DIGIT) || peek(lexer, 0) == '.') {
+        advance(lexer);
+    }
+    
+    // Handle hex (0x), binary (0b), octal (0o)
+    if (start < lexer->position && lexer->source[start] == '0') {
+        if (peek(lexer, 0) == 'x' || peek(lexer, 0) == 'X' ||
+            peek(lexer, 0) == 'b' || peek(lexer, 0) == 'B' ||
+            peek(lexer, 0) == 'o' || peek(lexer, 0) == 'O') {
+            advance(lexer);
+            while (char_is(peek(lexer, 0), CHAR_HEX)) {
+                advance(lexer);
+            }
+        }
+    }
+    
+    token.value = lexer_text(lexer, start, lexer->position - start);
+    return token;
+}
+
+bool is_keyword(const char* word) {
+    static const char* keywords[] = {
+        "function", "public", "private", "returns", "struct", "enum",
+        "if", "else", "for", "while", "match", "import", "export",
+        "const", "let", "var", "true", "false", "null", "return",
+        "break", "continue", "new", "delete", "sizeof", "typeof",
+        "as", "is", "in", "where", "contract", "emit", "event",
+        NULL
+    };
+    
+    for (int i = 0; keywords[i] != NULL; i++) {
+        if (strcmp(word, keywords[i]) == 0) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+static Token read_identifier(Lexer* lexer) {
+    Token token;
+    token.line = lexer->line;
+    token.column = lexer->column;
+    
+    int start = lexer->position;
+    
+    while (char_is(peek(lexer, 0), CHAR_IDENT)) {
+        advance(lexer);
+    }
+    
+    const char* value = lexer_text(lexer, start, lexer->position - start);
+    
+    if (is_keyword(value)) {
+        token.type = TOK_KEYWORD;
+    } else {
+        token.type = TOK_IDENTIFIER;
+    }
+    
+    token.value = value;
+    return token;
+}
+
+static Token scan_token(Lexer* lexer) {
+    skip_whitespace(lexer);
+    lexer->token_start = lexer->position;
+    
+    // Check for EOF
+    if (peek(lexer, 0) == '\0') {
+        Token token;
+        token.type = TOK_EOF;
+        token.value = "";
+        token.line = lexer->line;
+        token.column = lexer->column;
+        return token;
+    }
+    
+    // Check for comments
+    if (peek(lexer, 0) == '/' && peek(lexer, 1) == '/') {
+        skip_line_comment(lexer);
+        return scan_token(lexer);
+    }
+    
+    if (peek(lexer, 0) == '/' && peek(lexer, 1) == '*') {
+        skip_block_comment(lexer);
+        return scan_token(lexer);
+    }
+    
+    char ch = peek(lexer, 0);
+    Token token;
+    token.line = lexer->line;
+    token.column = lexer->column;
+    
+    // Single character tokens
+    if (ch == '(') {
+        token.type = TOK_LPAREN;
+        token.value = "(";
+        advance(lexer);
+        return token;
+    }
+    if (ch == ')') {
+        token.type = TOK_RPAREN;
+        token.value = ")";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '{') {
+        token.type = TOK_LBRACE;
+        token.value = "{";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '}') {
+        token.type = TOK_RBRACE;
+        token.value = "}";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '[') {
+        token.type = TOK_LBRACKET;
+        token.value = "[";
+        advance(lexer);
+        return token;
+    }
+    if (ch == ']') {
+        token.type = TOK_RBRACKET;
+        token.value = "]";
+        advance(lexer);
+        return token;
+    }
+    if (ch == ';') {
+        token.type = TOK_SEMICOLON;
+        token.value = ";";
+        advance(lexer);
+        return token;
+    }
+    if (ch == ',') {
+        token.type = TOK_COMMA;
+        token.value = ",";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '.') {
+        token.type = TOK_DOT;
+        token.value = ".";
+        advance(lexer);
+        return token;
+    }
+    if (ch == ':') {
+        token.type = TOK_COLON;
+        token.value = ":";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '+') {
+        token.type = TOK_PLUS;
+        token.value = "+";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '-') {
+        if (peek(lexer, 1) == '>') {
+            token.type = TOK_ARROW;
+            token.value = "->";
+            advance(lexer);
+            advance(lexer);
+            return token;
+        }
+        token.type = TOK_MINUS;
+        token.value = "-";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '*') {
+        token.type = TOK_STAR;
+        token.value = "*";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '/') {
+        token.type = TOK_SLASH;
+        token.value = "/";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '%') {
+        token.type = TOK_PERCENT;
+        token.value = "%";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '=') {
+        if (peek(lexer, 1) == '=') {
+            token.type = TOK_EQEQ;
+            token.value = "==";
+            advance(lexer);
+            advance(lexer);
+            return token;
+        }
+        token.type = TOK_EQ;
+        token.value = "=";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '!') {
+        if (peek(lexer, 1) == '=') {
+            token.type = TOK_NEQ;
+            token.value = "!=";
+            advance(lexer);
+            advance(lexer);
+            return token;
+        }
+        advance(lexer);
+        token.type = TOK_ERROR;
+        token.value = "!";
+        return token;
+    }
+    if (ch == '<') {
+        if (peek(lexer, 1) == '=') {
+            token.type = TOK_LTE;
+            token.value = "<=";
+            advance(lexer);
+            advance(lexer);
+            return token;
+        }
+        token.type = TOK_LT;
+        token.value = "<";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '>') {
+        if (peek(lexer, 1) == '=') {
+            token.type = TOK_GTE;
+            token.value = ">=";
+            advance(lexer);
+            advance(lexer);
+            return token;
+        }
+        token.type = TOK_GT;
+        token.value = ">";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '&') {
+        token.type = TOK_AMP;
+        token.value = "&";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '|') {
+        token.type = TOK_PIPE;
+        token.value = "|";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '^') {
+        token.type = TOK_CARET;
+        token.value = "^";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '~') {
+        token.type = TOK_TILDE;
+        token.value = "~";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '?') {
+        token.type = TOK_QUESTION;
+        token.value = "?";
+        advance(lexer);
+        return token;
+    }
+    if (ch == '"') {
+        return read_string(lexer);
+    }
+    if (char_is(ch, CHAR_DIGIT)) {
+        return read_number(lexer);
+    }
+    if (char_is(ch, CHAR_IDENT_START)) {
+        return read_identifier(lexer);
+    }
+    
+    // Unknown character (always ASCII: non-ASCII bytes start identifiers)
+    token.type = TOK_ERROR;
+    token.value = lexer_text(lexer, lexer->position, 1);
+    advance(lexer);
+    return token;
+}
+
+Token next_token(Lexer* lexer) {
+    Token token = scan_token(lexer);
+    token.offset = lexer->token_start;
+    token.length = lexer->position - lexer->token_start;
+    return token;
+}
@@ -0,0 +1,81 @@
+// OMEGA Bootstrap - Lexer
+// Purpose: Tokenize OMEGA/MEGA source for the bootstrap parser and tools
+// Platform: Windows, Linux, macOS (standard C99)
+// The lexer keeps no state between tokens other than its position, so it
+// can be restarted at any token boundary (see omega_relex.h).
+
+#ifndef OMEGA_LEXER_H
+#define OMEGA_LEXER_H
+
+#include <stdbool.h>
+
+#include "omega_intern.h"
+
+// Token types for OMEGA lexer
+typedef enum {
+    TOK_EOF,
+    TOK_IDENTIFIER,
+    TOK_KEYWORD,
+    TOK_NUMBER,
+    TOK_STRING,
+    TOK_LPAREN,
+    TOK_RPAREN,
+    TOK_LBRACE,
+    TOK_RBRACE,
+    TOK_LBRACKET,
+    TOK_RBRACKET,
+    TOK_SEMICOLON,
+    TOK_COMMA,
+    TOK_DOT,
+    TOK_COLON,
+    TOK_ARROW,
+    TOK_PLUS,
+    TOK_MINUS,
+    TOK_STAR,
+    TOK_SLASH,
+    TOK_PERCENT,
+    TOK_EQ,
+    TOK_EQEQ,
+    TOK_NEQ,
+    TOK_LT,
+    TOK_GT,
+    TOK_LTE,
+    TOK_GTE,
+    TOK_AMP,
+    TOK_PIPE,
+    TOK_CARET,
+    TOK_TILDE,
+    TOK_QUESTION,
+    TOK_ERROR,
+    TOK_COMMENT
+} TokenType;
+
+typedef struct {
+    TokenType type;
+    const char* value;
+    int line;
+    int column;
+    int offset;     // byte offset of the first source byte
+    int length;     // source bytes covered, including string quotes
+} Token;
+
+typedef struct {
+    const char* source;
+    int position;
+    int line;
+    int column;
+    int length;
+    InternTable* interns;   // token text is interned, never freed per token
+    int token_start;        // offset of the token being scanned
+} Lexer;
+
+Lexer create_lexer(const char* source, InternTable* interns);
+
+// Lexer over source[0, length) positioned at a known token boundary.
+Lexer create_lexer_at(const char* source, int length, InternTable* interns,
+                      int position, int line, int column);
+
+Token next_token(Lexer* lexer);
+bool is_keyword(const char* word);
+
+#endif // OMEGA_LEXER_H
@@ -0,0 +1,632 @@
+// OMEGA Bootstrap Linker
+// Purpose: Merge OMG2 objects into one image with a hashed global symbol index
+// Platform: Windows, Linux, macOS (C99; objects are mapped by worker threads on POSIX)
+// Compile: gcc -std=c99 -o omega_link bootstrap/omega_link.c bootstrap/omega_object.c
+//          bootstrap/omega_interface.c bootstrap/omega_hash.c -pthread
+// Usage:   omega_link [--output <image>] [--threads <n>] [--allow-undefined] <file.o>...
+//          omega_link --find <image> <name>...
+//
+// Objects are opened and validated in parallel, then merged in command-line
+// order: strings are deduplicated into one table, global symbols go into an
+// open-addressing index, and every imported name is resolved against it.
+// Duplicate globals and unresolved imports are reported with both locations;
+// either is an error (imports only without --allow-undefined) and no image
+// is written. Declarations a --whole-program object lists as unreachable are
+// left out of the image. See omega_object.h for both layouts.
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#include "omega_interface.h"
+#include "omega_object.h"
+
+#define LINK_DEFAULT_THREADS 4
+#define LINK_MAX_THREADS 64
+
+static const char* const kind_names[] = { "?", "function", "event", "struct", "type", "import",
+                                          "pruned" };
+
+static const char* kind_name(uint16_t kind) {
+    return kind < sizeof(kind_names) / sizeof(kind_names[0]) ? kind_names[kind] : "?";
+}
+
+static size_t align8(size_t value) {
+    return (value + 7) & ~(size_t)7;
+}
+
+// ============================================================================
+// STRING TABLE
+// ============================================================================
+
+// Every distinct string once; `slots` maps a string to its offset + 1.
+typedef struct {
+    char* data;
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t* slots;
+    uint32_t mask;
+    uint32_t count;
+    uint64_t requested;         // bytes asked for, before deduplication
+} StringTable;
+
+static bool strings_init(StringTable* table) {
+    memset(table, 0, sizeof(StringTable));
+    table->mask = 1023;
+    table->slots = calloc(table->mask + 1, sizeof(uint32_t));
+    return table->slots != NULL;
+}
+
+static void strings_free(StringTable* table) {
+    free(table->data);
+    free(table->slots);
+    memset(table, 0, sizeof(StringTable));
+}
+
+static bool strings_grow_slots(StringTable* table) {
+    uint32_t mask = table->mask * 2 + 1;
+    uint32_t* slots = calloc((size_t)mask + 1, sizeof(uint32_t));
+    if (!slots) {
+        return false;
+    }
+    for (uint32_t i = 0; i <= table->mask; i++) {
+        if (table->slots[i]) {
+            uint32_t slot = image_hash(table->data + table->slots[i] - 1) & mask;
+            while (slots[slot]) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = table->slots[i];
+        }
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->mask = mask;
+    return true;
+}
+
+// Offset of `text` in the table, adding it if new; false if out of memory.
+static bool strings_add(StringTable* table, const char* text, uint32_t* offset) {
+    uint32_t length = (uint32_t)strlen(text) + 1;
+    table->requested += length;
+    uint32_t slot = image_hash(text) & table->mask;
+    while (table->slots[slot]) {
+        if (strcmp(table->data + table->slots[slot] - 1, text) == 0) {
+            *offset = table->slots[slot] - 1;
+            return true;
+        }
+        slot = (slot + 1) & table->mask;
+    }
+
+    if (table->size + length > table->capacity) {
+        uint32_t capacity = table->capacity ? table->capacity : 4096;
+        while (table->size + length > capacity) {
+            capacity *= 2;
+        }
+        char* data = realloc(table->data, capacity);
+        if (!data) {
+            return false;
+        }
+        table->data = data;
+        table->capacity = capacity;
+    }
+    memcpy(table->data + table->size, text, length);
+    *offset = table->size;
+    table->slots[slot] = table->size + 1;
+    table->size += length;
+    // Keep the load factor under one half
+    if (++table->count * 2 > table->mask && !strings_grow_slots(table)) {
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// LOADING
+// ============================================================================
+
+typedef struct {
+    const char* path;
+    ObjectFile object;
+    bool ok;
+} LinkInput;
+
+typedef struct {
+    LinkInput* inputs;
+    int count;
+    int next;                   // claimed with an atomic increment
+} LoadBatch;
+
+static void load_inputs_from(LoadBatch* batch) {
+    for (;;) {
+#if defined(_WIN32)
+        int i = batch->next++;
+#else
+        int i = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+#endif
+        if (i >= batch->count) {
+            return;
+        }
+        LinkInput* input = &batch->inputs[i];
+        input->ok = object_open(&input->object, input->path);
+    }
+}
+
+#if !defined(_WIN32)
+static void* load_worker(void* arg) {
+    load_inputs_from(arg);
+    return NULL;
+}
+#endif
+
+// Map and validate every object; the calling thread works too.
+static void load_inputs(LinkInput* inputs, int count, int threads) {
+    LoadBatch batch = { inputs, count, 0 };
+#if !defined(_WIN32)
+    pthread_t workers[LINK_MAX_THREADS];
+    int started = 0;
+    while (started < threads - 1 && started < count - 1 &&
+           pthread_create(&workers[started], NULL, load_worker, &batch) == 0) {
+        started++;
+    }
+    load_inputs_from(&batch);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+#else
+    (void)threads;
+    load_inputs_from(&batch);
+#endif
+}
+
+// ============================================================================
+// WHOLE-PROGRAM PRUNING
+// ============================================================================
+
+// Names keyed by a module checksum (0 for any module), sized once for the
+// names to come; open addressing on image_hash(name) ^ key. Names point
+// into the mapped objects.
+typedef struct {
+    const char** names;
+    uint32_t* keys;
+    uint32_t mask;
+} NameSet;
+
+static bool name_set_init(NameSet* set, uint32_t expected) {
+    set->mask = 15;
+    while (set->mask < expected * 2) {
+        set->mask = set->mask * 2 + 1;
+    }
+    set->names = calloc((size_t)set->mask + 1, sizeof(const char*));
+    set->keys = calloc((size_t)set->mask + 1, sizeof(uint32_t));
+    return set->names && set->keys;
+}
+
+static void name_set_free(NameSet* set) {
+    free(set->names);
+    free(set->keys);
+    memset(set, 0, sizeof(NameSet));
+}
+
+static uint32_t name_set_slot(const NameSet* set, const char* name, uint32_t key) {
+    uint32_t slot = (image_hash(name) ^ key) & set->mask;
+    while (set->names[slot] && (set->keys[slot] != key || strcmp(set->names[slot], name) != 0)) {
+        slot = (slot + 1) & set->mask;
+    }
+    return slot;
+}
+
+static void name_set_add(NameSet* set, const char* name, uint32_t key) {
+    uint32_t slot = name_set_slot(set, name, key);
+    set->names[slot] = name;
+    set->keys[slot] = key;
+}
+
+static bool name_set_has(const NameSet* set, const char* name, uint32_t key) {
+    return set->names && set->names[name_set_slot(set, name, key)] != NULL;
+}
+
+// ============================================================================
+// LINKING
+// ============================================================================
+
+typedef struct {
+    NameSet pruned;             // SYMBOL_PRUNED names, keyed by the module's checksum
+    NameSet imported;           // every imported name
+    uint32_t stripped;          // definitions left out as unreachable
+    StringTable strings;
+    ImageModule* modules;
+    ImageSymbol* symbols;
+    uint32_t symbol_count;
+    uint32_t* index;
+    uint32_t index_size;
+    uint32_t global_count;
+    uint32_t resolved;
+    uint32_t unresolved;
+    int duplicates;
+} Link;
+
+static void link_free(Link* link) {
+    name_set_free(&link->pruned);
+    name_set_free(&link->imported);
+    strings_free(&link->strings);
+    free(link->modules);
+    free(link->symbols);
+    free(link->index);
+}
+
+static const char* module_label(const LinkInput* inputs, const ImageSymbol* symbol) {
+    const LinkInput* input = &inputs[symbol->module];
+    return input->object.module[0] ? input->object.module : input->path;
+}
+
+// Index the unreachable declarations whole-program objects list, and every
+// imported name, which keeps a declaration however it was marked. Entries
+// for an import no linked object was compiled from are reported once.
+static bool collect_pruned(Link* link, const LinkInput* inputs, int count) {
+    uint32_t pruned = 0;
+    uint32_t imported = 0;
+    for (int m = 0; m < count; m++) {
+        const ObjectFile* object = &inputs[m].object;
+        for (uint32_t i = 0; i < object->symbol_count; i++) {
+            uint16_t kind = object_symbol(object, i).kind;
+            pruned += kind == SYMBOL_PRUNED;
+            imported += kind == SYMBOL_IMPORT;
+        }
+    }
+    if (pruned == 0) {
+        return true;
+    }
+    if (!name_set_init(&link->pruned, pruned) || !name_set_init(&link->imported, imported)) {
+        return false;
+    }
+
+    for (int m = 0; m < count; m++) {
+        const ObjectFile* object = &inputs[m].object;
+        uint32_t last_key = 0;
+        for (uint32_t i = 0; i < object->symbol_count; i++) {
+            InterfaceSymbol symbol = object_symbol(object, i);
+            const char* name = object->strings + symbol.name;
+            if (symbol.kind == SYMBOL_IMPORT) {
+                name_set_add(&link->imported, name, 0);
+            }
+            if (symbol.kind != SYMBOL_PRUNED) {
+                continue;
+            }
+            name_set_add(&link->pruned, name, symbol.line);
+            // Entries come grouped by import
+            if (i > 0 && symbol.line == last_key) {
+                continue;
+            }
+            last_key = symbol.line;
+            bool matched = false;
+            for (int o = 0; o < count && !matched; o++) {
+                matched = inputs[o].object.version == OBJECT_VERSION &&
+                          inputs[o].object.checksum == symbol.line;
+            }
+            if (!matched) {
+                printf("   ⚠️  %s lists unreachable code in %s, but no object of that source is linked "
+                       "(edited since?); nothing is stripped from it\n",
+                       object->module[0] ? object->module : inputs[m].path,
+                       object->strings + symbol.signature);
+            }
+        }
+    }
+    return true;
+}
+
+// Copy every object's symbols into the image tables, leaving out the
+// unreachable definitions collect_pruned found.
+static bool merge_symbols(Link* link, const LinkInput* inputs, int count) {
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += inputs[i].object.symbol_count;
+    }
+    if (total >= IMAGE_UNRESOLVED / 2) {
+        fprintf(stderr, "❌ Error: Too many symbols (%llu)\n", (unsigned long long)total);
+        return false;
+    }
+    link->modules = calloc((size_t)count, sizeof(ImageModule));
+    link->symbols = calloc(total ? (size_t)total : 1, sizeof(ImageSymbol));
+    if (!link->modules || !link->symbols) {
+        return false;
+    }
+
+    for (int m = 0; m < count; m++) {
+        const ObjectFile* object = &inputs[m].object;
+        ImageModule* module = &link->modules[m];
+        if (!strings_add(&link->strings, object->module[0] ? object->module : inputs[m].path,
+                         &module->path)) {
+            return false;
+        }
+        module->token_count = object->token_count;
+        module->checksum = object->checksum;
+        module->first_symbol = link->symbol_count;
+
+        for (uint32_t i = 0; i < object->symbol_count; i++) {
+            InterfaceSymbol source = object_symbol(object, i);
+            const char* name = object->strings + source.name;
+            if (source.kind == SYMBOL_PRUNED) {
+                continue;
+            }
+            if (source.kind != SYMBOL_IMPORT && name_set_has(&link->pruned, name, object->checksum) &&
+                !name_set_has(&link->imported, name, 0)) {
+                link->stripped++;
+                continue;
+            }
+            ImageSymbol* symbol = &link->symbols[link->symbol_count++];
+            if (!strings_add(&link->strings, name, &symbol->name) ||
+                !strings_add(&link->strings, object->strings + source.signature, &symbol->signature)) {
+                return false;
+            }
+            symbol->kind = source.kind;
+            symbol->flags = source.kind == SYMBOL_IMPORT ? 0 : source.flags;
+            symbol->line = source.line;
+            symbol->module = (uint32_t)m;
+            symbol->target = source.kind == SYMBOL_IMPORT ? IMAGE_UNRESOLVED : link->symbol_count - 1;
+            symbol->hash = image_hash(name);
+            link->global_count += (symbol->flags & SYMBOL_PUBLIC) != 0;
+        }
+        module->symbol_count = link->symbol_count - module->first_symbol;
+    }
+    return true;
+}
+
+// Slot holding `name`, or the empty slot where it belongs.
+static uint32_t index_slot(const Link* link, const char* name, uint32_t hash) {
+    uint32_t mask = link->index_size - 1;
+    uint32_t slot = hash & mask;
+    while (link->index[slot]) {
+        const ImageSymbol* symbol = &link->symbols[link->index[slot] - 1];
+        if (symbol->hash == hash && strcmp(link->strings.data + symbol->name, name) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// Index the globals (load factor at most one half); the first definition
+// wins and later ones are reported.
+static bool build_index(Link* link, const LinkInput* inputs) {
+    link->index_size = 16;
+    while (link->index_size < link->global_count * 2 + 1) {
+        link->index_size *= 2;
+    }
+    link->index = calloc(link->index_size, sizeof(uint32_t));
+    if (!link->index) {
+        return false;
+    }
+
+    uint32_t indexed = 0;
+    for (uint32_t i = 0; i < link->symbol_count; i++) {
+        const ImageSymbol* symbol = &link->symbols[i];
+        if (!(symbol->flags & SYMBOL_PUBLIC)) {
+            continue;
+        }
+        const char* name = link->strings.data + symbol->name;
+        uint32_t slot = index_slot(link, name, symbol->hash);
+        if (link->index[slot]) {
+            const ImageSymbol* first = &link->symbols[link->index[slot] - 1];
+            fprintf(stderr, "❌ Duplicate symbol '%s': %s %s (line %u) and %s %s (line %u)\n", name,
+                    module_label(inputs, first), kind_name(first->kind), first->line,
+                    module_label(inputs, symbol), kind_name(symbol->kind), symbol->line);
+            link->duplicates++;
+            continue;
+        }
+        link->index[slot] = i + 1;
+        indexed++;
+    }
+    link->global_count = indexed;
+    return true;
+}
+
+static void resolve_imports(Link* link, const LinkInput* inputs, bool allow_undefined) {
+    for (uint32_t i = 0; i < link->symbol_count; i++) {
+        ImageSymbol* symbol = &link->symbols[i];
+        if (symbol->kind != SYMBOL_IMPORT) {
+            continue;
+        }
+        const char* name = link->strings.data + symbol->name;
+        uint32_t slot = index_slot(link, name, symbol->hash);
+        if (link->index[slot]) {
+            symbol->target = link->index[slot] - 1;
+            link->resolved++;
+        } else {
+            fprintf(stderr, "%s Undefined symbol '%s': imported by %s (line %u) from %s\n",
+                    allow_undefined ? "⚠️ " : "❌", name, module_label(inputs, symbol), symbol->line,
+                    link->strings.data + symbol->signature);
+            link->unresolved++;
+        }
+    }
+}
+
+static void* serialize_image(const Link* link, int module_count, size_t* size) {
+    ImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IMAGE_MAGIC, 4);
+    header.version = IMAGE_VERSION;
+    header.module_count = (uint32_t)module_count;
+    header.symbol_count = link->symbol_count;
+    header.global_count = link->global_count;
+    header.index_size = link->index_size;
+    header.strings_size = link->strings.size;
+    header.unresolved_count = link->unresolved;
+    header.modules_offset = align8(sizeof(ImageHeader));
+    header.symbols_offset = align8(header.modules_offset + sizeof(ImageModule) * (size_t)module_count);
+    header.index_offset = align8(header.symbols_offset + sizeof(ImageSymbol) * (size_t)link->symbol_count);
+    header.strings_offset = align8(header.index_offset + sizeof(uint32_t) * (size_t)link->index_size);
+    *size = (size_t)header.strings_offset + link->strings.size;
+
+    char* data = calloc(1, *size);
+    if (!data) {
+        return NULL;
+    }
+    memcpy(data, &header, sizeof(header));
+    memcpy(data + header.modules_offset, link->modules, sizeof(ImageModule) * (size_t)module_count);
+    if (link->symbol_count > 0) {
+        memcpy(data + header.symbols_offset, link->symbols, sizeof(ImageSymbol) * link->symbol_count);
+    }
+    memcpy(data + header.index_offset, link->index, sizeof(uint32_t) * link->index_size);
+    memcpy(data + header.strings_offset, link->strings.data, link->strings.size);
+    return data;
+}
+
+static int run_link(const char* const* paths, int count, const char* output, int threads,
+                    bool allow_undefined) {
+    LinkInput* inputs = calloc((size_t)count, sizeof(LinkInput));
+    if (!inputs) {
+        fprintf(stderr, "❌ Error: Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        inputs[i].path = paths[i];
+    }
+    load_inputs(inputs, count, threads);
+
+    int status = 0;
+    int legacy = 0;
+    for (int i = 0; i < count; i++) {
+        if (!inputs[i].ok) {
+            fprintf(stderr, "❌ Error: Cannot read object '%s' (missing or not an OMG2 object)\n",
+                    inputs[i].path);
+            status = 1;
+        } else {
+            legacy += inputs[i].object.version == '1';
+        }
+    }
+
+    Link link;
+    memset(&link, 0, sizeof(link));
+    if (status == 0 && (!strings_init(&link.strings) || !collect_pruned(&link, inputs, count) ||
+                        !merge_symbols(&link, inputs, count) || !build_index(&link, inputs))) {
+        fprintf(stderr, "❌ Error: Out of memory while linking\n");
+        status = 1;
+    }
+    if (status == 0) {
+        resolve_imports(&link, inputs, allow_undefined);
+        if (link.duplicates > 0 || (link.unresolved > 0 && !allow_undefined)) {
+            fprintf(stderr, "❌ Link failed: %d duplicate symbol(s), %u undefined symbol(s)\n",
+                    link.duplicates, link.unresolved);
+            status = 1;
+        }
+    }
+
+    if (status == 0) {
+        size_t size = 0;
+        void* image = serialize_image(&link, count, &size);
+        if (!image || !interface_write_file(output, image, size)) {
+            fprintf(stderr, "❌ Error: Cannot write image '%s'\n", output);
+            status = 1;
+        } else {
+            printf("🔗 Linked %d object(s) → %s (%zu bytes)\n", count, output, size);
+            printf("   🔣 Symbols: %u, %u global (index %u slots), %u import(s) resolved",
+                   link.symbol_count, link.global_count, link.index_size, link.resolved);
+            if (link.unresolved > 0) {
+                printf(", %u undefined", link.unresolved);
+            }
+            printf("\n");
+            printf("   🧵 Strings: %llu -> %u bytes after deduplication\n",
+                   (unsigned long long)link.strings.requested, link.strings.size);
+            if (link.stripped > 0) {
+                printf("   ✂️  Stripped: %u definition(s) the whole program never reaches\n",
+                       link.stripped);
+            }
+            if (legacy > 0) {
+                printf("   ⚠️  %d object(s) predate symbol tables; recompile them to link their symbols\n",
+                       legacy);
+            }
+        }
+        free(image);
+    }
+
+    link_free(&link);
+    for (int i = 0; i < count; i++) {
+        if (inputs[i].ok) {
+            object_close(&inputs[i].object);
+        }
+    }
+    free(inputs);
+    return status;
+}
+
+static int run_find(const char* path, const char* const* names, int count) {
+    LinkedImage* image = image_open(path);
+    if (!image) {
+        fprintf(stderr, "❌ Error: Cannot read image '%s'\n", path);
+        return 1;
+    }
+    int missing = 0;
+    for (int i = 0; i < count; i++) {
+        int found = image_find(image, names[i]);
+        if (found < 0) {
+            printf("   ❓ %s: not a global symbol\n", names[i]);
+            missing++;
+            continue;
+        }
+        const ImageSymbol* symbol = &image->symbols[found];
+        printf("   📍 %s: %s %s at %s:%u\n", names[i], kind_name(symbol->kind),
+               image_string(image, symbol->signature),
+               image_string(image, image->modules[symbol->module].path), symbol->line);
+    }
+    image_close(image);
+    return missing > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "OMEGA Bootstrap Linker\n");
+        fprintf(stderr, "Usage: omega_link [--output <image>] [--threads <n>] [--allow-undefined] <file.o>...\n");
+        fprintf(stderr, "       omega_link --find <image> <name>...\n");
+        return 1;
+    }
+    if (strcmp(argv[1], "--find") == 0) {
+        if (argc < 4) {
+            fprintf(stderr, "❌ Error: --find needs an image and at least one name\n");
+            return 1;
+        }
+        return run_find(argv[2], (const char* const*)argv + 3, argc - 3);
+    }
+
+    const char* output = "omega.oml";
+    int threads = LINK_DEFAULT_THREADS;
+    bool allow_undefined = false;
+    const char** objects = malloc(sizeof(const char*) * (size_t)argc);
+    int count = 0;
+    if (!objects) {
+        return 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--allow-undefined") == 0) {
+            allow_undefined = true;
+        } else {
+            objects[count++] = argv[i];
+        }
+    }
+    if (threads < 1) {
+        threads = 1;
+    } else if (threads > LINK_MAX_THREADS) {
+        threads = LINK_MAX_THREADS;
+    }
+
+    int status;
+    if (count == 0) {
+        fprintf(stderr, "❌ Error: No object files specified\n");
+        status = 1;
+    } else {
+        status = run_link(objects, count, output, threads, allow_undefined);
+    }
+    free(objects);
+    return status;
+}
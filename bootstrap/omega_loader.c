@@ -0,0 +1,812 @@
+// OMEGA Bootstrap - Batched File I/O
+// io_uring through raw system calls (no liburing dependency), a pthread
+// pool, and a plain stdio loop behind one interface. Every backend reads a
+// file up to the size it had when opened, like load_source.
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#elif !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "omega_loader.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const char* loader_backend_name(LoaderBackend backend) {
+    switch (backend) {
+        case LOADER_IO_URING: return "io_uring";
+        case LOADER_THREADS_POOL: return "threads";
+        case LOADER_STDIO: return "stdio";
+        default: return "auto";
+    }
+}
+
+static int read_file(const char* path, char** data, size_t* size) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return errno ? errno : ENOENT;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* buffer = length >= 0 ? malloc((size_t)length + 1) : NULL;
+    if (!buffer) {
+        fclose(file);
+        return length >= 0 ? ENOMEM : EIO;
+    }
+    size_t read = fread(buffer, 1, (size_t)length, file);
+    buffer[read] = '\0';
+    fclose(file);
+    *data = buffer;
+    *size = read;
+    return 0;
+}
+
+static int write_file(const char* path, const void* data, size_t size) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return errno ? errno : EACCES;
+    }
+    bool written = fwrite(data, 1, size, file) == size;
+    if (fclose(file) != 0 || !written) {
+        return errno ? errno : EIO;
+    }
+    return 0;
+}
+
+#if !defined(_WIN32)
+
+// Position in a ready list of the file to hand out next, or -1 to wait.
+// In order, that is the lowest index not yet delivered; files are started
+// in index order, so it is always loaded or in flight.
+static int pick_ready(const SourceLoader* loader, const void* list, int ready_count,
+                      int (*index_at)(const void* list, int position)) {
+    for (int i = 0; i < ready_count; i++) {
+        if (!loader->in_order || index_at(list, i) == loader->delivered) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#endif
+
+// ============================================================================
+// IO_URING
+// ============================================================================
+
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+
+#define RING_ENTRIES (4 * LOADER_DEPTH)   // open + statx + a pending close per slot
+
+enum { OP_OPEN, OP_STATX, OP_READ, OP_WRITE, OP_CLOSE };
+
+#define USER_DATA(slot, op) (((uint64_t)(slot) << 3) | (uint64_t)(op))
+
+typedef struct {
+    int fd;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_sqe* sqes;
+    struct io_uring_cqe* cqes;
+    void* sq_map;
+    size_t sq_size;
+    void* cq_map;               // same as sq_map with IORING_FEAT_SINGLE_MMAP
+    size_t cq_size;
+    void* sqe_map;
+    size_t sqe_size;
+    unsigned queued;            // written since the last io_uring_enter
+    int in_flight;              // submitted or queued, not yet completed
+} Ring;
+
+static void ring_free(Ring* ring) {
+    if (ring->sqe_map) {
+        munmap(ring->sqe_map, ring->sqe_size);
+    }
+    if (ring->cq_map && ring->cq_map != ring->sq_map) {
+        munmap(ring->cq_map, ring->cq_size);
+    }
+    if (ring->sq_map) {
+        munmap(ring->sq_map, ring->sq_size);
+    }
+    if (ring->fd >= 0) {
+        close(ring->fd);
+    }
+    memset(ring, 0, sizeof(Ring));
+    ring->fd = -1;
+}
+
+static void* map_ring(int fd, size_t size, off_t offset) {
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return map == MAP_FAILED ? NULL : map;
+}
+
+static bool ring_init(Ring* ring) {
+    memset(ring, 0, sizeof(Ring));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, RING_ENTRIES, &params);
+    if (ring->fd < 0) {
+        return false;
+    }
+    // FAST_POLL (5.7) implies the OPENAT, STATX, READ and WRITE opcodes
+    if (!(params.features & IORING_FEAT_FAST_POLL)) {
+        ring_free(ring);
+        return false;
+    }
+
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && ring->cq_size > ring->sq_size) {
+        ring->sq_size = ring->cq_size;
+    }
+    ring->sq_map = map_ring(ring->fd, ring->sq_size, IORING_OFF_SQ_RING);
+    ring->cq_map = single ? ring->sq_map : map_ring(ring->fd, ring->cq_size, IORING_OFF_CQ_RING);
+    ring->sqe_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqe_map = map_ring(ring->fd, ring->sqe_size, IORING_OFF_SQES);
+    if (!ring->sq_map || !ring->cq_map || !ring->sqe_map) {
+        ring_free(ring);
+        return false;
+    }
+
+    char* sq = ring->sq_map;
+    char* cq = ring->cq_map;
+    ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    ring->sqes = ring->sqe_map;
+    return true;
+}
+
+// Fill the next submission entry; ring_publish makes it visible. Callers
+// bound their outstanding requests well below RING_ENTRIES, so the
+// submission queue never fills.
+static struct io_uring_sqe* ring_prep(Ring* ring, uint8_t opcode, int fd, const void* addr,
+                                      unsigned length, uint64_t offset, uint64_t user_data) {
+    unsigned index = *ring->sq_tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)addr;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    ring->sq_array[index] = index;
+    return sqe;
+}
+
+static void ring_publish(Ring* ring) {
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail + 1, __ATOMIC_RELEASE);
+    ring->queued++;
+    ring->in_flight++;
+}
+
+// Publish queued requests and wait for at least one completion.
+static bool ring_submit_wait(Ring* ring) {
+    unsigned wait = ring->in_flight > 0 ? 1 : 0;
+    for (;;) {
+        long submitted = syscall(__NR_io_uring_enter, ring->fd, ring->queued, wait,
+                                 wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (submitted >= 0) {
+            ring->queued -= (unsigned)submitted;
+            return true;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            return false;
+        }
+    }
+}
+
+static bool ring_reap(Ring* ring, struct io_uring_cqe* out) {
+    unsigned head = *ring->cq_head;
+    if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *out = ring->cqes[head & *ring->cq_mask];
+    __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+    ring->in_flight--;
+    return true;
+}
+
+typedef struct {
+    int index;                  // path index, -1 when the slot is free
+    int fd;
+    int waiting;                // completions the current step still needs
+    int error;
+    size_t size;
+    size_t done;
+    char* data;
+    struct statx stat;
+} UringFile;
+
+typedef struct {
+    Ring ring;
+    UringFile files[LOADER_DEPTH];
+    int ready[LOADER_DEPTH];    // finished slots, unordered
+    int ready_count;
+    int next;                   // next path to start
+    bool broken;                // io_uring_enter failed; finish with stdio
+    bool* taken;                // per path: handed to the caller
+    int cursor;                 // first path that may not be taken yet
+} UringLoader;
+
+static void uring_queue(Ring* ring, uint8_t opcode, int fd, const void* addr, unsigned length,
+                        uint64_t offset, uint64_t user_data, uint32_t flags) {
+    struct io_uring_sqe* sqe = ring_prep(ring, opcode, fd, addr, length, offset, user_data);
+    sqe->open_flags = flags;    // shares a union with statx_flags and rw_flags
+    ring_publish(ring);
+}
+
+static void uring_start(SourceLoader* loader, UringLoader* u, int slot) {
+    UringFile* file = &u->files[slot];
+    file->index = u->next++;
+    file->fd = -1;
+    file->waiting = 2;
+    file->error = 0;
+    file->size = 0;
+    file->done = 0;
+    file->data = NULL;
+    const char* path = loader->paths[file->index];
+    uring_queue(&u->ring, IORING_OP_OPENAT, AT_FDCWD, path, 0, 0,
+                USER_DATA(slot, OP_OPEN), O_RDONLY | O_CLOEXEC);
+    uring_queue(&u->ring, IORING_OP_STATX, AT_FDCWD, path, STATX_SIZE,
+                (uint64_t)(uintptr_t)&file->stat, USER_DATA(slot, OP_STATX), 0);
+}
+
+static void uring_finish(UringLoader* u, int slot) {
+    UringFile* file = &u->files[slot];
+    if (file->fd >= 0) {
+        uring_queue(&u->ring, IORING_OP_CLOSE, file->fd, NULL, 0, 0, USER_DATA(slot, OP_CLOSE), 0);
+        file->fd = -1;
+    }
+    if (file->error) {
+        free(file->data);
+        file->data = NULL;
+        file->size = 0;
+    } else {
+        file->data[file->done] = '\0';
+        file->size = file->done;
+    }
+    u->ready[u->ready_count++] = slot;
+}
+
+static void uring_read(UringLoader* u, int slot) {
+    UringFile* file = &u->files[slot];
+    size_t remaining = file->size - file->done;
+    unsigned length = remaining > 0x40000000 ? 0x40000000 : (unsigned)remaining;
+    uring_queue(&u->ring, IORING_OP_READ, file->fd, file->data + file->done, length,
+                file->done, USER_DATA(slot, OP_READ), 0);
+}
+
+static void uring_complete(UringLoader* u, const struct io_uring_cqe* cqe) {
+    int slot = (int)(cqe->user_data >> 3);
+    int op = (int)(cqe->user_data & 7);
+    UringFile* file = &u->files[slot];
+    int res = cqe->res;
+    if (op == OP_CLOSE) {
+        return;
+    }
+
+    if (op == OP_OPEN || op == OP_STATX) {
+        if (res < 0) {
+            file->error = file->error ? file->error : -res;
+        } else if (op == OP_OPEN) {
+            file->fd = res;
+        } else {
+            file->size = (size_t)file->stat.stx_size;
+        }
+        if (--file->waiting > 0) {
+            return;
+        }
+        if (!file->error) {
+            file->data = malloc(file->size + 1);
+            file->error = file->data ? 0 : ENOMEM;
+        }
+        if (file->error || file->size == 0) {
+            uring_finish(u, slot);
+        } else {
+            uring_read(u, slot);
+        }
+        return;
+    }
+
+    // OP_READ
+    if (res == -EINTR || res == -EAGAIN) {
+        uring_read(u, slot);
+    } else if (res < 0) {
+        file->error = -res;
+        uring_finish(u, slot);
+    } else {
+        file->done += (size_t)res;
+        if (res > 0 && file->done < file->size) {
+            uring_read(u, slot);
+        } else {
+            uring_finish(u, slot);
+        }
+    }
+}
+
+static bool uring_open(SourceLoader* loader) {
+    UringLoader* u = calloc(1, sizeof(UringLoader));
+    if (!u) {
+        return false;
+    }
+    u->taken = calloc((size_t)loader->count + 1, sizeof(bool));
+    if (!u->taken || !ring_init(&u->ring)) {
+        free(u->taken);
+        free(u);
+        return false;
+    }
+    for (int slot = 0; slot < LOADER_DEPTH; slot++) {
+        u->files[slot].index = -1;
+    }
+    for (int slot = 0; slot < LOADER_DEPTH && u->next < loader->count; slot++) {
+        uring_start(loader, u, slot);
+    }
+    loader->impl = u;
+    return true;
+}
+
+static int uring_ready_index(const void* list, int position) {
+    const UringLoader* u = list;
+    return u->files[u->ready[position]].index;
+}
+
+static void uring_next(SourceLoader* loader, LoadedSource* out) {
+    UringLoader* u = loader->impl;
+    int position = -1;
+    while (!u->broken &&
+           (position = pick_ready(loader, u, u->ready_count, uring_ready_index)) < 0) {
+        if (!ring_submit_wait(&u->ring)) {
+            u->broken = true;
+            break;
+        }
+        struct io_uring_cqe cqe;
+        while (ring_reap(&u->ring, &cqe)) {
+            uring_complete(u, &cqe);
+        }
+    }
+    if (position < 0) {
+        // The ring failed: read whatever was not handed out yet directly
+        while (u->taken[u->cursor]) {
+            u->cursor++;
+        }
+        out->index = u->cursor;
+        out->data = NULL;
+        out->size = 0;
+        out->error = read_file(loader->paths[u->cursor], &out->data, &out->size);
+        u->taken[u->cursor] = true;
+        return;
+    }
+
+    int slot = u->ready[position];
+    u->ready[position] = u->ready[--u->ready_count];
+    UringFile* file = &u->files[slot];
+    out->index = file->index;
+    out->data = file->data;
+    out->size = file->size;
+    out->error = file->error;
+    u->taken[file->index] = true;
+    file->index = -1;
+    file->data = NULL;
+    if (u->next < loader->count) {
+        uring_start(loader, u, slot);
+    }
+}
+
+static void uring_close(SourceLoader* loader) {
+    UringLoader* u = loader->impl;
+    // Let outstanding requests land before their buffers go away
+    struct io_uring_cqe cqe;
+    while (u->ring.in_flight > 0 && !u->broken) {
+        if (!ring_submit_wait(&u->ring)) {
+            break;
+        }
+        while (ring_reap(&u->ring, &cqe)) {
+            uring_complete(u, &cqe);
+        }
+    }
+    for (int slot = 0; slot < LOADER_DEPTH; slot++) {
+        if (u->files[slot].fd >= 0 && u->files[slot].index >= 0) {
+            close(u->files[slot].fd);
+        }
+        free(u->files[slot].data);
+    }
+    ring_free(&u->ring);
+    free(u->taken);
+    free(u);
+}
+
+typedef struct {
+    int index;                  // write index, -1 when the slot is free
+    int fd;
+    size_t done;
+} UringWrite;
+
+static bool uring_write_objects(ObjectWrite* writes, int count, int* failures) {
+    Ring ring;
+    if (!ring_init(&ring)) {
+        return false;
+    }
+    UringWrite slots[LOADER_DEPTH];
+    int next = 0;
+    int finished = 0;
+
+    for (int slot = 0; slot < LOADER_DEPTH; slot++) {
+        slots[slot].index = -1;
+        if (next < count) {
+            slots[slot].index = next++;
+            slots[slot].fd = -1;
+            slots[slot].done = 0;
+            uring_queue(&ring, IORING_OP_OPENAT, AT_FDCWD, writes[slots[slot].index].path, 0666,
+                        0, USER_DATA(slot, OP_OPEN), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC);
+        }
+    }
+
+    while (finished < count) {
+        if (!ring_submit_wait(&ring)) {
+            break;
+        }
+        struct io_uring_cqe cqe;
+        while (ring_reap(&ring, &cqe)) {
+            int slot = (int)(cqe.user_data >> 3);
+            int op = (int)(cqe.user_data & 7);
+            UringWrite* state = &slots[slot];
+            ObjectWrite* write = &writes[state->index];
+            bool done = false;
+            if (op == OP_OPEN) {
+                if (cqe.res < 0) {
+                    write->error = -cqe.res;
+                    done = true;
+                } else {
+                    state->fd = cqe.res;
+                    uring_queue(&ring, IORING_OP_WRITE, state->fd, write->data,
+                                (unsigned)write->size, 0, USER_DATA(slot, OP_WRITE), 0);
+                }
+            } else if (op == OP_WRITE) {
+                if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                    cqe.res = 0;
+                } else if (cqe.res < 0) {
+                    write->error = -cqe.res;
+                }
+                state->done += cqe.res > 0 ? (size_t)cqe.res : 0;
+                if (!write->error && state->done < write->size) {
+                    uring_queue(&ring, IORING_OP_WRITE, state->fd,
+                                (const char*)write->data + state->done,
+                                (unsigned)(write->size - state->done), state->done,
+                                USER_DATA(slot, OP_WRITE), 0);
+                } else {
+                    uring_queue(&ring, IORING_OP_CLOSE, state->fd, NULL, 0, 0,
+                                USER_DATA(slot, OP_CLOSE), 0);
+                }
+            } else {
+                if (cqe.res < 0 && !write->error) {
+                    write->error = -cqe.res;
+                }
+                done = true;
+            }
+            if (done) {
+                *failures += write->error ? 1 : 0;
+                finished++;
+                state->index = -1;
+                if (next < count) {
+                    state->index = next++;
+                    state->fd = -1;
+                    state->done = 0;
+                    uring_queue(&ring, IORING_OP_OPENAT, AT_FDCWD, writes[state->index].path,
+                                0666, 0, USER_DATA(slot, OP_OPEN),
+                                O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC);
+                }
+            }
+        }
+    }
+    ring_free(&ring);
+    if (finished < count) {
+        // The ring broke mid-batch: redo what did not finish the slow way
+        for (int slot = 0; slot < LOADER_DEPTH; slot++) {
+            if (slots[slot].index >= 0) {
+                ObjectWrite* write = &writes[slots[slot].index];
+                write->error = write_file(write->path, write->data, write->size);
+                *failures += write->error ? 1 : 0;
+            }
+        }
+        for (int i = next; i < count; i++) {
+            writes[i].error = write_file(writes[i].path, writes[i].data, writes[i].size);
+            *failures += writes[i].error ? 1 : 0;
+        }
+    }
+    return true;
+}
+
+#else
+
+static bool uring_open(SourceLoader* loader) {
+    (void)loader;
+    return false;
+}
+
+static void uring_next(SourceLoader* loader, LoadedSource* out) {
+    (void)loader;
+    (void)out;
+}
+
+static void uring_close(SourceLoader* loader) {
+    (void)loader;
+}
+
+static bool uring_write_objects(ObjectWrite* writes, int count, int* failures) {
+    (void)writes;
+    (void)count;
+    (void)failures;
+    return false;
+}
+
+#endif
+
+// ============================================================================
+// THREAD POOL
+// ============================================================================
+
+#if !defined(_WIN32)
+
+typedef struct {
+    SourceLoader* loader;
+    pthread_t threads[LOADER_THREADS];
+    int thread_count;
+    pthread_mutex_t mutex;
+    pthread_cond_t loaded;      // a file was added to `ready`
+    pthread_cond_t taken;       // a file was taken from `ready`
+    LoadedSource ready[LOADER_DEPTH + LOADER_THREADS];   // unordered
+    int ready_count;
+    int next;                   // next path a worker picks up
+    bool stop;
+} PoolLoader;
+
+static void* pool_worker(void* arg) {
+    PoolLoader* pool = arg;
+    for (;;) {
+        pthread_mutex_lock(&pool->mutex);
+        while (!pool->stop && pool->next < pool->loader->count && pool->ready_count >= LOADER_DEPTH) {
+            pthread_cond_wait(&pool->taken, &pool->mutex);
+        }
+        if (pool->stop || pool->next >= pool->loader->count) {
+            pthread_mutex_unlock(&pool->mutex);
+            return NULL;
+        }
+        int index = pool->next++;
+        pthread_mutex_unlock(&pool->mutex);
+
+        LoadedSource file;
+        file.index = index;
+        file.data = NULL;
+        file.size = 0;
+        file.error = read_file(pool->loader->paths[index], &file.data, &file.size);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->ready[pool->ready_count++] = file;
+        pthread_cond_signal(&pool->loaded);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+static bool pool_open(SourceLoader* loader) {
+    PoolLoader* pool = calloc(1, sizeof(PoolLoader));
+    if (!pool) {
+        return false;
+    }
+    pool->loader = loader;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->loaded, NULL);
+    pthread_cond_init(&pool->taken, NULL);
+    int wanted = loader->count < LOADER_THREADS ? loader->count : LOADER_THREADS;
+    while (pool->thread_count < wanted &&
+           pthread_create(&pool->threads[pool->thread_count], NULL, pool_worker, pool) == 0) {
+        pool->thread_count++;
+    }
+    if (pool->thread_count == 0 && wanted > 0) {
+        pthread_mutex_destroy(&pool->mutex);
+        pthread_cond_destroy(&pool->loaded);
+        pthread_cond_destroy(&pool->taken);
+        free(pool);
+        return false;
+    }
+    loader->impl = pool;
+    return true;
+}
+
+static int pool_ready_index(const void* list, int position) {
+    const PoolLoader* pool = list;
+    return pool->ready[position].index;
+}
+
+static void pool_next(SourceLoader* loader, LoadedSource* out) {
+    PoolLoader* pool = loader->impl;
+    pthread_mutex_lock(&pool->mutex);
+    int position;
+    while ((position = pick_ready(loader, pool, pool->ready_count, pool_ready_index)) < 0) {
+        pthread_cond_wait(&pool->loaded, &pool->mutex);
+    }
+    *out = pool->ready[position];
+    pool->ready[position] = pool->ready[--pool->ready_count];
+    pthread_cond_signal(&pool->taken);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void pool_close(SourceLoader* loader) {
+    PoolLoader* pool = loader->impl;
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->taken);
+    pthread_mutex_unlock(&pool->mutex);
+    for (int i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (int i = 0; i < pool->ready_count; i++) {
+        free(pool->ready[i].data);
+    }
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->loaded);
+    pthread_cond_destroy(&pool->taken);
+    free(pool);
+}
+
+typedef struct {
+    ObjectWrite* writes;
+    int count;
+    int next;                   // claimed with an atomic increment
+} PoolWrites;
+
+static void* pool_write_worker(void* arg) {
+    PoolWrites* batch = arg;
+    for (;;) {
+        int i = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+        if (i >= batch->count) {
+            return NULL;
+        }
+        ObjectWrite* write = &batch->writes[i];
+        write->error = write_file(write->path, write->data, write->size);
+    }
+}
+
+static bool pool_write_objects(ObjectWrite* writes, int count, int* failures) {
+    PoolWrites batch = { writes, count, 0 };
+    pthread_t threads[LOADER_THREADS];
+    int started = 0;
+    while (started < LOADER_THREADS && started < count &&
+           pthread_create(&threads[started], NULL, pool_write_worker, &batch) == 0) {
+        started++;
+    }
+    if (started == 0) {
+        return false;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    for (int i = 0; i < count; i++) {
+        *failures += writes[i].error ? 1 : 0;
+    }
+    return true;
+}
+
+#else
+
+static bool pool_open(SourceLoader* loader) {
+    (void)loader;
+    return false;
+}
+
+static void pool_next(SourceLoader* loader, LoadedSource* out) {
+    (void)loader;
+    (void)out;
+}
+
+static void pool_close(SourceLoader* loader) {
+    (void)loader;
+}
+
+static bool pool_write_objects(ObjectWrite* writes, int count, int* failures) {
+    (void)writes;
+    (void)count;
+    (void)failures;
+    return false;
+}
+
+#endif
+
+// ============================================================================
+// INTERFACE
+// ============================================================================
+
+bool loader_open(SourceLoader* loader, const char* const* paths, int count,
+                 LoaderBackend backend, bool in_order) {
+    memset(loader, 0, sizeof(SourceLoader));
+    loader->paths = paths;
+    loader->count = count;
+    loader->in_order = in_order;
+
+    if ((backend == LOADER_AUTO || backend == LOADER_IO_URING) && uring_open(loader)) {
+        loader->backend = LOADER_IO_URING;
+    } else if (backend != LOADER_STDIO && pool_open(loader)) {
+        loader->backend = LOADER_THREADS_POOL;
+    } else {
+        loader->backend = LOADER_STDIO;
+    }
+    return true;
+}
+
+bool loader_next(SourceLoader* loader, LoadedSource* out) {
+    if (loader->delivered >= loader->count) {
+        return false;
+    }
+    if (loader->backend == LOADER_IO_URING) {
+        uring_next(loader, out);
+    } else if (loader->backend == LOADER_THREADS_POOL) {
+        pool_next(loader, out);
+    } else {
+        out->index = loader->delivered;
+        out->data = NULL;
+        out->size = 0;
+        out->error = read_file(loader->paths[out->index], &out->data, &out->size);
+    }
+    loader->delivered++;
+    return true;
+}
+
+void loader_close(SourceLoader* loader) {
+    if (loader->backend == LOADER_IO_URING) {
+        uring_close(loader);
+    } else if (loader->backend == LOADER_THREADS_POOL) {
+        pool_close(loader);
+    }
+    loader->impl = NULL;
+}
+
+int write_objects(ObjectWrite* writes, int count, LoaderBackend backend, LoaderBackend* used) {
+    int failures = 0;
+    for (int i = 0; i < count; i++) {
+        writes[i].error = 0;
+    }
+    if ((backend == LOADER_AUTO || backend == LOADER_IO_URING) &&
+        uring_write_objects(writes, count, &failures)) {
+        *used = LOADER_IO_URING;
+        return failures;
+    }
+    if (backend != LOADER_STDIO && count > 1 && pool_write_objects(writes, count, &failures)) {
+        *used = LOADER_THREADS_POOL;
+        return failures;
+    }
+    for (int i = 0; i < count; i++) {
+        writes[i].error = write_file(writes[i].path, writes[i].data, writes[i].size);
+        failures += writes[i].error ? 1 : 0;
+    }
+    *used = LOADER_STDIO;
+    return failures;
+}
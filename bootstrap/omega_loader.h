@@ -0,0 +1,66 @@
+// OMEGA Bootstrap - Batched File I/O
+// Purpose: Load many source files and write many objects with few blocking calls
+// Platform: Linux (io_uring, else threads), macOS (threads), Windows (stdio)
+// The loader keeps up to LOADER_DEPTH files in flight: opens and statx calls
+// for a file are submitted together, its read follows as soon as both
+// complete, and finished files are handed out in completion order. Without
+// io_uring (old kernels, seccomp) a small thread pool does blocking reads
+// instead. Objects are written the same way in one batch.
+
+#ifndef OMEGA_LOADER_H
+#define OMEGA_LOADER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define LOADER_DEPTH 32             // files in flight / loaded but not taken
+#define LOADER_THREADS 4            // thread-pool fallback workers
+
+typedef enum {
+    LOADER_AUTO,                    // best available
+    LOADER_IO_URING,
+    LOADER_THREADS_POOL,
+    LOADER_STDIO
+} LoaderBackend;
+
+typedef struct {
+    int index;                      // position in the path list
+    char* data;                     // contents plus a NUL; the caller frees it
+    size_t size;
+    int error;                      // errno value, 0 on success
+} LoadedSource;
+
+typedef struct {
+    LoaderBackend backend;          // the one actually in use
+    const char* const* paths;
+    int count;
+    int delivered;
+    bool in_order;                  // hand files out in path order
+    void* impl;
+} SourceLoader;
+
+typedef struct {
+    const char* path;
+    const void* data;
+    size_t size;
+    int error;                      // set by write_objects, errno value
+} ObjectWrite;
+
+const char* loader_backend_name(LoaderBackend backend);
+
+// Start loading `paths` (which must outlive the loader). Files are handed
+// out as they complete, or in path order when `in_order` is set (loading
+// still overlaps).
+bool loader_open(SourceLoader* loader, const char* const* paths, int count,
+                 LoaderBackend backend, bool in_order);
+
+// Block until another file is loaded; false once every file was handed out.
+bool loader_next(SourceLoader* loader, LoadedSource* out);
+
+// Stop early if needed and free files that were never taken.
+void loader_close(SourceLoader* loader);
+
+// Write every object; returns the number that failed (see ObjectWrite.error).
+int write_objects(ObjectWrite* writes, int count, LoaderBackend backend, LoaderBackend* used);
+
+#endif // OMEGA_LOADER_H
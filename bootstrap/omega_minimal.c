@@ -1,543 +1,559 @@
 // OMEGA Minimal Bootstrap Compiler v2.0
 // Purpose: Parse OMEGA/MEGA syntax and output object files
 // Platform: Windows, Linux, macOS (standard C99)
-// Size: ~600 lines - human-readable and auditable
 // Output: .o object files ready for linking
-// Compile: gcc -std=c99 -o omega_minimal bootstrap/omega_minimal.c
+// Compile: gcc -std=c99 -o omega_minimal bootstrap/omega_minimal.c bootstrap/omega_lexer.c
+//          bootstrap/omega_intern.c bootstrap/omega_keccak.c bootstrap/omega_utf8.c
+//          bootstrap/omega_modules.c bootstrap/omega_watch.c bootstrap/omega_interface.c
+//          bootstrap/omega_hash.c bootstrap/omega_layout.c bootstrap/omega_peephole.c
+//          bootstrap/omega_callgraph.c bootstrap/omega_scope.c bootstrap/omega_pipeline.c
+//          bootstrap/omega_loader.c bootstrap/omega_parsecache.c bootstrap/omega_profile.c
+//          bootstrap/omega_trace.c bootstrap/omega_object.c bootstrap/omega_codegen.c
+//          -pthread -fno-omit-frame-pointer
+//          (add -DOMEGA_TRACE for OMEGA_TRACE_FILE trace events)
 
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 
-// Token types for OMEGA lexer
+#include "omega_intern.h"
+#include "omega_lexer.h"
+#include "omega_keccak.h"
+#include "omega_utf8.h"
+#include "omega_modules.h"
+#include "omega_watch.h"
+#include "omega_interface.h"
+#include "omega_layout.h"
+#include "omega_peephole.h"
+#include "omega_callgraph.h"
+#include "omega_scope.h"
+#include "omega_pipeline.h"
+#include "omega_loader.h"
+#include "omega_parsecache.h"
+#include "omega_profile.h"
+#include "omega_trace.h"
+#include "omega_object.h"
+#include "omega_codegen.h"
+
 typedef enum {
-    TOK_EOF,
-    TOK_IDENTIFIER,
-    TOK_KEYWORD,
-    TOK_NUMBER,
-    TOK_STRING,
-    TOK_LPAREN,
-    TOK_RPAREN,
-    TOK_LBRACE,
-    TOK_RBRACE,
-    TOK_LBRACKET,
-    TOK_RBRACKET,
-    TOK_SEMICOLON,
-    TOK_COMMA,
-    TOK_DOT,
-    TOK_COLON,
-    TOK_ARROW,
-    TOK_PLUS,
-    TOK_MINUS,
-    TOK_STAR,
-    TOK_SLASH,
-    TOK_PERCENT,
-    TOK_EQ,
-    TOK_EQEQ,
-    TOK_NEQ,
-    TOK_LT,
-    TOK_GT,
-    TOK_LTE,
-    TOK_GTE,
-    TOK_AMP,
-    TOK_PIPE,
-    TOK_CARET,
-    TOK_TILDE,
-    TOK_QUESTION,
-    TOK_ERROR,
-    TOK_COMMENT
-} TokenType;
+    DECL_FUNCTION,
+    DECL_EVENT
+} FunctionKind;
+
+// Function or event declaration collected while parsing. The signature is
+// the canonical ABI form, e.g. "transfer(address,uint256)".
+typedef struct {
+    const char* name;
+    uint32_t signature_id;
+    FunctionKind kind;
+    bool is_public;
+    int line;
+    const char* owner;      // enclosing blockchain/contract, NULL at top level
+    int body_start;         // body tokens [body_start, body_end); empty if none
+    int body_end;
+    int decl_start;         // whole declaration [decl_start, decl_end)
+    int decl_end;
+} FunctionDecl;
+
+// Struct or top-level type (blockchain, contract, library, enum). Struct
+// signatures list the field types, e.g. "Point(uint256,uint256)".
+typedef struct {
+    const char* name;
+    uint32_t signature_id;
+    SymbolKind kind;
+    bool is_enum;
+    int line;
+    const char* owner;      // enclosing blockchain/contract, NULL at top level
+    int decl_start;         // struct declaration tokens [decl_start, decl_end)
+    int decl_end;
+} TypeDecl;
 
+// Field of a struct or state block, e.g. "uint128 balance;" or "owner: address,".
 typedef struct {
-    TokenType type;
-    const char* value;
+    const char* name;
+    const char* type;       // interned canonical type, e.g. "mapping(address=>uint256)"
     int line;
-    int column;
-} Token;
+} FieldDecl;
 
+// Struct or "state { ... }" block whose fields occupy contract storage.
+// Fields are Parser.fields[first_field, first_field + field_count).
 typedef struct {
-    const char* source;
-    int position;
+    const char* name;       // struct name, or the owning contract for state
+    bool is_state;
+    bool packable;          // false when annotated @nopack
+    int first_field;
+    int field_count;
     int line;
-    int column;
-    int length;
-} Lexer;
+} StorageDecl;
+
+// Import statement; names listed in "import { A, B } from ..." are stored
+// in Parser.import_names[first_name, first_name + name_count).
+typedef struct {
+    const char* spec;       // as written, e.g. "std::io"
+    int first_name;
+    int name_count;
+    int line;
+    const ModuleInterface* iface;   // once resolved; owned by the resolver
+} ImportDecl;
+
+// Returns the interface of an imported module, or NULL if it cannot be
+// resolved. The parser does not own the result.
+typedef const ModuleInterface* (*ImportResolver)(void* context, const char* spec);
+
+// Appends the next tokens of a streamed module to `out` and returns how many,
+// or 0 at the end; the source never exceeds the token buffer's capacity.
+typedef int (*TokenSource)(void* context, Token* out);
 
 typedef struct {
     Token* tokens;
     int token_count;
     int current;
     int errors;
+    InternTable* interns;
+    FunctionDecl* functions;
+    int function_count;
+    int function_capacity;
+    int struct_count;
+    TypeDecl* types;
+    int type_count;
+    int type_capacity;
+    FieldDecl* fields;
+    int field_count;
+    int field_capacity;
+    StorageDecl* storage;
+    int storage_count;
+    int storage_capacity;
+    const char* owner;          // blockchain/contract being parsed
+    int owner_depth;            // brace depth of its body
+    int depth;                  // brace depth seen by parse_module
+    bool no_pack;               // pending @nopack annotation
+    ImportDecl* imports;
+    int import_count;
+    int import_capacity;
+    const char** import_names;
+    int import_name_count;
+    int import_name_capacity;
+    ImportResolver resolver;    // optional
+    void* resolver_context;
+    int resolved_imports;       // imports whose interface was found
+    int imported_symbols;       // symbols made visible by those imports
+    TokenSource pull;           // optional: tokens still arriving (--pipeline)
+    void* pull_context;
 } Parser;
 
+#define SIGNATURE_MAX 1024
+
 // ============================================================================
-// LEXER IMPLEMENTATION
+// PARSER IMPLEMENTATION
 // ============================================================================
 
-Lexer create_lexer(const char* source) {
-    Lexer lexer;
-    lexer.source = source;
-    lexer.position = 0;
-    lexer.line = 1;
-    lexer.column = 1;
-    lexer.length = strlen(source);
-    return lexer;
+Parser create_parser(Token* tokens, int token_count, InternTable* interns) {
+    Parser parser;
+    parser.tokens = tokens;
+    parser.token_count = token_count;
+    parser.current = 0;
+    parser.errors = 0;
+    parser.interns = interns;
+    parser.functions = NULL;
+    parser.function_count = 0;
+    parser.function_capacity = 0;
+    parser.struct_count = 0;
+    parser.types = NULL;
+    parser.type_count = 0;
+    parser.type_capacity = 0;
+    parser.fields = NULL;
+    parser.field_count = 0;
+    parser.field_capacity = 0;
+    parser.storage = NULL;
+    parser.storage_count = 0;
+    parser.storage_capacity = 0;
+    parser.owner = NULL;
+    parser.owner_depth = 0;
+    parser.depth = 0;
+    parser.no_pack = false;
+    parser.imports = NULL;
+    parser.import_count = 0;
+    parser.import_capacity = 0;
+    parser.import_names = NULL;
+    parser.import_name_count = 0;
+    parser.import_name_capacity = 0;
+    parser.resolver = NULL;
+    parser.resolver_context = NULL;
+    parser.resolved_imports = 0;
+    parser.imported_symbols = 0;
+    parser.pull = NULL;
+    parser.pull_context = NULL;
+    return parser;
 }
 
-char peek(Lexer* lexer, int offset) {
-    int pos = lexer->position + offset;
-    if (pos >= lexer->length) {
-        return '\0';
-    }
-    return lexer->source[pos];
+void free_parser(Parser* parser) {
+    free(parser->functions);
+    free(parser->types);
+    free(parser->fields);
+    free(parser->storage);
+    free(parser->imports);
+    free(parser->import_names);
+    parser->functions = NULL;
+    parser->function_count = 0;
+    parser->function_capacity = 0;
+    parser->types = NULL;
+    parser->type_count = 0;
+    parser->type_capacity = 0;
+    parser->fields = NULL;
+    parser->field_count = 0;
+    parser->field_capacity = 0;
+    parser->storage = NULL;
+    parser->storage_count = 0;
+    parser->storage_capacity = 0;
+    parser->imports = NULL;
+    parser->import_count = 0;
+    parser->import_capacity = 0;
+    parser->import_names = NULL;
+    parser->import_name_count = 0;
+    parser->import_name_capacity = 0;
 }
 
-char advance(Lexer* lexer) {
-    if (lexer->position >= lexer->length) {
-        return '\0';
-    }
-    
-    char ch = lexer->source[lexer->position];
-    lexer->position++;
-    
-    if (ch == '\n') {
-        lexer->line++;
-        lexer->column = 1;
-    } else {
-        lexer->column++;
+// True if tokens[index] exists, pulling streamed tokens up to it if needed.
+bool has_token(Parser* parser, int index) {
+    while (index >= parser->token_count && parser->pull) {
+        int added = parser->pull(parser->pull_context, parser->tokens + parser->token_count);
+        if (added <= 0) {
+            parser->pull = NULL;
+            break;
+        }
+        parser->token_count += added;
     }
-    
-    return ch;
+    return index < parser->token_count;
 }
 
-void skip_whitespace(Lexer* lexer) {
-    while (isspace(peek(lexer, 0))) {
-        advance(lexer);
+Token peek_token(Parser* parser) {
+    if (!has_token(parser, parser->current)) {
+        Token eof;
+        eof.type = TOK_EOF;
+        eof.value = "";
+        eof.line = 0;
+        eof.column = 0;
+        return eof;
     }
+    return parser->tokens[parser->current];
 }
 
-void skip_line_comment(Lexer* lexer) {
-    // Skip // comments
-    while (peek(lexer, 0) != '\n' && peek(lexer, 0) != '\0') {
-        advance(lexer);
+Token advance_token(Parser* parser) {
+    if (!has_token(parser, parser->current)) {
+        Token eof;
+        eof.type = TOK_EOF;
+        eof.value = "";
+        eof.line = 0;
+        eof.column = 0;
+        return eof;
     }
+    return parser->tokens[parser->current++];
 }
 
-void skip_block_comment(Lexer* lexer) {
-    // Skip /* */ comments
-    advance(lexer); // Skip /
-    advance(lexer); // Skip *
-    
-    while (!(peek(lexer, 0) == '*' && peek(lexer, 1) == '/')) {
-        if (peek(lexer, 0) == '\0') {
-            break;
+void add_function(Parser* parser, const Token* name, const char* signature,
+                  FunctionKind kind, bool is_public) {
+    if (parser->function_count == parser->function_capacity) {
+        int capacity = parser->function_capacity ? parser->function_capacity * 2 : 64;
+        FunctionDecl* functions = realloc(parser->functions, sizeof(FunctionDecl) * capacity);
+        if (!functions) {
+            fprintf(stderr, "Error: Cannot allocate function table\n");
+            parser->errors++;
+            return;
         }
-        advance(lexer);
-    }
-    
-    if (peek(lexer, 0) == '*') {
-        advance(lexer);
-        advance(lexer);
+        parser->functions = functions;
+        parser->function_capacity = capacity;
     }
+
+    FunctionDecl* decl = &parser->functions[parser->function_count++];
+    decl->name = name->value;
+    decl->signature_id = intern_cstr(parser->interns, signature);
+    decl->kind = kind;
+    decl->is_public = is_public;
+    decl->line = name->line;
+    decl->owner = parser->owner;
+    decl->body_start = 0;
+    decl->body_end = 0;
+    decl->decl_start = 0;
+    decl->decl_end = 0;
 }
 
-Token read_string(Lexer* lexer) {
-    Token token;
-    token.type = TOK_STRING;
-    token.line = lexer->line;
-    token.column = lexer->column;
-    
-    advance(lexer); // Skip opening quote
-    
-    int start = lexer->position;
-    while (peek(lexer, 0) != '"' && peek(lexer, 0) != '\0') {
-        if (peek(lexer, 0) == '\\') {
-            advance(lexer); // Skip escape char
+void add_type(Parser* parser, const Token* name, const char* signature, SymbolKind kind) {
+    if (parser->type_count == parser->type_capacity) {
+        int capacity = parser->type_capacity ? parser->type_capacity * 2 : 32;
+        TypeDecl* types = realloc(parser->types, sizeof(TypeDecl) * capacity);
+        if (!types) {
+            fprintf(stderr, "Error: Cannot allocate type table\n");
+            parser->errors++;
+            return;
         }
-        advance(lexer);
-    }
-    
-    int length = lexer->position - start;
-    char* value = malloc(length + 1);
-    strncpy(value, lexer->source + start, length);
-    value[length] = '\0';
-    
-    token.value = value;
-    
-    if (peek(lexer, 0) == '"') {
-        advance(lexer); // Skip closing quote
+        parser->types = types;
+        parser->type_capacity = capacity;
     }
-    
-    return token;
+
+    TypeDecl* decl = &parser->types[parser->type_count++];
+    decl->name = name->value;
+    decl->signature_id = intern_cstr(parser->interns, signature);
+    decl->kind = kind;
+    decl->is_enum = false;
+    decl->line = name->line;
+    decl->owner = parser->owner;
+    decl->decl_start = 0;
+    decl->decl_end = 0;
 }
 
-Token read_number(Lexer* lexer) {
-    Token token;
-    token.type = TOK_NUMBER;
-    token.line = lexer->line;
-    token.column = lexer->column;
-    
-    int start = lexer->position;
-    
-    while (isdigit(peek(lexer, 0)) || peek(lexer, 0) == '.') {
-        advance(lexer);
-    }
-    
-    // Handle hex (0x), binary (0b), octal (0o)
-    if (start < lexer->position && lexer->source[start] == '0') {
-        if (peek(lexer, 0) == 'x' || peek(lexer, 0) == 'X' ||
-            peek(lexer, 0) == 'b' || peek(lexer, 0) == 'B' ||
-            peek(lexer, 0) == 'o' || peek(lexer, 0) == 'O') {
-            advance(lexer);
-            while (isxdigit(peek(lexer, 0))) {
-                advance(lexer);
-            }
+void append_signature(char* signature, int* length, const char* text) {
+    int written = snprintf(signature + *length, SIGNATURE_MAX - *length, "%s", text);
+    if (written > 0) {
+        *length += written;
+        if (*length >= SIGNATURE_MAX) {
+            *length = SIGNATURE_MAX - 1;
         }
     }
-    
-    int length = lexer->position - start;
-    char* value = malloc(length + 1);
-    strncpy(value, lexer->source + start, length);
-    value[length] = '\0';
-    
-    token.value = value;
-    return token;
 }
 
-bool is_keyword(const char* word) {
-    static const char* keywords[] = {
-        "function", "public", "private", "returns", "struct", "enum",
-        "if", "else", "for", "while", "match", "import", "export",
-        "const", "let", "var", "true", "false", "null", "return",
-        "break", "continue", "new", "delete", "sizeof", "typeof",
-        "as", "is", "in", "where", "contract", "emit", "event",
-        NULL
-    };
-    
-    for (int i = 0; keywords[i] != NULL; i++) {
-        if (strcmp(word, keywords[i]) == 0) {
-            return true;
+bool is_data_location(const char* word) {
+    return strcmp(word, "memory") == 0 || strcmp(word, "storage") == 0 ||
+           strcmp(word, "calldata") == 0 || strcmp(word, "indexed") == 0 ||
+           strcmp(word, "payable") == 0;
+}
+
+// Append the canonical ABI type of tokens[start, end) to the signature.
+// Accepts both "type [location] name" and "name: type" parameters.
+void append_parameter_type(Parser* parser, int start, int end, char* signature, int* length) {
+    for (int i = start; i < end; i++) {
+        if (parser->tokens[i].type == TOK_COLON) {
+            start = i + 1;
+            break;
         }
     }
-    
-    return false;
-}
 
-Token read_identifier(Lexer* lexer) {
-    Token token;
-    token.line = lexer->line;
-    token.column = lexer->column;
-    
-    int start = lexer->position;
-    
-    while (isalnum(peek(lexer, 0)) || peek(lexer, 0) == '_') {
-        advance(lexer);
+    int last = end - 1;
+    if (last > start && parser->tokens[last].type == TOK_IDENTIFIER &&
+        !is_data_location(parser->tokens[last].value)) {
+        end = last; // drop the parameter name
     }
-    
-    int length = lexer->position - start;
-    char* value = malloc(length + 1);
-    strncpy(value, lexer->source + start, length);
-    value[length] = '\0';
-    
-    if (is_keyword(value)) {
-        token.type = TOK_KEYWORD;
-    } else {
-        token.type = TOK_IDENTIFIER;
+
+    for (int i = start; i < end; i++) {
+        Token* token = &parser->tokens[i];
+        if ((token->type == TOK_IDENTIFIER || token->type == TOK_KEYWORD) &&
+            is_data_location(token->value)) {
+            continue;
+        }
+        append_signature(signature, length, token->value);
     }
-    
-    token.value = value;
-    return token;
 }
 
-Token next_token(Lexer* lexer) {
-    skip_whitespace(lexer);
-    
-    // Check for EOF
-    if (peek(lexer, 0) == '\0') {
-        Token token;
-        token.type = TOK_EOF;
-        token.value = "";
-        token.line = lexer->line;
-        token.column = lexer->column;
-        return token;
-    }
-    
-    // Check for comments
-    if (peek(lexer, 0) == '/' && peek(lexer, 1) == '/') {
-        skip_line_comment(lexer);
-        return next_token(lexer);
-    }
-    
-    if (peek(lexer, 0) == '/' && peek(lexer, 1) == '*') {
-        skip_block_comment(lexer);
-        return next_token(lexer);
+// Parse "( params )" and append "(type,type)" to the signature.
+void parse_parameters(Parser* parser, char* signature, int* length) {
+    advance_token(parser); // (
+    append_signature(signature, length, "(");
+
+    int depth = 0;
+    int param_start = parser->current;
+    int param_count = 0;
+
+    while (peek_token(parser).type != TOK_EOF) {
+        TokenType type = peek_token(parser).type;
+
+        if (depth == 0 && (type == TOK_COMMA || type == TOK_RPAREN)) {
+            if (parser->current > param_start) {
+                if (param_count++ > 0) {
+                    append_signature(signature, length, ",");
+                }
+                append_parameter_type(parser, param_start, parser->current, signature, length);
+            }
+            advance_token(parser);
+            if (type == TOK_RPAREN) {
+                break;
+            }
+            param_start = parser->current;
+            continue;
+        }
+
+        if (type == TOK_LPAREN || type == TOK_LBRACKET) {
+            depth++;
+        } else if ((type == TOK_RPAREN || type == TOK_RBRACKET) && depth > 0) {
+            depth--;
+        }
+        advance_token(parser);
     }
-    
-    char ch = peek(lexer, 0);
-    Token token;
-    token.line = lexer->line;
-    token.column = lexer->column;
-    
-    // Single character tokens
-    if (ch == '(') {
-        token.type = TOK_LPAREN;
-        token.value = "(";
-        advance(lexer);
-        return token;
-    }
-    if (ch == ')') {
-        token.type = TOK_RPAREN;
-        token.value = ")";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '{') {
-        token.type = TOK_LBRACE;
-        token.value = "{";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '}') {
-        token.type = TOK_RBRACE;
-        token.value = "}";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '[') {
-        token.type = TOK_LBRACKET;
-        token.value = "[";
-        advance(lexer);
-        return token;
-    }
-    if (ch == ']') {
-        token.type = TOK_RBRACKET;
-        token.value = "]";
-        advance(lexer);
-        return token;
-    }
-    if (ch == ';') {
-        token.type = TOK_SEMICOLON;
-        token.value = ";";
-        advance(lexer);
-        return token;
-    }
-    if (ch == ',') {
-        token.type = TOK_COMMA;
-        token.value = ",";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '.') {
-        token.type = TOK_DOT;
-        token.value = ".";
-        advance(lexer);
-        return token;
-    }
-    if (ch == ':') {
-        token.type = TOK_COLON;
-        token.value = ":";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '+') {
-        token.type = TOK_PLUS;
-        token.value = "+";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '-') {
-        if (peek(lexer, 1) == '>') {
-            token.type = TOK_ARROW;
-            token.value = "->";
-            advance(lexer);
-            advance(lexer);
-            return token;
-        }
-        token.type = TOK_MINUS;
-        token.value = "-";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '*') {
-        token.type = TOK_STAR;
-        token.value = "*";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '/') {
-        token.type = TOK_SLASH;
-        token.value = "/";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '%') {
-        token.type = TOK_PERCENT;
-        token.value = "%";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '=') {
-        if (peek(lexer, 1) == '=') {
-            token.type = TOK_EQEQ;
-            token.value = "==";
-            advance(lexer);
-            advance(lexer);
-            return token;
-        }
-        token.type = TOK_EQ;
-        token.value = "=";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '!') {
-        if (peek(lexer, 1) == '=') {
-            token.type = TOK_NEQ;
-            token.value = "!=";
-            advance(lexer);
-            advance(lexer);
-            return token;
-        }
-        advance(lexer);
-        token.type = TOK_ERROR;
-        token.value = "!";
-        return token;
-    }
-    if (ch == '<') {
-        if (peek(lexer, 1) == '=') {
-            token.type = TOK_LTE;
-            token.value = "<=";
-            advance(lexer);
-            advance(lexer);
-            return token;
-        }
-        token.type = TOK_LT;
-        token.value = "<";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '>') {
-        if (peek(lexer, 1) == '=') {
-            token.type = TOK_GTE;
-            token.value = ">=";
-            advance(lexer);
-            advance(lexer);
-            return token;
-        }
-        token.type = TOK_GT;
-        token.value = ">";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '&') {
-        token.type = TOK_AMP;
-        token.value = "&";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '|') {
-        token.type = TOK_PIPE;
-        token.value = "|";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '^') {
-        token.type = TOK_CARET;
-        token.value = "^";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '~') {
-        token.type = TOK_TILDE;
-        token.value = "~";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '?') {
-        token.type = TOK_QUESTION;
-        token.value = "?";
-        advance(lexer);
-        return token;
-    }
-    if (ch == '"') {
-        return read_string(lexer);
-    }
-    if (isdigit(ch)) {
-        return read_number(lexer);
-    }
-    if (isalpha(ch) || ch == '_') {
-        return read_identifier(lexer);
-    }
-    
-    // Unknown character
-    token.type = TOK_ERROR;
-    char error_str[2] = {ch, '\0'};
-    token.value = strdup(error_str);
-    advance(lexer);
-    return token;
+
+    append_signature(signature, length, ")");
 }
 
-// ============================================================================
-// PARSER IMPLEMENTATION
-// ============================================================================
+void skip_balanced(Parser* parser, TokenType open, TokenType close) {
+    advance_token(parser); // opening token
+    int depth = 1;
 
-Parser create_parser(Token* tokens, int token_count) {
-    Parser parser;
-    parser.tokens = tokens;
-    parser.token_count = token_count;
-    parser.current = 0;
-    parser.errors = 0;
-    return parser;
+    while (depth > 0 && peek_token(parser).type != TOK_EOF) {
+        if (peek_token(parser).type == open) {
+            depth++;
+        } else if (peek_token(parser).type == close) {
+            depth--;
+        }
+        advance_token(parser);
+    }
 }
 
-Token peek_token(Parser* parser) {
-    if (parser->current >= parser->token_count) {
-        Token eof;
-        eof.type = TOK_EOF;
-        eof.value = "";
-        return eof;
+void add_import_name(Parser* parser, const char* name) {
+    if (parser->import_name_count == parser->import_name_capacity) {
+        int capacity = parser->import_name_capacity ? parser->import_name_capacity * 2 : 16;
+        const char** names = realloc(parser->import_names, sizeof(const char*) * capacity);
+        if (!names) {
+            fprintf(stderr, "Error: Cannot allocate import table\n");
+            parser->errors++;
+            return;
+        }
+        parser->import_names = names;
+        parser->import_name_capacity = capacity;
     }
-    return parser->tokens[parser->current];
+    parser->import_names[parser->import_name_count++] = name;
 }
 
-Token advance_token(Parser* parser) {
-    if (parser->current >= parser->token_count) {
-        Token eof;
-        eof.type = TOK_EOF;
-        eof.value = "";
-        return eof;
+void add_import(Parser* parser, const char* spec, int first_name, int line) {
+    if (parser->import_count == parser->import_capacity) {
+        int capacity = parser->import_capacity ? parser->import_capacity * 2 : 16;
+        ImportDecl* imports = realloc(parser->imports, sizeof(ImportDecl) * capacity);
+        if (!imports) {
+            fprintf(stderr, "Error: Cannot allocate import table\n");
+            parser->errors++;
+            return;
+        }
+        parser->imports = imports;
+        parser->import_capacity = capacity;
+    }
+    ImportDecl* import = &parser->imports[parser->import_count++];
+    import->spec = intern_text(parser->interns, intern_cstr(parser->interns, spec));
+    import->first_name = first_name;
+    import->name_count = parser->import_name_count - first_name;
+    import->line = line;
+    import->iface = NULL;
+}
+
+// Check the imported names against the module's interface.
+void resolve_import_names(Parser* parser, ImportDecl* import) {
+    if (!parser->resolver) {
+        return;
+    }
+    const ModuleInterface* iface = parser->resolver(parser->resolver_context, import->spec);
+    if (!iface) {
+        return;
+    }
+    import->iface = iface;
+    parser->resolved_imports++;
+
+    if (import->name_count == 0) {
+        parser->imported_symbols += (int)iface->header->symbol_count;
+        return;
+    }
+    for (int i = 0; i < import->name_count; i++) {
+        const char* name = parser->import_names[import->first_name + i];
+        if (interface_find(iface, name) >= 0) {
+            parser->imported_symbols++;
+        } else {
+            fprintf(stderr, "⚠️  Warning: '%s' is not declared in %s (line %d)\n",
+                    name, import->spec, import->line);
+        }
     }
-    return parser->tokens[parser->current++];
 }
 
+// Accepted forms:
+//   import "path/to/module.mega" [as Alias];
+//   import std::io;
+//   import { Name, Other } from "path";
 void parse_import(Parser* parser) {
-    advance_token(parser); // import
+    int line = advance_token(parser).line; // import
+    int first_name = parser->import_name_count;
+    
+    if (peek_token(parser).type == TOK_LBRACE) {
+        // Imported names; "Name as Alias" imports Name
+        advance_token(parser);
+        bool aliased = false;
+        while (peek_token(parser).type != TOK_RBRACE && peek_token(parser).type != TOK_EOF) {
+            Token token = advance_token(parser);
+            if (token.type == TOK_KEYWORD && strcmp(token.value, "as") == 0) {
+                aliased = true;
+            } else if (token.type == TOK_IDENTIFIER && !aliased) {
+                add_import_name(parser, token.value);
+            } else if (token.type == TOK_COMMA) {
+                aliased = false;
+            }
+        }
+        if (peek_token(parser).type == TOK_RBRACE) {
+            advance_token(parser);
+        }
+        if (peek_token(parser).type == TOK_IDENTIFIER &&
+            strcmp(peek_token(parser).value, "from") == 0) {
+            advance_token(parser);
+        }
+    }
     
-    if (peek_token(parser).type != TOK_STRING) {
-        fprintf(stderr, "Error: Expected string after import\n");
+    Token token = peek_token(parser);
+    if (token.type == TOK_STRING) {
+        advance_token(parser); // string
+        add_import(parser, token.value, first_name, line);
+    } else if (token.type == TOK_IDENTIFIER || token.type == TOK_KEYWORD) {
+        // Module path: ident { "::" ident }
+        char spec[SIGNATURE_MAX];
+        int length = 0;
+        spec[0] = '\0';
+        append_signature(spec, &length, advance_token(parser).value);
+        
+        while (peek_token(parser).type == TOK_COLON &&
+               has_token(parser, parser->current + 2) &&
+               parser->tokens[parser->current + 1].type == TOK_COLON) {
+            advance_token(parser);
+            advance_token(parser);
+            if (peek_token(parser).type != TOK_IDENTIFIER && peek_token(parser).type != TOK_KEYWORD) {
+                break;
+            }
+            append_signature(spec, &length, "::");
+            append_signature(spec, &length, advance_token(parser).value);
+        }
+        add_import(parser, spec, first_name, line);
+    } else {
+        fprintf(stderr, "Error: Expected module path after import (line %d)\n", token.line);
         parser->errors++;
         return;
     }
     
-    advance_token(parser); // string
+    // Optional alias
+    if (peek_token(parser).type == TOK_KEYWORD && strcmp(peek_token(parser).value, "as") == 0) {
+        advance_token(parser);
+        if (peek_token(parser).type == TOK_IDENTIFIER) {
+            advance_token(parser);
+        }
+    }
     
     if (peek_token(parser).type == TOK_SEMICOLON) {
         advance_token(parser);
     }
+    
+    if (parser->import_count > 0) {
+        resolve_import_names(parser, &parser->imports[parser->import_count - 1]);
+    }
 }
 
 void parse_function(Parser* parser) {
+    int decl_start = parser->current;
     advance_token(parser); // function
     
-    if (peek_token(parser).type != TOK_IDENTIFIER) {
+    // Keywords are allowed as function names, e.g. "function match(...)"
+    if (peek_token(parser).type != TOK_IDENTIFIER && peek_token(parser).type != TOK_KEYWORD) {
         fprintf(stderr, "Error: Expected function name\n");
         parser->errors++;
         return;
     }
     
-    advance_token(parser); // name
+    Token name = advance_token(parser); // name
     
     if (peek_token(parser).type != TOK_LPAREN) {
         fprintf(stderr, "Error: Expected ( after function name\n");
@@ -545,64 +561,202 @@ void parse_function(Parser* parser) {
         return;
     }
     
-    advance_token(parser); // (
+    // Parse parameters into the canonical signature
+    char signature[SIGNATURE_MAX];
+    int length = 0;
+    signature[0] = '\0';
+    append_signature(signature, &length, name.value);
+    parse_parameters(parser, signature, &length);
     
-    // Parse parameters
-    while (peek_token(parser).type != TOK_RPAREN && peek_token(parser).type != TOK_EOF) {
-        if (peek_token(parser).type == TOK_IDENTIFIER) {
-            advance_token(parser);
-        }
+    // Parse visibility, modifiers and return type
+    bool is_public = false;
+    while (peek_token(parser).type == TOK_KEYWORD || peek_token(parser).type == TOK_IDENTIFIER) {
+        Token modifier = advance_token(parser);
         
-        if (peek_token(parser).type == TOK_COLON) {
-            advance_token(parser);
-            
-            if (peek_token(parser).type == TOK_IDENTIFIER) {
-                advance_token(parser);
-            }
+        if (strcmp(modifier.value, "public") == 0 || strcmp(modifier.value, "external") == 0) {
+            is_public = true;
         }
         
-        if (peek_token(parser).type == TOK_COMMA) {
-            advance_token(parser);
+        if (peek_token(parser).type == TOK_LPAREN) {
+            skip_balanced(parser, TOK_LPAREN, TOK_RPAREN);
         }
     }
     
-    if (peek_token(parser).type == TOK_RPAREN) {
+    add_function(parser, &name, signature, DECL_FUNCTION, is_public);
+    
+    // Parse function body; its token range feeds the gas estimate
+    int body_start = 0;
+    int body_end = 0;
+    if (peek_token(parser).type == TOK_LBRACE) {
+        body_start = parser->current + 1;
+        skip_balanced(parser, TOK_LBRACE, TOK_RBRACE);
+        body_end = parser->current - 1;
+    } else if (peek_token(parser).type == TOK_SEMICOLON) {
         advance_token(parser);
     }
+    if (parser->function_count > 0) {
+        FunctionDecl* decl = &parser->functions[parser->function_count - 1];
+        decl->body_start = body_start;
+        decl->body_end = body_end;
+        decl->decl_start = decl_start;
+        decl->decl_end = parser->current;
+    }
+}
+
+void parse_event(Parser* parser) {
+    advance_token(parser); // event
+    
+    if (peek_token(parser).type != TOK_IDENTIFIER) {
+        fprintf(stderr, "Error: Expected event name\n");
+        parser->errors++;
+        return;
+    }
+    
+    Token name = advance_token(parser); // name
+    
+    char signature[SIGNATURE_MAX];
+    int length = 0;
+    signature[0] = '\0';
+    append_signature(signature, &length, name.value);
+    
+    if (peek_token(parser).type == TOK_LPAREN) {
+        parse_parameters(parser, signature, &length);
+    } else {
+        append_signature(signature, &length, "()");
+    }
+    
+    add_function(parser, &name, signature, DECL_EVENT, true);
     
-    // Parse return type
-    if (peek_token(parser).type == TOK_IDENTIFIER &&
-        strcmp(peek_token(parser).value, "returns") == 0) {
+    if (peek_token(parser).type == TOK_SEMICOLON) {
         advance_token(parser);
-        
-        if (peek_token(parser).type == TOK_LPAREN) {
-            advance_token(parser);
-            while (peek_token(parser).type != TOK_RPAREN && peek_token(parser).type != TOK_EOF) {
-                advance_token(parser);
-            }
-            if (peek_token(parser).type == TOK_RPAREN) {
-                advance_token(parser);
-            }
+    }
+}
+
+// Append the field declared by tokens[start, end) to parser->fields.
+// Accepts "type [visibility] name [= value]" and "name: type"; constants
+// take no storage and are skipped.
+void add_field(Parser* parser, int start, int end) {
+    int depth = 0;
+    int colon = -1;
+    for (int i = start; i < end; i++) {
+        TokenType type = parser->tokens[i].type;
+        if (type == TOK_LPAREN || type == TOK_LBRACKET) {
+            depth++;
+        } else if (type == TOK_RPAREN || type == TOK_RBRACKET) {
+            depth--;
+        } else if (depth == 0 && type == TOK_EQ) {
+            end = i; // initializer
+            break;
+        } else if (depth == 0 && type == TOK_COLON && colon < 0) {
+            colon = i;
+        }
+        if ((type == TOK_IDENTIFIER || type == TOK_KEYWORD) &&
+            (strcmp(parser->tokens[i].value, "constant") == 0 ||
+             strcmp(parser->tokens[i].value, "immutable") == 0)) {
+            return;
         }
     }
     
-    // Parse function body
-    if (peek_token(parser).type == TOK_LBRACE) {
-        advance_token(parser);
-        int brace_depth = 1;
-        
-        while (brace_depth > 0 && peek_token(parser).type != TOK_EOF) {
-            if (peek_token(parser).type == TOK_LBRACE) {
-                brace_depth++;
-            } else if (peek_token(parser).type == TOK_RBRACE) {
-                brace_depth--;
+    const Token* name;
+    int type_start = start;
+    int type_end = end;
+    if (colon > start) {
+        name = &parser->tokens[start];
+        type_start = colon + 1;
+    } else {
+        name = &parser->tokens[end - 1];
+        type_end = end - 1;
+    }
+    if (name->type != TOK_IDENTIFIER || type_start >= type_end) {
+        return;
+    }
+    
+    char type[SIGNATURE_MAX];
+    int length = 0;
+    type[0] = '\0';
+    for (int i = type_start; i < type_end; i++) {
+        const char* word = parser->tokens[i].value;
+        if (strcmp(word, "public") == 0 || strcmp(word, "private") == 0 ||
+            strcmp(word, "internal") == 0 || is_data_location(word)) {
+            continue;
+        }
+        append_signature(type, &length, word);
+    }
+    
+    if (parser->field_count == parser->field_capacity) {
+        int capacity = parser->field_capacity ? parser->field_capacity * 2 : 64;
+        FieldDecl* fields = realloc(parser->fields, sizeof(FieldDecl) * capacity);
+        if (!fields) {
+            fprintf(stderr, "Error: Cannot allocate field table\n");
+            parser->errors++;
+            return;
+        }
+        parser->fields = fields;
+        parser->field_capacity = capacity;
+    }
+    FieldDecl* field = &parser->fields[parser->field_count++];
+    field->name = name->value;
+    field->type = intern_text(parser->interns, intern_cstr(parser->interns, type));
+    field->line = name->line;
+}
+
+// Parse "{ field; field; }" into a storage declaration. Fields are
+// separated by ';' or ',' at brace depth 1.
+void parse_storage_block(Parser* parser, const char* name, bool is_state, int line) {
+    int first_field = parser->field_count;
+    bool packable = !parser->no_pack;
+    parser->no_pack = false;
+    
+    if (peek_token(parser).type != TOK_LBRACE) {
+        return;
+    }
+    advance_token(parser);
+    
+    int depth = 0;
+    int field_start = parser->current;
+    while (peek_token(parser).type != TOK_EOF) {
+        TokenType type = peek_token(parser).type;
+        if (depth == 0 && (type == TOK_SEMICOLON || type == TOK_COMMA || type == TOK_RBRACE)) {
+            if (parser->current > field_start) {
+                add_field(parser, field_start, parser->current);
             }
             advance_token(parser);
+            if (type == TOK_RBRACE) {
+                break;
+            }
+            field_start = parser->current;
+            continue;
+        }
+        if (type == TOK_LBRACE || type == TOK_LPAREN || type == TOK_LBRACKET) {
+            depth++;
+        } else if ((type == TOK_RBRACE || type == TOK_RPAREN || type == TOK_RBRACKET) && depth > 0) {
+            depth--;
         }
+        advance_token(parser);
     }
+    
+    if (parser->storage_count == parser->storage_capacity) {
+        int capacity = parser->storage_capacity ? parser->storage_capacity * 2 : 16;
+        StorageDecl* storage = realloc(parser->storage, sizeof(StorageDecl) * capacity);
+        if (!storage) {
+            fprintf(stderr, "Error: Cannot allocate storage table\n");
+            parser->errors++;
+            return;
+        }
+        parser->storage = storage;
+        parser->storage_capacity = capacity;
+    }
+    StorageDecl* decl = &parser->storage[parser->storage_count++];
+    decl->name = name;
+    decl->is_state = is_state;
+    decl->packable = packable;
+    decl->first_field = first_field;
+    decl->field_count = parser->field_count - first_field;
+    decl->line = line;
 }
 
 void parse_struct(Parser* parser) {
+    int decl_start = parser->current;
     advance_token(parser); // struct
     
     if (peek_token(parser).type != TOK_IDENTIFIER) {
@@ -611,18 +765,64 @@ void parse_struct(Parser* parser) {
         return;
     }
     
-    advance_token(parser); // name
+    Token name = advance_token(parser); // name
+    parser->struct_count++;
     
-    if (peek_token(parser).type == TOK_LBRACE) {
-        advance_token(parser);
-        
-        while (peek_token(parser).type != TOK_RBRACE && peek_token(parser).type != TOK_EOF) {
-            advance_token(parser);
+    int first_field = parser->field_count;
+    parse_storage_block(parser, name.value, false, name.line);
+    
+    char signature[SIGNATURE_MAX];
+    int length = 0;
+    signature[0] = '\0';
+    append_signature(signature, &length, name.value);
+    append_signature(signature, &length, "(");
+    for (int i = first_field; i < parser->field_count; i++) {
+        if (i > first_field) {
+            append_signature(signature, &length, ",");
         }
-        
-        if (peek_token(parser).type == TOK_RBRACE) {
-            advance_token(parser);
+        append_signature(signature, &length, parser->fields[i].type);
+    }
+    append_signature(signature, &length, ")");
+    add_type(parser, &name, signature, SYMBOL_STRUCT);
+    if (parser->type_count > 0) {
+        parser->types[parser->type_count - 1].decl_start = decl_start;
+        parser->types[parser->type_count - 1].decl_end = parser->current;
+    }
+}
+
+bool is_type_declaration(const char* word) {
+    return strcmp(word, "blockchain") == 0 || strcmp(word, "contract") == 0 ||
+           strcmp(word, "library") == 0 || strcmp(word, "enum") == 0;
+}
+
+// Record "blockchain Name", "enum Name", ...; contract-like bodies become
+// the owner of the functions and state parsed inside them.
+void parse_type_declaration(Parser* parser) {
+    Token keyword = advance_token(parser);
+    if (peek_token(parser).type != TOK_IDENTIFIER) {
+        return;
+    }
+    Token name = advance_token(parser);
+    add_type(parser, &name, name.value, SYMBOL_TYPE);
+    
+    if (strcmp(keyword.value, "enum") == 0) {
+        parser->types[parser->type_count - 1].is_enum = true;
+        if (peek_token(parser).type == TOK_LBRACE) {
+            skip_balanced(parser, TOK_LBRACE, TOK_RBRACE);
         }
+        return;
+    }
+    
+    // Skip inheritance clauses up to the body
+    while (peek_token(parser).type != TOK_LBRACE && peek_token(parser).type != TOK_SEMICOLON &&
+           peek_token(parser).type != TOK_EOF) {
+        advance_token(parser);
+    }
+    if (peek_token(parser).type == TOK_LBRACE) {
+        advance_token(parser);
+        parser->depth++;
+        parser->owner = name.value;
+        parser->owner_depth = parser->depth;
     }
 }
 
@@ -637,67 +837,188 @@ void parse_module(Parser* parser) {
                 parse_function(parser);
             } else if (strcmp(token.value, "struct") == 0) {
                 parse_struct(parser);
+            } else if (strcmp(token.value, "event") == 0) {
+                parse_event(parser);
+            } else if (is_type_declaration(token.value)) {
+                parse_type_declaration(parser);
             } else {
                 advance_token(parser);
             }
+        } else if (token.type == TOK_IDENTIFIER && is_type_declaration(token.value) &&
+                   has_token(parser, parser->current + 1) &&
+                   parser->tokens[parser->current + 1].type == TOK_IDENTIFIER) {
+            // "blockchain" and "library" are not lexer keywords
+            parse_type_declaration(parser);
+        } else if (token.type == TOK_IDENTIFIER && strcmp(token.value, "state") == 0 &&
+                   has_token(parser, parser->current + 1) &&
+                   parser->tokens[parser->current + 1].type == TOK_LBRACE) {
+            advance_token(parser);
+            parse_storage_block(parser, parser->owner ? parser->owner : "state", true, token.line);
+        } else if (token.type == TOK_ERROR && strcmp(token.value, "@") == 0 &&
+                   has_token(parser, parser->current + 1) &&
+                   strcmp(parser->tokens[parser->current + 1].value, "nopack") == 0) {
+            // @nopack keeps the next struct/state block in declaration order
+            advance_token(parser);
+            advance_token(parser);
+            parser->no_pack = true;
         } else {
+            if (token.type == TOK_LBRACE) {
+                parser->depth++;
+            } else if (token.type == TOK_RBRACE) {
+                if (parser->owner && parser->depth == parser->owner_depth) {
+                    parser->owner = NULL;
+                }
+                parser->depth--;
+            }
             advance_token(parser);
         }
     }
 }
 
 // ============================================================================
-// MAIN - Now outputs .o files
+// COMPILER SESSION
 // ============================================================================
 
-int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        fprintf(stderr, "OMEGA Minimal Bootstrap Compiler v2.0\n");
-        fprintf(stderr, "Usage: omega_minimal <file.omega|file.mega> [--output <file.o>]\n");
-        fprintf(stderr, "       omega_minimal --version\n");
-        return 1;
-    }
-    
-    // Handle version flag
-    if (strcmp(argv[1], "--version") == 0) {
-        printf("OMEGA Bootstrap v2.0.0\n");
-        printf("Pure C implementation - cross-platform\n");
-        return 0;
-    }
-    
-    // Determine output file
-    const char* input_file = argv[1];
-    const char* output_file = NULL;
-    
-    // Parse command line for --output
-    for (int i = 2; i < argc; i++) {
-        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
-            output_file = argv[i + 1];
-            i++;
-        }
-    }
-    
-    // Generate default output filename if not specified
-    char auto_output[256];
-    if (!output_file) {
-        strcpy(auto_output, input_file);
-        // Remove extension and add .o
-        char* dot = strrchr(auto_output, '.');
-        if (dot) {
-            strcpy(dot, ".o");
+#define MAX_TOKENS 50000
+
+#define OMEGA_VERSION "2.0.0"
+
+// Cached parses are keyed by the build that produced them as well as the
+// source. The build scripts pass OMEGA_FRONTEND_HASH, a digest of the
+// compiler's sources and headers, so any change to the lexer or parser
+// starts a fresh cache; a build without it falls back to the time this
+// file was compiled, which only ever misses more often.
+#define OMEGA_STRINGIFY(x) #x
+#define OMEGA_EXPAND_STRING(x) OMEGA_STRINGIFY(x)
+#ifdef OMEGA_FRONTEND_HASH
+#define PARSE_CACHE_TOOL "omega_minimal " OMEGA_VERSION " " OMEGA_EXPAND_STRING(OMEGA_FRONTEND_HASH)
+#else
+#define PARSE_CACHE_TOOL "omega_minimal " OMEGA_VERSION " " __DATE__ " " __TIME__
+#endif
+
+// State kept warm across compiles: interned identifiers and signatures, the
+// selector cache, the token buffer, the import graph and the interfaces of
+// imported modules. A single compile uses one session; watch mode reuses it
+// for every rebuild.
+typedef struct {
+    InternTable* interns;
+    SelectorCache* selectors;
+    Token* tokens;
+    Token* interface_tokens;        // for parsing imports without an .omi
+    ModuleGraph* graph;
+    ModuleInterface** interfaces;   // per graph module, loaded on first import
+    int interface_capacity;
+    int* import_targets;            // modules imported by the current compile
+    int import_target_count;
+    int import_target_capacity;
+    char current_path[MODULE_PATH_MAX];
+    int interfaces_mapped;          // per compile: loaded from .omi files
+    int interfaces_parsed;          // per compile: parsed from source
+    const char* std_dir;
+    const char* interface_dir;      // cached .omi files; NULL keeps them in memory
+    bool print_selectors;
+    bool print_layout;              // --layout: field-level layout diff
+    bool print_gas;                 // --gas: per-function gas estimates
+    bool whole_program;             // --whole-program: drop unreachable declarations
+    bool pipelined;                 // --pipeline: read/lex/write on their own threads
+    char* preloaded;                // next compile's source, read by build_modules
+    size_t preloaded_size;
+    bool batch_writes;              // queue objects for build_modules to write
+    ObjectWrite* object_writes;
+    int object_write_count;
+    int object_write_capacity;
+    ParseCache* parse_cache;        // --parse-cache: token streams and tables by content hash
+    unsigned targets;               // --target: CodegenTarget bits; 0 writes only the object
+} CompilerSession;
+
+bool create_session(CompilerSession* session) {
+    memset(session, 0, sizeof(CompilerSession));
+    session->interns = intern_create();
+    session->selectors = session->interns ? selector_cache_create(session->interns) : NULL;
+    session->tokens = malloc(sizeof(Token) * MAX_TOKENS);
+    session->graph = session->interns ? module_graph_create(session->interns) : NULL;
+    session->std_dir = "src/std";
+    session->print_selectors = false;
+    session->print_layout = false;
+    session->print_gas = false;
+    session->whole_program = false;
+    session->pipelined = false;
+    return session->interns && session->selectors && session->tokens && session->graph;
+}
+
+void destroy_session(CompilerSession* session) {
+    for (int i = 0; i < session->interface_capacity; i++) {
+        interface_close(session->interfaces[i]);
+    }
+    free(session->interfaces);
+    free(session->import_targets);
+    module_graph_destroy(session->graph);
+    selector_cache_destroy(session->selectors);
+    intern_destroy(session->interns);
+    free(session->tokens);
+    free(session->interface_tokens);
+    free(session->preloaded);
+    free(session->object_writes);
+    free(session->parse_cache);
+}
+
+double monotonic_ms(void) {
+#ifdef _WIN32
+    return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1e6;
+#endif
+}
+
+void default_output_path(const char* input_file, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s", input_file);
+    // Remove extension and add .o
+    char* dot = strrchr(out, '.');
+    char* slash = strrchr(out, '/');
+    if (dot && (!slash || dot > slash)) {
+        *dot = '\0';
+    }
+    size_t length = strlen(out);
+    snprintf(out + length, out_size - length, ".o");
+}
+
+void report_encoding_error(const char* input_file, const char* source, const Utf8Result* encoding) {
+    int line = 1;
+    int column = 1;
+    for (size_t i = 0; i < encoding->error_offset; i++) {
+        if (source[i] == '\n') {
+            line++;
+            column = 1;
         } else {
-            strcat(auto_output, ".o");
+            column++;
         }
-        output_file = auto_output;
     }
-    
-    printf("🔨 OMEGA Bootstrap: Compiling %s → %s\n", input_file, output_file);
-    
-    // Read source file
+    fprintf(stderr, "❌ Error: Invalid UTF-8 in '%s' at line %d, column %d (byte %zu)\n",
+            input_file, line, column, encoding->error_offset);
+}
+
+// Validate the encoding of a source read elsewhere. Returns `source`, or
+// NULL after reporting the error and freeing it.
+char* accept_source(const char* input_file, char* source, size_t size, Utf8Result* encoding) {
+    // Validate encoding up front so the lexer can classify bytes by table
+    *encoding = utf8_validate((const uint8_t*)source, size);
+    if (!encoding->valid) {
+        report_encoding_error(input_file, source, encoding);
+        free(source);
+        return NULL;
+    }
+    return source;
+}
+
+// Read a source file and validate its encoding. Returns NULL after
+// reporting the error.
+char* load_source(const char* input_file, size_t* size, Utf8Result* encoding) {
     FILE* file = fopen(input_file, "r");
     if (!file) {
         fprintf(stderr, "❌ Error: Cannot open file '%s'\n", input_file);
-        return 1;
+        return NULL;
     }
     
     // Get file size
@@ -710,94 +1031,2313 @@ int main(int argc, char* argv[]) {
     if (!source) {
         fprintf(stderr, "❌ Error: Cannot allocate memory for %ld bytes\n", file_size);
         fclose(file);
-        return 1;
+        return NULL;
     }
     
     size_t read_size = fread(source, 1, file_size, file);
     source[read_size] = '\0';
     fclose(file);
     
-    printf("   📄 Input size: %ld bytes\n", file_size);
-    
-    // Tokenize
-    Lexer lexer = create_lexer(source);
-    Token* tokens = malloc(sizeof(Token) * 50000);
-    if (!tokens) {
-        fprintf(stderr, "❌ Error: Cannot allocate token memory\n");
-        return 1;
-    }
-    
+    *size = read_size;
+    return accept_source(input_file, source, read_size, encoding);
+}
+
+// Tokenize into `tokens` (capacity MAX_TOKENS); returns the token count.
+int tokenize(InternTable* interns, const char* source, Token* tokens, int* comment_count) {
+    Lexer lexer = create_lexer(source, interns);
     int token_count = 0;
-    int comment_count = 0;
+    *comment_count = 0;
     
     Token token;
     do {
         token = next_token(&lexer);
         if (token.type == TOK_COMMENT) {
-            comment_count++;
+            (*comment_count)++;
         } else {
             tokens[token_count++] = token;
         }
-    } while (token.type != TOK_EOF && token_count < 50000);
+    } while (token.type != TOK_EOF && token_count < MAX_TOKENS);
+    
+    return token_count;
+}
+
+// ============================================================================
+// PARSE CACHE
+// ============================================================================
+
+typedef enum {
+    PARSED_FRESH,           // lexed and parsed here, not cached
+    PARSED_FROM_CACHE,
+    PARSED_AND_CACHED
+} ParseOrigin;
+
+// Restore a cached parse into an empty `parser` whose token buffer holds
+// `capacity` tokens. Imports are resolved again, as parse_import would.
+static bool restore_parse(Parser* parser, const ParseCacheEntry* entry, int capacity) {
+    const ParseCacheHeader* header = entry->header;
+    if (header->token_count > (uint32_t)capacity) {
+        return false;
+    }
+    
+    // Intern every distinct string once
+    uint32_t* ids = malloc(sizeof(uint32_t) * ((size_t)header->string_count + 1));
+    const char** texts = malloc(sizeof(const char*) * ((size_t)header->string_count + 1));
+    parser->functions = malloc(sizeof(FunctionDecl) * ((size_t)header->function_count + 1));
+    parser->types = malloc(sizeof(TypeDecl) * ((size_t)header->type_count + 1));
+    parser->fields = malloc(sizeof(FieldDecl) * ((size_t)header->field_count + 1));
+    parser->storage = malloc(sizeof(StorageDecl) * ((size_t)header->storage_count + 1));
+    parser->imports = malloc(sizeof(ImportDecl) * ((size_t)header->import_count + 1));
+    parser->import_names = malloc(sizeof(const char*) * ((size_t)header->import_name_count + 1));
+    if (!ids || !texts || !parser->functions || !parser->types || !parser->fields ||
+        !parser->storage || !parser->imports || !parser->import_names) {
+        free(ids);
+        free(texts);
+        free_parser(parser);
+        return false;
+    }
+    for (uint32_t i = 0; i < header->string_count; i++) {
+        ids[i] = intern_cstr(parser->interns, parse_cache_text(entry, i));
+        texts[i] = intern_text(parser->interns, ids[i]);
+    }
+    
+    for (uint32_t i = 0; i < header->token_count; i++) {
+        const CachedToken* cached = &entry->tokens[i];
+        Token* token = &parser->tokens[i];
+        token->type = (TokenType)cached->type;
+        token->value = texts[cached->value];
+        token->line = cached->line;
+        token->column = cached->column;
+        token->offset = cached->offset;
+        token->length = cached->length;
+    }
+    for (uint32_t i = 0; i < header->function_count; i++) {
+        const CachedFunction* cached = &entry->functions[i];
+        FunctionDecl* decl = &parser->functions[i];
+        decl->name = texts[cached->name];
+        decl->signature_id = ids[cached->signature];
+        decl->kind = cached->kind ? DECL_EVENT : DECL_FUNCTION;
+        decl->is_public = cached->is_public != 0;
+        decl->line = cached->line;
+        decl->owner = cached->owner == PARSE_CACHE_NONE ? NULL : texts[cached->owner];
+        decl->body_start = cached->body_start;
+        decl->body_end = cached->body_end;
+        decl->decl_start = cached->decl_start;
+        decl->decl_end = cached->decl_end;
+    }
+    for (uint32_t i = 0; i < header->type_count; i++) {
+        const CachedType* cached = &entry->types[i];
+        TypeDecl* decl = &parser->types[i];
+        decl->name = texts[cached->name];
+        decl->signature_id = ids[cached->signature];
+        decl->kind = (SymbolKind)cached->kind;
+        decl->is_enum = cached->is_enum != 0;
+        decl->line = cached->line;
+        decl->owner = cached->owner == PARSE_CACHE_NONE ? NULL : texts[cached->owner];
+        decl->decl_start = cached->decl_start;
+        decl->decl_end = cached->decl_end;
+    }
+    for (uint32_t i = 0; i < header->field_count; i++) {
+        parser->fields[i].name = texts[entry->fields[i].name];
+        parser->fields[i].type = texts[entry->fields[i].type];
+        parser->fields[i].line = entry->fields[i].line;
+    }
+    for (uint32_t i = 0; i < header->storage_count; i++) {
+        const CachedStorage* cached = &entry->storage[i];
+        StorageDecl* decl = &parser->storage[i];
+        decl->name = texts[cached->name];
+        decl->is_state = cached->is_state != 0;
+        decl->packable = cached->packable != 0;
+        decl->first_field = cached->first_field;
+        decl->field_count = cached->field_count;
+        decl->line = cached->line;
+    }
+    for (uint32_t i = 0; i < header->import_name_count; i++) {
+        parser->import_names[i] = texts[entry->import_names[i]];
+    }
+    for (uint32_t i = 0; i < header->import_count; i++) {
+        parser->imports[i].spec = texts[entry->imports[i].spec];
+        parser->imports[i].first_name = entry->imports[i].first_name;
+        parser->imports[i].name_count = entry->imports[i].name_count;
+        parser->imports[i].line = entry->imports[i].line;
+        parser->imports[i].iface = NULL;
+    }
+    free(ids);
+    free(texts);
+    
+    parser->token_count = (int)header->token_count;
+    parser->current = parser->token_count > 0 ? parser->token_count - 1 : 0;
+    parser->function_count = parser->function_capacity = (int)header->function_count;
+    parser->struct_count = (int)header->struct_count;
+    parser->type_count = parser->type_capacity = (int)header->type_count;
+    parser->field_count = parser->field_capacity = (int)header->field_count;
+    parser->storage_count = parser->storage_capacity = (int)header->storage_count;
+    parser->import_count = parser->import_capacity = (int)header->import_count;
+    parser->import_name_count = parser->import_name_capacity = (int)header->import_name_count;
+    
+    for (int i = 0; i < parser->import_count; i++) {
+        resolve_import_names(parser, &parser->imports[i]);
+    }
+    return true;
+}
+
+// Serialize a successful parse under `key`. The key covers PARSE_CACHE_TOOL,
+// so only a compiler built from the same sources reads the entry back;
+// bump PARSE_CACHE_VERSION when the entry layout itself changes.
+static bool store_parse(ParseCache* cache, const uint8_t* key, const Parser* parser,
+                        int comment_count) {
+    ParseCacheHeader counts;
+    memset(&counts, 0, sizeof(counts));
+    counts.token_count = (uint32_t)parser->token_count;
+    counts.comment_count = (uint32_t)comment_count;
+    counts.function_count = (uint32_t)parser->function_count;
+    counts.struct_count = (uint32_t)parser->struct_count;
+    counts.type_count = (uint32_t)parser->type_count;
+    counts.field_count = (uint32_t)parser->field_count;
+    counts.storage_count = (uint32_t)parser->storage_count;
+    counts.import_count = (uint32_t)parser->import_count;
+    counts.import_name_count = (uint32_t)parser->import_name_count;
+    
+    ParseCacheBuilder builder;
+    if (!parse_cache_builder_init(&builder, &counts)) {
+        parse_cache_builder_free(&builder);
+        return false;
+    }
+    for (int i = 0; i < parser->token_count; i++) {
+        const Token* token = &parser->tokens[i];
+        CachedToken* cached = &builder.tokens[i];
+        cached->type = (uint32_t)token->type;
+        cached->value = parse_cache_builder_string(&builder, token->value);
+        cached->line = token->line;
+        cached->column = token->column;
+        cached->offset = token->offset;
+        cached->length = token->length;
+    }
+    for (int i = 0; i < parser->function_count; i++) {
+        const FunctionDecl* decl = &parser->functions[i];
+        CachedFunction* cached = &builder.functions[i];
+        cached->name = parse_cache_builder_string(&builder, decl->name);
+        cached->signature = parse_cache_builder_string(&builder,
+                                                       intern_text(parser->interns, decl->signature_id));
+        cached->owner = parse_cache_builder_string(&builder, decl->owner);
+        cached->kind = decl->kind == DECL_EVENT ? 1 : 0;
+        cached->is_public = decl->is_public;
+        cached->line = decl->line;
+        cached->body_start = decl->body_start;
+        cached->body_end = decl->body_end;
+        cached->decl_start = decl->decl_start;
+        cached->decl_end = decl->decl_end;
+    }
+    for (int i = 0; i < parser->type_count; i++) {
+        const TypeDecl* decl = &parser->types[i];
+        CachedType* cached = &builder.types[i];
+        cached->name = parse_cache_builder_string(&builder, decl->name);
+        cached->signature = parse_cache_builder_string(&builder,
+                                                       intern_text(parser->interns, decl->signature_id));
+        cached->owner = parse_cache_builder_string(&builder, decl->owner);
+        cached->kind = (uint32_t)decl->kind;
+        cached->is_enum = decl->is_enum;
+        cached->line = decl->line;
+        cached->decl_start = decl->decl_start;
+        cached->decl_end = decl->decl_end;
+    }
+    for (int i = 0; i < parser->field_count; i++) {
+        builder.fields[i].name = parse_cache_builder_string(&builder, parser->fields[i].name);
+        builder.fields[i].type = parse_cache_builder_string(&builder, parser->fields[i].type);
+        builder.fields[i].line = parser->fields[i].line;
+    }
+    for (int i = 0; i < parser->storage_count; i++) {
+        const StorageDecl* decl = &parser->storage[i];
+        CachedStorage* cached = &builder.storage[i];
+        cached->name = parse_cache_builder_string(&builder, decl->name);
+        cached->is_state = decl->is_state;
+        cached->packable = decl->packable;
+        cached->first_field = decl->first_field;
+        cached->field_count = decl->field_count;
+        cached->line = decl->line;
+    }
+    for (int i = 0; i < parser->import_name_count; i++) {
+        builder.import_names[i] = parse_cache_builder_string(&builder, parser->import_names[i]);
+    }
+    for (int i = 0; i < parser->import_count; i++) {
+        builder.imports[i].spec = parse_cache_builder_string(&builder, parser->imports[i].spec);
+        builder.imports[i].first_name = parser->imports[i].first_name;
+        builder.imports[i].name_count = parser->imports[i].name_count;
+        builder.imports[i].line = parser->imports[i].line;
+    }
+    
+    size_t size = 0;
+    void* data = parse_cache_builder_serialize(&builder, key, &size);
+    parse_cache_builder_free(&builder);
+    bool stored = data && parse_cache_store(cache, key, data, size);
+    free(data);
+    return stored;
+}
+
+// Attribute what follows to `phase` in the profile and the trace; returns
+// the phase being left so a nested step can restore it.
+static ProfilePhase enter_phase(ProfilePhase phase) {
+    ProfilePhase previous = profile_phase(phase);
+    TRACE_PHASE(profile_phase_name(phase));
+    return previous;
+}
+
+// Tokenize and parse `source` into `parser` (created empty over a token
+// buffer of `capacity`), or restore both from the session's parse cache.
+// Only parses without errors are cached.
+ParseOrigin parse_source(CompilerSession* session, Parser* parser, int capacity,
+                         const char* source, size_t size, int* comment_count) {
+    uint8_t key[PARSE_CACHE_KEY_SIZE];
+    if (session->parse_cache) {
+        parse_cache_key(PARSE_CACHE_TOOL, source, size, key);
+        ParseCacheEntry* entry = parse_cache_lookup(session->parse_cache, key);
+        bool restored = entry && restore_parse(parser, entry, capacity);
+        if (restored) {
+            *comment_count = (int)entry->header->comment_count;
+        }
+        parse_cache_release(entry);
+        if (restored) {
+            return PARSED_FROM_CACHE;
+        }
+    }
+    
+    ProfilePhase caller = enter_phase(PHASE_LEX);
+    parser->token_count = tokenize(session->interns, source, parser->tokens, comment_count);
+    enter_phase(caller);
+    parse_module(parser);
+    if (session->parse_cache && parser->errors == 0 &&
+        store_parse(session->parse_cache, key, parser, *comment_count)) {
+        return PARSED_AND_CACHED;
+    }
+    return PARSED_FRESH;
+}
+
+// ============================================================================
+// MODULE INTERFACES
+// ============================================================================
+
+// Serialize the parser's declarations as the interface of `source_path`
+// (canonical), parsed from `source`; cache it in the session's interface
+// directory, and return it (NULL on failure).
+ModuleInterface* emit_interface(const CompilerSession* session, const Parser* parser,
+                                const char* source_path, const char* source, size_t source_size) {
+    InterfaceBuilder builder;
+    interface_builder_init(&builder);
+    
+    bool ok = true;
+    for (int i = 0; i < parser->function_count && ok; i++) {
+        const FunctionDecl* decl = &parser->functions[i];
+        ok = interface_builder_add(&builder, decl->kind == DECL_EVENT ? SYMBOL_EVENT : SYMBOL_FUNCTION,
+                                   decl->is_public, decl->name,
+                                   intern_text(parser->interns, decl->signature_id), decl->line);
+    }
+    for (int i = 0; i < parser->type_count && ok; i++) {
+        const TypeDecl* decl = &parser->types[i];
+        ok = interface_builder_add(&builder, decl->kind, true, decl->name,
+                                   intern_text(parser->interns, decl->signature_id), decl->line);
+    }
+    
+    size_t size = 0;
+    void* data = ok ? interface_builder_serialize(&builder, source_path, source, source_size, &size) : NULL;
+    interface_builder_free(&builder);
+    if (!data) {
+        return NULL;
+    }
+    
+    // Without a writable cache the interface lives only in this session
+    if (session->interface_dir) {
+        char path[MODULE_PATH_MAX];
+        interface_path_for(session->interface_dir, source_path, path, sizeof(path));
+        interface_write_file(path, data, size);
+    }
+    return interface_from_buffer(data, size);
+}
+
+// Parse an imported module just far enough to collect its declarations.
+ModuleInterface* parse_interface(CompilerSession* session, const char* source_path) {
+    if (!session->interface_tokens) {
+        session->interface_tokens = malloc(sizeof(Token) * MAX_TOKENS);
+        if (!session->interface_tokens) {
+            return NULL;
+        }
+    }
     
-    printf("   🔤 Tokens: %d (comments: %d, code tokens: %d)\n", 
-           token_count + comment_count, comment_count, token_count);
+    size_t size;
+    Utf8Result encoding;
+    char* source = load_source(source_path, &size, &encoding);
+    if (!source) {
+        return NULL;
+    }
     
-    // Parse
-    Parser parser = create_parser(tokens, token_count);
-    parse_module(&parser);
+    int comment_count;
+    Parser parser = create_parser(session->interface_tokens, 0, session->interns);
+    parse_source(session, &parser, MAX_TOKENS, source, size, &comment_count);
     
-    printf("   ✓ Parsed: %d modules, %d functions, %d structs\n", 
-           1, 10, 5); // Placeholder counts
+    ModuleInterface* iface = emit_interface(session, &parser, source_path, source, size);
+    free_parser(&parser);
+    free(source);
+    return iface;
+}
+
+// Replace the cached interface of `module` (NULL drops it).
+void set_session_interface(CompilerSession* session, int module, ModuleInterface* iface) {
+    if (module >= session->interface_capacity) {
+        int capacity = session->interface_capacity ? session->interface_capacity : 64;
+        while (capacity <= module) {
+            capacity *= 2;
+        }
+        ModuleInterface** interfaces = realloc(session->interfaces, sizeof(ModuleInterface*) * capacity);
+        if (!interfaces) {
+            interface_close(iface);
+            return;
+        }
+        memset(interfaces + session->interface_capacity, 0,
+               sizeof(ModuleInterface*) * (capacity - session->interface_capacity));
+        session->interfaces = interfaces;
+        session->interface_capacity = capacity;
+    }
+    interface_close(session->interfaces[module]);
+    session->interfaces[module] = iface;
+}
+
+// ImportResolver for the session: resolve the spec against the module being
+// compiled, record the graph edge, and return the import's interface from
+// the session, its .omi file, or (last resort) its source.
+const ModuleInterface* resolve_session_import(void* context, const char* spec) {
+    CompilerSession* session = context;
+    char resolved[MODULE_PATH_MAX];
+    if (!resolve_import(session->current_path, spec, session->std_dir, resolved, sizeof(resolved))) {
+        return NULL;
+    }
+    int module = module_graph_add(session->graph, resolved);
+    if (module < 0) {
+        return NULL;
+    }
+    
+    if (session->import_target_count == session->import_target_capacity) {
+        int capacity = session->import_target_capacity ? session->import_target_capacity * 2 : 16;
+        int* targets = realloc(session->import_targets, sizeof(int) * capacity);
+        if (!targets) {
+            return NULL;
+        }
+        session->import_targets = targets;
+        session->import_target_capacity = capacity;
+    }
+    session->import_targets[session->import_target_count++] = module;
     
-    // Write object file
-    FILE* obj_file = fopen(output_file, "wb");
-    if (!obj_file) {
-        fprintf(stderr, "❌ Error: Cannot create object file '%s'\n", output_file);
-        return 1;
+    if (module < session->interface_capacity && session->interfaces[module]) {
+        return session->interfaces[module];
+    }
+    
+    ModuleInterface* iface = NULL;
+    if (session->interface_dir) {
+        char path[MODULE_PATH_MAX];
+        interface_path_for(session->interface_dir, resolved, path, sizeof(path));
+        iface = interface_open(path, resolved);
+    }
+    if (iface) {
+        session->interfaces_mapped++;
+    } else {
+        iface = parse_interface(session, resolved);
+        if (!iface) {
+            return NULL;
+        }
+        session->interfaces_parsed++;
+    }
+    set_session_interface(session, module, iface);
+    return module < session->interface_capacity ? session->interfaces[module] : NULL;
+}
+
+// ============================================================================
+// STORAGE LAYOUT AND GAS
+// ============================================================================
+
+#define LAYOUT_VISITING (-1)     // being sized; only reached again if recursion went undetected
+
+typedef struct {
+    const Parser* parser;
+    int* struct_slots;      // per StorageDecl: slots + 1 once sized, 0 if not yet
+    const bool* recursive;  // per StorageDecl: a struct that contains itself
+} LayoutContext;
+
+int storage_decl_slots(LayoutContext* context, const StorageDecl* decl);
+
+// Index of the struct named `name` in parser->storage, or -1.
+static int find_struct_decl(const Parser* parser, const char* name) {
+    for (int i = 0; i < parser->storage_count; i++) {
+        if (!parser->storage[i].is_state && strcmp(parser->storage[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// UserTypeSize for the module being compiled: enums take one byte, structs
+// their own slot count, each sized once. A recursive struct has no finite
+// size, so every field of that type takes one slot, in its own layout too.
+// Imported types are unknown and get a whole slot.
+int user_type_size(void* context, const char* name, bool* whole_slot) {
+    LayoutContext* layout = context;
+    const Parser* parser = layout->parser;
+    
+    for (int i = 0; i < parser->type_count; i++) {
+        if (parser->types[i].is_enum && strcmp(parser->types[i].name, name) == 0) {
+            *whole_slot = false;
+            return 1;
+        }
+    }
+    int i = find_struct_decl(parser, name);
+    if (i < 0) {
+        return 0;
+    }
+    *whole_slot = true;
+    int* memo = &layout->struct_slots[i];
+    if (layout->recursive[i] || *memo == LAYOUT_VISITING) {
+        return STORAGE_SLOT_SIZE;
+    }
+    if (*memo == 0) {
+        *memo = LAYOUT_VISITING;
+        int slots = storage_decl_slots(layout, &parser->storage[i]);
+        *memo = (slots > 0 ? slots : 1) + 1;
+    }
+    return (*memo - 1) * STORAGE_SLOT_SIZE;
+}
+
+typedef struct {
+    const Parser* parser;
+    bool* contains;         // [from * storage_count + to]: `from` holds a `to` by value
+    int from;
+} StructGraph;
+
+// UserTypeSize that only records which structs a declaration holds by value:
+// directly or in fixed-size arrays, never behind a mapping or dynamic array.
+static int record_contained_struct(void* context, const char* name, bool* whole_slot) {
+    StructGraph* graph = context;
+    int to = find_struct_decl(graph->parser, name);
+    if (to >= 0) {
+        graph->contains[graph->from * graph->parser->storage_count + to] = true;
+    }
+    *whole_slot = true;
+    return STORAGE_SLOT_SIZE;
+}
+
+// Mark the structs that contain themselves, directly or through others, and
+// warn once about each. A state block that contains one cannot be laid out
+// (Solidity rejects recursive structs) and is an error; returns how many.
+static int find_recursive_structs(const Parser* parser, bool* recursive) {
+    int count = parser->storage_count;
+    bool* contains = calloc((size_t)count * count + 1, sizeof(bool));
+    bool* reached = malloc(sizeof(bool) * (count + 1));
+    int* stack = malloc(sizeof(int) * (count + 1));
+    if (!contains || !reached || !stack) {
+        free(contains);
+        free(reached);
+        free(stack);
+        return 0;
+    }
+    
+    StructGraph graph = { parser, contains, 0 };
+    for (int d = 0; d < count; d++) {
+        const StorageDecl* decl = &parser->storage[d];
+        graph.from = d;
+        for (int f = 0; f < decl->field_count; f++) {
+            LayoutField field;
+            memset(&field, 0, sizeof(field));
+            field.type = parser->fields[decl->first_field + f].type;
+            layout_size_field(&field, record_contained_struct, &graph);
+        }
     }
     
-    // Write minimal object file format (ELF header for Linux, portable)
-    // For now, write a simple format that tracks the compilation
-    fprintf(obj_file, "OMG2");  // Magic number for OMEGA object
-    fprintf(obj_file, "%.1d", 1);  // Version
+    // Depth-first from each declaration over what it contains
+    int errors = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int d = 0; d < count; d++) {
+            const StorageDecl* decl = &parser->storage[d];
+            if (decl->is_state != (pass == 1)) {
+                continue;
+            }
+            memset(reached, 0, sizeof(bool) * count);
+            int depth = 0;
+            for (int to = 0; to < count; to++) {
+                if (contains[d * count + to]) {
+                    reached[to] = true;
+                    stack[depth++] = to;
+                }
+            }
+            while (depth > 0) {
+                int from = stack[--depth];
+                for (int to = 0; to < count; to++) {
+                    if (contains[from * count + to] && !reached[to]) {
+                        reached[to] = true;
+                        stack[depth++] = to;
+                    }
+                }
+            }
+            if (pass == 0 && reached[d]) {
+                recursive[d] = true;
+                fprintf(stderr, "⚠️  Warning: struct '%s' contains itself (line %d); "
+                        "each field of that type takes one slot\n", decl->name, decl->line);
+            }
+            for (int s = 0; pass == 1 && s < count; s++) {
+                if (reached[s] && recursive[s]) {
+                    fprintf(stderr, "❌ Error: State of '%s' (line %d) holds recursive struct '%s', "
+                            "which has no storage layout\n", decl->name, decl->line, parser->storage[s].name);
+                    errors++;
+                    break;
+                }
+            }
+        }
+    }
+    free(contains);
+    free(reached);
+    free(stack);
+    return errors;
+}
+
+// Size the fields of `decl` into `fields` (capacity decl->field_count).
+void size_storage_fields(LayoutContext* context, const StorageDecl* decl, LayoutField* fields) {
+    const Parser* parser = context->parser;
+    for (int i = 0; i < decl->field_count; i++) {
+        const FieldDecl* field = &parser->fields[decl->first_field + i];
+        fields[i].name = field->name;
+        fields[i].type = field->type;
+        layout_size_field(&fields[i], user_type_size, context);
+    }
+}
+
+// Slots used by a struct as the compiler lays it out (packed when allowed).
+int storage_decl_slots(LayoutContext* context, const StorageDecl* decl) {
+    if (decl->field_count == 0) {
+        return 0;
+    }
+    LayoutField* fields = malloc(sizeof(LayoutField) * decl->field_count * 2);
+    if (!fields) {
+        return 1;
+    }
+    size_storage_fields(context, decl, fields);
+    int slots = layout_assign(fields, decl->field_count);
+    if (decl->packable) {
+        int packed = layout_pack(fields, decl->field_count, fields + decl->field_count);
+        if (packed < slots) {
+            slots = packed;
+        }
+    }
+    free(fields);
+    return slots;
+}
+
+// Lay out every struct and state block, report what packing changed, and
+// estimate per-function gas against the final state layout. `field_order`
+// (optional, indexed like parser->fields) receives the field laid out at
+// each position: the packed order where packing applies, else declaration
+// order. Returns the number of state blocks holding a recursive struct;
+// nothing is laid out then.
+int analyze_storage(CompilerSession* session, const Parser* parser, int* field_order) {
+    for (int i = 0; field_order && i < parser->field_count; i++) {
+        field_order[i] = i;
+    }
+    if (parser->storage_count == 0) {
+        return 0;
+    }
     
-    // Write module metadata
-    int module_count = 1;
-    fwrite(&module_count, sizeof(int), 1, obj_file);
+    // Per field, indexed like parser->fields: declaration order and final
+    LayoutField* original = calloc(parser->field_count + 1, sizeof(LayoutField));
+    LayoutField* final = calloc(parser->field_count + 1, sizeof(LayoutField));
+    if (!original || !final) {
+        free(original);
+        free(final);
+        return 0;
+    }
     
-    // Write token count
-    fwrite(&token_count, sizeof(int), 1, obj_file);
+    int* slots = calloc(parser->storage_count, sizeof(int) * 3);
+    bool* recursive = calloc(parser->storage_count, sizeof(bool));
+    if (!slots || !recursive) {
+        free(slots);
+        free(recursive);
+        free(original);
+        free(final);
+        return 0;
+    }
+    int* packed = slots + parser->storage_count;
     
-    // Write file hash (simple CRC)
-    unsigned int hash = 0;
-    for (int i = 0; i < read_size; i++) {
-        hash = ((hash << 5) + hash) + source[i];
+    int errors = find_recursive_structs(parser, recursive);
+    if (errors > 0) {
+        free(slots);
+        free(recursive);
+        free(original);
+        free(final);
+        return errors;
     }
-    fwrite(&hash, sizeof(unsigned int), 1, obj_file);
     
-    fclose(obj_file);
+    LayoutContext context = { parser, packed + parser->storage_count, recursive };
+    int total_original = 0;
+    int total_final = 0;
+    int changed = 0;
     
-    // Check for parse errors
-    if (parser.errors == 0) {
-        printf("✅ Successfully compiled: %s\n", output_file);
+    for (int d = 0; d < parser->storage_count; d++) {
+        const StorageDecl* decl = &parser->storage[d];
+        LayoutField* before = original + decl->first_field;
+        LayoutField* after = final + decl->first_field;
+        
+        size_storage_fields(&context, decl, before);
+        slots[d] = layout_assign(before, decl->field_count);
+        packed[d] = layout_pack(before, decl->field_count, after);
+        if (!decl->packable || packed[d] >= slots[d]) {
+            memcpy(after, before, sizeof(LayoutField) * decl->field_count);
+        } else {
+            changed++;
+            for (int i = 0; field_order && i < decl->field_count; i++) {
+                for (int j = 0; j < decl->field_count; j++) {
+                    if (before[j].name == after[i].name) {
+                        field_order[decl->first_field + i] = decl->first_field + j;
+                        break;
+                    }
+                }
+            }
+        }
+        total_original += slots[d];
+        total_final += decl->packable && packed[d] < slots[d] ? packed[d] : slots[d];
+    }
+    free(recursive);
+    
+    printf("   🧱 Storage: %d layout(s), %d slot(s)", parser->storage_count, total_original);
+    if (changed > 0) {
+        printf(" → %d after packing %d layout(s)", total_final, changed);
+    }
+    printf("\n");
+    
+    // Layout diff: every packed layout, plus the rest with --layout
+    for (int d = 0; d < parser->storage_count; d++) {
+        const StorageDecl* decl = &parser->storage[d];
+        bool applied = decl->packable && packed[d] < slots[d];
+        if (applied) {
+            printf("      📐 %s%s: %d → %d slot(s)\n", decl->name,
+                   decl->is_state ? " (state)" : "", slots[d], packed[d]);
+        } else if (!decl->packable && packed[d] < slots[d]) {
+            printf("      📐 %s%s: %d slot(s), @nopack (packing would use %d)\n", decl->name,
+                   decl->is_state ? " (state)" : "", slots[d], packed[d]);
+        } else if (session->print_layout) {
+            printf("      📐 %s%s: %d slot(s), unchanged\n", decl->name,
+                   decl->is_state ? " (state)" : "", slots[d]);
+        } else {
+            continue;
+        }
+        
+        const LayoutField* before = original + decl->first_field;
+        const LayoutField* after = final + decl->first_field;
+        for (int i = 0; i < decl->field_count; i++) {
+            const LayoutField* field = &after[i];
+            const LayoutField* old = field;
+            for (int j = 0; j < decl->field_count; j++) {
+                if (before[j].name == field->name) {
+                    old = &before[j];
+                    break;
+                }
+            }
+            bool moved = old->slot != field->slot || old->offset != field->offset;
+            if (!moved && !session->print_layout) {
+                continue;
+            }
+            printf("         %c slot %d+%-2d %-24s %-16s %2dB", moved ? '~' : ' ',
+                   field->slot, field->offset, field->name, field->type, field->size);
+            if (moved) {
+                printf("  (was slot %d+%d)", old->slot, old->offset);
+            }
+            printf("\n");
+        }
+    }
+    free(slots);
+    
+    // Static gas per function body, against its contract's state layout
+    long total_gas = 0;
+    long total_saved = 0;
+    int estimated = 0;
+    for (int i = 0; i < parser->function_count; i++) {
+        const FunctionDecl* decl = &parser->functions[i];
+        if (decl->kind != DECL_FUNCTION || decl->body_end <= decl->body_start) {
+            continue;
+        }
         
-        // Get output file size
-        FILE* check = fopen(output_file, "rb");
-        if (check) {
-            fseek(check, 0, SEEK_END);
-            long obj_size = ftell(check);
-            fclose(check);
-            printf("   📦 Object file size: %ld bytes\n", obj_size);
+        const LayoutField* state_final = NULL;
+        const LayoutField* state_original = NULL;
+        int state_count = 0;
+        for (int d = 0; d < parser->storage_count && decl->owner; d++) {
+            const StorageDecl* storage = &parser->storage[d];
+            if (storage->is_state && strcmp(storage->name, decl->owner) == 0) {
+                state_final = final + storage->first_field;
+                state_original = original + storage->first_field;
+                state_count = storage->field_count;
+                break;
+            }
         }
         
+        GasEstimate gas = estimate_gas(parser->tokens, decl->body_start, decl->body_end,
+                                       state_final, state_count, decl->is_public);
+        GasEstimate unpacked = estimate_gas(parser->tokens, decl->body_start, decl->body_end,
+                                            state_original, state_count, decl->is_public);
+        total_gas += gas.gas;
+        total_saved += unpacked.gas - gas.gas;
+        estimated++;
+        
+        if (session->print_gas) {
+            printf("      ⛽ %-40s %8ld gas (%d SLOAD, %d SSTORE)%s", 
+                   intern_text(parser->interns, decl->signature_id), gas.gas,
+                   gas.sloads, gas.sstores, gas.unbounded ? " per loop iteration" : "");
+            if (unpacked.gas != gas.gas) {
+                printf(", packing saves %ld", unpacked.gas - gas.gas);
+            }
+            printf("\n");
+        }
+    }
+    
+    if (estimated > 0) {
+        printf("   ⛽ Gas: %d function(s), %ld static estimate", estimated, total_gas);
+        if (total_saved != 0) {
+            printf(", packing saves %ld", total_saved);
+        }
+        printf("\n");
+    }
+    
+    free(original);
+    free(final);
+    return 0;
+}
+
+// ============================================================================
+// WHOLE-PROGRAM REACHABILITY
+// ============================================================================
+
+uint32_t object_hash(uint32_t hash, const char* data, size_t length);
+
+// A module of the program: the entry module (borrowing the compile's parser
+// and tokens) or a transitive import, parsed in full for its bodies.
+typedef struct {
+    const char* path;           // interned canonical path
+    char* source;               // NULL for the entry module
+    Token* tokens;
+    int token_count;
+    Parser parser;
+    uint32_t checksum;          // object_hash of the source, as its object records it
+    int first_import;           // its imports are Program.imports[first_import, +import_count)
+    int import_count;
+    int node;                   // CALLGRAPH_MODULE node
+    bool kept_whole;            // not fully lexed, so nothing is dropped
+    int* function_nodes;        // per FunctionDecl, -1 for events
+    int* type_nodes;            // per TypeDecl, -1 for non-structs
+} ProgramModule;
+
+typedef struct {
+    ProgramModule* modules;
+    int count;
+    int capacity;
+    int* imports;
+    int* import_decls;          // per import, its ImportDecl in the importing module
+    int import_count;
+    int import_capacity;
+} Program;
+
+// Index of the module at interned `path`, loading and parsing it if new;
+// -1 if it cannot be read.
+static int program_module(Program* program, CompilerSession* session, const char* path) {
+    for (int i = 0; i < program->count; i++) {
+        if (program->modules[i].path == path) {
+            return i;
+        }
+    }
+    if (program->count == program->capacity) {
+        int capacity = program->capacity ? program->capacity * 2 : 16;
+        ProgramModule* modules = realloc(program->modules, sizeof(ProgramModule) * capacity);
+        if (!modules) {
+            return -1;
+        }
+        program->modules = modules;
+        program->capacity = capacity;
+    }
+    
+    size_t size;
+    Utf8Result encoding;
+    char* source = load_source(path, &size, &encoding);
+    if (!source) {
+        return -1;
+    }
+    // A token spans at least one byte, plus EOF
+    size_t capacity = size + 2 < MAX_TOKENS ? size + 2 : MAX_TOKENS;
+    Token* tokens = malloc(sizeof(Token) * capacity);
+    if (!tokens) {
         free(source);
-        free(tokens);
+        return -1;
+    }
+    
+    ProgramModule* module = &program->modules[program->count];
+    memset(module, 0, sizeof(ProgramModule));
+    module->path = path;
+    module->source = source;
+    module->checksum = object_hash(0, source, size);
+    module->tokens = tokens;
+    int comment_count;
+    module->parser = create_parser(tokens, 0, session->interns);
+    parse_source(session, &module->parser, (int)capacity, source, size, &comment_count);
+    module->token_count = module->parser.token_count;
+    return program->count++;
+}
+
+static bool add_program_import(Program* program, int module, int decl) {
+    if (program->import_count == program->import_capacity) {
+        int capacity = program->import_capacity ? program->import_capacity * 2 : 32;
+        int* imports = realloc(program->imports, sizeof(int) * capacity);
+        if (!imports) {
+            return false;
+        }
+        program->imports = imports;
+        int* decls = realloc(program->import_decls, sizeof(int) * capacity);
+        if (!decls) {
+            return false;
+        }
+        program->import_decls = decls;
+        program->import_capacity = capacity;
+    }
+    program->imports[program->import_count] = module;
+    program->import_decls[program->import_count++] = decl;
+    return true;
+}
+
+// Source bytes covered by tokens[start, end)
+static int token_span(const Token* tokens, int start, int end) {
+    if (end <= start) {
         return 0;
-    } else {
-        printf("❌ Compilation failed: %d parse error(s)\n", parser.errors);
-        free(source);
-        free(tokens);
-        return 1;
     }
+    return tokens[end - 1].offset + tokens[end - 1].length - tokens[start].offset;
+}
+
+static bool is_entry_point(const FunctionDecl* decl) {
+    return decl->is_public || strcmp(decl->name, "main") == 0 ||
+           strcmp(decl->name, "constructor") == 0 || strcmp(decl->name, "fallback") == 0 ||
+           strcmp(decl->name, "receive") == 0;
+}
+
+// True if a character literal such as '"' made the lexer open a string that
+// swallows code; references hidden in it cannot be seen.
+static bool has_misread_strings(const ProgramModule* module) {
+    for (int t = 0; t + 1 < module->token_count; t++) {
+        const Token* token = &module->tokens[t];
+        if (token->type == TOK_ERROR && strcmp(token->value, "'") == 0 &&
+            module->tokens[t + 1].type == TOK_STRING &&
+            module->tokens[t + 1].offset == token->offset + 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Add a node per function and struct of `module`; declarations mention the
+// module's top-level code so it is kept whenever any of them is. Modules
+// that were misread or failed to parse are kept whole: their top-level code
+// mentions every declaration.
+static void add_module_nodes(CallGraph* graph, ProgramModule* module, int index) {
+    bool entry = index == 0;
+    const Parser* parser = &module->parser;
+    bool whole = has_misread_strings(module) || parser->errors > 0;
+    module->kept_whole = whole;
+    module->node = callgraph_add(graph, module->path, index, CALLGRAPH_MODULE, entry, 0, 0);
+    module->function_nodes = malloc(sizeof(int) * (size_t)(parser->function_count + 1));
+    module->type_nodes = malloc(sizeof(int) * (size_t)(parser->type_count + 1));
+    if (module->node < 0 || !module->function_nodes || !module->type_nodes) {
+        module->node = -1;
+        return;
+    }
+    for (int i = 0; i < parser->function_count; i++) {
+        const FunctionDecl* decl = &parser->functions[i];
+        module->function_nodes[i] = -1;
+        if (decl->kind != DECL_FUNCTION) {
+            continue;
+        }
+        int node = callgraph_add(graph, decl->name, index, CALLGRAPH_FUNCTION,
+                                 entry && is_entry_point(decl),
+                                 token_span(module->tokens, decl->decl_start, decl->decl_end),
+                                 decl->line);
+        module->function_nodes[i] = node;
+        if (node >= 0) {
+            callgraph_add_edge(graph, node, module->node);
+            if (whole) callgraph_add_edge(graph, module->node, node);
+        }
+    }
+    for (int i = 0; i < parser->type_count; i++) {
+        const TypeDecl* decl = &parser->types[i];
+        module->type_nodes[i] = -1;
+        if (decl->kind != SYMBOL_STRUCT) {
+            continue;
+        }
+        int node = callgraph_add(graph, decl->name, index, CALLGRAPH_STRUCT, false,
+                                 token_span(module->tokens, decl->decl_start, decl->decl_end),
+                                 decl->line);
+        module->type_nodes[i] = node;
+        if (node >= 0) {
+            callgraph_add_edge(graph, node, module->node);
+            if (whole) callgraph_add_edge(graph, module->node, node);
+        }
+    }
+}
+
+static const char* base_name(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+static uint32_t interned_id(const Parser* parser, const char* name) {
+    return intern_find(parser->interns, name, strlen(name));
+}
+
+// Declare the functions, events and types of `module` (index `index`) in a
+// new scope; overloads and same-named members keep the first declaration.
+// Returns how many were declared.
+static int declare_module(ScopeTable* scope, const ProgramModule* module, int index) {
+    const Parser* parser = &module->parser;
+    int declared = 0;
+    if (!scope_push(scope)) {
+        return 0;
+    }
+    for (int i = 0; i < parser->function_count + parser->type_count; i++) {
+        bool function = i < parser->function_count;
+        const char* name = function ? parser->functions[i].name
+                                    : parser->types[i - parser->function_count].name;
+        int line = function ? parser->functions[i].line : parser->types[i - parser->function_count].line;
+        declared += scope_define(scope, interned_id(parser, name), index, i, line) >= 0;
+    }
+    return declared;
+}
+
+// Report the imports of `module` it never names: whole modules, and names
+// listed in `import { ... }`. `scope` holds one scope per import, innermost
+// last; each is popped here, so findings are gathered backwards and
+// printed in source order.
+static void report_unused_imports(ScopeTable* scope, const Program* program, int index,
+                                  const int* declared) {
+    const ProgramModule* module = &program->modules[index];
+    const Parser* parser = &module->parser;
+    uint32_t* unused_names = malloc(sizeof(uint32_t) * (size_t)(module->import_count + 1));
+    if (!unused_names) {
+        return;
+    }
+    // Per import: UINT32_MAX if nothing of it is named, else a bit per
+    // unused name of its list
+    for (int i = module->import_count - 1; i >= 0; i--) {
+        const ImportDecl* import = &parser->imports[program->import_decls[module->first_import + i]];
+        uint32_t unused[256];
+        int count = scope_unused(scope, unused, 256);
+        unused_names[i] = 0;
+        if (declared[i] > 0 && count == declared[i]) {
+            unused_names[i] = UINT32_MAX;
+        }
+        for (int n = 0; n < import->name_count && n < 32 && unused_names[i] != UINT32_MAX; n++) {
+            uint32_t id = interned_id(parser, parser->import_names[import->first_name + n]);
+            for (int u = 0; u < count && u < 256; u++) {
+                if (unused[u] == id) {
+                    unused_names[i] |= 1u << n;
+                    break;
+                }
+            }
+        }
+        scope_pop(scope);
+    }
+    
+    for (int i = 0; i < module->import_count; i++) {
+        const ImportDecl* import = &parser->imports[program->import_decls[module->first_import + i]];
+        if (unused_names[i] == UINT32_MAX) {
+            printf("      📭 %s:%d imports \"%s\" but names nothing from it\n",
+                   base_name(module->path), import->line, import->spec);
+            continue;
+        }
+        for (int n = 0; n < import->name_count && n < 32; n++) {
+            if (unused_names[i] & (1u << n)) {
+                printf("      📭 %s:%d imports %s from \"%s\" but never uses it\n",
+                       base_name(module->path), import->line,
+                       parser->import_names[import->first_name + n], import->spec);
+            }
+        }
+    }
+    free(unused_names);
+}
+
+// Every identifier inside a declaration becomes an edge to the functions and
+// structs of that name visible from the module. Names resolve through a
+// scope table: one scope per import, then the module's own declarations, so
+// a lookup is one probe and the shadowed chain reaches every visible module
+// declaring the name. Names in import statements and a declaration's own
+// name are not references. Unused imports are reported from the table's
+// use bits.
+static void add_module_edges(CallGraph* graph, const Program* program, int index) {
+    const ProgramModule* module = &program->modules[index];
+    const Parser* parser = &module->parser;
+    int* owner = malloc(sizeof(int) * (size_t)(module->token_count + 1));
+    int* declared = malloc(sizeof(int) * (size_t)(module->import_count + 1));
+    ScopeTable scope;
+    if (!owner || !declared || module->node < 0 || !module->function_nodes || !module->type_nodes ||
+        !scope_table_init(&scope)) {
+        free(owner);
+        free(declared);
+        return;
+    }
+    for (int t = 0; t < module->token_count; t++) {
+        owner[t] = module->node;
+    }
+    for (int i = 0; i < parser->function_count; i++) {
+        for (int t = parser->functions[i].decl_start; t < parser->functions[i].decl_end; t++) {
+            if (module->function_nodes[i] >= 0) owner[t] = module->function_nodes[i];
+        }
+        if (module->function_nodes[i] >= 0 && parser->functions[i].decl_start + 1 < module->token_count) {
+            owner[parser->functions[i].decl_start + 1] = -1;
+        }
+    }
+    for (int i = 0; i < parser->type_count; i++) {
+        for (int t = parser->types[i].decl_start; t < parser->types[i].decl_end; t++) {
+            if (module->type_nodes[i] >= 0) owner[t] = module->type_nodes[i];
+        }
+        if (module->type_nodes[i] >= 0 && parser->types[i].decl_start + 1 < module->token_count) {
+            owner[parser->types[i].decl_start + 1] = -1;
+        }
+    }
+    for (int i = 0; i < module->import_count; i++) {
+        int imported = program->imports[module->first_import + i];
+        declared[i] = declare_module(&scope, &program->modules[imported], imported);
+    }
+    declare_module(&scope, module, index);
+    
+    for (int t = 0; t < module->token_count; t++) {
+        const Token* token = &module->tokens[t];
+        if (token->type == TOK_KEYWORD && strcmp(token->value, "import") == 0) {
+            while (t + 1 < module->token_count && module->tokens[t + 1].type != TOK_SEMICOLON &&
+                   module->tokens[t + 1].line == token->line) {
+                t++;
+            }
+            continue;
+        }
+        if ((token->type != TOK_IDENTIFIER && token->type != TOK_KEYWORD) || owner[t] < 0) {
+            continue;
+        }
+        uint32_t id = interned_id(parser, token->value);
+        int decl = id ? scope_use(&scope, id) : SCOPE_NOT_FOUND;
+        for (; decl >= 0; decl = (int)scope_symbol(&scope, decl)->shadowed - 1) {
+            scope_mark_used(&scope, decl);
+            int target_module = scope_symbol(&scope, decl)->kind;
+            for (int node = callgraph_find(graph, token->value); node >= 0;
+                 node = graph->nodes[node].next_named) {
+                if (graph->nodes[node].module == target_module && node != owner[t] &&
+                    graph->nodes[node].kind != CALLGRAPH_MODULE) {
+                    callgraph_add_edge(graph, owner[t], node);
+                }
+            }
+        }
+    }
+    
+    // A misread module may name its imports where they cannot be seen
+    scope_pop(&scope);
+    if (!module->kept_whole) {
+        report_unused_imports(&scope, program, index, declared);
+    }
+    scope_table_free(&scope);
+    free(owner);
+    free(declared);
+}
+
+// Name a declaration has in object files: contract members carry their
+// owner, "Owner::transfer(address,uint256)", "Owner::Position".
+static void object_symbol_name(const char* owner, const char* name, char* out, size_t size) {
+    snprintf(out, size, "%s%s%s", owner ? owner : "", owner ? "::" : "", name);
+}
+
+// List an imported module's unreachable functions and structs and record
+// each in `pruned` as a SYMBOL_PRUNED entry (omega_object.h), for omega_link
+// to strip from that module's object. Returns the source bytes they cover.
+static long prune_import(const ProgramModule* module, const CallGraph* graph,
+                         InterfaceBuilder* pruned) {
+    const Parser* parser = &module->parser;
+    char name[2 * SIGNATURE_MAX];
+    long bytes = 0;
+    int listed = 0;
+    for (int i = 0; i < parser->function_count + parser->type_count; i++) {
+        bool function = i < parser->function_count;
+        int index = function ? i : i - parser->function_count;
+        int node = function ? module->function_nodes[index] : module->type_nodes[index];
+        if (node < 0 || graph->nodes[node].live) {
+            continue;
+        }
+        if (function) {
+            const FunctionDecl* decl = &parser->functions[index];
+            object_symbol_name(decl->owner, intern_text(parser->interns, decl->signature_id),
+                               name, sizeof(name));
+        } else {
+            const TypeDecl* decl = &parser->types[index];
+            object_symbol_name(decl->owner, decl->name, name, sizeof(name));
+        }
+        if (pruned && interface_builder_add(pruned, SYMBOL_PRUNED, false, name, module->path, 0)) {
+            pruned->symbols[pruned->symbol_count - 1].line = module->checksum;
+        }
+        if (listed++ == 0) {
+            printf("      ✂️  %s (import): ", base_name(module->path));
+        } else {
+            printf(", ");
+        }
+        printf("%s%s", graph->nodes[node].name, function ? "()" : "");
+        bytes += graph->nodes[node].size;
+    }
+    if (listed) {
+        printf("\n");
+    }
+    return bytes;
+}
+
+// Drop the entry module's unreachable functions and structs so later
+// passes (selectors, layout, gas, object output) never see them.
+static void drop_unreachable(Parser* parser, const CallGraph* graph, const ProgramModule* entry) {
+    int kept = 0;
+    for (int i = 0; i < parser->function_count; i++) {
+        int node = entry->function_nodes[i];
+        if (node < 0 || graph->nodes[node].live) {
+            parser->functions[kept++] = parser->functions[i];
+        }
+    }
+    parser->function_count = kept;
+    
+    kept = 0;
+    for (int i = 0; i < parser->type_count; i++) {
+        int node = entry->type_nodes[i];
+        if (node >= 0 && !graph->nodes[node].live) {
+            // Its storage declaration goes with it
+            int storage_kept = 0;
+            for (int s = 0; s < parser->storage_count; s++) {
+                if (parser->storage[s].is_state || parser->storage[s].name != parser->types[i].name) {
+                    parser->storage[storage_kept++] = parser->storage[s];
+                }
+            }
+            parser->storage_count = storage_kept;
+            parser->struct_count--;
+            continue;
+        }
+        parser->types[kept++] = parser->types[i];
+    }
+    parser->type_count = kept;
+}
+
+// Build the cross-module call graph rooted at the entry module's public and
+// external functions (and its top-level code) and remove what is unreachable
+// from the entry module. Unreachable declarations of imports are reported
+// and added to `pruned`; their objects are built separately, and omega_link
+// strips them when it links those objects with this one.
+void eliminate_unreachable(CompilerSession* session, Parser* parser, Token* tokens, int token_count,
+                           InterfaceBuilder* pruned) {
+    Program program;
+    memset(&program, 0, sizeof(program));
+    program.modules = malloc(sizeof(ProgramModule) * 16);
+    if (!program.modules) {
+        return;
+    }
+    program.capacity = 16;
+    memset(&program.modules[0], 0, sizeof(ProgramModule));
+    program.modules[0].path = intern_text(session->interns, intern_cstr(session->interns, session->current_path));
+    program.modules[0].tokens = tokens;
+    program.modules[0].token_count = token_count;
+    program.modules[0].parser = *parser;
+    program.count = 1;
+    
+    // Breadth-first over imports; each module's imports are contiguous
+    for (int m = 0; m < program.count; m++) {
+        program.modules[m].first_import = program.import_count;
+        for (int i = 0; i < program.modules[m].parser.import_count; i++) {
+            char resolved[MODULE_PATH_MAX];
+            if (!resolve_import(program.modules[m].path, program.modules[m].parser.imports[i].spec,
+                                session->std_dir, resolved, sizeof(resolved))) {
+                continue;
+            }
+            const char* path = intern_text(session->interns, intern_cstr(session->interns, resolved));
+            int imported = program_module(&program, session, path);
+            if (imported >= 0 && imported != m && add_program_import(&program, imported, i)) {
+                program.modules[m].import_count++;
+            }
+        }
+    }
+    
+    CallGraph graph;
+    if (callgraph_init(&graph)) {
+        for (int m = 0; m < program.count; m++) {
+            add_module_nodes(&graph, &program.modules[m], m);
+        }
+        for (int m = 0; m < program.count; m++) {
+            add_module_edges(&graph, &program, m);
+        }
+        callgraph_mark_live(&graph);
+        
+        // The entry module's own declarations; imports are summarized below
+        int functions = 0, functions_live = 0, structs = 0, structs_live = 0;
+        long bytes = 0, bytes_removed = 0;
+        for (int i = 0; i < graph.count; i++) {
+            const CallGraphNode* node = &graph.nodes[i];
+            if (node->module != 0 || node->kind == CALLGRAPH_MODULE) {
+                continue;
+            }
+            bool function = node->kind == CALLGRAPH_FUNCTION;
+            functions += function;
+            structs += !function;
+            functions_live += function && node->live;
+            structs_live += !function && node->live;
+            bytes += node->size;
+            bytes_removed += node->live ? 0 : node->size;
+        }
+        printf("   🌳 Whole program: %d module(s), %s keeps %d/%d functions, %d/%d structs\n",
+               program.count, base_name(program.modules[0].path), functions_live, functions,
+               structs_live, structs);
+        for (int m = 0; m < program.count; m++) {
+            if (program.modules[m].kept_whole) {
+                printf("      ⚠️  %s kept whole: the bootstrap front end cannot read all of it\n",
+                       base_name(program.modules[m].path));
+            }
+        }
+        
+        // Removed symbols
+        int listed = 0;
+        for (int i = 0; i < graph.count; i++) {
+            const CallGraphNode* node = &graph.nodes[i];
+            if (node->module != 0 || node->live || node->kind == CALLGRAPH_MODULE) {
+                continue;
+            }
+            if (listed++ == 0) {
+                printf("      ✂️  %s: ", base_name(program.modules[0].path));
+            } else {
+                printf(", ");
+            }
+            printf("%s%s", node->name, node->kind == CALLGRAPH_FUNCTION ? "()" : "");
+        }
+        if (listed) {
+            printf("\n");
+        }
+        printf("   📉 Declarations: %ld -> %ld bytes (-%.1f%%)\n", bytes, bytes - bytes_removed,
+               bytes ? 100.0 * (double)bytes_removed / (double)bytes : 0.0);
+        
+        // Imports keep their declarations until omega_link strips these
+        long import_bytes = 0;
+        for (int m = 1; m < program.count; m++) {
+            if (program.modules[m].node >= 0 && program.modules[m].function_nodes &&
+                program.modules[m].type_nodes) {
+                import_bytes += prune_import(&program.modules[m], &graph, pruned);
+            }
+        }
+        if (import_bytes > 0) {
+            printf("   📉 Imports: %ld bytes unreachable, stripped when linked with this object\n",
+                   import_bytes);
+        }
+        
+        const ProgramModule* entry = &program.modules[0];
+        if (entry->node >= 0 && entry->function_nodes && entry->type_nodes) {
+            drop_unreachable(parser, &graph, entry);
+        }
+        callgraph_free(&graph);
+    }
+    
+    for (int m = 0; m < program.count; m++) {
+        ProgramModule* module = &program.modules[m];
+        if (m > 0) {
+            free_parser(&module->parser);
+            free(module->tokens);
+            free(module->source);
+        }
+        free(module->function_nodes);
+        free(module->type_nodes);
+    }
+    free(program.modules);
+    free(program.imports);
+    free(program.import_decls);
+}
+
+// ============================================================================
+// TARGET CODE GENERATION
+// ============================================================================
+
+// Describe the parsed module for the generators and run the requested
+// targets concurrently. The description points into the parser, the intern
+// table and the imported interfaces, which stay untouched until every target
+// is written. Fields follow `field_order` from analyze_storage (declaration
+// order if NULL), so generated storage is the layout the compiler reported.
+// False if a target could not be generated or written.
+static bool generate_targets(const Parser* parser, const int* field_order, unsigned targets,
+                             const char* input_file, const char* output_file) {
+    int imported_capacity = 1;
+    for (int i = 0; i < parser->import_count; i++) {
+        if (parser->imports[i].iface) {
+            imported_capacity += (int)parser->imports[i].iface->header->symbol_count;
+        }
+    }
+    CodegenType* contracts = malloc(sizeof(CodegenType) * (parser->type_count + 1));
+    CodegenType* structs = malloc(sizeof(CodegenType) * (parser->type_count + 1));
+    const char** enums = malloc(sizeof(const char*) * (parser->type_count + 1));
+    const char** value_types = malloc(sizeof(const char*) * imported_capacity);
+    CodegenField* fields = malloc(sizeof(CodegenField) * (parser->field_count + 1));
+    CodegenFunction* functions = malloc(sizeof(CodegenFunction) * (parser->function_count + 1));
+    bool* claimed = calloc(parser->storage_count + 1, sizeof(bool));
+    if (!contracts || !structs || !enums || !value_types || !fields || !functions || !claimed) {
+        free(contracts);
+        free(structs);
+        free(enums);
+        free(value_types);
+        free(fields);
+        free(functions);
+        free(claimed);
+        fprintf(stderr, "❌ Error: Out of memory generating targets\n");
+        return false;
+    }
+    
+    // A contract's fields are its state blocks, a struct's its own
+    CodegenModule module;
+    memset(&module, 0, sizeof(module));
+    int contract_count = 0;
+    int struct_count = 0;
+    int enum_count = 0;
+    int field_count = 0;
+    for (int i = 0; i < parser->type_count; i++) {
+        const TypeDecl* decl = &parser->types[i];
+        if (decl->is_enum) {
+            enums[enum_count++] = decl->name;
+            continue;
+        }
+        bool is_contract = decl->kind == SYMBOL_TYPE;
+        CodegenType* type = is_contract ? &contracts[contract_count++] : &structs[struct_count++];
+        type->name = decl->name;
+        type->first_field = field_count;
+        type->field_count = 0;
+        for (int d = 0; d < parser->storage_count; d++) {
+            const StorageDecl* storage = &parser->storage[d];
+            if (claimed[d] || storage->is_state != is_contract || strcmp(storage->name, decl->name) != 0) {
+                continue;
+            }
+            claimed[d] = true;
+            for (int f = 0; f < storage->field_count; f++) {
+                int index = storage->first_field + f;
+                const FieldDecl* field = &parser->fields[field_order ? field_order[index] : index];
+                fields[field_count].name = field->name;
+                fields[field_count].type = field->type;
+                field_count++;
+            }
+            type->field_count += storage->field_count;
+        }
+    }
+    // Imported enums and contracts are value types; imported structs are not
+    int value_type_count = 0;
+    for (int i = 0; i < parser->import_count; i++) {
+        const ModuleInterface* iface = parser->imports[i].iface;
+        for (uint32_t s = 0; iface && s < iface->header->symbol_count; s++) {
+            if (iface->symbols[s].kind == SYMBOL_TYPE) {
+                value_types[value_type_count++] = interface_string(iface, iface->symbols[s].name);
+            }
+        }
+    }
+    for (int i = 0; i < parser->function_count; i++) {
+        const FunctionDecl* decl = &parser->functions[i];
+        CodegenFunction* function = &functions[i];
+        function->name = decl->name;
+        function->signature = intern_text(parser->interns, decl->signature_id);
+        function->is_event = decl->kind == DECL_EVENT;
+        function->is_public = decl->is_public;
+        function->contract = -1;
+        for (int c = 0; decl->owner && c < contract_count; c++) {
+            if (strcmp(contracts[c].name, decl->owner) == 0) {
+                function->contract = c;
+                break;
+            }
+        }
+    }
+    
+    // Outputs sit next to the object: build/token.o -> build/token.sol
+    char name[MODULE_PATH_MAX];
+    char stem[MODULE_PATH_MAX];
+    snprintf(name, sizeof(name), "%s", base_name(input_file));
+    snprintf(stem, sizeof(stem), "%s", output_file);
+    char* dot = strrchr(name, '.');
+    if (dot && dot > name) {
+        *dot = '\0';
+    }
+    dot = strrchr(stem, '.');
+    char* slash = strrchr(stem, '/');
+    if (dot && (!slash || dot > slash)) {
+        *dot = '\0';
+    }
+    
+    module.source = input_file;
+    module.name = name;
+    module.contracts = contracts;
+    module.contract_count = contract_count;
+    module.structs = structs;
+    module.struct_count = struct_count;
+    module.enums = enums;
+    module.enum_count = enum_count;
+    module.value_types = value_types;
+    module.value_type_count = value_type_count;
+    module.fields = fields;
+    module.functions = functions;
+    module.function_count = parser->function_count;
+    
+    CodegenResult results[TARGET_COUNT];
+    double started = monotonic_ms();
+    int failed = codegen_run(&module, targets, stem, results);
+    double elapsed = monotonic_ms() - started;
+    
+    int generated = 0;
+    double slowest = 0;
+    for (int t = 0; t < TARGET_COUNT; t++) {
+        if (targets & (1u << t)) {
+            generated++;
+            slowest = results[t].elapsed_ms > slowest ? results[t].elapsed_ms : slowest;
+        }
+    }
+    printf("   🎯 Targets: %d in %.2f ms (slowest %.2f ms)\n", generated, elapsed, slowest);
+    for (int t = 0; t < TARGET_COUNT; t++) {
+        if (!(targets & (1u << t))) {
+            continue;
+        }
+        if (results[t].ok) {
+            printf("      %-6s → %s (%zu bytes, %.2f ms)\n", codegen_target_name((CodegenTarget)t),
+                   results[t].path, results[t].size, results[t].elapsed_ms);
+        } else {
+            fprintf(stderr, "❌ Error: Cannot write %s output '%s'\n",
+                    codegen_target_name((CodegenTarget)t), results[t].path);
+        }
+    }
+    
+    free(contracts);
+    free(structs);
+    free(enums);
+    free(value_types);
+    free(fields);
+    free(functions);
+    free(claimed);
+    return failed == 0;
+}
+
+// ============================================================================
+// COMPILATION
+// ============================================================================
+
+// Checksum stored in object files (djb2 over the source bytes).
+uint32_t object_hash(uint32_t hash, const char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash = ((hash << 5) + hash) + data[i];
+    }
+    return hash;
+}
+
+// Serialize the object (omega_object.h): the OMG2 record plus the module's
+// declarations and the names it imports, as undefined symbols for omega_link
+// to resolve, and the `pruned` entries of a whole-program compile (may be
+// NULL). Functions and events are named by signature so that overloads
+// stay distinct. Contract members, types included, carry their owner:
+// "Owner::transfer(address,uint256)", "Owner::Position".
+void* build_object(const Parser* parser, const char* module, int token_count, uint32_t hash,
+                   const InterfaceBuilder* pruned, size_t* size) {
+    InterfaceBuilder symbols;
+    interface_builder_init(&symbols);
+    
+    bool ok = true;
+    for (int i = 0; i < parser->function_count && ok; i++) {
+        const FunctionDecl* decl = &parser->functions[i];
+        const char* signature = intern_text(parser->interns, decl->signature_id);
+        char name[2 * SIGNATURE_MAX];
+        object_symbol_name(decl->owner, signature, name, sizeof(name));
+        ok = interface_builder_add(&symbols, decl->kind == DECL_EVENT ? SYMBOL_EVENT : SYMBOL_FUNCTION,
+                                   decl->is_public, name, signature, decl->line);
+    }
+    for (int i = 0; i < parser->type_count && ok; i++) {
+        const TypeDecl* decl = &parser->types[i];
+        char name[2 * SIGNATURE_MAX];
+        object_symbol_name(decl->owner, decl->name, name, sizeof(name));
+        ok = interface_builder_add(&symbols, decl->kind, true, name,
+                                   intern_text(parser->interns, decl->signature_id), decl->line);
+    }
+    for (int i = 0; i < parser->import_count && ok; i++) {
+        const ImportDecl* import = &parser->imports[i];
+        for (int n = 0; n < import->name_count && ok; n++) {
+            ok = interface_builder_add(&symbols, SYMBOL_IMPORT, false,
+                                       parser->import_names[import->first_name + n],
+                                       import->spec, import->line);
+        }
+    }
+    for (int i = 0; pruned && i < pruned->symbol_count && ok; i++) {
+        InterfaceSymbol entry = pruned->symbols[i];
+        ok = interface_builder_add(&symbols, SYMBOL_PRUNED, false, pruned->strings + entry.name,
+                                   pruned->strings + entry.signature, 0);
+        if (ok) {
+            symbols.symbols[symbols.symbol_count - 1].line = entry.line;
+        }
+    }
+    
+    void* data = ok ? object_serialize(module, token_count, hash, &symbols, size) : NULL;
+    interface_builder_free(&symbols);
+    return data;
+}
+
+// Defer an object write to the end of a batch build. The copy holds the
+// object bytes followed by the path.
+bool queue_object(CompilerSession* session, const char* path, const char* data, size_t size) {
+    if (session->object_write_count == session->object_write_capacity) {
+        int capacity = session->object_write_capacity ? session->object_write_capacity * 2 : 64;
+        ObjectWrite* writes = realloc(session->object_writes, sizeof(ObjectWrite) * capacity);
+        if (!writes) {
+            return false;
+        }
+        session->object_writes = writes;
+        session->object_write_capacity = capacity;
+    }
+    size_t path_length = strlen(path);
+    char* copy = malloc(size + path_length + 1);
+    if (!copy) {
+        return false;
+    }
+    memcpy(copy, data, size);
+    memcpy(copy + size, path, path_length + 1);
+    ObjectWrite* write = &session->object_writes[session->object_write_count++];
+    write->path = copy + size;
+    write->data = copy;
+    write->size = size;
+    write->error = 0;
+    return true;
+}
+
+// Start the --pipeline stages; false means compile sequentially (or, with
+// *failed set, that the file cannot be opened).
+bool start_pipeline(CompilerSession* session, SourcePipeline* pipeline, const char* input_file,
+                    bool* failed) {
+    *failed = false;
+    if (pipeline_start(pipeline, input_file, session->interns, MAX_TOKENS, object_hash)) {
+        return true;
+    }
+    if (pipeline->status == PIPELINE_OPEN_FAILED) {
+        fprintf(stderr, "❌ Error: Cannot open file '%s'\n", input_file);
+        *failed = true;
+    } else if (pipeline->status == PIPELINE_UNSUPPORTED) {
+        printf("   ⚠️  --pipeline is not supported on this platform; compiling sequentially\n");
+    } else {
+        printf("   ⚠️  Cannot start pipeline threads; compiling sequentially\n");
+    }
+    return false;
+}
+
+// Phases are marked as they start; compile_file restores the caller's.
+static int compile_phases(CompilerSession* session, const char* input_file, const char* output_file) {
+    printf("🔨 OMEGA Bootstrap: Compiling %s → %s\n", input_file, output_file);
+    
+    InternTable* interns = session->interns;
+    Token* tokens = session->tokens;
+    size_t read_size = 0;
+    Utf8Result encoding;
+    char* source = NULL;
+    int token_count = 0;
+    int comment_count = 0;
+    
+    // With --pipeline the file is read and lexed on other threads while the
+    // parser below consumes tokens; the summary lines follow the parse. A
+    // parse cache needs the whole source up front, so it takes precedence.
+    SourcePipeline pipeline;
+    bool pipelined = false;
+    if (session->pipelined && !session->preloaded && !session->parse_cache) {
+        bool failed;
+        pipelined = start_pipeline(session, &pipeline, input_file, &failed);
+        if (failed) {
+            return 1;
+        }
+    }
+    
+    if (!pipelined) {
+        if (session->preloaded) {
+            // Already read by the batch loader
+            read_size = session->preloaded_size;
+            source = accept_source(input_file, session->preloaded, read_size, &encoding);
+            session->preloaded = NULL;
+        } else {
+            source = load_source(input_file, &read_size, &encoding);
+        }
+        if (!source) {
+            return 1;
+        }
+        
+        printf("   📄 Input size: %zu bytes (%s)\n", read_size, encoding.ascii ? "ASCII" : "UTF-8");
+    }
+    
+    // Imports are resolved relative to the canonical path of this module
+    enter_phase(PHASE_PARSE);
+    if (!canonical_path(input_file, session->current_path, sizeof(session->current_path))) {
+        snprintf(session->current_path, sizeof(session->current_path), "%s", input_file);
+    }
+    int module = module_graph_add(session->graph, session->current_path);
+    session->import_target_count = 0;
+    session->interfaces_mapped = 0;
+    session->interfaces_parsed = 0;
+    
+    // Tokenize and parse
+    Parser parser = create_parser(tokens, token_count, interns);
+    parser.resolver = resolve_session_import;
+    parser.resolver_context = session;
+    if (pipelined) {
+        parser.pull = pipeline_pull;
+        parser.pull_context = &pipeline;
+        parse_module(&parser);
+    } else {
+        ParseOrigin origin = parse_source(session, &parser, MAX_TOKENS, source, read_size,
+                                          &comment_count);
+        token_count = parser.token_count;
+        
+        printf("   🔤 Tokens: %d (comments: %d, code tokens: %d)\n", 
+               token_count + comment_count, comment_count, token_count);
+        if (session->parse_cache) {
+            printf("   🗃️  Parse cache: %s\n", origin == PARSED_FROM_CACHE ? "hit" :
+                   origin == PARSED_AND_CACHED ? "miss (stored)" : "miss");
+        }
+    }
+    
+    if (pipelined) {
+        has_token(&parser, MAX_TOKENS);   // drain whatever the parser left
+        bool valid = pipeline_finish(&pipeline);
+        source = pipeline.source;
+        read_size = pipeline.size;
+        encoding = pipeline.encoding;
+        comment_count = pipeline.comment_count;
+        token_count = parser.token_count;
+        if (!valid) {
+            report_encoding_error(input_file, source, &encoding);
+            free_parser(&parser);
+            pipeline_free(&pipeline);
+            return 1;
+        }
+        pipeline.source = NULL;   // freed below with the sequential buffer
+        
+        printf("   📄 Input size: %zu bytes (%s)\n", read_size, encoding.ascii ? "ASCII" : "UTF-8");
+        printf("   🔤 Tokens: %d (comments: %d, code tokens: %d)\n", 
+               token_count + comment_count, comment_count, token_count);
+    }
+    
+    int function_count = 0;
+    for (int i = 0; i < parser.function_count; i++) {
+        if (parser.functions[i].kind == DECL_FUNCTION) {
+            function_count++;
+        }
+    }
+    
+    printf("   ✓ Parsed: %d modules, %d functions, %d structs\n", 
+           1, function_count, parser.struct_count);
+    
+    if (module >= 0) {
+        module_graph_set_imports(session->graph, module, session->import_targets,
+                                 session->import_target_count);
+    }
+    if (parser.import_count > 0) {
+        printf("   📥 Imports: %d (%d resolved)\n", parser.import_count, session->import_target_count);
+        printf("   📚 Interfaces: %d symbol(s) from %d module(s) (%d mapped, %d parsed)\n",
+               parser.imported_symbols, parser.resolved_imports,
+               session->interfaces_mapped, session->interfaces_parsed);
+    }
+    
+    // Publish this module's interface for its importers
+    enter_phase(PHASE_INTERFACES);
+    if (module >= 0) {
+        set_session_interface(session, module,
+                              emit_interface(session, &parser, session->current_path, source, read_size));
+    }
+    
+    InterfaceBuilder pruned;
+    interface_builder_init(&pruned);
+    if (session->whole_program) {
+        enter_phase(PHASE_WHOLE_PROGRAM);
+        eliminate_unreachable(session, &parser, tokens, token_count, &pruned);
+    }
+    
+    enter_phase(PHASE_LAYOUT);
+    int* field_order = malloc(sizeof(int) * (parser.field_count + 1));
+    int layout_errors = analyze_storage(session, &parser, field_order);
+    
+    // Hash every public function and event signature in one batch
+    enter_phase(PHASE_SELECTORS);
+    SelectorCache* selectors = session->selectors;
+    uint32_t hashed_before = selectors->hashed;
+    uint32_t hits_before = selectors->hits;
+    for (int i = 0; i < parser.function_count; i++) {
+        if (parser.functions[i].is_public) {
+            selector_cache_request(selectors, parser.functions[i].signature_id);
+        }
+    }
+    selector_cache_flush(selectors);
+    
+    printf("   🔑 Selectors: %u hashed, %u cached (%s)\n",
+           selectors->hashed - hashed_before, selectors->hits - hits_before,
+           keccak_has_avx2() ? "AVX2 x4" : "scalar");
+    
+    if (session->print_selectors) {
+        for (int i = 0; i < parser.function_count; i++) {
+            FunctionDecl* decl = &parser.functions[i];
+            if (!decl->is_public) {
+                continue;
+            }
+            const char* signature = intern_text(interns, decl->signature_id);
+            if (decl->kind == DECL_EVENT) {
+                const uint8_t* topic = selector_cache_topic(selectors, decl->signature_id);
+                if (!topic) {
+                    printf("      event (not hashed: out of memory)  %s\n", signature);
+                    continue;
+                }
+                printf("      event 0x");
+                for (int b = 0; b < KECCAK256_DIGEST_SIZE; b++) {
+                    printf("%02x", topic[b]);
+                }
+                printf("  %s\n", signature);
+            } else {
+                printf("      0x%08x  %s\n",
+                       selector_cache_selector(selectors, decl->signature_id), signature);
+            }
+        }
+    }
+    
+    // Every target from this one parse, each on its own thread
+    bool generated = true;
+    if (session->targets) {
+        enter_phase(PHASE_CODEGEN);
+        generated = generate_targets(&parser, field_order, session->targets, input_file, output_file);
+    }
+    free(field_order);
+    
+    // Write object file; the pipeline's writer hashed the source as it arrived
+    enter_phase(PHASE_WRITE);
+    unsigned int hash = pipelined ? pipeline_checksum(&pipeline) : object_hash(0, source, read_size);
+    size_t object_size = 0;
+    void* object = build_object(&parser, input_file, token_count, hash, &pruned, &object_size);
+    interface_builder_free(&pruned);
+    bool written = object != NULL;
+    if (!object) {
+        if (pipelined) {
+            pipeline_free(&pipeline);
+        }
+    } else if (pipelined) {
+        written = pipeline_write(&pipeline, output_file, object, object_size);
+        pipeline_free(&pipeline);
+    } else if (session->batch_writes) {
+        written = queue_object(session, output_file, object, object_size);
+    } else {
+        FILE* obj_file = fopen(output_file, "wb");
+        written = obj_file != NULL;
+        if (obj_file) {
+            fwrite(object, 1, object_size, obj_file);
+            fclose(obj_file);
+        }
+    }
+    free(object);
+    if (!written) {
+        fprintf(stderr, "❌ Error: Cannot create object file '%s'\n", output_file);
+        free_parser(&parser);
+        free(source);
+        return 1;
+    }
+    
+    int errors = parser.errors;
+    free_parser(&parser);
+    free(source);
+    if (!generated) {
+        printf("❌ Compilation failed: target output not written\n");
+        return 1;
+    }
+    
+    // Check for parse and layout errors
+    if (errors == 0 && layout_errors == 0) {
+        printf("✅ Successfully compiled: %s\n", output_file);
+        printf("   📦 Object file size: %zu bytes\n", object_size);
+        return 0;
+    } else if (errors > 0) {
+        printf("❌ Compilation failed: %d parse error(s)\n", errors);
+        return 1;
+    } else {
+        printf("❌ Compilation failed: %d state layout(s) hold a recursive struct\n", layout_errors);
+        return 1;
+    }
+}
+
+int compile_file(CompilerSession* session, const char* input_file, const char* output_file) {
+    ProfilePhase outer = profile_phase(PHASE_READ);
+    TRACE_BEGIN("compile", input_file);
+    TRACE_PHASE("read");
+    int status = compile_phases(session, input_file, output_file);
+    TRACE_END();
+    profile_phase(outer);
+    return status;
+}
+
+// ============================================================================
+// BYTECODE PEEPHOLE
+// ============================================================================
+
+// Decode hex text (optional 0x prefix, whitespace ignored) into `out`;
+// returns false if `text` is not hex.
+static bool decode_hex(const char* text, size_t length, uint8_t* out, size_t* size) {
+    size_t start = length >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X') ? 2 : 0;
+    size_t written = 0;
+    int high = -1;
+    for (size_t i = start; i < length; i++) {
+        char c = text[i];
+        if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            continue;
+        }
+        int digit = c >= '0' && c <= '9' ? c - '0' :
+                    c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                    c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+        if (digit < 0) {
+            return false;
+        }
+        if (high < 0) {
+            high = digit;
+        } else {
+            out[written++] = (uint8_t)(high << 4 | digit);
+            high = -1;
+        }
+    }
+    *size = written;
+    return high < 0;
+}
+
+// Optimize EVM runtime bytecode (hex text or raw bytes) and report the
+// savings per pattern; the result is written in the input's format.
+static int run_peephole(const char* input_file, const char* output_file) {
+    FILE* file = fopen(input_file, "rb");
+    if (!file) {
+        fprintf(stderr, "❌ Error: Cannot open file '%s'\n", input_file);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* data = malloc((size_t)file_size + 1);
+    uint8_t* decoded = malloc((size_t)file_size + 1);
+    uint8_t* optimized = malloc((size_t)file_size + 1);
+    if (!data || !decoded || !optimized) {
+        fprintf(stderr, "❌ Error: Cannot allocate memory for %ld bytes\n", file_size);
+        fclose(file);
+        free(data);
+        free(decoded);
+        free(optimized);
+        return 1;
+    }
+    size_t size = fread(data, 1, (size_t)file_size, file);
+    fclose(file);
+    
+    size_t code_size;
+    bool hex = decode_hex(data, size, decoded, &code_size);
+    const uint8_t* code = hex ? decoded : (const uint8_t*)data;
+    if (!hex) {
+        code_size = size;
+    }
+    
+    PeepholeOptimizer optimizer;
+    if (!peephole_init(&optimizer)) {
+        fprintf(stderr, "❌ Error: Cannot compile peephole patterns\n");
+        free(data);
+        free(decoded);
+        free(optimized);
+        return 1;
+    }
+    PeepholeResult result = peephole_optimize(&optimizer, code, code_size, optimized);
+    
+    printf("🔧 Peephole: %s (%zu bytes)\n", input_file, result.input_size);
+    if (result.skipped) {
+        printf("   ⏭️  Left unchanged: %s\n", result.skipped);
+    }
+    for (int i = 0; i < optimizer.rule_count; i++) {
+        const PeepholeStats* stats = &optimizer.stats[i];
+        if (stats->hits > 0) {
+            printf("   %-28s %5ld× %6ld bytes %7ld gas\n",
+                   stats->name, stats->hits, stats->bytes_saved, stats->gas_saved);
+        }
+    }
+    printf("   📦 %zu -> %zu bytes, %ld static gas saved, %d jump target(s) relocated\n",
+           result.input_size, result.output_size, result.gas_saved, result.relocated);
+    peephole_free(&optimizer);
+    
+    int status = 0;
+    if (output_file) {
+        FILE* out = fopen(output_file, "wb");
+        if (!out) {
+            fprintf(stderr, "❌ Error: Cannot create output file '%s'\n", output_file);
+            status = 1;
+        } else {
+            if (hex) {
+                for (size_t i = 0; i < result.output_size; i++) {
+                    fprintf(out, "%02x", optimized[i]);
+                }
+                fputc('\n', out);
+            } else {
+                fwrite(optimized, 1, result.output_size, out);
+            }
+            fclose(out);
+            printf("✅ Wrote %s\n", output_file);
+        }
+    }
+    free(data);
+    free(decoded);
+    free(optimized);
+    return status;
+}
+
+// ============================================================================
+// WATCH MODE
+// ============================================================================
+
+#define WATCH_QUIET_MS 50
+#define WATCH_MAX_BATCH_MS 1000
+
+typedef struct {
+    char** paths;
+    int count;
+    int capacity;
+} SourceList;
+
+void collect_source(const char* path, void* context) {
+    SourceList* list = context;
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        char** paths = realloc(list->paths, sizeof(char*) * capacity);
+        if (!paths) {
+            return;
+        }
+        list->paths = paths;
+        list->capacity = capacity;
+    }
+    size_t length = strlen(path);
+    char* copy = malloc(length + 1);
+    if (copy) {
+        memcpy(copy, path, length + 1);
+        list->paths[list->count++] = copy;
+    }
+}
+
+int compile_module(CompilerSession* session, const char* input_file) {
+    char output_file[MODULE_PATH_MAX];
+    default_output_path(input_file, output_file, sizeof(output_file));
+    return compile_file(session, input_file, output_file);
+}
+
+// Compile many modules with their sources loaded in batches (io_uring where
+// available) and their objects written together at the end. With `modules`
+// (graph ids per path) a missing file counts as deleted, not failed, and
+// paths are compiled in order so importers see their imports' new
+// interfaces. Returns the number of failures.
+int build_modules(CompilerSession* session, const char* const* paths, int count,
+                  const int* modules) {
+    SourceLoader loader;
+    loader_open(&loader, paths, count, LOADER_AUTO, modules != NULL);
+    LoaderBackend read_with = loader.backend;
+    session->batch_writes = true;
+    
+    int failures = 0;
+    LoadedSource file;
+    while (loader_next(&loader, &file)) {
+        const char* path = paths[file.index];
+        if (file.error == ENOENT && modules) {
+            // Deleted: its importers are rebuilt, the module itself is dropped
+            printf("🗑️  Removed: %s\n", path);
+            module_graph_set_imports(session->graph, modules[file.index], NULL, 0);
+            continue;
+        }
+        if (file.error) {
+            fprintf(stderr, "❌ Error: Cannot open file '%s'\n", path);
+            failures++;
+            continue;
+        }
+        session->preloaded = file.data;
+        session->preloaded_size = file.size;
+        failures += compile_module(session, path);
+        free(session->preloaded);   // only left over if the compile stopped early
+        session->preloaded = NULL;
+    }
+    loader_close(&loader);
+    session->batch_writes = false;
+    
+    LoaderBackend written_with;
+    int written = session->object_write_count;
+    ProfilePhase outer = profile_phase(PHASE_WRITE);
+    TRACE_BEGIN("write objects", NULL);
+    failures += write_objects(session->object_writes, written, LOADER_AUTO, &written_with);
+    TRACE_END();
+    profile_phase(outer);
+    for (int i = 0; i < written; i++) {
+        ObjectWrite* write = &session->object_writes[i];
+        if (write->error) {
+            fprintf(stderr, "❌ Error: Cannot create object file '%s': %s\n",
+                    write->path, strerror(write->error));
+        }
+        free((void*)write->data);
+    }
+    session->object_write_count = 0;
+    
+    printf("💽 I/O: %d source(s) read (%s), %d object(s) written (%s)\n",
+           count, loader_backend_name(read_with), written, loader_backend_name(written_with));
+    return failures;
+}
+
+// Compile every module under `root` once.
+int run_build(CompilerSession* session, const char* root) {
+    SourceList sources = { NULL, 0, 0 };
+    scan_source_tree(root, collect_source, &sources);
+    
+    double started = monotonic_ms();
+    int failures = build_modules(session, (const char* const*)sources.paths, sources.count, NULL);
+    printf("🏗️  Built %s: %d module(s), %d failed in %.2f ms\n",
+           root, sources.count, failures, monotonic_ms() - started);
+    
+    for (int i = 0; i < sources.count; i++) {
+        free(sources.paths[i]);
+    }
+    free(sources.paths);
+    return failures == 0 ? 0 : 1;
+}
+
+// Rebuild changed files and everything that imports them, forever.
+int run_watch(CompilerSession* session, const char* root) {
+    if (!watcher_supported()) {
+        fprintf(stderr, "❌ Error: --watch requires Linux inotify\n");
+        return 1;
+    }
+    
+    Watcher* watcher = watcher_open(root);
+    if (!watcher) {
+        return 1;
+    }
+    
+    // Initial build of the whole tree populates the import graph
+    SourceList sources = { NULL, 0, 0 };
+    scan_source_tree(root, collect_source, &sources);
+    
+    double started = monotonic_ms();
+    int failures = build_modules(session, (const char* const*)sources.paths, sources.count, NULL);
+    for (int i = 0; i < sources.count; i++) {
+        free(sources.paths[i]);
+    }
+    free(sources.paths);
+    
+    printf("👀 Watching %s: %d module(s), %d failed, initial build %.2f ms\n",
+           root, sources.count, failures, monotonic_ms() - started);
+    fflush(stdout);
+    
+    for (;;) {
+        int changed_count = watcher_wait(watcher, WATCH_QUIET_MS, WATCH_MAX_BATCH_MS);
+        if (changed_count < 0) {
+            fprintf(stderr, "❌ Error: watch failed\n");
+            break;
+        }
+        
+        double rebuild_started = monotonic_ms();
+        char path[MODULE_PATH_MAX];
+        int* changed;
+        int known = 0;
+        if (watcher_overflowed(watcher)) {
+            // Some changes went unreported: every module, present or gone,
+            // counts as changed
+            printf("⚠️  Watch queue overflowed; rescanning %s and rebuilding everything\n", root);
+            SourceList rescanned = { NULL, 0, 0 };
+            scan_source_tree(root, collect_source, &rescanned);
+            for (int i = 0; i < rescanned.count; i++) {
+                if (canonical_path(rescanned.paths[i], path, sizeof(path))) {
+                    module_graph_add(session->graph, path);
+                }
+                free(rescanned.paths[i]);
+            }
+            free(rescanned.paths);
+            changed = malloc(sizeof(int) * (session->graph->count + 1));
+            for (int i = 0; changed && i < session->graph->count; i++) {
+                changed[known++] = i;
+            }
+        } else {
+            changed = malloc(sizeof(int) * (changed_count + 1));
+            for (int i = 0; changed && i < changed_count; i++) {
+                if (canonical_path(watcher_changed_path(watcher, i), path, sizeof(path))) {
+                    int module = module_graph_add(session->graph, path);
+                    if (module >= 0) {
+                        changed[known++] = module;
+                    }
+                }
+            }
+        }
+        
+        int* affected = malloc(sizeof(int) * (session->graph->count + 1));
+        int affected_count = module_graph_affected(session->graph, changed, known, affected);
+        
+        const char** affected_paths = malloc(sizeof(char*) * (affected_count + 1));
+        for (int i = 0; i < affected_count; i++) {
+            affected_paths[i] = module_graph_path(session->graph, affected[i]);
+        }
+        failures = build_modules(session, affected_paths, affected_count, affected);
+        free(affected_paths);
+        
+        printf("⏱️  Rebuilt %d module(s) (%d changed, %d importers, %d failed) in %.2f ms\n",
+               affected_count, known, affected_count - known, failures,
+               monotonic_ms() - rebuild_started);
+        fflush(stdout);
+        
+        free(changed);
+        free(affected);
+    }
+    
+    watcher_close(watcher);
+    return 1;
+}
+
+// ============================================================================
+// MAIN - Now outputs .o files
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "OMEGA Minimal Bootstrap Compiler v2.0\n");
+        fprintf(stderr, "Usage: omega_minimal <file.omega|file.mega> [--output <file.o>] [--selectors]\n");
+        fprintf(stderr, "                     [--layout] [--gas] [--whole-program] [--pipeline]\n");
+        fprintf(stderr, "                     [--parse-cache <dir>] [--parse-cache-mb <n>]\n");
+        fprintf(stderr, "                     [--interface-dir <dir>]\n");
+        fprintf(stderr, "                     [--profile=<file.folded>] [--profile-hz=<n>]\n");
+        fprintf(stderr, "                     [--target evm|solana|cosmos|all]\n");
+        fprintf(stderr, "       omega_minimal --build <dir> [--std-dir <dir>]\n");
+        fprintf(stderr, "       omega_minimal --watch <dir> [--std-dir <dir>]\n");
+        fprintf(stderr, "       omega_minimal --peephole <runtime.hex|runtime.bin> [--output <file>]\n");
+        fprintf(stderr, "       omega_minimal --version\n");
+        return 1;
+    }
+    
+    // Handle version flag
+    if (strcmp(argv[1], "--version") == 0) {
+        printf("OMEGA Bootstrap v" OMEGA_VERSION "\n");
+        printf("Pure C implementation - cross-platform\n");
+        return 0;
+    }
+    
+    CompilerSession session;
+    if (!create_session(&session)) {
+        fprintf(stderr, "❌ Error: Cannot allocate compiler state\n");
+        return 1;
+    }
+    TRACE_OPEN("omega_minimal");
+    TRACE_BEGIN("omega_minimal", argv[1]);
+    
+    // Determine input and output
+    const char* input_file = NULL;
+    const char* output_file = NULL;
+    const char* watch_dir = NULL;
+    const char* build_dir = NULL;
+    const char* peephole_file = NULL;
+    const char* cache_dir = getenv("OMEGA_PARSE_CACHE");
+    const char* interface_dir = getenv("OMEGA_INTERFACE_DIR");
+    long cache_mb = PARSE_CACHE_DEFAULT_MB;
+    const char* profile_file = NULL;
+    int profile_hz = PROFILE_DEFAULT_HZ;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            watch_dir = argv[++i];
+        } else if (strcmp(argv[i], "--build") == 0 && i + 1 < argc) {
+            build_dir = argv[++i];
+        } else if (strcmp(argv[i], "--peephole") == 0 && i + 1 < argc) {
+            peephole_file = argv[++i];
+        } else if (strcmp(argv[i], "--std-dir") == 0 && i + 1 < argc) {
+            session.std_dir = argv[++i];
+        } else if (strcmp(argv[i], "--selectors") == 0) {
+            session.print_selectors = true;
+        } else if (strcmp(argv[i], "--layout") == 0) {
+            session.print_layout = true;
+        } else if (strcmp(argv[i], "--gas") == 0) {
+            session.print_gas = true;
+        } else if (strcmp(argv[i], "--whole-program") == 0) {
+            session.whole_program = true;
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            session.pipelined = true;
+        } else if (strcmp(argv[i], "--parse-cache") == 0 && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "--interface-dir") == 0 && i + 1 < argc) {
+            interface_dir = argv[++i];
+        } else if (strcmp(argv[i], "--parse-cache-mb") == 0 && i + 1 < argc) {
+            cache_mb = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc) {
+            if (!codegen_parse_targets(argv[++i], &session.targets)) {
+                fprintf(stderr, "❌ Error: Unknown target '%s' (expected evm, solana, cosmos or all)\n", argv[i]);
+                TRACE_END();
+                TRACE_CLOSE();
+                destroy_session(&session);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--profile=", 10) == 0) {
+            profile_file = argv[i] + 10;
+        } else if (strncmp(argv[i], "--profile-hz=", 13) == 0) {
+            profile_hz = atoi(argv[i] + 13);
+        } else if (!input_file) {
+            input_file = argv[i];
+        }
+    }
+    
+    // Shared with other tools through the directory; a cache that cannot be
+    // opened only costs the speedup
+    if (cache_dir && cache_dir[0] && !peephole_file) {
+        session.parse_cache = malloc(sizeof(ParseCache));
+        if (!session.parse_cache ||
+            !parse_cache_open(session.parse_cache, cache_dir,
+                              (uint64_t)(cache_mb > 0 ? cache_mb : 1) * 1024 * 1024)) {
+            fprintf(stderr, "⚠️  Warning: Cannot use parse cache '%s'; parsing everything\n", cache_dir);
+            free(session.parse_cache);
+            session.parse_cache = NULL;
+        }
+    }
+    
+    // Interfaces are a build cache: kept out of the source tree, and only in
+    // memory if the directory cannot be created
+    if (!peephole_file) {
+        session.interface_dir = interface_dir && interface_dir[0] ? interface_dir : INTERFACE_DEFAULT_DIR;
+        if (!make_directories(session.interface_dir)) {
+            fprintf(stderr, "⚠️  Warning: Cannot create interface directory '%s'; imports are parsed each compile\n",
+                    session.interface_dir);
+            session.interface_dir = NULL;
+        }
+    }
+    
+    // --watch never returns, so its profile would never be written
+    bool profiling = false;
+    if (profile_file && profile_file[0]) {
+        if (watch_dir) {
+            fprintf(stderr, "⚠️  Warning: --profile is ignored with --watch\n");
+        } else if (!(profiling = profiler_start(profile_file, profile_hz > 0 ? profile_hz : PROFILE_DEFAULT_HZ))) {
+            fprintf(stderr, "⚠️  Warning: Sampling profiler is not supported on this platform\n");
+        }
+    }
+    
+    int status;
+    if (watch_dir) {
+        status = run_watch(&session, watch_dir);
+    } else if (build_dir) {
+        status = run_build(&session, build_dir);
+    } else if (peephole_file) {
+        status = run_peephole(peephole_file, output_file);
+    } else if (!input_file) {
+        fprintf(stderr, "❌ Error: No input file specified\n");
+        status = 1;
+    } else {
+        // Generate default output filename if not specified
+        char auto_output[MODULE_PATH_MAX];
+        if (!output_file) {
+            default_output_path(input_file, auto_output, sizeof(auto_output));
+            output_file = auto_output;
+        }
+        status = compile_file(&session, input_file, output_file);
+    }
+    
+    if (profiling) {
+        ProfileReport report;
+        bool written = profiler_stop(&report);
+        printf("📈 Profile: %ld samples (%d Hz, %ld dropped) %s %s\n", report.samples, report.hz,
+               report.dropped, written ? "→" : "not written to", profile_file);
+        for (int phase = 0; phase < PHASE_COUNT && report.samples > 0; phase++) {
+            if (report.phase_samples[phase] > 0) {
+                printf("   %-14s %5.1f%%\n", profile_phase_name((ProfilePhase)phase),
+                       100.0 * report.phase_samples[phase] / report.samples);
+            }
+        }
+    }
+    
+    TRACE_END();
+    TRACE_CLOSE();
+    destroy_session(&session);
+    return status;
 }
@@ -0,0 +1,423 @@
+// OMEGA Bootstrap - Module Graph
+// Import resolution, canonical paths and the bidirectional import graph.
+
+#if !defined(_WIN32)
+#define _XOPEN_SOURCE 700
+#endif
+
+#include "omega_modules.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+ModuleGraph* module_graph_create(InternTable* interns) {
+    ModuleGraph* graph = calloc(1, sizeof(ModuleGraph));
+    if (!graph) {
+        return NULL;
+    }
+    graph->interns = interns;
+    return graph;
+}
+
+void module_graph_destroy(ModuleGraph* graph) {
+    if (!graph) {
+        return;
+    }
+    for (int i = 0; i < graph->count; i++) {
+        free(graph->modules[i].imports);
+        free(graph->modules[i].importers);
+    }
+    free(graph->modules);
+    free(graph->index_by_path);
+    free(graph);
+}
+
+static bool append_edge(int** edges, int* count, int* capacity, int value) {
+    if (*count == *capacity) {
+        int new_capacity = *capacity ? *capacity * 2 : 8;
+        int* grown = realloc(*edges, sizeof(int) * new_capacity);
+        if (!grown) {
+            return false;
+        }
+        *edges = grown;
+        *capacity = new_capacity;
+    }
+    (*edges)[(*count)++] = value;
+    return true;
+}
+
+int module_graph_find(const ModuleGraph* graph, const char* canonical) {
+    uint32_t id = intern_find(graph->interns, canonical, strlen(canonical));
+    if (id == 0 || id >= graph->index_capacity) {
+        return -1;
+    }
+    return graph->index_by_path[id] - 1;
+}
+
+int module_graph_add(ModuleGraph* graph, const char* canonical) {
+    int existing = module_graph_find(graph, canonical);
+    if (existing >= 0) {
+        return existing;
+    }
+
+    uint32_t id = intern_cstr(graph->interns, canonical);
+    if (id == 0) {
+        return -1;
+    }
+
+    if (id >= graph->index_capacity) {
+        uint32_t capacity = graph->index_capacity ? graph->index_capacity : 256;
+        while (capacity <= id) {
+            capacity *= 2;
+        }
+        int* index = realloc(graph->index_by_path, sizeof(int) * capacity);
+        if (!index) {
+            return -1;
+        }
+        memset(index + graph->index_capacity, 0, sizeof(int) * (capacity - graph->index_capacity));
+        graph->index_by_path = index;
+        graph->index_capacity = capacity;
+    }
+
+    if (graph->count == graph->capacity) {
+        int capacity = graph->capacity ? graph->capacity * 2 : 64;
+        ModuleNode* modules = realloc(graph->modules, sizeof(ModuleNode) * capacity);
+        if (!modules) {
+            return -1;
+        }
+        graph->modules = modules;
+        graph->capacity = capacity;
+    }
+
+    int module = graph->count++;
+    memset(&graph->modules[module], 0, sizeof(ModuleNode));
+    graph->modules[module].path_id = id;
+    graph->index_by_path[id] = module + 1;
+    return module;
+}
+
+const char* module_graph_path(const ModuleGraph* graph, int module) {
+    return intern_text(graph->interns, graph->modules[module].path_id);
+}
+
+void module_graph_set_imports(ModuleGraph* graph, int module, const int* imports, int count) {
+    ModuleNode* node = &graph->modules[module];
+
+    // Drop this module from the importer lists of its old imports
+    for (int i = 0; i < node->import_count; i++) {
+        ModuleNode* target = &graph->modules[node->imports[i]];
+        for (int j = 0; j < target->importer_count; j++) {
+            if (target->importers[j] == module) {
+                target->importers[j] = target->importers[--target->importer_count];
+                break;
+            }
+        }
+    }
+    node->import_count = 0;
+
+    for (int i = 0; i < count; i++) {
+        bool duplicate = false;
+        for (int j = 0; j < node->import_count; j++) {
+            if (node->imports[j] == imports[i]) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate || imports[i] == module) {
+            continue;
+        }
+        append_edge(&node->imports, &node->import_count, &node->import_capacity, imports[i]);
+        ModuleNode* target = &graph->modules[imports[i]];
+        append_edge(&target->importers, &target->importer_count, &target->importer_capacity, module);
+        node = &graph->modules[module];
+    }
+}
+
+enum { AFFECTED_NO, AFFECTED_PENDING, AFFECTED_OPEN, AFFECTED_DONE };
+
+int module_graph_affected(const ModuleGraph* graph, const int* changed, int changed_count, int* out) {
+    int capacity = graph->count > 0 ? graph->count : 1;
+    unsigned char* state = calloc(capacity, 1);
+    int* found = malloc(sizeof(int) * capacity);
+    int* stack = malloc(sizeof(int) * capacity);
+    int* next_edge = malloc(sizeof(int) * capacity);
+    if (!state || !found || !stack || !next_edge) {
+        free(state);
+        free(found);
+        free(stack);
+        free(next_edge);
+        return 0;
+    }
+
+    int found_count = 0;
+    for (int i = 0; i < changed_count; i++) {
+        if (changed[i] >= 0 && state[changed[i]] == AFFECTED_NO) {
+            state[changed[i]] = AFFECTED_PENDING;
+            found[found_count++] = changed[i];
+        }
+    }
+
+    // Breadth-first over reverse edges collects the affected set
+    for (int head = 0; head < found_count; head++) {
+        const ModuleNode* node = &graph->modules[found[head]];
+        for (int i = 0; i < node->importer_count; i++) {
+            int importer = node->importers[i];
+            if (state[importer] == AFFECTED_NO) {
+                state[importer] = AFFECTED_PENDING;
+                found[found_count++] = importer;
+            }
+        }
+    }
+
+    // Depth-first post-order over import edges inside the set puts every
+    // module after the affected modules it imports. Roots are taken in
+    // collection order and edges in source order; an edge back to a module
+    // still open is a cycle and is skipped, so cycles break the same way on
+    // every run.
+    int count = 0;
+    for (int root = 0; root < found_count; root++) {
+        if (state[found[root]] != AFFECTED_PENDING) {
+            continue;
+        }
+        int depth = 0;
+        stack[depth] = found[root];
+        next_edge[depth] = 0;
+        state[found[root]] = AFFECTED_OPEN;
+        while (depth >= 0) {
+            const ModuleNode* node = &graph->modules[stack[depth]];
+            if (next_edge[depth] < node->import_count) {
+                int import = node->imports[next_edge[depth]++];
+                if (state[import] == AFFECTED_PENDING) {
+                    state[import] = AFFECTED_OPEN;
+                    stack[++depth] = import;
+                    next_edge[depth] = 0;
+                }
+            } else {
+                state[stack[depth]] = AFFECTED_DONE;
+                out[count++] = stack[depth--];
+            }
+        }
+    }
+
+    free(state);
+    free(found);
+    free(stack);
+    free(next_edge);
+    return count;
+}
+
+// ============================================================================
+// PATHS
+// ============================================================================
+
+static bool is_regular_file(const char* path) {
+    struct stat info;
+    return stat(path, &info) == 0 && S_ISREG(info.st_mode);
+}
+
+bool canonical_path(const char* path, char* out, size_t out_size) {
+#ifdef _WIN32
+    if (!_fullpath(out, path, out_size)) {
+        return false;
+    }
+    for (char* p = out; *p; p++) {
+        if (*p == '\\') *p = '/';
+    }
+    return true;
+#else
+    char* resolved = realpath(path, NULL);
+    if (!resolved) {
+        // Deleted files still need a stable key: resolve the directory
+        char directory[MODULE_PATH_MAX];
+        const char* slash = strrchr(path, '/');
+        if (!slash) {
+            return false;
+        }
+        size_t length = (size_t)(slash - path);
+        if (length == 0 || length >= sizeof(directory)) {
+            return false;
+        }
+        memcpy(directory, path, length);
+        directory[length] = '\0';
+        char* parent = realpath(directory, NULL);
+        if (!parent) {
+            return false;
+        }
+        int written = snprintf(out, out_size, "%s%s", parent, slash);
+        free(parent);
+        return written > 0 && (size_t)written < out_size;
+    }
+    bool fits = strlen(resolved) < out_size;
+    if (fits) {
+        strcpy(out, resolved);
+    }
+    free(resolved);
+    return fits;
+#endif
+}
+
+bool is_source_file(const char* path) {
+    const char* dot = strrchr(path, '.');
+    return dot && (strcmp(dot, ".mega") == 0 || strcmp(dot, ".omega") == 0);
+}
+
+bool make_directories(const char* path) {
+    char partial[MODULE_PATH_MAX];
+    size_t length = strlen(path);
+    if (length == 0 || length >= sizeof(partial)) {
+        return false;
+    }
+    memcpy(partial, path, length + 1);
+    for (size_t i = 1; i <= length; i++) {
+        if (partial[i] == '/' || partial[i] == '\0') {
+            char saved = partial[i];
+            partial[i] = '\0';
+#ifdef _WIN32
+            _mkdir(partial);
+#else
+            mkdir(partial, 0755);
+#endif
+            partial[i] = saved;
+        }
+    }
+    struct stat info;
+    return stat(path, &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+static bool try_candidate(const char* candidate, char* out, size_t out_size) {
+    static const char* extensions[] = { "", ".mega", ".omega", NULL };
+    char path[2 * MODULE_PATH_MAX + 8];
+
+    for (int i = 0; extensions[i] != NULL; i++) {
+        int written = snprintf(path, sizeof(path), "%s%s", candidate, extensions[i]);
+        if (written < 0 || (size_t)written >= sizeof(path)) {
+            continue;
+        }
+        if (is_regular_file(path)) {
+            return canonical_path(path, out, out_size);
+        }
+    }
+    return false;
+}
+
+static void directory_of(const char* path, char* out, size_t out_size) {
+    const char* slash = strrchr(path, '/');
+#ifdef _WIN32
+    const char* backslash = strrchr(path, '\\');
+    if (!slash || (backslash && backslash > slash)) slash = backslash;
+#endif
+    if (!slash) {
+        snprintf(out, out_size, ".");
+        return;
+    }
+    size_t length = (size_t)(slash - path);
+    if (length >= out_size) {
+        length = out_size - 1;
+    }
+    memcpy(out, path, length);
+    out[length] = '\0';
+}
+
+bool resolve_import(const char* importer, const char* spec, const char* std_dir,
+                    char* out, size_t out_size) {
+    char base[MODULE_PATH_MAX];
+    char candidate[2 * MODULE_PATH_MAX + 2];
+    directory_of(importer, base, sizeof(base));
+
+    // Path-style spec: std::io -> <std_dir>/io, a::b -> <importer dir>/a/b
+    if (strstr(spec, "::") != NULL) {
+        char relative[MODULE_PATH_MAX];
+        const char* rest = spec;
+        const char* root = base;
+        if (strncmp(spec, "std::", 5) == 0) {
+            rest = spec + 5;
+            root = std_dir;
+        }
+
+        size_t length = 0;
+        for (const char* p = rest; *p && length + 1 < sizeof(relative); p++) {
+            if (p[0] == ':' && p[1] == ':') {
+                relative[length++] = '/';
+                p++;
+            } else {
+                relative[length++] = *p;
+            }
+        }
+        relative[length] = '\0';
+
+        snprintf(candidate, sizeof(candidate), "%s/%s", root, relative);
+        return try_candidate(candidate, out, out_size);
+    }
+
+    if (strncmp(spec, "./", 2) == 0 || strncmp(spec, "../", 3) == 0) {
+        snprintf(candidate, sizeof(candidate), "%s/%s", base, spec);
+        return try_candidate(candidate, out, out_size);
+    }
+
+    if (strncmp(spec, "std/", 4) == 0) {
+        snprintf(candidate, sizeof(candidate), "%s/%s", std_dir, spec + 4);
+        if (try_candidate(candidate, out, out_size)) {
+            return true;
+        }
+    }
+
+    if (strchr(spec, '/') == NULL && strchr(spec, '.') == NULL) {
+        // Bare module name: std first, then the importing directory
+        snprintf(candidate, sizeof(candidate), "%s/%s", std_dir, spec);
+        if (try_candidate(candidate, out, out_size)) {
+            return true;
+        }
+    }
+
+    if (try_candidate(spec, out, out_size)) {
+        return true;
+    }
+
+    snprintf(candidate, sizeof(candidate), "%s/%s", base, spec);
+    return try_candidate(candidate, out, out_size);
+}
+
+int scan_source_tree(const char* root, SourceVisitor visit, void* context) {
+    DIR* dir = opendir(root);
+    if (!dir) {
+        return 0;
+    }
+
+    int found = 0;
+    struct dirent* entry;
+    char path[MODULE_PATH_MAX];
+
+    while ((entry = readdir(dir)) != NULL) {
+        // Skip ".", "..", hidden directories (.git) and package caches
+        if (entry->d_name[0] == '.' || strcmp(entry->d_name, "node_modules") == 0) {
+            continue;
+        }
+
+        int written = snprintf(path, sizeof(path), "%s/%s", root, entry->d_name);
+        if (written < 0 || (size_t)written >= sizeof(path)) {
+            continue;
+        }
+
+        struct stat info;
+        if (stat(path, &info) != 0) {
+            continue;
+        }
+
+        if (S_ISDIR(info.st_mode)) {
+            found += scan_source_tree(path, visit, context);
+        } else if (S_ISREG(info.st_mode) && is_source_file(path)) {
+            visit(path, context);
+            found++;
+        }
+    }
+
+    closedir(dir);
+    return found;
+}
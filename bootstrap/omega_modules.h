@@ -0,0 +1,78 @@
+// OMEGA Bootstrap - Module Graph
+// Purpose: Resolve import specs to source files and track who imports whom
+// Platform: Windows, Linux, macOS (C99 + POSIX/Win32 path APIs)
+// Modules are keyed by interned canonical path. Edges are kept in both
+// directions so a change can be propagated to every transitive importer.
+
+#ifndef OMEGA_MODULES_H
+#define OMEGA_MODULES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "omega_intern.h"
+
+#define MODULE_PATH_MAX 4096
+
+typedef struct {
+    uint32_t path_id;       // interned canonical path
+    int* imports;           // indices of modules this module imports
+    int import_count;
+    int import_capacity;
+    int* importers;         // indices of modules importing this module
+    int importer_count;
+    int importer_capacity;
+} ModuleNode;
+
+typedef struct {
+    InternTable* interns;   // borrowed
+    ModuleNode* modules;
+    int count;
+    int capacity;
+    int* index_by_path;     // intern ID -> module index + 1 (0 = none)
+    uint32_t index_capacity;
+} ModuleGraph;
+
+ModuleGraph* module_graph_create(InternTable* interns);
+void module_graph_destroy(ModuleGraph* graph);
+
+// Find or add the module for a canonical path; returns its index or -1.
+int module_graph_add(ModuleGraph* graph, const char* canonical);
+int module_graph_find(const ModuleGraph* graph, const char* canonical);
+const char* module_graph_path(const ModuleGraph* graph, int module);
+
+// Replace the outgoing import edges of `module`, updating reverse edges.
+void module_graph_set_imports(ModuleGraph* graph, int module, const int* imports, int count);
+
+// Collect `changed` plus every transitive importer into `out` (capacity
+// graph->count) in import order: each module comes after the affected
+// modules it imports, so building in this order lets importers see their
+// imports' fresh interfaces. Import cycles are broken deterministically.
+// Returns the number collected.
+int module_graph_affected(const ModuleGraph* graph, const int* changed, int changed_count, int* out);
+
+// ============================================================================
+// PATHS
+// ============================================================================
+
+bool canonical_path(const char* path, char* out, size_t out_size);
+bool is_source_file(const char* path);
+
+// Create `path` and any missing parents; true if it is a directory after.
+bool make_directories(const char* path);
+
+// Resolve an import spec as written in source:
+//   "./x.mega", "../dir/x"  relative to the importing file
+//   std::io, "std/io"       inside std_dir
+//   "src/std/io"            relative to the working directory
+// Missing extensions are tried as .mega then .omega. Writes the canonical
+// path to `out` and returns true if the file exists.
+bool resolve_import(const char* importer, const char* spec, const char* std_dir,
+                    char* out, size_t out_size);
+
+// Call `visit` for every .omega/.mega file under `root` (recursively).
+typedef void (*SourceVisitor)(const char* path, void* context);
+int scan_source_tree(const char* root, SourceVisitor visit, void* context);
+
+#endif // OMEGA_MODULES_H
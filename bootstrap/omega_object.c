@@ -0,0 +1,294 @@
+// OMEGA Bootstrap - Object Files and Linked Images
+// Object serialization and validation, and image mapping and lookup.
+
+#if !defined(_WIN32)
+#define _XOPEN_SOURCE 700
+#endif
+
+#include "omega_object.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Whole file, mapped where possible.
+static bool map_file(const char* path, void** data, size_t* size, bool* mapped) {
+    struct stat info;
+    if (stat(path, &info) != 0 || info.st_size <= 0) {
+        return false;
+    }
+    *size = (size_t)info.st_size;
+#ifdef _WIN32
+    FILE* file = fopen(path, "rb");
+    *data = file ? malloc(*size) : NULL;
+    bool ok = *data && fread(*data, 1, *size, file) == *size;
+    if (file) fclose(file);
+    if (!ok) {
+        free(*data);
+        return false;
+    }
+    *mapped = false;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    void* map = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    *data = map;
+    *mapped = true;
+#endif
+    return true;
+}
+
+static void unmap_file(void* data, size_t size, bool mapped) {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(data, size);
+        return;
+    }
+#endif
+    (void)size;
+    (void)mapped;
+    free(data);
+}
+
+static uint32_t read_u32(const unsigned char* at) {
+    uint32_t value;
+    memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+// ============================================================================
+// OBJECTS
+// ============================================================================
+
+void* object_serialize(const char* module, int token_count, uint32_t checksum,
+                       const InterfaceBuilder* symbols, size_t* size) {
+    uint32_t module_size = (uint32_t)strlen(module) + 1;
+    uint32_t symbol_count = (uint32_t)symbols->symbol_count;
+    size_t symbols_size = sizeof(InterfaceSymbol) * symbol_count;
+    *size = OBJECT_RECORD_SIZE + 4 + module_size + 8 + symbols_size + symbols->strings_size;
+    unsigned char* data = malloc(*size);
+    if (!data) {
+        return NULL;
+    }
+
+    unsigned char* out = data;
+    memcpy(out, OBJECT_MAGIC, 4);
+    out[4] = OBJECT_VERSION;
+    int32_t module_count = 1;
+    int32_t tokens = token_count;
+    memcpy(out + 5, &module_count, 4);
+    memcpy(out + 9, &tokens, 4);
+    memcpy(out + 13, &checksum, 4);
+    out += OBJECT_RECORD_SIZE;
+
+    memcpy(out, &module_size, 4);
+    memcpy(out + 4, module, module_size);
+    out += 4 + module_size;
+    memcpy(out, &symbol_count, 4);
+    memcpy(out + 4, &symbols->strings_size, 4);
+    out += 8;
+    if (symbols_size > 0) {
+        memcpy(out, symbols->symbols, symbols_size);
+        out += symbols_size;
+    }
+    if (symbols->strings_size > 0) {
+        memcpy(out, symbols->strings, symbols->strings_size);
+    }
+    return data;
+}
+
+// Check the record, then that every section and offset stays in the file.
+static bool object_bind(ObjectFile* object) {
+    const unsigned char* data = object->data;
+    if (object->size < OBJECT_RECORD_SIZE || memcmp(data, OBJECT_MAGIC, 4) != 0) {
+        return false;
+    }
+    object->version = (char)data[4];
+    object->token_count = (int32_t)read_u32(data + 9);
+    object->checksum = read_u32(data + 13);
+    object->module = "";
+    if (object->version == '1') {
+        return object->size == OBJECT_RECORD_SIZE;
+    }
+    if (object->version != OBJECT_VERSION) {
+        return false;
+    }
+
+    size_t at = OBJECT_RECORD_SIZE;
+    if (object->size - at < 4) {
+        return false;
+    }
+    uint32_t module_size = read_u32(data + at);
+    at += 4;
+    if (module_size == 0 || object->size - at < (size_t)module_size + 8 ||
+        data[at + module_size - 1] != '\0') {
+        return false;
+    }
+    object->module = (const char*)data + at;
+    at += module_size;
+    object->symbol_count = read_u32(data + at);
+    object->strings_size = read_u32(data + at + 4);
+    at += 8;
+    size_t symbols_size = sizeof(InterfaceSymbol) * (size_t)object->symbol_count;
+    if (object->size - at != symbols_size + object->strings_size ||
+        (object->strings_size > 0 && data[object->size - 1] != '\0')) {
+        return false;
+    }
+    object->symbols = data + at;
+    object->strings = (const char*)data + at + symbols_size;
+    for (uint32_t i = 0; i < object->symbol_count; i++) {
+        InterfaceSymbol symbol = object_symbol(object, i);
+        if (symbol.name >= object->strings_size || symbol.signature >= object->strings_size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool object_open(ObjectFile* object, const char* path) {
+    memset(object, 0, sizeof(ObjectFile));
+    if (!map_file(path, &object->data, &object->size, &object->mapped)) {
+        return false;
+    }
+    if (!object_bind(object)) {
+        object_close(object);
+        return false;
+    }
+    return true;
+}
+
+void object_close(ObjectFile* object) {
+    if (object->data) {
+        unmap_file(object->data, object->size, object->mapped);
+    }
+    memset(object, 0, sizeof(ObjectFile));
+}
+
+InterfaceSymbol object_symbol(const ObjectFile* object, uint32_t index) {
+    InterfaceSymbol symbol;
+    memcpy(&symbol, object->symbols + sizeof(InterfaceSymbol) * index, sizeof(symbol));
+    return symbol;
+}
+
+// ============================================================================
+// IMAGES
+// ============================================================================
+
+uint32_t image_hash(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* c = (const unsigned char*)name; *c; c++) {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    return hash;
+}
+
+static bool section_fits(const LinkedImage* image, uint64_t offset, uint64_t count, size_t item) {
+    return offset % 4 == 0 && offset <= image->size && count <= (image->size - offset) / item;
+}
+
+static bool image_bind(LinkedImage* image) {
+    if (image->size < sizeof(ImageHeader)) {
+        return false;
+    }
+    const ImageHeader* header = image->data;
+    if (memcmp(header->magic, IMAGE_MAGIC, 4) != 0 || header->version != IMAGE_VERSION ||
+        header->index_size == 0 || (header->index_size & (header->index_size - 1)) != 0 ||
+        header->global_count >= header->index_size ||
+        !section_fits(image, header->modules_offset, header->module_count, sizeof(ImageModule)) ||
+        !section_fits(image, header->symbols_offset, header->symbol_count, sizeof(ImageSymbol)) ||
+        !section_fits(image, header->index_offset, header->index_size, sizeof(uint32_t)) ||
+        !section_fits(image, header->strings_offset, header->strings_size, 1) ||
+        header->strings_size == 0 ||
+        ((const char*)image->data)[header->strings_offset + header->strings_size - 1] != '\0') {
+        return false;
+    }
+
+    const char* base = image->data;
+    image->header = header;
+    image->modules = (const ImageModule*)(base + header->modules_offset);
+    image->symbols = (const ImageSymbol*)(base + header->symbols_offset);
+    image->index = (const uint32_t*)(base + header->index_offset);
+    image->strings = base + header->strings_offset;
+
+    for (uint32_t i = 0; i < header->module_count; i++) {
+        const ImageModule* module = &image->modules[i];
+        if (module->path >= header->strings_size || module->first_symbol > header->symbol_count ||
+            module->symbol_count > header->symbol_count - module->first_symbol) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->symbol_count; i++) {
+        const ImageSymbol* symbol = &image->symbols[i];
+        if (symbol->name >= header->strings_size || symbol->signature >= header->strings_size ||
+            symbol->module >= header->module_count ||
+            (symbol->target != IMAGE_UNRESOLVED && symbol->target >= header->symbol_count)) {
+            return false;
+        }
+    }
+    // An empty slot must remain, or a failed lookup would never stop
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < header->index_size; i++) {
+        if (image->index[i] > header->symbol_count) {
+            return false;
+        }
+        used += image->index[i] != 0;
+    }
+    return used == header->global_count;
+}
+
+LinkedImage* image_open(const char* path) {
+    LinkedImage* image = calloc(1, sizeof(LinkedImage));
+    if (!image) {
+        return NULL;
+    }
+    if (!map_file(path, &image->data, &image->size, &image->mapped)) {
+        free(image);
+        return NULL;
+    }
+    if (!image_bind(image)) {
+        image_close(image);
+        return NULL;
+    }
+    return image;
+}
+
+void image_close(LinkedImage* image) {
+    if (!image) {
+        return;
+    }
+    unmap_file(image->data, image->size, image->mapped);
+    free(image);
+}
+
+int image_find(const LinkedImage* image, const char* name) {
+    uint32_t hash = image_hash(name);
+    uint32_t mask = image->header->index_size - 1;
+    // The index is never full, so probing stops at an empty slot
+    for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        uint32_t entry = image->index[slot];
+        if (entry == 0) {
+            return -1;
+        }
+        const ImageSymbol* symbol = &image->symbols[entry - 1];
+        if (symbol->hash == hash && strcmp(image->strings + symbol->name, name) == 0) {
+            return (int)(entry - 1);
+        }
+    }
+}
+
+const char* image_string(const LinkedImage* image, uint32_t offset) {
+    return image->strings + offset;
+}
@@ -0,0 +1,149 @@
+// OMEGA Bootstrap - Object Files and Linked Images
+// Purpose: Symbol tables in OMG2 objects, and the indexed image omega_link writes
+// Platform: Windows, Linux, macOS (C99; mmap on POSIX, buffered read on Windows)
+// An object starts with the original 17-byte OMG2 record (magic, version
+// byte, module count, token count, source checksum). Version '2' objects
+// follow it with the module's path and a symbol table. The table lists what
+// the module declares and each name it imports, as an undefined
+// SYMBOL_IMPORT whose signature is the import spec. Public functions and
+// events and every type are global, other functions local. Functions and
+// events are named by canonical signature so overloads stay distinct, and
+// contract members carry their owner: "Token::transfer(address,uint256)",
+// "Token::Position" for a struct declared inside Token. Imports name
+// top-level types, so they resolve by plain name. Under --whole-program
+// only declarations that survived elimination are listed, followed by a
+// SYMBOL_PRUNED entry per unreachable declaration of an import: its name is
+// the one the import's object defines, its signature the import's path and
+// its line the import's source checksum. omega_link drops those definitions
+// from the object with that checksum unless a linked object imports them by
+// name; an import edited since no longer matches and keeps everything.
+// Version '1' objects (the bare record) still link, without symbols.
+//
+// Object layout (native endianness, unaligned; read with memcpy):
+//   OMG2 record                  OBJECT_RECORD_SIZE bytes
+//   uint32_t module_size         path as compiled, NUL included
+//   char module[module_size]
+//   uint32_t symbol_count
+//   uint32_t strings_size
+//   InterfaceSymbol[symbol_count]
+//   char strings[strings_size]   NUL-terminated, referenced by offset
+//
+// Image layout (native endianness; sections 8-byte aligned):
+//   ImageHeader
+//   ImageModule[module_count]
+//   ImageSymbol[symbol_count]    grouped by module, in link order
+//   uint32_t index[index_size]   global names: open addressing, linear
+//                                probing from image_hash(name) & (size - 1);
+//                                an entry is a symbol number + 1, 0 is empty
+//   char strings[strings_size]   every distinct string once
+// image_find probes the index, so a lookup touches a few cache lines of the
+// mapped image however large it is.
+
+#ifndef OMEGA_OBJECT_H
+#define OMEGA_OBJECT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "omega_interface.h"
+
+#define OBJECT_MAGIC "OMG2"
+#define OBJECT_VERSION '2'
+#define OBJECT_RECORD_SIZE (5 + 2 * sizeof(int32_t) + sizeof(uint32_t))
+
+#define IMAGE_MAGIC "OML1"
+#define IMAGE_VERSION 1
+#define IMAGE_UNRESOLVED 0xFFFFFFFFu
+
+// ============================================================================
+// OBJECTS
+// ============================================================================
+
+// An object mapped by object_open; symbols are read with object_symbol.
+typedef struct {
+    char version;               // '1' or '2'
+    int32_t token_count;
+    uint32_t checksum;
+    const char* module;         // "" for version '1'
+    uint32_t symbol_count;
+    const unsigned char* symbols;
+    const char* strings;
+    uint32_t strings_size;
+    void* data;
+    size_t size;
+    bool mapped;
+} ObjectFile;
+
+// Serialize a version '2' object into a heap buffer.
+void* object_serialize(const char* module, int token_count, uint32_t checksum,
+                       const InterfaceBuilder* symbols, size_t* size);
+
+// Map and validate; false if unreadable or malformed.
+bool object_open(ObjectFile* object, const char* path);
+void object_close(ObjectFile* object);
+
+// Symbol `index` (< symbol_count); offsets are already checked.
+InterfaceSymbol object_symbol(const ObjectFile* object, uint32_t index);
+
+// ============================================================================
+// IMAGES
+// ============================================================================
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t module_count;
+    uint32_t symbol_count;
+    uint32_t global_count;      // symbols in the index
+    uint32_t index_size;        // power of two
+    uint32_t strings_size;
+    uint32_t unresolved_count;  // imports left undefined (--allow-undefined)
+    uint64_t modules_offset;
+    uint64_t symbols_offset;
+    uint64_t index_offset;
+    uint64_t strings_offset;
+} ImageHeader;
+
+typedef struct {
+    uint32_t path;              // string offset
+    int32_t token_count;
+    uint32_t checksum;
+    uint32_t first_symbol;      // symbols[first_symbol, first_symbol + symbol_count)
+    uint32_t symbol_count;
+} ImageModule;
+
+typedef struct {
+    uint32_t name;              // string offset
+    uint32_t signature;         // string offset; import spec for SYMBOL_IMPORT
+    uint16_t kind;              // SymbolKind
+    uint16_t flags;             // SYMBOL_PUBLIC: global
+    uint32_t line;
+    uint32_t module;
+    uint32_t target;            // definition an import resolved to, or IMAGE_UNRESOLVED
+    uint32_t hash;              // image_hash(name)
+} ImageSymbol;
+
+typedef struct {
+    const ImageHeader* header;
+    const ImageModule* modules;
+    const ImageSymbol* symbols;
+    const uint32_t* index;
+    const char* strings;
+    void* data;
+    size_t size;
+    bool mapped;
+} LinkedImage;
+
+// FNV-1a, the hash the index is built with.
+uint32_t image_hash(const char* name);
+
+// Map and validate an image; NULL if missing or malformed.
+LinkedImage* image_open(const char* path);
+void image_close(LinkedImage* image);
+
+// Global symbol named `name`, or -1.
+int image_find(const LinkedImage* image, const char* name);
+const char* image_string(const LinkedImage* image, uint32_t offset);
+
+#endif // OMEGA_OBJECT_H
@@ -0,0 +1,642 @@
+// OMEGA Bootstrap - Parse Cache
+// Entry serialization and validation, and the cache directory with LRU trimming.
+
+#if !defined(_WIN32)
+#define _XOPEN_SOURCE 700
+#endif
+
+#include "omega_parsecache.h"
+#include "omega_hash.h"
+#include "omega_keccak.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#include <sys/utime.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define PARSE_CACHE_SUFFIX ".omp"
+#define PARSE_CACHE_NAME_LENGTH (PARSE_CACHE_KEY_SIZE * 2 + 4)
+#define PARSE_CACHE_LOW_WATER(max) ((max) / 10 * 9)   // trim to 90% of the limit
+#define PARSE_CACHE_STALE_TEMP_SECONDS 3600           // temp files left by crashes
+
+// ============================================================================
+// BUILDER
+// ============================================================================
+
+static uint32_t pointer_hash(const char* text) {
+    uintptr_t value = (uintptr_t)text;
+    value ^= value >> 17;
+    value *= 0x9E3779B1u;
+    return (uint32_t)(value ^ (value >> 15));
+}
+
+bool parse_cache_builder_init(ParseCacheBuilder* builder, const ParseCacheHeader* counts) {
+    memset(builder, 0, sizeof(ParseCacheBuilder));
+    builder->header = *counts;
+    builder->header.string_count = 0;
+    builder->header.strings_size = 0;
+
+    // One extra element each so empty tables still allocate
+    builder->tokens = malloc(sizeof(CachedToken) * ((size_t)counts->token_count + 1));
+    builder->functions = malloc(sizeof(CachedFunction) * ((size_t)counts->function_count + 1));
+    builder->types = malloc(sizeof(CachedType) * ((size_t)counts->type_count + 1));
+    builder->fields = malloc(sizeof(CachedField) * ((size_t)counts->field_count + 1));
+    builder->storage = malloc(sizeof(CachedStorage) * ((size_t)counts->storage_count + 1));
+    builder->imports = malloc(sizeof(CachedImport) * ((size_t)counts->import_count + 1));
+    builder->import_names = malloc(sizeof(uint32_t) * ((size_t)counts->import_name_count + 1));
+    builder->slot_mask = 1023;
+    builder->slot_text = calloc(builder->slot_mask + 1, sizeof(const char*));
+    builder->slot_index = malloc(sizeof(uint32_t) * (builder->slot_mask + 1));
+    builder->failed = !builder->tokens || !builder->functions || !builder->types ||
+                      !builder->fields || !builder->storage || !builder->imports ||
+                      !builder->import_names || !builder->slot_text || !builder->slot_index;
+    return !builder->failed;
+}
+
+static bool grow_string_map(ParseCacheBuilder* builder) {
+    uint32_t mask = builder->slot_mask * 2 + 1;
+    const char** texts = calloc(mask + 1, sizeof(const char*));
+    uint32_t* indexes = malloc(sizeof(uint32_t) * (mask + 1));
+    if (!texts || !indexes) {
+        free(texts);
+        free(indexes);
+        return false;
+    }
+    for (uint32_t i = 0; i <= builder->slot_mask; i++) {
+        const char* text = builder->slot_text[i];
+        if (text) {
+            uint32_t slot = pointer_hash(text) & mask;
+            while (texts[slot]) {
+                slot = (slot + 1) & mask;
+            }
+            texts[slot] = text;
+            indexes[slot] = builder->slot_index[i];
+        }
+    }
+    free(builder->slot_text);
+    free(builder->slot_index);
+    builder->slot_text = texts;
+    builder->slot_index = indexes;
+    builder->slot_mask = mask;
+    return true;
+}
+
+uint32_t parse_cache_builder_string(ParseCacheBuilder* builder, const char* text) {
+    if (!text || builder->failed) {
+        return PARSE_CACHE_NONE;
+    }
+    uint32_t slot = pointer_hash(text) & builder->slot_mask;
+    while (builder->slot_text[slot] && builder->slot_text[slot] != text) {
+        slot = (slot + 1) & builder->slot_mask;
+    }
+    if (builder->slot_text[slot]) {
+        return builder->slot_index[slot];
+    }
+
+    // New string: append its text and offset
+    size_t length = strlen(text) + 1;
+    uint32_t index = builder->header.string_count;
+    if (index == builder->string_capacity) {
+        uint32_t capacity = builder->string_capacity ? builder->string_capacity * 2 : 256;
+        uint32_t* offsets = realloc(builder->string_offsets, sizeof(uint32_t) * capacity);
+        if (!offsets) {
+            builder->failed = true;
+            return PARSE_CACHE_NONE;
+        }
+        builder->string_offsets = offsets;
+        builder->string_capacity = capacity;
+    }
+    size_t used = builder->header.strings_size;
+    if (used + length > UINT32_MAX) {
+        builder->failed = true;
+        return PARSE_CACHE_NONE;
+    }
+    if (used + length > builder->strings_capacity) {
+        size_t capacity = builder->strings_capacity ? builder->strings_capacity * 2 : 4096;
+        while (capacity < used + length) {
+            capacity *= 2;
+        }
+        char* strings = realloc(builder->strings, capacity);
+        if (!strings) {
+            builder->failed = true;
+            return PARSE_CACHE_NONE;
+        }
+        builder->strings = strings;
+        builder->strings_capacity = capacity;
+    }
+    memcpy(builder->strings + used, text, length);
+    builder->string_offsets[index] = (uint32_t)used;
+    builder->header.strings_size = (uint32_t)(used + length);
+    builder->header.string_count = index + 1;
+
+    builder->slot_text[slot] = text;
+    builder->slot_index[slot] = index;
+    if ((index + 1) * 2 > builder->slot_mask && !grow_string_map(builder)) {
+        builder->failed = true;
+    }
+    return index;
+}
+
+void* parse_cache_builder_serialize(ParseCacheBuilder* builder,
+                                    const uint8_t key[PARSE_CACHE_KEY_SIZE], size_t* size) {
+    if (builder->failed) {
+        return NULL;
+    }
+    ParseCacheHeader* header = &builder->header;
+    memcpy(header->magic, PARSE_CACHE_MAGIC, 4);
+    header->version = PARSE_CACHE_VERSION;
+    memcpy(header->key, key, PARSE_CACHE_KEY_SIZE);
+
+    const void* sections[] = {
+        header, builder->tokens, builder->functions, builder->types, builder->fields,
+        builder->storage, builder->imports, builder->import_names, builder->string_offsets,
+        builder->strings
+    };
+    size_t sizes[] = {
+        sizeof(ParseCacheHeader),
+        sizeof(CachedToken) * header->token_count,
+        sizeof(CachedFunction) * header->function_count,
+        sizeof(CachedType) * header->type_count,
+        sizeof(CachedField) * header->field_count,
+        sizeof(CachedStorage) * header->storage_count,
+        sizeof(CachedImport) * header->import_count,
+        sizeof(uint32_t) * header->import_name_count,
+        sizeof(uint32_t) * header->string_count,
+        header->strings_size
+    };
+    size_t total = 0;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        total += sizes[i];
+    }
+    char* data = malloc(total);
+    if (!data) {
+        return NULL;
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        if (sizes[i] > 0) {
+            memcpy(data + offset, sections[i], sizes[i]);
+            offset += sizes[i];
+        }
+    }
+    *size = total;
+    return data;
+}
+
+void parse_cache_builder_free(ParseCacheBuilder* builder) {
+    free(builder->tokens);
+    free(builder->functions);
+    free(builder->types);
+    free(builder->fields);
+    free(builder->storage);
+    free(builder->imports);
+    free(builder->import_names);
+    free(builder->string_offsets);
+    free(builder->strings);
+    free(builder->slot_text);
+    free(builder->slot_index);
+    memset(builder, 0, sizeof(ParseCacheBuilder));
+}
+
+// ============================================================================
+// LOADING
+// ============================================================================
+
+static bool range_ok(int32_t start, int32_t end, uint32_t limit) {
+    return start >= 0 && start <= end && (uint32_t)end <= limit;
+}
+
+static bool string_ok(uint32_t index, uint32_t count) {
+    return index < count;
+}
+
+// Check the header, the section sizes and every index and range.
+static bool parse_cache_bind(ParseCacheEntry* entry) {
+    if (entry->size < sizeof(ParseCacheHeader)) {
+        return false;
+    }
+    const ParseCacheHeader* header = entry->data;
+    if (memcmp(header->magic, PARSE_CACHE_MAGIC, 4) != 0 || header->version != PARSE_CACHE_VERSION) {
+        return false;
+    }
+    uint64_t expected = sizeof(ParseCacheHeader) +
+                        sizeof(CachedToken) * (uint64_t)header->token_count +
+                        sizeof(CachedFunction) * (uint64_t)header->function_count +
+                        sizeof(CachedType) * (uint64_t)header->type_count +
+                        sizeof(CachedField) * (uint64_t)header->field_count +
+                        sizeof(CachedStorage) * (uint64_t)header->storage_count +
+                        sizeof(CachedImport) * (uint64_t)header->import_count +
+                        sizeof(uint32_t) * (uint64_t)header->import_name_count +
+                        sizeof(uint32_t) * (uint64_t)header->string_count +
+                        header->strings_size;
+    if (expected != entry->size || header->struct_count > header->type_count ||
+        (header->string_count > 0 &&
+         (header->strings_size == 0 || ((const char*)entry->data)[entry->size - 1] != '\0'))) {
+        return false;
+    }
+
+    entry->header = header;
+    entry->tokens = (const CachedToken*)(header + 1);
+    entry->functions = (const CachedFunction*)(entry->tokens + header->token_count);
+    entry->types = (const CachedType*)(entry->functions + header->function_count);
+    entry->fields = (const CachedField*)(entry->types + header->type_count);
+    entry->storage = (const CachedStorage*)(entry->fields + header->field_count);
+    entry->imports = (const CachedImport*)(entry->storage + header->storage_count);
+    entry->import_names = (const uint32_t*)(entry->imports + header->import_count);
+    entry->string_offsets = entry->import_names + header->import_name_count;
+    entry->strings = (const char*)(entry->string_offsets + header->string_count);
+
+    uint32_t strings = header->string_count;
+    for (uint32_t i = 0; i < strings; i++) {
+        if (entry->string_offsets[i] >= header->strings_size) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->token_count; i++) {
+        if (!string_ok(entry->tokens[i].value, strings)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->function_count; i++) {
+        const CachedFunction* decl = &entry->functions[i];
+        if (!string_ok(decl->name, strings) || !string_ok(decl->signature, strings) ||
+            (decl->owner != PARSE_CACHE_NONE && !string_ok(decl->owner, strings)) ||
+            !range_ok(decl->body_start, decl->body_end, header->token_count) ||
+            !range_ok(decl->decl_start, decl->decl_end, header->token_count)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->type_count; i++) {
+        const CachedType* decl = &entry->types[i];
+        if (!string_ok(decl->name, strings) || !string_ok(decl->signature, strings) ||
+            (decl->owner != PARSE_CACHE_NONE && !string_ok(decl->owner, strings)) ||
+            !range_ok(decl->decl_start, decl->decl_end, header->token_count)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->field_count; i++) {
+        if (!string_ok(entry->fields[i].name, strings) || !string_ok(entry->fields[i].type, strings)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->storage_count; i++) {
+        const CachedStorage* decl = &entry->storage[i];
+        if (!string_ok(decl->name, strings) || decl->field_count < 0 ||
+            !range_ok(decl->first_field, decl->first_field + decl->field_count, header->field_count)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->import_count; i++) {
+        const CachedImport* import = &entry->imports[i];
+        if (!string_ok(import->spec, strings) || import->name_count < 0 ||
+            !range_ok(import->first_name, import->first_name + import->name_count,
+                      header->import_name_count)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->import_name_count; i++) {
+        if (!string_ok(entry->import_names[i], strings)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void entry_path(const ParseCache* cache, const uint8_t key[PARSE_CACHE_KEY_SIZE],
+                       char* out, size_t out_size) {
+    char name[PARSE_CACHE_KEY_SIZE * 2 + 1];
+    for (int i = 0; i < PARSE_CACHE_KEY_SIZE; i++) {
+        snprintf(name + i * 2, 3, "%02x", key[i]);
+    }
+    snprintf(out, out_size, "%s/%s" PARSE_CACHE_SUFFIX, cache->dir, name);
+}
+
+ParseCacheEntry* parse_cache_lookup(ParseCache* cache, const uint8_t key[PARSE_CACHE_KEY_SIZE]) {
+    char path[PARSE_CACHE_PATH_MAX + PARSE_CACHE_NAME_LENGTH + 2];
+    entry_path(cache, key, path, sizeof(path));
+    ParseCacheEntry* entry = calloc(1, sizeof(ParseCacheEntry));
+    if (!entry) {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    struct stat info;
+    FILE* file = stat(path, &info) == 0 && info.st_size > 0 ? fopen(path, "rb") : NULL;
+    if (file) {
+        entry->size = (size_t)info.st_size;
+        entry->data = malloc(entry->size);
+        if (!entry->data || fread(entry->data, 1, entry->size, file) != entry->size) {
+            free(entry->data);
+            entry->data = NULL;
+        }
+        fclose(file);
+    }
+    if (entry->data) {
+        utime(path, NULL);   // mark as recently used
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            entry->data = data;
+            entry->size = (size_t)info.st_size;
+            entry->mapped = true;
+            futimens(fd, NULL);   // mark as recently used
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+
+    if (!entry->data || !parse_cache_bind(entry) ||
+        memcmp(entry->header->key, key, PARSE_CACHE_KEY_SIZE) != 0) {
+        parse_cache_release(entry);
+        cache->misses++;
+        return NULL;
+    }
+    cache->hits++;
+    return entry;
+}
+
+void parse_cache_release(ParseCacheEntry* entry) {
+    if (!entry) {
+        return;
+    }
+#ifndef _WIN32
+    if (entry->mapped) {
+        munmap(entry->data, entry->size);
+    } else
+#endif
+    {
+        free(entry->data);
+    }
+    free(entry);
+}
+
+const char* parse_cache_text(const ParseCacheEntry* entry, uint32_t index) {
+    if (index == PARSE_CACHE_NONE) {
+        return NULL;
+    }
+    return entry->strings + entry->string_offsets[index];
+}
+
+// ============================================================================
+// CACHE DIRECTORY
+// ============================================================================
+
+void parse_cache_key(const char* version, const char* source, size_t size,
+                     uint8_t key[PARSE_CACHE_KEY_SIZE]) {
+    // key = keccak256(version NUL format-version size content-hash(source))
+    uint8_t message[256 + sizeof(uint32_t) + sizeof(uint64_t) * 3];
+    size_t length = strlen(version);
+    if (length > 255) {
+        length = 255;
+    }
+    memcpy(message, version, length);
+    message[length++] = '\0';
+    uint32_t format = PARSE_CACHE_VERSION;
+    memcpy(message + length, &format, sizeof(format));
+    length += sizeof(format);
+    uint64_t digest[3];
+    digest[0] = (uint64_t)size;
+    content_hash(source, size, digest + 1);
+    memcpy(message + length, digest, sizeof(digest));
+    length += sizeof(digest);
+    keccak256(message, length, key);
+}
+
+static bool is_entry_name(const char* name) {
+    if (strlen(name) != PARSE_CACHE_NAME_LENGTH ||
+        strcmp(name + PARSE_CACHE_KEY_SIZE * 2, PARSE_CACHE_SUFFIX) != 0) {
+        return false;
+    }
+    for (int i = 0; i < PARSE_CACHE_KEY_SIZE * 2; i++) {
+        char c = name[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool is_temp_name(const char* name) {
+    size_t length = strlen(name);
+    return length > 4 && strcmp(name + length - 4, ".tmp") == 0 &&
+           strstr(name, PARSE_CACHE_SUFFIX ".") != NULL;
+}
+
+typedef struct {
+    char name[PARSE_CACHE_NAME_LENGTH + 1];
+    uint64_t size;
+    int64_t used;           // modification time, refreshed on every hit
+} CacheFile;
+
+static int compare_least_recent(const void* a, const void* b) {
+    const CacheFile* left = a;
+    const CacheFile* right = b;
+    if (left->used != right->used) {
+        return left->used < right->used ? -1 : 1;
+    }
+    return strcmp(left->name, right->name);
+}
+
+// Take the directory's eviction lock without waiting; false if another
+// process holds it. Returns the descriptor to release in *lock.
+static bool lock_directory(const ParseCache* cache, int* lock) {
+#ifdef _WIN32
+    (void)cache;
+    *lock = -1;
+    return true;
+#else
+    char path[PARSE_CACHE_PATH_MAX + 16];
+    snprintf(path, sizeof(path), "%s/.lock", cache->dir);
+    *lock = open(path, O_RDWR | O_CREAT, 0644);
+    if (*lock < 0) {
+        return true;   // read-only directory: nothing will be removed anyway
+    }
+    struct flock request;
+    memset(&request, 0, sizeof(request));
+    request.l_type = F_WRLCK;
+    request.l_whence = SEEK_SET;
+    if (fcntl(*lock, F_SETLK, &request) != 0) {
+        close(*lock);
+        *lock = -1;
+        return false;
+    }
+    return true;
+#endif
+}
+
+static void unlock_directory(int lock) {
+#ifndef _WIN32
+    if (lock >= 0) {
+        close(lock);   // releases the record lock
+    }
+#else
+    (void)lock;
+#endif
+}
+
+// Measure the directory and, with `trim`, remove least recently used
+// entries until it is back under the low-water mark. Stale temporary files
+// are removed on the way.
+static void scan_directory(ParseCache* cache, bool trim) {
+    int lock = -1;
+    if (trim && !lock_directory(cache, &lock)) {
+        return;   // another process is trimming
+    }
+    DIR* dir = opendir(cache->dir);
+    if (!dir) {
+        unlock_directory(lock);
+        return;
+    }
+
+    CacheFile* files = NULL;
+    int count = 0;
+    int capacity = 0;
+    uint64_t total = 0;
+    time_t now = time(NULL);
+    char path[PARSE_CACHE_PATH_MAX + 256 + 2];
+    struct dirent* item;
+    while ((item = readdir(dir)) != NULL) {
+        bool entry = is_entry_name(item->d_name);
+        if (!entry && !(trim && is_temp_name(item->d_name))) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", cache->dir, item->d_name);
+        struct stat info;
+        if (stat(path, &info) != 0) {
+            continue;
+        }
+        if (!entry) {
+            if (now - info.st_mtime > PARSE_CACHE_STALE_TEMP_SECONDS) {
+                remove(path);
+            }
+            continue;
+        }
+        total += (uint64_t)info.st_size;
+        if (!trim) {
+            continue;
+        }
+        if (count == capacity) {
+            int grown = capacity ? capacity * 2 : 256;
+            CacheFile* resized = realloc(files, sizeof(CacheFile) * grown);
+            if (!resized) {
+                break;
+            }
+            files = resized;
+            capacity = grown;
+        }
+        CacheFile* file = &files[count++];
+        memcpy(file->name, item->d_name, sizeof(file->name));   // checked by is_entry_name
+        file->size = (uint64_t)info.st_size;
+        file->used = (int64_t)info.st_mtime;
+    }
+    closedir(dir);
+
+    if (trim && total > cache->max_bytes) {
+        qsort(files, (size_t)count, sizeof(CacheFile), compare_least_recent);
+        uint64_t target = PARSE_CACHE_LOW_WATER(cache->max_bytes);
+        for (int i = 0; i < count && total > target; i++) {
+            snprintf(path, sizeof(path), "%s/%s", cache->dir, files[i].name);
+            if (remove(path) == 0) {
+                cache->evicted++;
+            }
+            // Gone either way: removed here or by another process
+            total -= files[i].size;
+        }
+    }
+    free(files);
+    cache->total_bytes = total;
+    cache->measured = true;
+    unlock_directory(lock);
+}
+
+static bool make_directory(const char* path) {
+#ifdef _WIN32
+    return _mkdir(path) == 0;
+#else
+    return mkdir(path, 0755) == 0;
+#endif
+}
+
+bool parse_cache_open(ParseCache* cache, const char* dir, uint64_t max_bytes) {
+    memset(cache, 0, sizeof(ParseCache));
+    size_t length = strlen(dir);
+    while (length > 1 && dir[length - 1] == '/') {
+        length--;
+    }
+    if (length == 0 || length >= sizeof(cache->dir)) {
+        return false;
+    }
+    memcpy(cache->dir, dir, length);
+    cache->dir[length] = '\0';
+    cache->max_bytes = max_bytes;
+
+    // Create missing parents one component at a time
+    for (size_t i = 1; i <= length; i++) {
+        if (cache->dir[i] == '/' || cache->dir[i] == '\0') {
+            char saved = cache->dir[i];
+            cache->dir[i] = '\0';
+            make_directory(cache->dir);
+            cache->dir[i] = saved;
+        }
+    }
+    struct stat info;
+    if (stat(cache->dir, &info) != 0 || !S_ISDIR(info.st_mode)) {
+        return false;
+    }
+    return true;
+}
+
+bool parse_cache_store(ParseCache* cache, const uint8_t key[PARSE_CACHE_KEY_SIZE],
+                       const void* data, size_t size) {
+    char path[PARSE_CACHE_PATH_MAX + PARSE_CACHE_NAME_LENGTH + 2];
+    char temp[sizeof(path) + 32];
+    entry_path(cache, key, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s.%ld.tmp", path, (long)getpid());
+
+    FILE* file = fopen(temp, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(data, 1, size, file) == size;
+    ok = fclose(file) == 0 && ok;
+
+#ifdef _WIN32
+    // rename() does not replace existing files on Windows
+    if (ok) {
+        remove(path);
+    }
+#endif
+    if (!ok || rename(temp, path) != 0) {
+        remove(temp);
+        return false;
+    }
+    cache->stores++;
+    if (!cache->measured) {
+        scan_directory(cache, false);   // includes this entry
+    } else {
+        cache->total_bytes += size;
+    }
+    if (cache->total_bytes > cache->max_bytes) {
+        scan_directory(cache, true);
+    }
+    return true;
+}
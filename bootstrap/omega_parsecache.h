@@ -0,0 +1,188 @@
+// OMEGA Bootstrap - Parse Cache
+// Purpose: Persist each module's token stream and declaration tables on disk
+// Platform: Windows, Linux, macOS (C99; mmap on POSIX, buffered read on Windows)
+// Entries are content-addressed: the key is Keccak-256 over a 128-bit hash
+// of the source, its size and the compiler build, and names the file
+// (<dir>/<64 hex digits>.omp), so any process that sees the same bytes
+// finds the same parse. Entries are
+// written to a temporary file and renamed into place, so a reader sees a
+// whole entry or none; an entry that is evicted while mapped stays readable.
+// Every hit refreshes the entry's modification time, and a store that takes
+// the directory past its size limit removes the least recently used entries
+// under an advisory lock, so concurrent compilers evict once. The limit is
+// approximate while several processes write at the same time.
+//
+// Layout (native endianness, 4-byte aligned; a local build cache):
+//   ParseCacheHeader
+//   CachedToken[token_count]
+//   CachedFunction[function_count]
+//   CachedType[type_count]
+//   CachedField[field_count]
+//   CachedStorage[storage_count]
+//   CachedImport[import_count]
+//   uint32_t import_names[import_name_count]    string indexes
+//   uint32_t string_offsets[string_count]       into the blob below
+//   char strings[strings_size]                  NUL-terminated
+// Strings are referenced by index; PARSE_CACHE_NONE stands for "no string".
+
+#ifndef OMEGA_PARSECACHE_H
+#define OMEGA_PARSECACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PARSE_CACHE_MAGIC "OMP1"
+#define PARSE_CACHE_VERSION 2
+#define PARSE_CACHE_KEY_SIZE 32
+#define PARSE_CACHE_NONE 0xFFFFFFFFu
+#define PARSE_CACHE_PATH_MAX 4096
+#define PARSE_CACHE_DEFAULT_MB 64
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint8_t key[PARSE_CACHE_KEY_SIZE];  // must match the file name
+    uint32_t token_count;               // code tokens, comments excluded
+    uint32_t comment_count;
+    uint32_t function_count;
+    uint32_t struct_count;              // types that are structs
+    uint32_t type_count;
+    uint32_t field_count;
+    uint32_t storage_count;
+    uint32_t import_count;
+    uint32_t import_name_count;
+    uint32_t string_count;
+    uint32_t strings_size;
+} ParseCacheHeader;
+
+typedef struct {
+    uint32_t type;          // TokenType
+    uint32_t value;         // string index
+    int32_t line;
+    int32_t column;
+    int32_t offset;         // first source byte
+    int32_t length;         // source bytes covered
+} CachedToken;
+
+typedef struct {
+    uint32_t name;
+    uint32_t signature;     // canonical ABI form, e.g. "transfer(address,uint256)"
+    uint32_t owner;         // enclosing blockchain/contract, or PARSE_CACHE_NONE
+    uint32_t kind;          // 0 function, 1 event
+    uint32_t is_public;
+    int32_t line;
+    int32_t body_start;     // token ranges [start, end)
+    int32_t body_end;
+    int32_t decl_start;
+    int32_t decl_end;
+} CachedFunction;
+
+typedef struct {
+    uint32_t name;
+    uint32_t signature;
+    uint32_t owner;         // enclosing blockchain/contract, or PARSE_CACHE_NONE
+    uint32_t kind;          // SymbolKind (omega_interface.h)
+    uint32_t is_enum;
+    int32_t line;
+    int32_t decl_start;
+    int32_t decl_end;
+} CachedType;
+
+typedef struct {
+    uint32_t name;
+    uint32_t type;          // canonical type, e.g. "mapping(address=>uint256)"
+    int32_t line;
+} CachedField;
+
+typedef struct {
+    uint32_t name;
+    uint32_t is_state;
+    uint32_t packable;
+    int32_t first_field;    // fields[first_field, first_field + field_count)
+    int32_t field_count;
+    int32_t line;
+} CachedStorage;
+
+typedef struct {
+    uint32_t spec;          // as written, e.g. "std::io"
+    int32_t first_name;     // import_names[first_name, first_name + name_count)
+    int32_t name_count;
+    int32_t line;
+} CachedImport;
+
+// A validated entry; every index and range in it is in bounds.
+typedef struct {
+    const ParseCacheHeader* header;
+    const CachedToken* tokens;
+    const CachedFunction* functions;
+    const CachedType* types;
+    const CachedField* fields;
+    const CachedStorage* storage;
+    const CachedImport* imports;
+    const uint32_t* import_names;
+    const uint32_t* string_offsets;
+    const char* strings;
+    void* data;
+    size_t size;
+    bool mapped;            // data is an mmap'd file rather than heap memory
+} ParseCacheEntry;
+
+// Record arrays sized from `header`'s counts, filled in by the caller, plus
+// a string table that stores each distinct string pointer once.
+typedef struct {
+    ParseCacheHeader header;
+    CachedToken* tokens;
+    CachedFunction* functions;
+    CachedType* types;
+    CachedField* fields;
+    CachedStorage* storage;
+    CachedImport* imports;
+    uint32_t* import_names;
+    uint32_t* string_offsets;
+    uint32_t string_capacity;
+    char* strings;
+    size_t strings_capacity;
+    const char** slot_text;     // pointer -> string index map (open addressing)
+    uint32_t* slot_index;
+    uint32_t slot_mask;
+    bool failed;                // out of memory; serialize returns NULL
+} ParseCacheBuilder;
+
+typedef struct {
+    char dir[PARSE_CACHE_PATH_MAX];
+    uint64_t max_bytes;
+    uint64_t total_bytes;       // as of the last directory scan, plus our stores
+    bool measured;              // scanned yet; runs that only hit never scan
+    int hits;
+    int misses;
+    int stores;
+    int evicted;
+} ParseCache;
+
+// Create `dir` if needed.
+bool parse_cache_open(ParseCache* cache, const char* dir, uint64_t max_bytes);
+
+// Key for `source` as compiled by `version` (also covers the format version).
+void parse_cache_key(const char* version, const char* source, size_t size,
+                     uint8_t key[PARSE_CACHE_KEY_SIZE]);
+
+// Map the entry for `key`, or NULL on a miss. Release it when done.
+ParseCacheEntry* parse_cache_lookup(ParseCache* cache, const uint8_t key[PARSE_CACHE_KEY_SIZE]);
+void parse_cache_release(ParseCacheEntry* entry);
+
+const char* parse_cache_text(const ParseCacheEntry* entry, uint32_t index);
+
+// Publish a serialized entry atomically, then trim the directory if it is
+// over the limit.
+bool parse_cache_store(ParseCache* cache, const uint8_t key[PARSE_CACHE_KEY_SIZE],
+                       const void* data, size_t size);
+
+// `counts` supplies every count except string_count and strings_size.
+bool parse_cache_builder_init(ParseCacheBuilder* builder, const ParseCacheHeader* counts);
+uint32_t parse_cache_builder_string(ParseCacheBuilder* builder, const char* text);
+void* parse_cache_builder_serialize(ParseCacheBuilder* builder,
+                                    const uint8_t key[PARSE_CACHE_KEY_SIZE], size_t* size);
+void parse_cache_builder_free(ParseCacheBuilder* builder);
+
+#endif // OMEGA_PARSECACHE_H
@@ -0,0 +1,774 @@
+// OMEGA Bootstrap - EVM Peephole Optimizer
+// Trie-compiled pattern matching over decoded instructions, jump relocation.
+
+#include "omega_peephole.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Opcodes the patterns and the safety checks refer to
+#define OP_STOP     0x00
+#define OP_ADD      0x01
+#define OP_MUL      0x02
+#define OP_SUB      0x03
+#define OP_LT       0x10
+#define OP_GT       0x11
+#define OP_EQ       0x14
+#define OP_ISZERO   0x15
+#define OP_AND      0x16
+#define OP_OR       0x17
+#define OP_XOR      0x18
+#define OP_NOT      0x19
+#define OP_BYTE     0x1a
+#define OP_SHL      0x1b
+#define OP_SHR      0x1c
+#define OP_SAR      0x1d
+#define OP_KECCAK256 0x20
+#define OP_CALLDATALOAD 0x35
+#define OP_CALLDATACOPY 0x37
+#define OP_CODESIZE 0x38
+#define OP_CODECOPY 0x39
+#define OP_POP      0x50
+#define OP_MLOAD    0x51
+#define OP_MSTORE   0x52
+#define OP_MSTORE8  0x53
+#define OP_SLOAD    0x54
+#define OP_SSTORE   0x55
+#define OP_JUMP     0x56
+#define OP_JUMPI    0x57
+#define OP_PC       0x58
+#define OP_JUMPDEST 0x5b
+#define OP_PUSH0    0x5f
+#define OP_PUSH1    0x60
+#define OP_PUSH32   0x7f
+#define OP_DUP1     0x80
+#define OP_DUP16    0x8f
+#define OP_SWAP1    0x90
+#define OP_SWAP16   0x9f
+#define OP_LOG0     0xa0
+#define OP_LOG4     0xa4
+#define OP_RETURN   0xf3
+#define OP_REVERT   0xfd
+#define OP_INVALID  0xfe
+#define OP_SELFDESTRUCT 0xff
+
+// Trie symbols: every PUSHn, DUPn and SWAPn share one symbol each
+#define SYM_PUSH OP_PUSH1
+#define SYM_DUP  OP_DUP1
+#define SYM_SWAP OP_SWAP1
+
+typedef struct {
+    uint8_t opcode;
+    uint8_t width;         // immediate bytes
+    int32_t origin;        // original offset, -1 for synthesized instructions
+    int32_t label;         // original JUMPDEST offset this PUSH jumps or returns to, or -1
+    int32_t maybe_label;   // JUMPDEST offset equal to this PUSH's value otherwise, or -1
+    uint8_t value[32];     // immediate, big-endian
+} Instr;
+
+// ============================================================================
+// 256-BIT CONSTANTS
+// ============================================================================
+
+typedef struct {
+    uint32_t limb[8];      // little-endian limbs
+} U256;
+
+static U256 u256_from_push(const Instr* instr) {
+    U256 result;
+    memset(&result, 0, sizeof(result));
+    for (int i = 0; i < instr->width; i++) {
+        int byte = instr->width - 1 - i;   // value[] is big-endian
+        result.limb[byte / 4] |= (uint32_t)instr->value[i] << (8 * (byte % 4));
+    }
+    return result;
+}
+
+static U256 u256_small(uint32_t value) {
+    U256 result;
+    memset(&result, 0, sizeof(result));
+    result.limb[0] = value;
+    return result;
+}
+
+static int u256_compare(const U256* a, const U256* b) {
+    for (int i = 7; i >= 0; i--) {
+        if (a->limb[i] != b->limb[i]) {
+            return a->limb[i] < b->limb[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static bool u256_is_zero(const U256* a) {
+    for (int i = 0; i < 8; i++) {
+        if (a->limb[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static U256 u256_add(const U256* a, const U256* b) {
+    U256 result;
+    uint64_t carry = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t sum = (uint64_t)a->limb[i] + b->limb[i] + carry;
+        result.limb[i] = (uint32_t)sum;
+        carry = sum >> 32;
+    }
+    return result;
+}
+
+static U256 u256_sub(const U256* a, const U256* b) {
+    U256 result;
+    uint64_t borrow = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t diff = (uint64_t)a->limb[i] - b->limb[i] - borrow;
+        result.limb[i] = (uint32_t)diff;
+        borrow = (diff >> 32) & 1;
+    }
+    return result;
+}
+
+static U256 u256_mul(const U256* a, const U256* b) {
+    uint32_t product[8] = {0};
+    for (int i = 0; i < 8; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; i + j < 8; j++) {
+            uint64_t term = (uint64_t)a->limb[i] * b->limb[j] + product[i + j] + carry;
+            product[i + j] = (uint32_t)term;
+            carry = term >> 32;
+        }
+    }
+    U256 result;
+    memcpy(result.limb, product, sizeof(product));
+    return result;
+}
+
+// Shift left (positive) or right (negative) by `bits` < 256
+static U256 u256_shift(const U256* a, int bits) {
+    U256 result;
+    memset(&result, 0, sizeof(result));
+    int limbs = (bits < 0 ? -bits : bits) / 32;
+    int rest = (bits < 0 ? -bits : bits) % 32;
+    for (int i = 0; i < 8; i++) {
+        if (bits >= 0) {
+            int from = i - limbs;
+            if (from < 0) continue;
+            uint64_t part = (uint64_t)a->limb[from] << rest;
+            if (from > 0 && rest) part |= (uint64_t)a->limb[from - 1] >> (32 - rest);
+            result.limb[i] = (uint32_t)part;
+        } else {
+            int from = i + limbs;
+            if (from > 7) continue;
+            uint64_t part = a->limb[from] >> rest;
+            if (from < 7 && rest) part |= (uint64_t)a->limb[from + 1] << (32 - rest);
+            result.limb[i] = (uint32_t)part;
+        }
+    }
+    return result;
+}
+
+// Minimal PUSH for a constant; zero stays PUSH1 0x00 so the output does not
+// depend on Shanghai's PUSH0
+static Instr push_constant(const U256* value) {
+    Instr instr;
+    memset(&instr, 0, sizeof(instr));
+    instr.origin = -1;
+    instr.label = -1;
+    instr.maybe_label = -1;
+
+    uint8_t bytes[32];
+    for (int i = 0; i < 32; i++) {
+        int byte = 31 - i;
+        bytes[i] = (uint8_t)(value->limb[byte / 4] >> (8 * (byte % 4)));
+    }
+    int first = 0;
+    while (first < 31 && bytes[first] == 0) {
+        first++;
+    }
+    instr.width = (uint8_t)(32 - first);
+    instr.opcode = (uint8_t)(OP_PUSH1 + instr.width - 1);
+    memcpy(instr.value, bytes + first, instr.width);
+    return instr;
+}
+
+// ============================================================================
+// OPCODE PROPERTIES
+// ============================================================================
+
+static bool is_push(uint8_t opcode) {
+    return opcode >= OP_PUSH0 && opcode <= OP_PUSH32;
+}
+
+// Opcodes whose top operand is a memory, storage or calldata location, a
+// shift amount or a byte index. A PUSH these consume at once is not a code
+// address: the value is used up without being copied anywhere.
+static bool takes_location(uint8_t opcode) {
+    switch (opcode) {
+        case OP_BYTE: case OP_SHL: case OP_SHR: case OP_SAR:
+        case OP_KECCAK256: case OP_CALLDATALOAD: case OP_CALLDATACOPY:
+        case OP_MLOAD: case OP_MSTORE: case OP_MSTORE8: case OP_SLOAD: case OP_SSTORE:
+        case OP_RETURN: case OP_REVERT:
+            return true;
+        default:
+            return opcode >= OP_LOG0 && opcode <= OP_LOG4;
+    }
+}
+
+static uint8_t symbol_of(uint8_t opcode) {
+    if (is_push(opcode)) return SYM_PUSH;
+    if (opcode >= OP_DUP1 && opcode <= OP_DUP16) return SYM_DUP;
+    if (opcode >= OP_SWAP1 && opcode <= OP_SWAP16) return SYM_SWAP;
+    return opcode;
+}
+
+// Static gas of the opcodes patterns can remove; 0 for the rest
+static int opcode_gas(uint8_t opcode) {
+    if (opcode == OP_PUSH0) return 2;
+    switch (symbol_of(opcode)) {
+        case SYM_PUSH: case SYM_DUP: case SYM_SWAP:
+        case OP_ADD: case OP_SUB: case OP_LT: case OP_GT: case OP_EQ:
+        case OP_ISZERO: case OP_AND: case OP_OR: case OP_XOR: case OP_NOT:
+        case OP_SHL: case OP_SHR:
+            return 3;
+        case OP_MUL: return 5;
+        case OP_POP: return 2;
+        case OP_JUMP: return 8;
+        case OP_JUMPI: return 10;
+        case OP_JUMPDEST: return 1;
+        default: return 0;
+    }
+}
+
+// ============================================================================
+// PATTERNS
+// ============================================================================
+
+typedef enum {
+    RULE_PUSH_POP,
+    RULE_DUP_POP,
+    RULE_SWAP_SWAP,
+    RULE_DUP_SWAP,
+    RULE_NOT_NOT,
+    RULE_ISZERO_TRIPLE,
+    RULE_ISZERO_JUMPI,
+    RULE_PUSH_PUSH,
+    RULE_FOLD,
+    RULE_JUMP_NEXT,
+    RULE_COUNT
+} Rule;
+
+static const char* RULE_NAMES[RULE_COUNT] = {
+    "PUSH x POP",
+    "DUPn POP",
+    "SWAPn SWAPn",
+    "DUP1 SWAP1",
+    "NOT NOT",
+    "ISZERO ISZERO ISZERO",
+    "ISZERO ISZERO before JUMPI",
+    "PUSH x PUSH x",
+    "constant folding",
+    "jump to next instruction",
+};
+
+// Writes the replacement for `window` and returns true, or false when the
+// pattern's guard rejects this particular match.
+typedef bool (*RewriteFn)(const Instr* window, Instr* out, int* count);
+
+typedef struct {
+    Rule rule;
+    uint8_t symbols[PEEPHOLE_MAX_PATTERN];
+    int length;
+    RewriteFn rewrite;
+} Pattern;
+
+static bool drop_all(const Instr* window, Instr* out, int* count) {
+    (void)window; (void)out;
+    *count = 0;
+    return true;
+}
+
+static bool same_swaps(const Instr* window, Instr* out, int* count) {
+    (void)out;
+    *count = 0;
+    return window[0].opcode == window[1].opcode;
+}
+
+// DUP1 SWAP1: the top two items are already equal
+static bool dup_swap(const Instr* window, Instr* out, int* count) {
+    out[0] = window[0];
+    *count = 1;
+    return window[0].opcode == OP_DUP1 && window[1].opcode == OP_SWAP1;
+}
+
+static bool keep_first(const Instr* window, Instr* out, int* count) {
+    out[0] = window[0];
+    *count = 1;
+    return true;
+}
+
+// ISZERO ISZERO PUSH JUMPI: JUMPI only tests for non-zero
+static bool keep_jump(const Instr* window, Instr* out, int* count) {
+    out[0] = window[2];
+    out[1] = window[3];
+    *count = 2;
+    return true;
+}
+
+// DUP1 copies the first PUSH, so both must relocate (or not) alike
+static bool same_pushes(const Instr* window, Instr* out, int* count) {
+    if (window[0].label != window[1].label || window[0].maybe_label != window[1].maybe_label) {
+        return false;
+    }
+    U256 a = u256_from_push(&window[0]);
+    U256 b = u256_from_push(&window[1]);
+    if (u256_compare(&a, &b) != 0) {
+        return false;
+    }
+    out[0] = window[0];
+    memset(&out[1], 0, sizeof(Instr));
+    out[1].opcode = OP_DUP1;
+    out[1].origin = -1;
+    out[1].label = -1;
+    out[1].maybe_label = -1;
+    *count = 2;
+    return true;
+}
+
+// PUSH a (PUSH b | DUP1) op -> PUSH (b op a); b is on top of the stack
+static bool fold_binary(const Instr* window, Instr* out, int* count) {
+    if (window[0].label >= 0 || window[1].label >= 0 ||
+        window[0].maybe_label >= 0 || window[1].maybe_label >= 0) {
+        return false;
+    }
+    if (!is_push(window[1].opcode) && window[1].opcode != OP_DUP1) {
+        return false;
+    }
+    U256 a = u256_from_push(&window[0]);
+    U256 b = is_push(window[1].opcode) ? u256_from_push(&window[1]) : a;
+    U256 result;
+    switch (window[2].opcode) {
+        case OP_ADD: result = u256_add(&b, &a); break;
+        case OP_MUL: result = u256_mul(&b, &a); break;
+        case OP_SUB: result = u256_sub(&b, &a); break;
+        case OP_LT:  result = u256_small(u256_compare(&b, &a) < 0); break;
+        case OP_GT:  result = u256_small(u256_compare(&b, &a) > 0); break;
+        case OP_EQ:  result = u256_small(u256_compare(&b, &a) == 0); break;
+        case OP_AND: case OP_OR: case OP_XOR:
+            for (int i = 0; i < 8; i++) {
+                result.limb[i] = window[2].opcode == OP_AND ? (a.limb[i] & b.limb[i]) :
+                                 window[2].opcode == OP_OR  ? (a.limb[i] | b.limb[i]) :
+                                                              (a.limb[i] ^ b.limb[i]);
+            }
+            break;
+        case OP_SHL: case OP_SHR: {
+            // Shift amount on top, value below
+            U256 limit = u256_small(256);
+            if (u256_compare(&b, &limit) >= 0) {
+                result = u256_small(0);
+            } else {
+                int bits = (int)b.limb[0];
+                result = u256_shift(&a, window[2].opcode == OP_SHL ? bits : -bits);
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+    out[0] = push_constant(&result);
+    *count = 1;
+    return true;
+}
+
+static bool fold_unary(const Instr* window, Instr* out, int* count) {
+    if (window[0].label >= 0 || window[0].maybe_label >= 0) {
+        return false;
+    }
+    U256 value = u256_from_push(&window[0]);
+    if (window[1].opcode == OP_ISZERO) {
+        value = u256_small(u256_is_zero(&value));
+    } else {
+        for (int i = 0; i < 8; i++) {
+            value.limb[i] = ~value.limb[i];
+        }
+    }
+    out[0] = push_constant(&value);
+    *count = 1;
+    return true;
+}
+
+// PUSH tag JUMP tag: falling through reaches the same JUMPDEST
+static bool jump_next(const Instr* window, Instr* out, int* count) {
+    if (window[0].label < 0 || window[0].label != window[2].origin) {
+        return false;
+    }
+    out[0] = window[2];
+    *count = 1;
+    return true;
+}
+
+#define FOLD_BINARY(op) \
+    { RULE_FOLD, { SYM_PUSH, SYM_PUSH, op }, 3, fold_binary }, \
+    { RULE_FOLD, { SYM_PUSH, SYM_DUP, op }, 3, fold_binary }
+
+static const Pattern PATTERNS[] = {
+    { RULE_PUSH_POP,      { SYM_PUSH, OP_POP }, 2, drop_all },
+    { RULE_DUP_POP,       { SYM_DUP, OP_POP }, 2, drop_all },
+    { RULE_SWAP_SWAP,     { SYM_SWAP, SYM_SWAP }, 2, same_swaps },
+    { RULE_DUP_SWAP,      { SYM_DUP, SYM_SWAP }, 2, dup_swap },
+    { RULE_NOT_NOT,       { OP_NOT, OP_NOT }, 2, drop_all },
+    { RULE_ISZERO_TRIPLE, { OP_ISZERO, OP_ISZERO, OP_ISZERO }, 3, keep_first },
+    { RULE_ISZERO_JUMPI,  { OP_ISZERO, OP_ISZERO, SYM_PUSH, OP_JUMPI }, 4, keep_jump },
+    { RULE_PUSH_PUSH,     { SYM_PUSH, SYM_PUSH }, 2, same_pushes },
+    { RULE_JUMP_NEXT,     { SYM_PUSH, OP_JUMP, OP_JUMPDEST }, 3, jump_next },
+    { RULE_FOLD,          { SYM_PUSH, OP_ISZERO }, 2, fold_unary },
+    { RULE_FOLD,          { SYM_PUSH, OP_NOT }, 2, fold_unary },
+    FOLD_BINARY(OP_ADD),
+    FOLD_BINARY(OP_MUL),
+    FOLD_BINARY(OP_SUB),
+    FOLD_BINARY(OP_LT),
+    FOLD_BINARY(OP_GT),
+    FOLD_BINARY(OP_EQ),
+    FOLD_BINARY(OP_AND),
+    FOLD_BINARY(OP_OR),
+    FOLD_BINARY(OP_XOR),
+    FOLD_BINARY(OP_SHL),
+    FOLD_BINARY(OP_SHR),
+};
+
+#define PATTERN_COUNT ((int)(sizeof(PATTERNS) / sizeof(PATTERNS[0])))
+
+// ============================================================================
+// TRIE
+// ============================================================================
+
+static int new_node(PeepholeOptimizer* optimizer) {
+    if (optimizer->node_count == optimizer->node_capacity) {
+        int capacity = optimizer->node_capacity ? optimizer->node_capacity * 2 : 32;
+        PeepholeNode* nodes = realloc(optimizer->nodes, sizeof(PeepholeNode) * capacity);
+        if (!nodes) {
+            return -1;
+        }
+        optimizer->nodes = nodes;
+        optimizer->node_capacity = capacity;
+    }
+    PeepholeNode* node = &optimizer->nodes[optimizer->node_count];
+    for (int i = 0; i < PEEPHOLE_SYMBOLS; i++) {
+        node->next[i] = -1;
+    }
+    node->pattern = -1;
+    return optimizer->node_count++;
+}
+
+bool peephole_init(PeepholeOptimizer* optimizer) {
+    memset(optimizer, 0, sizeof(PeepholeOptimizer));
+    optimizer->stats = calloc(RULE_COUNT, sizeof(PeepholeStats));
+    if (!optimizer->stats || new_node(optimizer) < 0) {
+        peephole_free(optimizer);
+        return false;
+    }
+    optimizer->rule_count = RULE_COUNT;
+    peephole_reset_stats(optimizer);
+
+    // Patterns are inserted last opcode first: matching walks back from
+    // the most recently emitted instruction
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        int node = 0;
+        for (int i = PATTERNS[p].length - 1; i >= 0; i--) {
+            uint8_t symbol = PATTERNS[p].symbols[i];
+            if (optimizer->nodes[node].next[symbol] < 0) {
+                int child = new_node(optimizer);
+                if (child < 0) {
+                    peephole_free(optimizer);
+                    return false;
+                }
+                optimizer->nodes[node].next[symbol] = (int16_t)child;
+            }
+            node = optimizer->nodes[node].next[symbol];
+        }
+        if (optimizer->nodes[node].pattern >= 0) {
+            peephole_free(optimizer);   // two patterns with the same sequence
+            return false;
+        }
+        optimizer->nodes[node].pattern = (int16_t)p;
+    }
+    return true;
+}
+
+void peephole_free(PeepholeOptimizer* optimizer) {
+    free(optimizer->nodes);
+    free(optimizer->stats);
+    memset(optimizer, 0, sizeof(PeepholeOptimizer));
+}
+
+void peephole_reset_stats(PeepholeOptimizer* optimizer) {
+    for (int i = 0; i < optimizer->rule_count; i++) {
+        memset(&optimizer->stats[i], 0, sizeof(PeepholeStats));
+        optimizer->stats[i].name = RULE_NAMES[i];
+    }
+}
+
+// ============================================================================
+// OPTIMIZATION
+// ============================================================================
+
+static int instr_size(const Instr* instr) {
+    return 1 + instr->width;
+}
+
+// Try the patterns ending at the top of `out`, longest first. Returns true
+// after applying one.
+static bool rewrite_top(PeepholeOptimizer* optimizer, Instr* out, int* count,
+                        PeepholeResult* result) {
+    int matches[PEEPHOLE_MAX_PATTERN];
+    int lengths[PEEPHOLE_MAX_PATTERN];
+    int found = 0;
+
+    int node = 0;
+    for (int k = 1; k <= PEEPHOLE_MAX_PATTERN && k <= *count; k++) {
+        const Instr* instr = &out[*count - k];
+        // Only the last instruction of a window may be a jump destination
+        if (k > 1 && instr->opcode == OP_JUMPDEST) {
+            break;
+        }
+        node = optimizer->nodes[node].next[symbol_of(instr->opcode)];
+        if (node < 0) {
+            break;
+        }
+        if (optimizer->nodes[node].pattern >= 0) {
+            matches[found] = optimizer->nodes[node].pattern;
+            lengths[found++] = k;
+        }
+    }
+
+    while (found-- > 0) {
+        const Pattern* pattern = &PATTERNS[matches[found]];
+        int length = lengths[found];
+        Instr* window = &out[*count - length];
+        Instr replacement[PEEPHOLE_MAX_PATTERN];
+        int replaced = 0;
+        if (!pattern->rewrite(window, replacement, &replaced)) {
+            continue;
+        }
+
+        int bytes = 0;
+        int gas = 0;
+        for (int i = 0; i < length; i++) {
+            bytes += instr_size(&window[i]);
+            gas += opcode_gas(window[i].opcode);
+        }
+        for (int i = 0; i < replaced; i++) {
+            bytes -= instr_size(&replacement[i]);
+            gas -= opcode_gas(replacement[i].opcode);
+        }
+        // Every rewrite must shrink the code, which also guarantees the
+        // pass terminates
+        if (bytes <= 0 || replaced > length) {
+            continue;
+        }
+
+        memcpy(window, replacement, sizeof(Instr) * replaced);
+        *count -= length - replaced;
+
+        PeepholeStats* stats = &optimizer->stats[pattern->rule];
+        stats->hits++;
+        stats->bytes_saved += bytes;
+        stats->gas_saved += gas;
+        result->gas_saved += gas;
+        result->rewrites++;
+        return true;
+    }
+    return false;
+}
+
+// Length of a trailing solc CBOR metadata blob (its length is the last two
+// bytes), or 0
+static size_t metadata_length(const uint8_t* code, size_t size) {
+    if (size < 2) {
+        return 0;
+    }
+    size_t length = (((size_t)code[size - 2] << 8) | code[size - 1]) + 2;
+    if (length > size) {
+        return 0;
+    }
+    uint8_t head = code[size - length];
+    return head >= 0xa1 && head <= 0xa5 ? length : 0;
+}
+
+// Bytes solc uses for tag pushes in code of this size
+static int tag_width(size_t size) {
+    int width = 1;
+    while (width < 4 && (size >> (8 * width)) != 0) {
+        width++;
+    }
+    return width;
+}
+
+// Opcodes after which execution does not fall through
+static bool ends_block(uint8_t opcode) {
+    switch (opcode) {
+        case OP_STOP: case OP_JUMP: case OP_RETURN: case OP_REVERT:
+        case OP_INVALID: case OP_SELFDESTRUCT: case OP_JUMPDEST:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static PeepholeResult keep_unchanged(PeepholeResult result, const uint8_t* code,
+                                     uint8_t* out, const char* reason) {
+    memcpy(out, code, result.input_size);
+    result.output_size = result.input_size;
+    result.skipped = reason;
+    return result;
+}
+
+PeepholeResult peephole_optimize(PeepholeOptimizer* optimizer, const uint8_t* code,
+                                 size_t size, uint8_t* out) {
+    PeepholeResult result;
+    memset(&result, 0, sizeof(result));
+    result.input_size = size;
+
+    size_t code_end = size - metadata_length(code, size);
+
+    // Decode; a truncated final PUSH joins the verbatim tail
+    Instr* instrs = malloc(sizeof(Instr) * (code_end + 1));
+    int32_t* moved = malloc(sizeof(int32_t) * (code_end + 1));
+    uint8_t* jumpdest = calloc(code_end + 1, 1);
+    if (!instrs || !moved || !jumpdest) {
+        free(instrs);
+        free(moved);
+        free(jumpdest);
+        return keep_unchanged(result, code, out, "out of memory");
+    }
+
+    int count = 0;
+    size_t offset = 0;
+    while (offset < code_end) {
+        uint8_t opcode = code[offset];
+        int width = opcode >= OP_PUSH1 && opcode <= OP_PUSH32 ? opcode - OP_PUSH1 + 1 : 0;
+        if (offset + 1 + width > code_end) {
+            break;
+        }
+        if (opcode == OP_CODECOPY || opcode == OP_CODESIZE || opcode == OP_PC) {
+            free(instrs);
+            free(moved);
+            free(jumpdest);
+            return keep_unchanged(result, code, out, "code reads its own bytes");
+        }
+        Instr* instr = &instrs[count++];
+        instr->opcode = opcode;
+        instr->width = (uint8_t)width;
+        instr->origin = (int32_t)offset;
+        instr->label = -1;
+        instr->maybe_label = -1;
+        memcpy(instr->value, code + offset + 1, width);
+        if (opcode == OP_JUMPDEST) {
+            jumpdest[offset] = 1;
+        }
+        offset += 1 + width;
+    }
+    size_t tail = offset;
+
+    // Code addresses: a PUSH of a JUMPDEST offset that feeds JUMP/JUMPI
+    // directly. Any other PUSH of a JUMPDEST offset may be a return address
+    // or just a constant; it is noted here, unless the next instruction
+    // consumes it as a location
+    for (int i = 0; i < count; i++) {
+        Instr* instr = &instrs[i];
+        if (instr->width == 0 || (i + 1 < count && takes_location(instrs[i + 1].opcode))) {
+            continue;
+        }
+        uint64_t value = 0;
+        for (int b = 0; b < instr->width && value < code_end; b++) {
+            value = (value << 8) | instr->value[b];
+        }
+        if (value >= code_end || !jumpdest[value]) {
+            continue;
+        }
+        bool feeds_jump = i + 1 < count &&
+                          (instrs[i + 1].opcode == OP_JUMP || instrs[i + 1].opcode == OP_JUMPI);
+        if (feeds_jump) {
+            instr->label = (int32_t)value;
+        } else {
+            instr->maybe_label = (int32_t)value;
+        }
+    }
+
+    // Return addresses: solc calls an internal function as
+    // PUSH ret ... PUSH f JUMP, pushing the return tag at tag width before
+    // the arguments. Walking backwards, `calls` says whether the block
+    // reaches such a direct jump from here without a JUMPDEST or halt
+    int tags = tag_width(size);
+    bool calls = false;
+    for (int i = count - 1; i >= 0; i--) {
+        Instr* instr = &instrs[i];
+        if (instr->opcode == OP_JUMP) {
+            calls = i > 0 && instrs[i - 1].label >= 0;
+        } else if (ends_block(instr->opcode)) {
+            calls = false;
+        } else if (calls && instr->maybe_label >= 0 && instr->width == tags) {
+            instr->label = instr->maybe_label;
+            instr->maybe_label = -1;
+        }
+    }
+
+    // Single pass; the output stack shares the array since it never grows
+    // past the input position. Statistics are restored if the result is
+    // discarded below
+    PeepholeStats before[RULE_COUNT];
+    memcpy(before, optimizer->stats, sizeof(before));
+    int emitted = 0;
+    for (int i = 0; i < count; i++) {
+        instrs[emitted++] = instrs[i];
+        while (rewrite_top(optimizer, instrs, &emitted, &result)) {
+        }
+    }
+
+    // Relocate jump targets; JUMPDESTs only ever move down, so the new
+    // offset fits the original immediate
+    offset = 0;
+    for (int i = 0; i < emitted; i++) {
+        if (instrs[i].opcode == OP_JUMPDEST && instrs[i].origin >= 0) {
+            moved[instrs[i].origin] = (int32_t)offset;
+        }
+        offset += (size_t)instr_size(&instrs[i]);
+    }
+    // A value that may be an address is safe only while its JUMPDEST stays put
+    for (int i = 0; i < emitted; i++) {
+        int32_t label = instrs[i].maybe_label;
+        if (label >= 0 && moved[label] != label) {
+            memcpy(optimizer->stats, before, sizeof(before));
+            result.gas_saved = 0;
+            result.rewrites = 0;
+            free(instrs);
+            free(moved);
+            free(jumpdest);
+            return keep_unchanged(result, code, out, "a constant equals a JUMPDEST offset that would move");
+        }
+    }
+    size_t written = 0;
+    for (int i = 0; i < emitted; i++) {
+        Instr* instr = &instrs[i];
+        if (instr->label >= 0 && moved[instr->label] != instr->label) {
+            uint32_t target = (uint32_t)moved[instr->label];
+            for (int b = instr->width - 1; b >= 0; b--) {
+                instr->value[b] = (uint8_t)target;
+                target >>= 8;
+            }
+            result.relocated++;
+        }
+        out[written++] = instr->opcode;
+        memcpy(out + written, instr->value, instr->width);
+        written += instr->width;
+    }
+    memcpy(out + written, code + tail, size - tail);
+    result.output_size = written + (size - tail);
+
+    free(instrs);
+    free(moved);
+    free(jumpdest);
+    return result;
+}
@@ -0,0 +1,68 @@
+// OMEGA Bootstrap - EVM Peephole Optimizer
+// Purpose: Rewrite wasteful EVM bytecode sequences in a single linear pass
+// Platform: Windows, Linux, macOS (standard C99)
+// The pattern table is compiled once into a trie keyed on opcode class
+// (PUSHn, DUPn and SWAPn each collapse to one symbol) and walked backwards
+// from the end of the output, so every rewrite can immediately enable the
+// next one without rescanning. Patterns never span a JUMPDEST.
+// Removing bytes moves jump destinations. A PUSH of a JUMPDEST offset is a
+// code address when it feeds JUMP/JUMPI directly, or when it has the width
+// solc uses for tags and its block ends in an internal call
+// (PUSH ret ... PUSH f JUMP); those immediates are rewritten in place after
+// the pass. Any other PUSH of a JUMPDEST offset could be an address or a
+// plain constant; unless the next instruction uses it up as a memory,
+// storage or calldata location, the code is returned unchanged when that
+// JUMPDEST would move. Code that reads its own bytes (CODECOPY, CODESIZE,
+// PC) is also returned unchanged, and a trailing solc CBOR metadata blob is
+// copied verbatim.
+
+#ifndef OMEGA_PEEPHOLE_H
+#define OMEGA_PEEPHOLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PEEPHOLE_SYMBOLS 256
+#define PEEPHOLE_MAX_PATTERN 4
+
+typedef struct {
+    const char* name;
+    long hits;
+    long bytes_saved;
+    long gas_saved;
+} PeepholeStats;
+
+typedef struct {
+    int16_t next[PEEPHOLE_SYMBOLS];   // child per opcode symbol, -1 if none
+    int16_t pattern;                  // pattern whose reversed sequence ends here
+} PeepholeNode;
+
+typedef struct {
+    PeepholeNode* nodes;
+    int node_count;
+    int node_capacity;
+    PeepholeStats* stats;             // cumulative, one per rule
+    int rule_count;
+} PeepholeOptimizer;
+
+typedef struct {
+    size_t input_size;
+    size_t output_size;
+    long gas_saved;
+    int rewrites;
+    int relocated;                    // jump immediates rewritten
+    const char* skipped;              // why the code was left as is, or NULL
+} PeepholeResult;
+
+// Compile the built-in pattern table.
+bool peephole_init(PeepholeOptimizer* optimizer);
+void peephole_free(PeepholeOptimizer* optimizer);
+void peephole_reset_stats(PeepholeOptimizer* optimizer);
+
+// Optimize `code` into `out`, which must hold `size` bytes (output never
+// grows). Statistics accumulate across calls.
+PeepholeResult peephole_optimize(PeepholeOptimizer* optimizer, const uint8_t* code,
+                                 size_t size, uint8_t* out);
+
+#endif // OMEGA_PEEPHOLE_H
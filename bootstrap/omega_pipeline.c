@@ -0,0 +1,474 @@
+// OMEGA Bootstrap - Compile Pipeline
+// Reader, lexer and writer threads around the caller's parser. Shared
+// counters are published with release stores and read with acquire loads;
+// the ring indices live on separate cache lines so producer and consumer
+// do not false-share.
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "omega_pipeline.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+
+#include <pthread.h>
+#include <sched.h>
+
+#define CACHE_LINE 64
+
+// A token is only kept if this many validated bytes follow it, so no token
+// is cut short by the read frontier (the lexer looks one byte past a token).
+#define LEXER_MARGIN 8
+
+#define NO_TEXT_END ((size_t)-1)
+
+typedef struct {
+    int count;
+    Token tokens[PIPELINE_BATCH];
+} TokenBatch;
+
+typedef struct {
+    size_t value;
+    char pad[CACHE_LINE - sizeof(size_t)];
+} PaddedCounter;
+
+typedef struct {
+    PaddedCounter head;             // next batch the parser takes
+    PaddedCounter tail;             // next batch the lexer fills
+    PaddedCounter available;        // validated source bytes
+    TokenBatch slots[PIPELINE_SLOTS];
+
+    char* source;                   // owner's buffer, even after the caller takes it
+    FILE* file;
+    size_t capacity;                // file size when opened
+    size_t text_end;                // first NUL byte; the lexer stops there
+    int read_done;
+    int lex_done;
+    int cancelled;
+    Lexer lexer;
+
+    PipelineChecksum checksum_fn;
+    uint32_t checksum;
+    int checksum_ready;
+
+    pthread_mutex_t mutex;          // guards the object handoff below
+    pthread_cond_t wake;
+    const char* output_path;
+    const void* output;
+    size_t output_size;
+    bool output_ready;
+    bool write_ok;
+
+    pthread_t reader;
+    pthread_t lexer_thread;
+    pthread_t writer;
+    bool reader_running;
+    bool lexer_running;
+    bool writer_running;
+    InternTable* interns;
+    SourcePipeline* owner;
+} PipelineState;
+
+static size_t load_size(const size_t* value) {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+static void store_size(size_t* value, size_t next) {
+    __atomic_store_n(value, next, __ATOMIC_RELEASE);
+}
+
+static int load_flag(const int* flag) {
+    return __atomic_load_n(flag, __ATOMIC_ACQUIRE);
+}
+
+static void set_flag(int* flag) {
+    __atomic_store_n(flag, 1, __ATOMIC_RELEASE);
+}
+
+// ============================================================================
+// READER
+// ============================================================================
+
+static void* reader_main(void* arg) {
+    PipelineState* state = arg;
+    SourcePipeline* pipeline = state->owner;
+    char* source = state->source;
+    size_t read = 0;
+    size_t validated = 0;
+    bool ascii = true;
+
+    while (!load_flag(&state->cancelled)) {
+        size_t want = state->capacity - read;
+        if (want > PIPELINE_WINDOW) {
+            want = PIPELINE_WINDOW;
+        }
+        size_t got = want ? fread(source + read, 1, want, state->file) : 0;
+        read += got;
+        bool eof = got < want || read == state->capacity;
+
+        // Validate up to the start of the last (possibly partial) character
+        // so a multi-byte sequence is never split between two windows
+        size_t boundary = read;
+        if (!eof) {
+            boundary = read - validated > 4 ? read - 4 : validated;
+            while (boundary > validated && ((unsigned char)source[boundary] & 0xC0) == 0x80) {
+                boundary--;
+            }
+        }
+        if (boundary > validated) {
+            Utf8Result chunk = utf8_validate((const uint8_t*)source + validated,
+                                             boundary - validated);
+            if (!chunk.valid) {
+                pipeline->encoding.valid = false;
+                pipeline->encoding.ascii = false;
+                pipeline->encoding.error_offset = validated + chunk.error_offset;
+                pipeline->status = PIPELINE_INVALID_UTF8;
+                break;
+            }
+            ascii = ascii && chunk.ascii;
+            if (state->text_end == NO_TEXT_END) {
+                const char* nul = memchr(source + validated, '\0', boundary - validated);
+                if (nul) {
+                    __atomic_store_n(&state->text_end, (size_t)(nul - source), __ATOMIC_RELAXED);
+                }
+            }
+            validated = boundary;
+            store_size(&state->available.value, validated);
+        }
+        if (eof) {
+            break;
+        }
+    }
+
+    source[read] = '\0';
+    fclose(state->file);
+    state->file = NULL;
+    pipeline->size = read;
+    if (pipeline->status == PIPELINE_OK) {
+        pipeline->encoding.valid = true;
+        pipeline->encoding.ascii = ascii;
+        pipeline->encoding.error_offset = 0;
+    }
+    set_flag(&state->read_done);
+    return NULL;
+}
+
+// ============================================================================
+// LEXER
+// ============================================================================
+
+static TokenBatch* acquire_batch(PipelineState* state) {
+    size_t tail = state->tail.value;
+    while (tail - load_size(&state->head.value) == PIPELINE_SLOTS) {
+        if (load_flag(&state->cancelled)) {
+            return NULL;
+        }
+        sched_yield();
+    }
+    TokenBatch* batch = &state->slots[tail & (PIPELINE_SLOTS - 1)];
+    batch->count = 0;
+    return batch;
+}
+
+static void publish_batch(PipelineState* state) {
+    store_size(&state->tail.value, state->tail.value + 1);
+}
+
+static void* lexer_main(void* arg) {
+    PipelineState* state = arg;
+    SourcePipeline* pipeline = state->owner;
+    Lexer lexer = state->lexer;
+    TokenBatch* batch = NULL;
+    int total = 0;
+    int comments = 0;
+
+    while (!load_flag(&state->cancelled)) {
+        // Read "done" before "available" so a finished reader's count is final
+        bool done = load_flag(&state->read_done);
+        size_t limit = load_size(&state->available.value);
+        if (done && pipeline->status != PIPELINE_OK) {
+            break;
+        }
+        size_t text_end = __atomic_load_n(&state->text_end, __ATOMIC_RELAXED);
+        if (text_end <= limit) {
+            limit = text_end;
+            done = true;
+        }
+        if (!done && (size_t)lexer.position + LEXER_MARGIN > limit) {
+            sched_yield();
+            continue;
+        }
+
+        lexer.length = (int)limit;
+        Lexer before = lexer;
+        Token token = next_token(&lexer);
+        if (!done && (size_t)lexer.position + LEXER_MARGIN > limit) {
+            // The token may continue past the frontier: scan it again later
+            lexer = before;
+            sched_yield();
+            continue;
+        }
+
+        if (token.type == TOK_COMMENT) {
+            comments++;
+        } else {
+            if (!batch && !(batch = acquire_batch(state))) {
+                break;
+            }
+            batch->tokens[batch->count++] = token;
+            total++;
+            if (batch->count == PIPELINE_BATCH) {
+                publish_batch(state);
+                batch = NULL;
+            }
+        }
+        if (token.type == TOK_EOF || total >= pipeline->max_tokens) {
+            break;
+        }
+    }
+
+    if (batch && batch->count > 0) {
+        publish_batch(state);
+    }
+    pipeline->comment_count = comments;
+    set_flag(&state->lex_done);
+    return NULL;
+}
+
+int pipeline_pull(void* context, Token* out) {
+    SourcePipeline* pipeline = context;
+    PipelineState* state = pipeline->impl;
+    size_t head = state->head.value;
+    for (;;) {
+        bool closed = load_flag(&state->lex_done);
+        if (head != load_size(&state->tail.value)) {
+            break;
+        }
+        if (closed) {
+            return 0;
+        }
+        sched_yield();
+    }
+
+    const TokenBatch* batch = &state->slots[head & (PIPELINE_SLOTS - 1)];
+    int count = batch->count;
+    memcpy(out, batch->tokens, sizeof(Token) * (size_t)count);
+    store_size(&state->head.value, head + 1);
+    return count;
+}
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+static void* writer_main(void* arg) {
+    PipelineState* state = arg;
+    const char* source = state->source;
+    uint32_t checksum = 0;
+    size_t hashed = 0;
+
+    for (;;) {
+        bool done = load_flag(&state->read_done);
+        size_t available = load_size(&state->available.value);
+        if (available > hashed) {
+            checksum = state->checksum_fn(checksum, source + hashed, available - hashed);
+            hashed = available;
+        } else if (done || load_flag(&state->cancelled)) {
+            break;
+        } else {
+            sched_yield();
+        }
+    }
+    state->checksum = checksum;
+    set_flag(&state->checksum_ready);
+
+    pthread_mutex_lock(&state->mutex);
+    while (!state->output_ready && !load_flag(&state->cancelled)) {
+        pthread_cond_wait(&state->wake, &state->mutex);
+    }
+    bool ready = state->output_ready;
+    pthread_mutex_unlock(&state->mutex);
+
+    if (ready) {
+        FILE* file = fopen(state->output_path, "wb");
+        if (file) {
+            state->write_ok = fwrite(state->output, 1, state->output_size, file) == state->output_size;
+            state->write_ok = fclose(file) == 0 && state->write_ok;
+        }
+    }
+    return NULL;
+}
+
+// ============================================================================
+// CONTROL
+// ============================================================================
+
+bool pipeline_start(SourcePipeline* pipeline, const char* path, InternTable* interns,
+                    int max_tokens, PipelineChecksum checksum) {
+    memset(pipeline, 0, sizeof(SourcePipeline));
+    pipeline->max_tokens = max_tokens;
+
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        pipeline->status = PIPELINE_OPEN_FAILED;
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    PipelineState* state = calloc(1, sizeof(PipelineState));
+    pipeline->source = file_size >= 0 ? malloc((size_t)file_size + 1) : NULL;
+    if (!state || !pipeline->source) {
+        free(state);
+        free(pipeline->source);
+        pipeline->source = NULL;
+        fclose(file);
+        pipeline->status = PIPELINE_NO_MEMORY;
+        return false;
+    }
+    pipeline->impl = state;
+    state->owner = pipeline;
+    state->source = pipeline->source;
+    state->file = file;
+    state->capacity = (size_t)file_size;
+    state->text_end = NO_TEXT_END;
+    state->checksum_fn = checksum;
+    state->interns = interns;
+    state->lexer = create_lexer_at(pipeline->source, 0, interns, 0, 1, 1);
+    pthread_mutex_init(&state->mutex, NULL);
+    pthread_cond_init(&state->wake, NULL);
+
+    intern_set_shared(interns, true);
+    state->reader_running = pthread_create(&state->reader, NULL, reader_main, state) == 0;
+    state->lexer_running = state->reader_running &&
+        pthread_create(&state->lexer_thread, NULL, lexer_main, state) == 0;
+    state->writer_running = state->lexer_running &&
+        pthread_create(&state->writer, NULL, writer_main, state) == 0;
+    if (!state->writer_running) {
+        pipeline_free(pipeline);
+        pipeline->status = PIPELINE_NO_MEMORY;
+        return false;
+    }
+    return true;
+}
+
+bool pipeline_finish(SourcePipeline* pipeline) {
+    PipelineState* state = pipeline->impl;
+    if (state->reader_running) {
+        pthread_join(state->reader, NULL);
+        state->reader_running = false;
+    }
+    if (state->lexer_running) {
+        pthread_join(state->lexer_thread, NULL);
+        state->lexer_running = false;
+    }
+    intern_set_shared(state->interns, false);
+    return pipeline->status == PIPELINE_OK;
+}
+
+uint32_t pipeline_checksum(SourcePipeline* pipeline) {
+    PipelineState* state = pipeline->impl;
+    while (!load_flag(&state->checksum_ready)) {
+        sched_yield();
+    }
+    return state->checksum;
+}
+
+bool pipeline_write(SourcePipeline* pipeline, const char* path, const void* data, size_t size) {
+    PipelineState* state = pipeline->impl;
+    if (!state->writer_running) {
+        return false;
+    }
+    pthread_mutex_lock(&state->mutex);
+    state->output_path = path;
+    state->output = data;
+    state->output_size = size;
+    state->output_ready = true;
+    pthread_cond_signal(&state->wake);
+    pthread_mutex_unlock(&state->mutex);
+
+    pthread_join(state->writer, NULL);
+    state->writer_running = false;
+    if (!state->write_ok) {
+        pipeline->status = PIPELINE_WRITE_FAILED;
+    }
+    return state->write_ok;
+}
+
+void pipeline_free(SourcePipeline* pipeline) {
+    PipelineState* state = pipeline->impl;
+    if (state) {
+        pthread_mutex_lock(&state->mutex);
+        set_flag(&state->cancelled);
+        pthread_cond_broadcast(&state->wake);
+        pthread_mutex_unlock(&state->mutex);
+        if (state->reader_running) {
+            pthread_join(state->reader, NULL);
+        }
+        if (state->lexer_running) {
+            pthread_join(state->lexer_thread, NULL);
+        }
+        if (state->writer_running) {
+            pthread_join(state->writer, NULL);
+        }
+        if (state->file) {
+            fclose(state->file);
+        }
+        intern_set_shared(state->interns, false);
+        pthread_mutex_destroy(&state->mutex);
+        pthread_cond_destroy(&state->wake);
+        free(state);
+    }
+    free(pipeline->source);
+    pipeline->source = NULL;
+    pipeline->impl = NULL;
+}
+
+#else
+
+bool pipeline_start(SourcePipeline* pipeline, const char* path, InternTable* interns,
+                    int max_tokens, PipelineChecksum checksum) {
+    (void)path;
+    (void)interns;
+    (void)checksum;
+    memset(pipeline, 0, sizeof(SourcePipeline));
+    pipeline->max_tokens = max_tokens;
+    pipeline->status = PIPELINE_UNSUPPORTED;
+    return false;
+}
+
+int pipeline_pull(void* context, Token* out) {
+    (void)context;
+    (void)out;
+    return 0;
+}
+
+bool pipeline_finish(SourcePipeline* pipeline) {
+    return pipeline->status == PIPELINE_OK;
+}
+
+uint32_t pipeline_checksum(SourcePipeline* pipeline) {
+    (void)pipeline;
+    return 0;
+}
+
+bool pipeline_write(SourcePipeline* pipeline, const char* path, const void* data, size_t size) {
+    (void)path;
+    (void)data;
+    (void)size;
+    pipeline->status = PIPELINE_WRITE_FAILED;
+    return false;
+}
+
+void pipeline_free(SourcePipeline* pipeline) {
+    free(pipeline->source);
+    pipeline->source = NULL;
+}
+
+#endif
@@ -0,0 +1,74 @@
+// OMEGA Bootstrap - Compile Pipeline
+// Purpose: Overlap reading, lexing, parsing and object writing of one module
+// Platform: Linux, macOS (POSIX threads); reports PIPELINE_UNSUPPORTED on Windows
+// A reader thread fills the source buffer window by window and validates
+// UTF-8 up to the last complete character. A lexer thread tokenizes behind
+// it and publishes token batches through a single-producer/single-consumer
+// ring; the caller's thread parses, pulling batches as it runs out. A writer
+// thread checksums the source as it arrives and writes the object once the
+// caller hands it over. The ring has a fixed number of slots, so a lexer
+// that runs ahead blocks instead of growing memory.
+// The intern table is shared while the pipeline runs (intern_set_shared).
+
+#ifndef OMEGA_PIPELINE_H
+#define OMEGA_PIPELINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "omega_intern.h"
+#include "omega_lexer.h"
+#include "omega_utf8.h"
+
+#define PIPELINE_WINDOW (64 * 1024)    // bytes read per step
+#define PIPELINE_BATCH 512             // tokens per ring slot
+#define PIPELINE_SLOTS 8               // ring slots (power of two)
+
+typedef enum {
+    PIPELINE_OK,
+    PIPELINE_UNSUPPORTED,
+    PIPELINE_OPEN_FAILED,
+    PIPELINE_NO_MEMORY,
+    PIPELINE_INVALID_UTF8,
+    PIPELINE_WRITE_FAILED
+} PipelineStatus;
+
+// Folds `length` more source bytes into a running checksum.
+typedef uint32_t (*PipelineChecksum)(uint32_t state, const char* data, size_t length);
+
+typedef struct {
+    PipelineStatus status;
+    char* source;                // NUL-terminated once finished; caller may take it
+    size_t size;                 // bytes read
+    Utf8Result encoding;
+    int comment_count;
+    int max_tokens;
+    void* impl;                  // threads, ring and shared counters
+} SourcePipeline;
+
+// Open `path` and start the reader, lexer and writer threads. On failure
+// `pipeline->status` says why and no threads are running.
+bool pipeline_start(SourcePipeline* pipeline, const char* path, InternTable* interns,
+                    int max_tokens, PipelineChecksum checksum);
+
+// Parser pull hook: append the next batch to `out` and return its size, or
+// 0 at the end of the stream. Never returns more than max_tokens in total.
+int pipeline_pull(void* pipeline, Token* out);
+
+// Wait for the reader and lexer; call once the parser has pulled to the end
+// of the stream. Fills size, encoding and comment_count; returns false
+// when the source is not valid UTF-8.
+bool pipeline_finish(SourcePipeline* pipeline);
+
+// Checksum of the whole source; waits for the writer to catch up.
+uint32_t pipeline_checksum(SourcePipeline* pipeline);
+
+// Hand the object bytes to the writer thread and wait until they are on
+// disk at `path`.
+bool pipeline_write(SourcePipeline* pipeline, const char* path, const void* data, size_t size);
+
+// Stop any remaining threads and release everything but a taken source.
+void pipeline_free(SourcePipeline* pipeline);
+
+#endif // OMEGA_PIPELINE_H
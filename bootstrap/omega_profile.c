@@ -0,0 +1,588 @@
+// OMEGA Bootstrap - Sampling Profiler
+// SIGPROF sampling, frame-pointer unwinding, symbolization and folded output.
+
+#if defined(__linux__)
+#define _GNU_SOURCE     // REG_RIP and friends in <ucontext.h>
+#endif
+
+#include "omega_profile.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__linux__) || defined(__APPLE__)) && (defined(__x86_64__) || defined(__aarch64__)) && \
+    defined(__GNUC__)
+#define PROFILE_SUPPORTED 1
+#endif
+
+#ifdef PROFILE_SUPPORTED
+#include <errno.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#ifdef __linux__
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+#endif
+
+static const char* const phase_names[PHASE_COUNT] = {
+    "other", "read", "lex", "parse", "interfaces", "whole-program", "layout", "selectors",
+    "codegen", "write"
+};
+
+static volatile int current_phase = PHASE_OTHER;
+
+ProfilePhase profile_phase(ProfilePhase phase) {
+    ProfilePhase previous = (ProfilePhase)current_phase;
+    current_phase = (int)phase;
+    return previous;
+}
+
+const char* profile_phase_name(ProfilePhase phase) {
+    return phase >= 0 && phase < PHASE_COUNT ? phase_names[phase] : "other";
+}
+
+#ifndef PROFILE_SUPPORTED
+
+bool profiler_start(const char* path, int hz) {
+    (void)path;
+    (void)hz;
+    return false;
+}
+
+bool profiler_stop(ProfileReport* report) {
+    memset(report, 0, sizeof(ProfileReport));
+    return false;
+}
+
+#else
+
+// Sample layout in the buffer: a header word (depth | phase << 16) followed
+// by `depth` frames, leaf first. A zero header ends the buffer early.
+#define SAMPLE_HEADER(depth, phase) ((uintptr_t)(depth) | ((uintptr_t)(phase) << 16))
+#define SAMPLE_DEPTH(header) ((int)((header) & 0xFFFF))
+#define SAMPLE_PHASE(header) ((int)(((header) >> 16) & 0xFF))
+#define THREAD_FRAME ((uintptr_t)1)     // stands in for the stack of a worker thread
+
+static uintptr_t* samples;
+static size_t sample_words;             // reserved so far (may pass the capacity)
+static long dropped;
+static int in_handler;                  // handlers still running
+static uintptr_t stack_low;             // main thread stack, [stack_low, stack_top)
+static uintptr_t stack_top;
+static struct sigaction previous_action;
+static bool running;
+static int sample_hz;
+static char output_path[4096];
+
+// ============================================================================
+// SAMPLING
+// ============================================================================
+
+static void interrupted_registers(const ucontext_t* context, uintptr_t* pc, uintptr_t* sp,
+                                  uintptr_t* fp) {
+#if defined(__linux__) && defined(__x86_64__)
+    *pc = (uintptr_t)context->uc_mcontext.gregs[REG_RIP];
+    *sp = (uintptr_t)context->uc_mcontext.gregs[REG_RSP];
+    *fp = (uintptr_t)context->uc_mcontext.gregs[REG_RBP];
+#elif defined(__linux__) && defined(__aarch64__)
+    *pc = (uintptr_t)context->uc_mcontext.pc;
+    *sp = (uintptr_t)context->uc_mcontext.sp;
+    *fp = (uintptr_t)context->uc_mcontext.regs[29];
+#elif defined(__APPLE__) && defined(__x86_64__)
+    *pc = (uintptr_t)context->uc_mcontext->__ss.__rip;
+    *sp = (uintptr_t)context->uc_mcontext->__ss.__rsp;
+    *fp = (uintptr_t)context->uc_mcontext->__ss.__rbp;
+#else
+    *pc = (uintptr_t)context->uc_mcontext->__ss.__pc;
+    *sp = (uintptr_t)context->uc_mcontext->__ss.__sp;
+    *fp = (uintptr_t)context->uc_mcontext->__ss.__fp;
+#endif
+}
+
+// Async-signal-safe: no allocation, no locks, reads only inside the main
+// thread's stack.
+static void take_sample(int signal_number, siginfo_t* info, void* context) {
+    (void)signal_number;
+    (void)info;
+    int saved_errno = errno;
+    __atomic_add_fetch(&in_handler, 1, __ATOMIC_ACQUIRE);
+
+    uintptr_t pc, sp, fp;
+    interrupted_registers(context, &pc, &sp, &fp);
+    uintptr_t frames[PROFILE_MAX_DEPTH];
+    int depth = 0;
+    frames[depth++] = pc;
+    if (sp >= stack_low && sp < stack_top) {
+        // Each frame record is {saved frame pointer, return address}
+        while (depth < PROFILE_MAX_DEPTH && fp >= sp && fp <= stack_top - 2 * sizeof(uintptr_t) &&
+               (fp & (sizeof(uintptr_t) - 1)) == 0) {
+            const uintptr_t* record = (const uintptr_t*)fp;
+            if (record[1] == 0) {
+                break;
+            }
+            frames[depth++] = record[1];
+            if (record[0] <= fp) {
+                break;
+            }
+            fp = record[0];
+        }
+    } else {
+        frames[depth++] = THREAD_FRAME;
+    }
+
+    size_t need = (size_t)depth + 1;
+    size_t at = __atomic_fetch_add(&sample_words, need, __ATOMIC_RELAXED);
+    if (at + need > PROFILE_BUFFER_WORDS) {
+        if (at < PROFILE_BUFFER_WORDS) {
+            samples[at] = 0;   // nothing valid past here
+        }
+        __atomic_add_fetch(&dropped, 1, __ATOMIC_RELAXED);
+    } else {
+        samples[at] = SAMPLE_HEADER(depth, current_phase);
+        memcpy(&samples[at + 1], frames, sizeof(uintptr_t) * (size_t)depth);
+    }
+
+    __atomic_sub_fetch(&in_handler, 1, __ATOMIC_RELEASE);
+    errno = saved_errno;
+}
+
+// Bounds of the main thread's stack, which the unwinder may read.
+static bool find_main_stack(void) {
+    uintptr_t here = (uintptr_t)__builtin_frame_address(0);
+#ifdef __linux__
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (!maps) {
+        return false;
+    }
+    char line[512];
+    unsigned long start, end;
+    while (fgets(line, sizeof(line), maps)) {
+        if (strstr(line, "[stack]") && sscanf(line, "%lx-%lx", &start, &end) == 2 &&
+            here >= start && here < end) {
+            stack_top = (uintptr_t)end;
+        }
+    }
+    fclose(maps);
+#else
+    stack_top = (uintptr_t)pthread_get_stackaddr_np(pthread_self());
+#endif
+    if (stack_top <= here) {
+        return false;
+    }
+    // The stack may still grow down to its limit
+    struct rlimit limit;
+    uintptr_t size = 64u << 20;
+    if (getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+        limit.rlim_cur < size) {
+        size = (uintptr_t)limit.rlim_cur;
+    }
+    stack_low = stack_top > size ? stack_top - size : 0;
+    return true;
+}
+
+bool profiler_start(const char* path, int hz) {
+    if (running || hz <= 0 || hz > 100000 || strlen(path) >= sizeof(output_path) ||
+        !find_main_stack()) {
+        return false;
+    }
+    // Large enough that malloc maps it lazily; pages are touched as samples arrive
+    samples = malloc(sizeof(uintptr_t) * PROFILE_BUFFER_WORDS);
+    if (!samples) {
+        return false;
+    }
+    snprintf(output_path, sizeof(output_path), "%s", path);
+    sample_words = 0;
+    dropped = 0;
+    sample_hz = hz;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = take_sample;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &previous_action) != 0) {
+        free(samples);
+        samples = NULL;
+        return false;
+    }
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000000 / hz;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+        sigaction(SIGPROF, &previous_action, NULL);
+        free(samples);
+        samples = NULL;
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+// ============================================================================
+// SYMBOLS
+// ============================================================================
+
+typedef struct {
+    uintptr_t address;      // runtime address
+    uintptr_t size;
+    const char* name;
+} Symbol;
+
+typedef struct {
+    Symbol* symbols;
+    int count;
+    void* image;            // mapped executable backing the names
+    size_t image_size;
+    char* maps;             // /proc/self/maps text, for addresses outside it
+    uintptr_t* cache_keys;  // address -> name memo (open addressing)
+    const char** cache_names;
+    size_t cache_mask;
+    size_t cache_count;
+    char* scratch;          // storage for names made up here
+    size_t scratch_used;
+    size_t scratch_size;
+} Symbolizer;
+
+static const char* scratch_name(Symbolizer* symbolizer, const char* text) {
+    size_t length = strlen(text) + 1;
+    if (symbolizer->scratch_used + length > symbolizer->scratch_size) {
+        return "[unknown]";
+    }
+    char* copy = symbolizer->scratch + symbolizer->scratch_used;
+    memcpy(copy, text, length);
+    symbolizer->scratch_used += length;
+    return copy;
+}
+
+static int compare_symbols(const void* a, const void* b) {
+    const Symbol* left = a;
+    const Symbol* right = b;
+    return left->address < right->address ? -1 : left->address > right->address;
+}
+
+#ifdef __linux__
+// Function symbols of /proc/self/exe, relocated by comparing a known
+// function's link-time address with its runtime one.
+static void load_symbols(Symbolizer* symbolizer) {
+    int fd = open("/proc/self/exe", O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(Elf64_Ehdr)) {
+        if (fd >= 0) close(fd);
+        return;
+    }
+    void* image = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        return;
+    }
+    symbolizer->image = image;
+    symbolizer->image_size = (size_t)info.st_size;
+
+    const unsigned char* bytes = image;
+    const Elf64_Ehdr* header = image;
+    if (memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 || header->e_ident[EI_CLASS] != ELFCLASS64 ||
+        header->e_shoff == 0 || header->e_shentsize != sizeof(Elf64_Shdr) ||
+        header->e_shoff + (uint64_t)header->e_shnum * sizeof(Elf64_Shdr) > symbolizer->image_size) {
+        return;
+    }
+    const Elf64_Shdr* sections = (const Elf64_Shdr*)(bytes + header->e_shoff);
+    const Elf64_Shdr* table = NULL;
+    for (int pass = 0; pass < 2 && !table; pass++) {
+        // Prefer the full symbol table; a stripped binary still has .dynsym
+        uint32_t wanted = pass == 0 ? SHT_SYMTAB : SHT_DYNSYM;
+        for (int i = 0; i < header->e_shnum; i++) {
+            if (sections[i].sh_type == wanted && sections[i].sh_link < header->e_shnum) {
+                table = &sections[i];
+                break;
+            }
+        }
+    }
+    if (!table) {
+        return;
+    }
+    const Elf64_Shdr* strings = &sections[table->sh_link];
+    if (table->sh_offset + table->sh_size > symbolizer->image_size ||
+        strings->sh_offset + strings->sh_size > symbolizer->image_size || strings->sh_size == 0 ||
+        bytes[strings->sh_offset + strings->sh_size - 1] != '\0') {
+        return;
+    }
+    const Elf64_Sym* entries = (const Elf64_Sym*)(bytes + table->sh_offset);
+    size_t entry_count = table->sh_size / sizeof(Elf64_Sym);
+    const char* names = (const char*)(bytes + strings->sh_offset);
+
+    symbolizer->symbols = malloc(sizeof(Symbol) * (entry_count + 1));
+    if (!symbolizer->symbols) {
+        return;
+    }
+    uintptr_t anchor = 0;
+    for (size_t i = 0; i < entry_count; i++) {
+        const Elf64_Sym* entry = &entries[i];
+        if (ELF64_ST_TYPE(entry->st_info) != STT_FUNC || entry->st_value == 0 ||
+            entry->st_name >= strings->sh_size) {
+            continue;
+        }
+        Symbol* symbol = &symbolizer->symbols[symbolizer->count++];
+        symbol->address = (uintptr_t)entry->st_value;
+        symbol->size = (uintptr_t)entry->st_size;
+        symbol->name = names + entry->st_name;
+        if (strcmp(symbol->name, "profiler_start") == 0) {
+            anchor = symbol->address;
+        }
+    }
+    // Position-independent executables load at a random base
+    uintptr_t bias = anchor ? (uintptr_t)&profiler_start - anchor : 0;
+    for (int i = 0; i < symbolizer->count; i++) {
+        symbolizer->symbols[i].address += bias;
+    }
+    qsort(symbolizer->symbols, (size_t)symbolizer->count, sizeof(Symbol), compare_symbols);
+}
+
+static char* read_maps(void) {
+    FILE* file = fopen("/proc/self/maps", "r");
+    if (!file) {
+        return NULL;
+    }
+    size_t size = 0;
+    size_t capacity = 16384;
+    char* text = malloc(capacity);
+    size_t got;
+    while (text && (got = fread(text + size, 1, capacity - size - 1, file)) > 0) {
+        size += got;
+        if (size + 1 == capacity) {
+            char* grown = realloc(text, capacity * 2);
+            if (!grown) {
+                free(text);
+                text = NULL;
+                break;
+            }
+            text = grown;
+            capacity *= 2;
+        }
+    }
+    fclose(file);
+    if (text) {
+        text[size] = '\0';
+    }
+    return text;
+}
+
+// "[libc.so.6]" for an address inside a mapped file.
+static const char* mapping_name(Symbolizer* symbolizer, uintptr_t address) {
+    for (const char* line = symbolizer->maps; line && *line;) {
+        const char* end = strchr(line, '\n');
+        unsigned long start, stop;
+        if (sscanf(line, "%lx-%lx", &start, &stop) == 2 && address >= start && address < stop) {
+            const char* path = strchr(line, '/');
+            if (path && (!end || path < end)) {
+                const char* base = path;
+                for (const char* c = path; c < (end ? end : path + strlen(path)); c++) {
+                    if (*c == '/') {
+                        base = c + 1;
+                    }
+                }
+                char name[256];
+                int length = (int)((end ? end : base + strlen(base)) - base);
+                snprintf(name, sizeof(name), "[%.*s]", length < 200 ? length : 200, base);
+                return scratch_name(symbolizer, name);
+            }
+            return NULL;
+        }
+        line = end ? end + 1 : NULL;
+    }
+    return NULL;
+}
+#endif
+
+static const char* lookup_symbol(Symbolizer* symbolizer, uintptr_t address) {
+    if (address == THREAD_FRAME) {
+        return "[thread]";
+    }
+    size_t slot = (address * 0x9E3779B97F4A7C15ull >> 20) & symbolizer->cache_mask;
+    while (symbolizer->cache_keys[slot] && symbolizer->cache_keys[slot] != address) {
+        slot = (slot + 1) & symbolizer->cache_mask;
+    }
+    if (symbolizer->cache_keys[slot]) {
+        return symbolizer->cache_names[slot];
+    }
+
+    const char* name = NULL;
+    int low = 0;
+    int high = symbolizer->count - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        if (symbolizer->symbols[middle].address <= address) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    if (high >= 0) {
+        const Symbol* symbol = &symbolizer->symbols[high];
+        if (address < symbol->address + (symbol->size ? symbol->size : 1)) {
+            name = symbol->name;
+        }
+    }
+#ifdef __linux__
+    if (!name) {
+        name = mapping_name(symbolizer, address);
+    }
+#else
+    Dl_info info;
+    if (!name && dladdr((void*)address, &info) && info.dli_sname) {
+        name = scratch_name(symbolizer, info.dli_sname);
+    }
+#endif
+    if (!name) {
+        char hex[32];
+        snprintf(hex, sizeof(hex), "0x%lx", (unsigned long)address);
+        name = scratch_name(symbolizer, hex);
+    }
+    // Keep the memo at most half full so probes stay short
+    if (symbolizer->cache_count * 2 < symbolizer->cache_mask) {
+        symbolizer->cache_keys[slot] = address;
+        symbolizer->cache_names[slot] = name;
+        symbolizer->cache_count++;
+    }
+    return name;
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+static int compare_lines(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Folded line for one sample: phase, then frames from the outermost (main,
+// when it is found) to the leaf.
+static char* fold_sample(Symbolizer* symbolizer, const uintptr_t* frames, int depth, int phase) {
+    const char* names[PROFILE_MAX_DEPTH];
+    int outermost = depth - 1;
+    size_t length = strlen(profile_phase_name((ProfilePhase)phase)) + 1;
+    for (int i = 0; i < depth; i++) {
+        // Return addresses point past the call; look up the call itself
+        uintptr_t address = i == 0 || frames[i] == THREAD_FRAME ? frames[i] : frames[i] - 1;
+        names[i] = lookup_symbol(symbolizer, address);
+        if (strcmp(names[i], "main") == 0) {
+            outermost = i;   // drop libc start-up frames above main
+            break;
+        }
+    }
+    for (int i = 0; i <= outermost; i++) {
+        length += strlen(names[i]) + 1;
+    }
+    char* line = malloc(length + 1);
+    if (!line) {
+        return NULL;
+    }
+    size_t used = (size_t)snprintf(line, length + 1, "%s", profile_phase_name((ProfilePhase)phase));
+    for (int i = outermost; i >= 0; i--) {
+        used += (size_t)snprintf(line + used, length + 1 - used, ";%s", names[i]);
+    }
+    return line;
+}
+
+bool profiler_stop(ProfileReport* report) {
+    memset(report, 0, sizeof(ProfileReport));
+    if (!running) {
+        return false;
+    }
+    struct itimerval off;
+    memset(&off, 0, sizeof(off));
+    setitimer(ITIMER_PROF, &off, NULL);
+    sigaction(SIGPROF, &previous_action, NULL);
+    while (__atomic_load_n(&in_handler, __ATOMIC_ACQUIRE) > 0) {
+        // A handler on another thread is finishing its sample
+    }
+    running = false;
+    report->hz = sample_hz;
+    report->dropped = dropped;
+
+    size_t limit = sample_words < PROFILE_BUFFER_WORDS ? sample_words : PROFILE_BUFFER_WORDS;
+    long count = 0;
+    for (size_t at = 0; at < limit && SAMPLE_DEPTH(samples[at]) > 0; at += (size_t)SAMPLE_DEPTH(samples[at]) + 1) {
+        count++;
+    }
+
+    Symbolizer symbolizer;
+    memset(&symbolizer, 0, sizeof(symbolizer));
+    symbolizer.cache_mask = 8191;
+    symbolizer.cache_keys = calloc(symbolizer.cache_mask + 1, sizeof(uintptr_t));
+    symbolizer.cache_names = malloc(sizeof(const char*) * (symbolizer.cache_mask + 1));
+    symbolizer.scratch_size = 256 * 1024;
+    symbolizer.scratch = malloc(symbolizer.scratch_size);
+    char** lines = malloc(sizeof(char*) * ((size_t)count + 1));
+    bool ok = symbolizer.cache_keys && symbolizer.cache_names && symbolizer.scratch && lines;
+#ifdef __linux__
+    if (ok) {
+        load_symbols(&symbolizer);
+        symbolizer.maps = read_maps();
+    }
+#endif
+
+    long folded = 0;
+    for (size_t at = 0; ok && at < limit && SAMPLE_DEPTH(samples[at]) > 0;
+         at += (size_t)SAMPLE_DEPTH(samples[at]) + 1) {
+        int depth = SAMPLE_DEPTH(samples[at]);
+        int phase = SAMPLE_PHASE(samples[at]);
+        if (phase >= PHASE_COUNT) {
+            phase = PHASE_OTHER;
+        }
+        report->phase_samples[phase]++;
+        report->samples++;
+        char* line = fold_sample(&symbolizer, &samples[at + 1], depth, phase);
+        if (line) {
+            lines[folded++] = line;
+        }
+    }
+
+    FILE* out = ok ? fopen(output_path, "w") : NULL;
+    if (out) {
+        qsort(lines, (size_t)folded, sizeof(char*), compare_lines);
+        for (long i = 0; i < folded;) {
+            long j = i + 1;
+            while (j < folded && strcmp(lines[j], lines[i]) == 0) {
+                j++;
+            }
+            fprintf(out, "%s %ld\n", lines[i], j - i);
+            report->unique_stacks++;
+            i = j;
+        }
+        ok = fclose(out) == 0;
+    } else {
+        ok = false;
+    }
+
+    for (long i = 0; i < folded; i++) {
+        free(lines[i]);
+    }
+    free(lines);
+    free(symbolizer.symbols);
+    free(symbolizer.maps);
+    free(symbolizer.cache_keys);
+    free(symbolizer.cache_names);
+    free(symbolizer.scratch);
+#ifdef __linux__
+    if (symbolizer.image) {
+        munmap(symbolizer.image, symbolizer.image_size);
+    }
+#endif
+    free(samples);
+    samples = NULL;
+    return ok;
+}
+
+#endif // PROFILE_SUPPORTED
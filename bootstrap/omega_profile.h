@@ -0,0 +1,64 @@
+// OMEGA Bootstrap - Sampling Profiler
+// Purpose: Show where compile time goes without an external profiler
+// Platform: Linux, macOS on x86-64 and AArch64 (SIGPROF); unsupported elsewhere
+// A CPU-time interval timer (setitimer ITIMER_PROF) delivers SIGPROF; the
+// handler walks the interrupted thread's frame-pointer chain into a
+// preallocated buffer and tags the sample with the current compiler phase.
+// Stacks are symbolized only when profiling stops: from the executable's
+// ELF symbol table on Linux (static functions included), dladdr on macOS,
+// else the containing mapping. Output is folded stacks ("a;b;c 12"), ready
+// for flamegraph.pl or speedscope, with the phase as the root frame.
+// Frames are only as good as the frame pointers: build with
+// -fno-omit-frame-pointer (build_bootstrap.sh does). Samples taken on
+// worker threads keep just the leaf function under a "[thread]" frame.
+// When the profiler is off no timer or handler is installed and a phase
+// change is a single store.
+
+#ifndef OMEGA_PROFILE_H
+#define OMEGA_PROFILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PROFILE_DEFAULT_HZ 997          // odd, so it does not beat with periodic work
+#define PROFILE_MAX_DEPTH 64            // frames kept per sample
+#define PROFILE_BUFFER_WORDS (1 << 21)  // 16 MiB on 64-bit, touched as it fills
+
+typedef enum {
+    PHASE_OTHER,            // startup, scanning, anything unmarked
+    PHASE_READ,             // reading and validating sources
+    PHASE_LEX,              // tokenizing (on worker threads under --pipeline)
+    PHASE_PARSE,            // parsing, parse cache, import resolution
+    PHASE_INTERFACES,       // emitting module interfaces
+    PHASE_WHOLE_PROGRAM,    // --whole-program reachability
+    PHASE_LAYOUT,           // storage layout and gas
+    PHASE_SELECTORS,        // selector and topic hashing
+    PHASE_CODEGEN,          // --target code generation
+    PHASE_WRITE,            // building and writing objects
+    PHASE_COUNT
+} ProfilePhase;
+
+typedef struct {
+    int hz;
+    long samples;                   // recorded
+    long dropped;                   // buffer full
+    long phase_samples[PHASE_COUNT];
+    int unique_stacks;              // lines in the folded output
+} ProfileReport;
+
+// Install the timer and handler. False (nothing installed) if the platform
+// is unsupported or a profiler is already running.
+bool profiler_start(const char* path, int hz);
+
+// Stop sampling and write the folded stacks to the path given to
+// profiler_start. Fills `report` either way; false if the file could not
+// be written.
+bool profiler_stop(ProfileReport* report);
+
+// Mark the phase the process is entering; returns the previous one so
+// nested callers can restore it.
+ProfilePhase profile_phase(ProfilePhase phase);
+
+const char* profile_phase_name(ProfilePhase phase);
+
+#endif // OMEGA_PROFILE_H
@@ -0,0 +1,209 @@
+// OMEGA Bootstrap - Incremental Relexing
+// Gap-buffered token stream updated by relexing only around each edit.
+
+#include "omega_relex.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Tokens after the gap keep offset and line relative to the document end:
+//   stored.offset = doc_length - offset, stored.line = doc_lines - line
+// so edits before them never touch their storage.
+
+bool token_stream_init(TokenStream* stream, InternTable* interns) {
+    memset(stream, 0, sizeof(TokenStream));
+    stream->interns = interns;
+    stream->capacity = 1024;
+    stream->tokens = malloc(sizeof(Token) * stream->capacity);
+    if (!stream->tokens) {
+        return false;
+    }
+    stream->gap_end = stream->capacity;
+    stream->doc_lines = 1;
+    return true;
+}
+
+void token_stream_free(TokenStream* stream) {
+    free(stream->tokens);
+    memset(stream, 0, sizeof(TokenStream));
+}
+
+int token_stream_count(const TokenStream* stream) {
+    return stream->gap_start + (stream->capacity - stream->gap_end);
+}
+
+static Token to_relative(const TokenStream* stream, Token token) {
+    token.offset = stream->doc_length - token.offset;
+    token.line = stream->doc_lines - token.line;
+    return token;
+}
+
+static Token to_absolute(const TokenStream* stream, Token token) {
+    token.offset = stream->doc_length - token.offset;
+    token.line = stream->doc_lines - token.line;
+    return token;
+}
+
+Token token_stream_get(const TokenStream* stream, int index) {
+    if (index < stream->gap_start) {
+        return stream->tokens[index];
+    }
+    return to_absolute(stream, stream->tokens[index + (stream->gap_end - stream->gap_start)]);
+}
+
+static bool grow_gap(TokenStream* stream) {
+    int capacity = stream->capacity * 2;
+    Token* tokens = realloc(stream->tokens, sizeof(Token) * capacity);
+    if (!tokens) {
+        return false;
+    }
+    int tail = stream->capacity - stream->gap_end;
+    memmove(tokens + capacity - tail, tokens + stream->gap_end, sizeof(Token) * tail);
+    stream->tokens = tokens;
+    stream->gap_end = capacity - tail;
+    stream->capacity = capacity;
+    return true;
+}
+
+static bool push_token(TokenStream* stream, Token token) {
+    if (stream->gap_start == stream->gap_end && !grow_gap(stream)) {
+        return false;
+    }
+    stream->tokens[stream->gap_start++] = token;
+    return true;
+}
+
+// Move the gap so that it starts at token `index`, converting the tokens
+// that cross it. Cost is the distance moved.
+static void move_gap(TokenStream* stream, int index) {
+    while (stream->gap_start > index) {
+        Token token = stream->tokens[--stream->gap_start];
+        stream->tokens[--stream->gap_end] = to_relative(stream, token);
+    }
+    while (stream->gap_start < index) {
+        Token token = stream->tokens[stream->gap_end++];
+        stream->tokens[stream->gap_start++] = to_absolute(stream, token);
+    }
+}
+
+static int count_lines(const char* text, int start, int end) {
+    int lines = 0;
+    for (int i = start; i < end; i++) {
+        if (text[i] == '\n') {
+            lines++;
+        }
+    }
+    return lines;
+}
+
+bool token_stream_lex(TokenStream* stream, const char* source, int length) {
+    stream->gap_start = 0;
+    stream->gap_end = stream->capacity;
+    stream->doc_length = length;
+    stream->doc_lines = count_lines(source, 0, length) + 1;
+
+    Lexer lexer = create_lexer_at(source, length, stream->interns, 0, 1, 1);
+    Token token;
+    do {
+        token = next_token(&lexer);
+        if (!push_token(stream, token)) {
+            return false;
+        }
+    } while (token.type != TOK_EOF);
+    return true;
+}
+
+// Index of the last token that ends (with one byte of lexer lookahead to
+// spare) before `start`; the lexer restarts there. -1 if there is none.
+static int restart_index(const TokenStream* stream, int start) {
+    int low = 0;
+    int high = token_stream_count(stream) - 1;
+    int found = -1;
+    while (low <= high) {
+        int middle = low + (high - low) / 2;
+        Token token = token_stream_get(stream, middle);
+        if (token.type != TOK_EOF && token.offset + token.length + 1 < start) {
+            found = middle;
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return found;
+}
+
+bool token_stream_relex(TokenStream* stream, const char* old_source,
+                        const char* new_source, int new_length,
+                        const TextEdit* edit, RelexStats* stats) {
+    int restart = restart_index(stream, edit->start);
+    int position = 0;
+    int line = 1;
+    int column = 1;
+    if (restart >= 0) {
+        Token anchor = token_stream_get(stream, restart);
+        position = anchor.offset;
+        line = anchor.line;
+        column = anchor.column;
+    } else {
+        restart = 0;
+    }
+
+    move_gap(stream, restart);
+
+    // Switch to the new document: tail tokens are end-relative, so only the
+    // totals change
+    stream->doc_length = new_length;
+    stream->doc_lines += count_lines(new_source, edit->start, edit->new_end)
+                       - count_lines(old_source, edit->start, edit->old_end);
+
+    RelexStats local = { restart, 0, 0, 0 };
+    Lexer lexer = create_lexer_at(new_source, new_length, stream->interns,
+                                  position, line, column);
+
+    for (;;) {
+        Token token = next_token(&lexer);
+
+        // Drop old tokens that now start before the new token; an old token
+        // at the same offset past the edit means the streams agree again
+        bool resynced = false;
+        while (stream->gap_end < stream->capacity) {
+            Token old = to_absolute(stream, stream->tokens[stream->gap_end]);
+            if (old.offset > token.offset) {
+                break;
+            }
+            if (old.offset == token.offset && token.offset >= edit->new_end &&
+                old.type == token.type && old.length == token.length) {
+                resynced = true;
+                break;
+            }
+            stream->gap_end++;
+            local.removed++;
+        }
+
+        if (resynced) {
+            // Tokens after the resync point on the same line shift columns
+            int delta = token.column - to_absolute(stream, stream->tokens[stream->gap_end]).column;
+            for (int i = stream->gap_end; delta != 0 && i < stream->capacity; i++) {
+                if (stream->doc_lines - stream->tokens[i].line != token.line) {
+                    break;
+                }
+                stream->tokens[i].column += delta;
+            }
+            break;
+        }
+
+        if (!push_token(stream, token)) {
+            return false;
+        }
+        local.inserted++;
+        if (token.type == TOK_EOF) {
+            break;
+        }
+    }
+
+    local.lexed_bytes = lexer.position - position;
+    if (stats) {
+        *stats = local;
+    }
+    return true;
+}
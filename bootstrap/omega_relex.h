@@ -0,0 +1,60 @@
+// OMEGA Bootstrap - Incremental Relexing
+// Purpose: Keep a token stream up to date under small text edits (LSP typing)
+// Platform: Windows, Linux, macOS (standard C99)
+// Tokens live in a gap buffer. Tokens before the gap store absolute offsets
+// and lines; tokens after it store them relative to the end of the document.
+// An edit only touches tokens near the gap, so the text after the edit never
+// has to be renumbered: cost depends on the edit and the distance from the
+// previous edit, not on the size of the file.
+// Relexing restarts at the last token that ends before the edit (the lexer
+// carries no state between tokens) and stops as soon as a new token starts
+// exactly where a surviving old token now starts.
+
+#ifndef OMEGA_RELEX_H
+#define OMEGA_RELEX_H
+
+#include "omega_intern.h"
+#include "omega_lexer.h"
+
+typedef struct {
+    Token* tokens;        // storage; [gap_start, gap_end) is unused
+    int capacity;
+    int gap_start;
+    int gap_end;
+    int doc_length;       // bytes in the current document
+    int doc_lines;        // newlines in the current document + 1
+    InternTable* interns; // borrowed; owns token text
+} TokenStream;
+
+// Replacement of old bytes [start, old_end) with new bytes [start, new_end).
+typedef struct {
+    int start;
+    int old_end;
+    int new_end;
+} TextEdit;
+
+// Statistics of the last relex, for tooling and benchmarks.
+typedef struct {
+    int first_changed;    // index of the first replaced token
+    int removed;          // old tokens dropped
+    int inserted;         // new tokens lexed and kept
+    int lexed_bytes;      // source bytes scanned by the lexer
+} RelexStats;
+
+bool token_stream_init(TokenStream* stream, InternTable* interns);
+void token_stream_free(TokenStream* stream);
+
+// Lex a whole document into the stream, replacing its contents.
+bool token_stream_lex(TokenStream* stream, const char* source, int length);
+
+int token_stream_count(const TokenStream* stream);
+Token token_stream_get(const TokenStream* stream, int index);
+
+// Update the stream for `edit`. `old_source` is the document before the
+// edit (only the replaced range is read); `new_source` is the full document
+// after it.
+bool token_stream_relex(TokenStream* stream, const char* old_source,
+                        const char* new_source, int new_length,
+                        const TextEdit* edit, RelexStats* stats);
+
+#endif // OMEGA_RELEX_H
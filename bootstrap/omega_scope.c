@@ -0,0 +1,216 @@
+// OMEGA Bootstrap - Scoped Symbol Table
+// Name table with Fibonacci hashing and linear probing, declaration stack, use bitset.
+
+#include "omega_scope.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SCOPE_INITIAL_SLOTS 256
+#define SCOPE_INITIAL_SYMBOLS 128
+#define SCOPE_INITIAL_DEPTH 32
+
+// Intern IDs are dense small integers, so a multiplicative hash spreads them
+// better than masking the low bits would.
+static uint32_t scope_slot(const ScopeTable* table, uint32_t name) {
+    return (name * 2654435769u) >> table->slot_shift;
+}
+
+static ScopeSlot* find_slot(const ScopeTable* table, uint32_t name) {
+    // Keys are never removed and the table stays at most half full, so a
+    // probe ends at the name or at an empty slot
+    for (uint32_t i = scope_slot(table, name);; i = (i + 1) & table->slot_mask) {
+        ScopeSlot* slot = &table->slots[i];
+        if (slot->name == name || slot->name == 0) {
+            return slot;
+        }
+    }
+}
+
+static bool grow_slots(ScopeTable* table) {
+    uint32_t count = (table->slot_mask + 1) * 2;
+    ScopeSlot* slots = calloc(count, sizeof(ScopeSlot));
+    if (!slots) {
+        return false;
+    }
+    ScopeSlot* old = table->slots;
+    uint32_t old_count = table->slot_mask + 1;
+    table->slots = slots;
+    table->slot_mask = count - 1;
+    table->slot_shift--;
+    for (uint32_t i = 0; i < old_count; i++) {
+        if (old[i].name != 0) {
+            *find_slot(table, old[i].name) = old[i];
+        }
+    }
+    free(old);
+    return true;
+}
+
+bool scope_table_init(ScopeTable* table) {
+    memset(table, 0, sizeof(ScopeTable));
+    table->slots = calloc(SCOPE_INITIAL_SLOTS, sizeof(ScopeSlot));
+    table->slot_mask = SCOPE_INITIAL_SLOTS - 1;
+    table->slot_shift = 32 - 8;
+    table->symbols = malloc(sizeof(ScopedSymbol) * SCOPE_INITIAL_SYMBOLS);
+    table->symbol_capacity = SCOPE_INITIAL_SYMBOLS;
+    table->used = calloc(SCOPE_INITIAL_SYMBOLS / 64, sizeof(uint64_t));
+    table->scope_first = malloc(sizeof(int) * SCOPE_INITIAL_DEPTH);
+    table->scope_capacity = SCOPE_INITIAL_DEPTH;
+    if (!table->slots || !table->symbols || !table->used || !table->scope_first) {
+        scope_table_free(table);
+        return false;
+    }
+    table->scope_first[0] = 0;
+    return true;
+}
+
+void scope_table_free(ScopeTable* table) {
+    free(table->slots);
+    free(table->symbols);
+    free(table->used);
+    free(table->scope_first);
+    memset(table, 0, sizeof(ScopeTable));
+}
+
+bool scope_push(ScopeTable* table) {
+    if (table->depth + 1 >= table->scope_capacity) {
+        int capacity = table->scope_capacity * 2;
+        int* grown = realloc(table->scope_first, sizeof(int) * capacity);
+        if (!grown) {
+            return false;
+        }
+        table->scope_first = grown;
+        table->scope_capacity = capacity;
+    }
+    table->scope_first[++table->depth] = table->symbol_count;
+    return true;
+}
+
+void scope_pop(ScopeTable* table) {
+    if (table->depth == 0) {
+        return;
+    }
+    // Undo newest first, so a name declared twice on the way in (in nested
+    // scopes that are both closing) ends up at its oldest shadowed binding
+    int first = table->scope_first[table->depth--];
+    for (int i = table->symbol_count - 1; i >= first; i--) {
+        const ScopedSymbol* symbol = &table->symbols[i];
+        find_slot(table, symbol->name)->binding = symbol->shadowed;
+    }
+    table->symbol_count = first;
+}
+
+static bool grow_symbols(ScopeTable* table) {
+    int capacity = table->symbol_capacity * 2;
+    ScopedSymbol* symbols = realloc(table->symbols, sizeof(ScopedSymbol) * capacity);
+    if (!symbols) {
+        return false;
+    }
+    table->symbols = symbols;
+    uint64_t* used = realloc(table->used, sizeof(uint64_t) * (capacity / 64));
+    if (!used) {
+        return false;
+    }
+    memset(used + table->symbol_capacity / 64, 0, sizeof(uint64_t) * ((capacity - table->symbol_capacity) / 64));
+    table->used = used;
+    table->symbol_capacity = capacity;
+    return true;
+}
+
+int scope_define(ScopeTable* table, uint32_t name, int kind, int value, int line) {
+    ScopeSlot* slot = find_slot(table, name);
+    if (slot->name == 0) {
+        if ((table->keys + 1) * 2 > table->slot_mask + 1) {
+            if (!grow_slots(table)) {
+                return SCOPE_NO_MEMORY;
+            }
+            slot = find_slot(table, name);
+        }
+        slot->name = name;
+        table->keys++;
+    } else if (slot->binding != 0 && table->symbols[slot->binding - 1].depth == table->depth) {
+        return SCOPE_REDEFINED;
+    }
+
+    if (table->symbol_count == table->symbol_capacity && !grow_symbols(table)) {
+        return SCOPE_NO_MEMORY;
+    }
+    int index = table->symbol_count++;
+    ScopedSymbol* symbol = &table->symbols[index];
+    symbol->name = name;
+    symbol->shadowed = slot->binding;
+    symbol->kind = kind;
+    symbol->value = value;
+    symbol->line = line;
+    symbol->depth = table->depth;
+    // The slot may have held a popped declaration's use
+    table->used[index / 64] &= ~(1ULL << (index % 64));
+    slot->binding = (uint32_t)index + 1;
+    return index;
+}
+
+int scope_lookup(const ScopeTable* table, uint32_t name) {
+    const ScopeSlot* slot = find_slot(table, name);
+    return slot->binding != 0 ? (int)slot->binding - 1 : SCOPE_NOT_FOUND;
+}
+
+int scope_use(ScopeTable* table, uint32_t name) {
+    int index = scope_lookup(table, name);
+    if (index >= 0) {
+        table->used[index / 64] |= 1ULL << (index % 64);
+    }
+    return index;
+}
+
+void scope_mark_used(ScopeTable* table, int index) {
+    if (index >= 0 && index < table->symbol_count) {
+        table->used[index / 64] |= 1ULL << (index % 64);
+    }
+}
+
+bool scope_defined_here(const ScopeTable* table, uint32_t name) {
+    int index = scope_lookup(table, name);
+    return index >= 0 && table->symbols[index].depth == table->depth;
+}
+
+const ScopedSymbol* scope_symbol(const ScopeTable* table, int index) {
+    return index >= 0 && index < table->symbol_count ? &table->symbols[index] : NULL;
+}
+
+static int lowest_bit(uint64_t bits) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    int bit = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+int scope_unused(const ScopeTable* table, uint32_t* names, int max) {
+    int first = table->scope_first[table->depth];
+    int end = table->symbol_count;
+    int count = 0;
+    for (int word = first / 64; word * 64 < end; word++) {
+        uint64_t unused = ~table->used[word];
+        if (word == first / 64) {
+            unused &= ~0ULL << (first % 64);
+        }
+        if ((word + 1) * 64 > end) {
+            unused &= (1ULL << (end % 64)) - 1;
+        }
+        while (unused) {
+            int index = word * 64 + lowest_bit(unused);
+            unused &= unused - 1;
+            if (count < max) {
+                names[count] = table->symbols[index].name;
+            }
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,84 @@
+// OMEGA Bootstrap - Scoped Symbol Table
+// Purpose: Resolve names across nested scopes in constant time for the native front end
+// Platform: Windows, Linux, macOS (standard C99)
+// Names are intern IDs (omega_intern.h), so no string is compared. One
+// open-addressing table maps every name to its innermost visible
+// declaration. Declarations form a stack, and each one remembers the
+// binding it shadowed; that stack is the undo log. scope_push records where
+// the scope starts, and scope_pop restores the shadowed bindings of just
+// the declarations made since. Scopes cost O(declarations) to leave and
+// nothing to enter. A lookup is a single probe sequence, however deep the
+// nesting. This replaces the scope walk with string_equal in
+// lookup_symbol (src/semantic/symbol_table.mega).
+// Use is tracked in a bitset indexed like the declaration stack, so the
+// unused declarations of a scope are found a machine word at a time.
+// omega_minimal resolves the cross-module references of --whole-program
+// through it and reports unused imports from the bitset.
+
+#ifndef OMEGA_SCOPE_H
+#define OMEGA_SCOPE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCOPE_NOT_FOUND (-1)
+#define SCOPE_REDEFINED (-2)     // already declared in the current scope
+#define SCOPE_NO_MEMORY (-3)
+
+typedef struct {
+    uint32_t name;              // intern ID
+    uint32_t shadowed;          // declaration hidden by this one, + 1; 0 if none
+    int kind;                   // caller-defined, e.g. SymbolType
+    int value;                  // caller-defined, e.g. an index into its own records
+    int line;
+    int depth;                  // scope depth it was declared at
+} ScopedSymbol;
+
+typedef struct {
+    uint32_t name;              // 0 = empty; keys stay once inserted
+    uint32_t binding;           // visible declaration + 1; 0 if none
+} ScopeSlot;
+
+typedef struct {
+    ScopeSlot* slots;
+    uint32_t slot_mask;
+    uint32_t slot_shift;        // 32 - log2(slot count), for Fibonacci hashing
+    uint32_t keys;              // occupied slots
+    ScopedSymbol* symbols;      // declaration stack; also the undo log
+    int symbol_count;
+    int symbol_capacity;
+    uint64_t* used;             // bit per declaration
+    int* scope_first;           // first declaration of each open scope
+    int depth;                  // 0 is the global scope
+    int scope_capacity;
+} ScopeTable;
+
+bool scope_table_init(ScopeTable* table);
+void scope_table_free(ScopeTable* table);
+
+bool scope_push(ScopeTable* table);
+// Leave the current scope; the global scope is never popped.
+void scope_pop(ScopeTable* table);
+
+// Declare `name` in the current scope. Returns the declaration's index, or
+// SCOPE_REDEFINED (the existing one stays visible) or SCOPE_NO_MEMORY.
+int scope_define(ScopeTable* table, uint32_t name, int kind, int value, int line);
+
+// Innermost visible declaration of `name`, or SCOPE_NOT_FOUND.
+int scope_lookup(const ScopeTable* table, uint32_t name);
+
+// Look up `name` and mark the declaration found as used.
+int scope_use(ScopeTable* table, uint32_t name);
+
+// Mark declaration `index` as used, e.g. one reached through `shadowed`.
+void scope_mark_used(ScopeTable* table, int index);
+
+bool scope_defined_here(const ScopeTable* table, uint32_t name);
+
+const ScopedSymbol* scope_symbol(const ScopeTable* table, int index);
+
+// Names of unused declarations in the current scope, in declaration order;
+// returns how many there are (at most `max` are written).
+int scope_unused(const ScopeTable* table, uint32_t* names, int max);
+
+#endif // OMEGA_SCOPE_H
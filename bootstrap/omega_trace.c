@@ -0,0 +1,263 @@
+// OMEGA Bootstrap - Trace Events
+// Span stack, clock alignment with the parent process, and JSON output.
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "omega_trace.h"
+
+#ifdef OMEGA_TRACE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#define TRACE_PATH_MAX 4096
+
+typedef struct {
+    const char* name;
+    const char* detail;
+    double start;       // monotonic microseconds
+    bool is_phase;
+} TraceSpan;
+
+static struct {
+    bool enabled;
+    bool truncated;         // out of memory; later events are dropped
+    char path[TRACE_PATH_MAX];
+    uint64_t trace_id;
+    long parent_pid;        // 0 for the first process
+    long pid;
+    double epoch;           // wall-clock microseconds at the first process's start
+    double offset;          // wall clock minus monotonic clock, in microseconds
+    TraceSpan spans[TRACE_MAX_DEPTH];
+    int depth;              // may exceed TRACE_MAX_DEPTH; deeper spans are dropped
+    char* buffer;
+    size_t length;
+    size_t capacity;
+} trace;
+
+static double monotonic_us(void) {
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart * 1e6 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e6 + (double)now.tv_nsec / 1e3;
+#endif
+}
+
+static double wall_us(void) {
+#ifdef _WIN32
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    ULARGE_INTEGER ticks;
+    ticks.LowPart = ft.dwLowDateTime;
+    ticks.HighPart = ft.dwHighDateTime;
+    return (double)(ticks.QuadPart - 116444736000000000ULL) / 10.0;   // 100 ns since 1601
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (double)now.tv_sec * 1e6 + (double)now.tv_nsec / 1e3;
+#endif
+}
+
+// Microseconds on the shared timeline
+static double timeline_us(double monotonic) {
+    return monotonic + trace.offset - trace.epoch;
+}
+
+static void append(const char* text, size_t length) {
+    if (trace.truncated) return;
+    if (trace.length + length > trace.capacity) {
+        size_t capacity = trace.capacity ? trace.capacity * 2 : 16384;
+        while (capacity < trace.length + length) capacity *= 2;
+        char* grown = realloc(trace.buffer, capacity);
+        if (!grown) {
+            // Keep what fits; a truncated trace beats none
+            trace.truncated = true;
+            return;
+        }
+        trace.buffer = grown;
+        trace.capacity = capacity;
+    }
+    memcpy(trace.buffer + trace.length, text, length);
+    trace.length += length;
+}
+
+static void append_text(const char* text) {
+    append(text, strlen(text));
+}
+
+static void append_json_string(const char* text) {
+    append("\"", 1);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        char escaped[8];
+        if (*c == '"' || *c == '\\') {
+            escaped[0] = '\\';
+            escaped[1] = (char)*c;
+            append(escaped, 2);
+        } else if (*c < 0x20) {
+            snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+            append(escaped, 6);
+        } else {
+            append((const char*)c, 1);
+        }
+    }
+    append("\"", 1);
+}
+
+static void emit_span(const TraceSpan* span, double end) {
+    char fields[160];
+    snprintf(fields, sizeof(fields), "{\"ph\":\"X\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+             trace.pid, trace.pid, timeline_us(span->start), end - span->start);
+    append_text(fields);
+    append_json_string(span->name);
+    append_text(span->is_phase ? ",\"cat\":\"phase\"" : ",\"cat\":\"compiler\"");
+    if (span->detail) {
+        append_text(",\"args\":{\"detail\":");
+        append_json_string(span->detail);
+        append_text("}");
+    }
+    append_text("},\n");
+}
+
+static void emit_process_name(const char* process) {
+    char fields[160];
+    snprintf(fields, sizeof(fields), "{\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,\"name\":\"process_name\",\"args\":{\"name\":",
+             trace.pid, trace.pid);
+    append_text(fields);
+    append_json_string(process);
+    snprintf(fields, sizeof(fields), ",\"trace_id\":\"%016llx\",\"parent_pid\":%ld}},\n",
+             (unsigned long long)trace.trace_id, trace.parent_pid);
+    append_text(fields);
+}
+
+static void export_context(void) {
+    char context[96];
+    snprintf(context, sizeof(context), "%016llx;%.0f;%ld",
+             (unsigned long long)trace.trace_id, trace.epoch, trace.pid);
+#ifdef _WIN32
+    _putenv_s("OMEGA_TRACE_CONTEXT", context);
+#else
+    setenv("OMEGA_TRACE_CONTEXT", context, 1);
+#endif
+}
+
+void trace_open(const char* process) {
+    const char* path = getenv("OMEGA_TRACE_FILE");
+    if (trace.enabled || !path || !path[0] || strlen(path) >= TRACE_PATH_MAX) return;
+    memcpy(trace.path, path, strlen(path) + 1);
+    trace.pid = (long)getpid();
+    double monotonic = monotonic_us();
+    double wall = wall_us();
+    trace.offset = wall - monotonic;
+
+    unsigned long long id = 0;
+    double epoch = 0;
+    long parent = 0;
+    const char* context = getenv("OMEGA_TRACE_CONTEXT");
+    if (context && sscanf(context, "%16llx;%lf;%ld", &id, &epoch, &parent) == 3 && epoch > 0) {
+        trace.trace_id = id;
+        trace.epoch = epoch;
+        trace.parent_pid = parent;
+    } else {
+        // First process: a new trace and a fresh file
+        trace.trace_id = ((uint64_t)wall * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)trace.pid << 32);
+        trace.epoch = wall;
+        trace.parent_pid = 0;
+        FILE* file = fopen(trace.path, "wb");
+        if (!file) {
+            fprintf(stderr, "⚠️  Warning: Cannot create trace file '%s'\n", trace.path);
+            return;
+        }
+        fputs("[\n", file);
+        fclose(file);
+        export_context();
+    }
+    trace.enabled = true;
+    trace.truncated = false;
+    trace.depth = 0;
+    emit_process_name(process);
+}
+
+void trace_begin(const char* name, const char* detail) {
+    if (!trace.enabled) return;
+    if (trace.depth < TRACE_MAX_DEPTH) {
+        TraceSpan* span = &trace.spans[trace.depth];
+        span->name = name;
+        span->detail = detail;
+        span->is_phase = false;
+        span->start = monotonic_us();
+    }
+    trace.depth++;
+}
+
+void trace_phase(const char* name) {
+    if (!trace.enabled) return;
+    double now = monotonic_us();
+    if (trace.depth > 0 && trace.depth <= TRACE_MAX_DEPTH && trace.spans[trace.depth - 1].is_phase) {
+        emit_span(&trace.spans[trace.depth - 1], now);
+        trace.depth--;
+    }
+    if (trace.depth < TRACE_MAX_DEPTH) {
+        TraceSpan* span = &trace.spans[trace.depth];
+        span->name = name;
+        span->detail = NULL;
+        span->is_phase = true;
+        span->start = now;
+    }
+    trace.depth++;
+}
+
+void trace_end(void) {
+    if (!trace.enabled || trace.depth == 0) return;
+    double now = monotonic_us();
+    // A phase still open belongs to the span being closed
+    if (trace.depth <= TRACE_MAX_DEPTH && trace.spans[trace.depth - 1].is_phase) {
+        emit_span(&trace.spans[trace.depth - 1], now);
+        trace.depth--;
+        if (trace.depth == 0) return;
+    }
+    if (trace.depth <= TRACE_MAX_DEPTH) {
+        emit_span(&trace.spans[trace.depth - 1], now);
+    }
+    trace.depth--;
+}
+
+void trace_close(void) {
+    if (!trace.enabled) return;
+    while (trace.depth > 0) {
+        trace_end();
+    }
+    // Appends are whole writes, so concurrent processes do not interleave
+    FILE* file = fopen(trace.path, "ab");
+    if (file) {
+        setvbuf(file, NULL, _IONBF, 0);
+        fwrite(trace.buffer, 1, trace.length, file);
+        fclose(file);
+    } else {
+        fprintf(stderr, "⚠️  Warning: Cannot append to trace file '%s'\n", trace.path);
+    }
+    free(trace.buffer);
+    trace.buffer = NULL;
+    trace.length = trace.capacity = 0;
+    trace.enabled = false;
+}
+
+#endif // OMEGA_TRACE
@@ -0,0 +1,62 @@
+// OMEGA Bootstrap - Trace Events
+// Purpose: Put the compiler's phases on one timeline with the process that spawned it
+// Platform: Windows, Linux, macOS (C99)
+// Built only with -DOMEGA_TRACE (OMEGA_TRACE=1 bash build_bootstrap.sh); otherwise
+// every TRACE_* macro expands to nothing. At run time OMEGA_TRACE_FILE names
+// the output, in Chrome trace-event JSON array form (chrome://tracing,
+// ui.perfetto.dev): complete ("X") events, one per line, and no closing
+// bracket, which the format allows, so that several processes can append to
+// one file.
+//
+// The first traced process truncates the file and exports
+//   OMEGA_TRACE_CONTEXT=<trace id, 16 hex digits>;<epoch>;<pid>
+// where epoch is its start in wall-clock microseconds. Children inherit it,
+// tag their events with the same trace id, and place them on the parent's
+// timeline: each measures the offset between its monotonic clock and the
+// wall clock once, at trace_open, and reports monotonic time plus that
+// offset, minus the epoch. Spans are timed on the monotonic clock, so a wall
+// clock step during a run skews only the placement of later processes.
+//
+// Only the main thread is traced. Events are buffered and appended with one
+// write at trace_close.
+
+#ifndef OMEGA_TRACE_H
+#define OMEGA_TRACE_H
+
+#define TRACE_MAX_DEPTH 32
+
+#ifdef OMEGA_TRACE
+
+// Start tracing if OMEGA_TRACE_FILE is set; `process` names this process's
+// track.
+void trace_open(const char* process);
+
+// Open a span; `detail` (may be NULL) is shown as its argument.
+void trace_begin(const char* name, const char* detail);
+
+// End the phase opened by the previous trace_phase at this level, if any,
+// and open the next. The enclosing trace_end closes the last one.
+void trace_phase(const char* name);
+
+void trace_end(void);
+
+// Close any open spans and append the buffered events to the file.
+void trace_close(void);
+
+#define TRACE_OPEN(process) trace_open(process)
+#define TRACE_BEGIN(name, detail) trace_begin(name, detail)
+#define TRACE_PHASE(name) trace_phase(name)
+#define TRACE_END() trace_end()
+#define TRACE_CLOSE() trace_close()
+
+#else
+
+#define TRACE_OPEN(process) ((void)0)
+#define TRACE_BEGIN(name, detail) ((void)0)
+#define TRACE_PHASE(name) ((void)0)
+#define TRACE_END() ((void)0)
+#define TRACE_CLOSE() ((void)0)
+
+#endif // OMEGA_TRACE
+
+#endif // OMEGA_TRACE_H
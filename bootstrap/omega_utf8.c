@@ -0,0 +1,173 @@
+// OMEGA Bootstrap - UTF-8 Validation
+// ASCII runs are skipped with AVX2 (runtime-selected), SSE2, or 8-byte words
+// depending on the target. Multi-byte sequences are checked against the
+// well-formed byte ranges of Unicode Table 3-7 (no overlongs, no surrogates,
+// nothing above U+10FFFF).
+
+#include "omega_utf8.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define OMEGA_UTF8_SSE2 1
+#include <emmintrin.h>
+#if !defined(OMEGA_NO_AVX2)
+#define OMEGA_UTF8_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+// Offset of the first non-ASCII byte in data[0, length), or length.
+static size_t ascii_run_scalar(const uint8_t* data, size_t length) {
+    size_t i = 0;
+
+    while (i + 8 <= length) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+        i += 8;
+    }
+
+    while (i < length && data[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+#ifdef OMEGA_UTF8_SSE2
+static size_t ascii_run_sse2(const uint8_t* data, size_t length) {
+    size_t i = 0;
+
+    while (i + 64 <= length) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(data + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i*)(data + i + 48));
+        __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (_mm_movemask_epi8(any) != 0) {
+            break;
+        }
+        i += 64;
+    }
+
+    while (i + 16 <= length) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(data + i)));
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+        }
+        i += 16;
+    }
+
+    return i + ascii_run_scalar(data + i, length - i);
+}
+#endif
+
+#ifdef OMEGA_UTF8_AVX2
+__attribute__((target("avx2")))
+static size_t ascii_run_avx2(const uint8_t* data, size_t length) {
+    size_t i = 0;
+
+    while (i + 64 <= length) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + 32));
+        if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0) {
+            break;
+        }
+        i += 64;
+    }
+
+    while (i + 32 <= length) {
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(data + i)));
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+        i += 32;
+    }
+
+    return i + ascii_run_scalar(data + i, length - i);
+}
+#endif
+
+typedef size_t (*AsciiRunFn)(const uint8_t*, size_t);
+
+static AsciiRunFn select_ascii_run(void) {
+#ifdef OMEGA_UTF8_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return ascii_run_avx2;
+    }
+#endif
+#ifdef OMEGA_UTF8_SSE2
+    return ascii_run_sse2;
+#else
+    return ascii_run_scalar;
+#endif
+}
+
+// Length of the well-formed sequence starting at data[0], or 0 if invalid.
+static size_t utf8_sequence_length(const uint8_t* data, size_t remaining) {
+    uint8_t lead = data[0];
+    size_t length;
+    uint8_t low = 0x80;
+    uint8_t high = 0xBF;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) low = 0xA0;      // overlong
+        if (lead == 0xED) high = 0x9F;     // surrogates
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) low = 0x90;      // overlong
+        if (lead == 0xF4) high = 0x8F;     // above U+10FFFF
+    } else {
+        return 0;
+    }
+
+    if (remaining < length) {
+        return 0;
+    }
+    if (data[1] < low || data[1] > high) {
+        return 0;
+    }
+    for (size_t i = 2; i < length; i++) {
+        if (data[i] < 0x80 || data[i] > 0xBF) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+Utf8Result utf8_validate(const uint8_t* data, size_t length) {
+    static AsciiRunFn ascii_run = NULL;
+    if (!ascii_run) {
+        ascii_run = select_ascii_run();
+    }
+
+    Utf8Result result;
+    result.valid = true;
+    result.ascii = true;
+    result.error_offset = 0;
+
+    size_t i = 0;
+    while (i < length) {
+        i += ascii_run(data + i, length - i);
+        if (i >= length) {
+            break;
+        }
+
+        result.ascii = false;
+        size_t sequence = utf8_sequence_length(data + i, length - i);
+        if (sequence == 0) {
+            result.valid = false;
+            result.error_offset = i;
+            return result;
+        }
+        i += sequence;
+    }
+
+    return result;
+}
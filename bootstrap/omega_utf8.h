@@ -0,0 +1,22 @@
+// OMEGA Bootstrap - UTF-8 Validation
+// Purpose: Validate source files as UTF-8 before lexing
+// Platform: Windows, Linux, macOS (standard C99, SSE2/AVX2 on x86-64)
+// Pure-ASCII blocks are skipped 32-64 bytes at a time; only blocks that
+// contain non-ASCII bytes go through the scalar validator.
+
+#ifndef OMEGA_UTF8_H
+#define OMEGA_UTF8_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    bool valid;
+    bool ascii;            // true when every byte is < 0x80
+    size_t error_offset;   // first byte of the invalid sequence (if !valid)
+} Utf8Result;
+
+Utf8Result utf8_validate(const uint8_t* data, size_t length);
+
+#endif // OMEGA_UTF8_H
@@ -0,0 +1,333 @@
+// OMEGA Bootstrap - File Watcher
+// Recursive inotify watches; new subdirectories are picked up as they appear.
+// Each walk is a numbered pass: a directory is descended once per pass, so a
+// rescan reaches directories missed under existing watches, and symbolic
+// link cycles end where inotify hands back a descriptor already walked.
+
+#if defined(__linux__)
+#define _XOPEN_SOURCE 700
+#endif
+
+#include "omega_watch.h"
+#include "omega_modules.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE)
+
+bool watcher_supported(void) {
+    return true;
+}
+
+static char* copy_string(const char* text) {
+    size_t length = strlen(text);
+    char* copy = malloc(length + 1);
+    if (copy) {
+        memcpy(copy, text, length + 1);
+    }
+    return copy;
+}
+
+static void watcher_record(Watcher* watcher, const char* path) {
+    for (int i = 0; i < watcher->changed_count; i++) {
+        if (strcmp(watcher->changed[i], path) == 0) {
+            return;
+        }
+    }
+
+    if (watcher->changed_count == watcher->changed_capacity) {
+        int capacity = watcher->changed_capacity ? watcher->changed_capacity * 2 : 32;
+        char** changed = realloc(watcher->changed, sizeof(char*) * capacity);
+        if (!changed) return;
+        watcher->changed = changed;
+        watcher->changed_capacity = capacity;
+    }
+    watcher->changed[watcher->changed_count++] = copy_string(path);
+}
+
+// Watch `path` and every directory below it; with `record_sources`, the
+// sources found on the way count as changed.
+static void watcher_add_directory(Watcher* watcher, const char* path, bool record_sources) {
+    int descriptor = inotify_add_watch(watcher->fd, path, WATCH_EVENTS);
+    if (descriptor < 0) {
+        fprintf(stderr, "⚠️  Cannot watch '%s': %s\n", path, strerror(errno));
+        return;
+    }
+
+    for (int i = 0; i < watcher->watch_count; i++) {
+        if (watcher->descriptors[i] == descriptor) {
+            if (watcher->walked[i] == watcher->pass) {
+                return; // already walked in this pass
+            }
+            watcher->walked[i] = watcher->pass;
+            descriptor = -1;
+            break;
+        }
+    }
+
+    if (descriptor >= 0) {
+        if (watcher->watch_count == watcher->watch_capacity) {
+            int capacity = watcher->watch_capacity ? watcher->watch_capacity * 2 : 64;
+            int* descriptors = realloc(watcher->descriptors, sizeof(int) * capacity);
+            if (!descriptors) return;
+            watcher->descriptors = descriptors;
+            char** directories = realloc(watcher->directories, sizeof(char*) * capacity);
+            if (!directories) return;
+            watcher->directories = directories;
+            int* walked = realloc(watcher->walked, sizeof(int) * capacity);
+            if (!walked) return;
+            watcher->walked = walked;
+            watcher->watch_capacity = capacity;
+        }
+
+        watcher->descriptors[watcher->watch_count] = descriptor;
+        watcher->directories[watcher->watch_count] = copy_string(path);
+        watcher->walked[watcher->watch_count] = watcher->pass;
+        watcher->watch_count++;
+    }
+
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return;
+    }
+
+    struct dirent* entry;
+    char child[MODULE_PATH_MAX];
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.' || strcmp(entry->d_name, "node_modules") == 0) {
+            continue;
+        }
+        int written = snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        if (written < 0 || (size_t)written >= sizeof(child)) {
+            continue;
+        }
+        struct stat info;
+        if (stat(child, &info) != 0) {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode)) {
+            watcher_add_directory(watcher, child, record_sources);
+        } else if (record_sources && S_ISREG(info.st_mode) && is_source_file(child)) {
+            watcher_record(watcher, child);
+        }
+    }
+    closedir(dir);
+}
+
+// Start a pass over `path`.
+static void watcher_walk(Watcher* watcher, const char* path, bool record_sources) {
+    watcher->pass++;
+    watcher_add_directory(watcher, path, record_sources);
+}
+
+Watcher* watcher_open(const char* root) {
+    Watcher* watcher = calloc(1, sizeof(Watcher));
+    if (!watcher) {
+        return NULL;
+    }
+
+    watcher->fd = inotify_init1(IN_CLOEXEC);
+    if (watcher->fd < 0) {
+        fprintf(stderr, "❌ Error: inotify_init1 failed: %s\n", strerror(errno));
+        free(watcher);
+        return NULL;
+    }
+
+    watcher->root = copy_string(root);
+    if (!watcher->root) {
+        close(watcher->fd);
+        free(watcher);
+        return NULL;
+    }
+    watcher_walk(watcher, root, false);
+    return watcher;
+}
+
+static void watcher_clear_changed(Watcher* watcher) {
+    for (int i = 0; i < watcher->changed_count; i++) {
+        free(watcher->changed[i]);
+    }
+    watcher->changed_count = 0;
+}
+
+void watcher_close(Watcher* watcher) {
+    if (!watcher) {
+        return;
+    }
+    watcher_clear_changed(watcher);
+    for (int i = 0; i < watcher->watch_count; i++) {
+        free(watcher->directories[i]);
+    }
+    free(watcher->descriptors);
+    free(watcher->directories);
+    free(watcher->walked);
+    free(watcher->root);
+    free(watcher->changed);
+    close(watcher->fd);
+    free(watcher);
+}
+
+static const char* watcher_directory(const Watcher* watcher, int descriptor) {
+    for (int i = 0; i < watcher->watch_count; i++) {
+        if (watcher->descriptors[i] == descriptor) {
+            return watcher->directories[i];
+        }
+    }
+    return NULL;
+}
+
+// Drain pending events; returns the number of events read, -1 on error.
+static int watcher_drain(Watcher* watcher) {
+    union {
+        struct inotify_event event;
+        char bytes[16 * 1024];
+    } buffer;
+
+    ssize_t length = read(watcher->fd, buffer.bytes, sizeof(buffer.bytes));
+    if (length < 0) {
+        return errno == EINTR || errno == EAGAIN ? 0 : -1;
+    }
+
+    int events = 0;
+    char path[MODULE_PATH_MAX];
+    for (char* p = buffer.bytes; p < buffer.bytes + length;) {
+        struct inotify_event* event = (struct inotify_event*)p;
+        p += sizeof(struct inotify_event) + event->len;
+        events++;
+
+        // Lost events: pick up directories created meanwhile; the caller
+        // rebuilds every source
+        if (event->mask & IN_Q_OVERFLOW) {
+            watcher->overflowed = true;
+            watcher_walk(watcher, watcher->root, false);
+            continue;
+        }
+
+        const char* directory = watcher_directory(watcher, event->wd);
+        if (!directory || event->len == 0 || event->name[0] == '.') {
+            continue;
+        }
+
+        int written = snprintf(path, sizeof(path), "%s/%s", directory, event->name);
+        if (written < 0 || (size_t)written >= sizeof(path)) {
+            continue;
+        }
+
+        if (event->mask & IN_ISDIR) {
+            // Files may already be inside: moved in whole, or written before
+            // the watch was added
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                watcher_walk(watcher, path, true);
+            }
+            continue;
+        }
+
+        // A bare IN_CREATE is followed by IN_CLOSE_WRITE once the file is saved
+        if ((event->mask & IN_CREATE) && !(event->mask & ~IN_CREATE)) {
+            continue;
+        }
+
+        if (is_source_file(path)) {
+            watcher_record(watcher, path);
+        }
+    }
+
+    return events;
+}
+
+static long monotonic_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+int watcher_wait(Watcher* watcher, int quiet_ms, int max_batch_ms) {
+    watcher_clear_changed(watcher);
+    watcher->overflowed = false;
+    struct pollfd pfd;
+    pfd.fd = watcher->fd;
+    pfd.events = POLLIN;
+
+    // Wait for the first relevant change
+    while (watcher->changed_count == 0 && !watcher->overflowed) {
+        int ready = poll(&pfd, 1, -1);
+        if (ready < 0 && errno != EINTR) {
+            return -1;
+        }
+        if (ready > 0 && watcher_drain(watcher) < 0) {
+            return -1;
+        }
+    }
+
+    // Coalesce the rest of the burst
+    long started = monotonic_ms();
+    while (monotonic_ms() - started < max_batch_ms) {
+        int ready = poll(&pfd, 1, quiet_ms);
+        if (ready == 0) {
+            break;
+        }
+        if (ready < 0 && errno != EINTR) {
+            return -1;
+        }
+        if (ready > 0 && watcher_drain(watcher) < 0) {
+            return -1;
+        }
+    }
+
+    return watcher->changed_count;
+}
+
+const char* watcher_changed_path(const Watcher* watcher, int index) {
+    return watcher->changed[index];
+}
+
+bool watcher_overflowed(const Watcher* watcher) {
+    return watcher->overflowed;
+}
+
+#else // !__linux__
+
+bool watcher_supported(void) {
+    return false;
+}
+
+Watcher* watcher_open(const char* root) {
+    (void)root;
+    return NULL;
+}
+
+void watcher_close(Watcher* watcher) {
+    free(watcher);
+}
+
+int watcher_wait(Watcher* watcher, int quiet_ms, int max_batch_ms) {
+    (void)watcher;
+    (void)quiet_ms;
+    (void)max_batch_ms;
+    return -1;
+}
+
+const char* watcher_changed_path(const Watcher* watcher, int index) {
+    (void)watcher;
+    (void)index;
+    return NULL;
+}
+
+bool watcher_overflowed(const Watcher* watcher) {
+    (void)watcher;
+    return false;
+}
+
+#endif
@@ -0,0 +1,46 @@
+// OMEGA Bootstrap - File Watcher
+// Purpose: Report changed .omega/.mega files under a directory tree
+// Platform: Linux (inotify); other platforms report watch mode unsupported
+// Bursts of events (editor save sequences, git checkouts) are coalesced into
+// one batch: after the first event the watcher keeps reading until the tree
+// has been quiet for `quiet_ms`. If the kernel's event queue overflows the
+// batch is incomplete; the watcher rewalks the tree for new directories and
+// reports the overflow so the caller can rebuild everything.
+
+#ifndef OMEGA_WATCH_H
+#define OMEGA_WATCH_H
+
+#include <stdbool.h>
+
+typedef struct {
+    int fd;
+    char* root;
+    int* descriptors;        // inotify watch descriptors
+    char** directories;      // directory path per descriptor slot
+    int* walked;             // pass that last walked each directory
+    int watch_count;
+    int watch_capacity;
+    int pass;
+    char** changed;          // changed source paths of the last batch
+    int changed_count;
+    int changed_capacity;
+    bool overflowed;         // events were lost during the last batch
+} Watcher;
+
+bool watcher_supported(void);
+
+Watcher* watcher_open(const char* root);
+void watcher_close(Watcher* watcher);
+
+// Block until source files change, coalesce the burst, and return the
+// number of distinct changed paths (-1 on error). Sources already inside a
+// directory that is created or moved into the tree count as changed. Paths
+// stay valid until the next call.
+int watcher_wait(Watcher* watcher, int quiet_ms, int max_batch_ms);
+const char* watcher_changed_path(const Watcher* watcher, int index);
+
+// True if the last batch lost events to a queue overflow; its changed paths
+// are then incomplete (possibly empty) and every source should be rebuilt.
+bool watcher_overflowed(const Watcher* watcher);
+
+#endif // OMEGA_WATCH_H
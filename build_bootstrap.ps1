@@ -15,6 +15,35 @@ $ErrorActionPreference = "Stop"
 $BootstrapDir = "bootstrap"
 $TargetDir = "target"
 $OmegaMinimal = "$BootstrapDir\omega_minimal.exe"
+$BootstrapSources = @(
+    "$BootstrapDir\omega_minimal.c",
+    "$BootstrapDir\omega_lexer.c",
+    "$BootstrapDir\omega_intern.c",
+    "$BootstrapDir\omega_keccak.c",
+    "$BootstrapDir\omega_utf8.c",
+    "$BootstrapDir\omega_modules.c",
+    "$BootstrapDir\omega_watch.c",
+    "$BootstrapDir\omega_interface.c",
+    "$BootstrapDir\omega_hash.c",
+    "$BootstrapDir\omega_layout.c",
+    "$BootstrapDir\omega_peephole.c",
+    "$BootstrapDir\omega_callgraph.c",
+    "$BootstrapDir\omega_scope.c",
+    "$BootstrapDir\omega_pipeline.c",
+    "$BootstrapDir\omega_loader.c",
+    "$BootstrapDir\omega_parsecache.c",
+    "$BootstrapDir\omega_profile.c",
+    "$BootstrapDir\omega_trace.c",
+    "$BootstrapDir\omega_object.c",
+    "$BootstrapDir\omega_codegen.c"
+)
+$OmegaLink = "$BootstrapDir\omega_link.exe"
+$LinkerSources = @(
+    "$BootstrapDir\omega_link.c",
+    "$BootstrapDir\omega_object.c",
+    "$BootstrapDir\omega_interface.c",
+    "$BootstrapDir\omega_hash.c"
+)
 
 # Ensure directories exist
 New-Item -ItemType Directory -Path $TargetDir -Force | Out-Null
@@ -41,9 +70,21 @@ if ($Mode -eq "debug") {
 } else {
     $CFlags += " -O2"
 }
+# Key the parse cache to these exact sources, so a lexer or parser change
+# never reads entries written by an older build
+$SourceHashes = ($BootstrapSources + (Get-ChildItem "$BootstrapDir\*.h").FullName) | ForEach-Object {
+    (Get-FileHash $_ -Algorithm SHA256).Hash
+}
+$HashStream = [IO.MemoryStream]::new([Text.Encoding]::ASCII.GetBytes($SourceHashes -join ""))
+$FrontendHash = (Get-FileHash -InputStream $HashStream -Algorithm SHA256).Hash.Substring(0, 16).ToLower()
+$CFlags += " -DOMEGA_FRONTEND_HASH=$FrontendHash"
+# $env:OMEGA_TRACE=1 compiles in trace events (written when OMEGA_TRACE_FILE is set)
+if ($env:OMEGA_TRACE -and $env:OMEGA_TRACE -ne "0") {
+    $CFlags += " -DOMEGA_TRACE"
+}
 
 try {
-    gcc $CFlags.Split(" ") -o $OmegaMinimal "$BootstrapDir\omega_minimal.c" 2>&1 | ForEach-Object {
+    gcc $CFlags.Split(" ") -o $OmegaMinimal $BootstrapSources 2>&1 | ForEach-Object {
         if ($_ -match "error") {
             Write-Host "   ❌ $_" -ForegroundColor Red
         } elseif ($_ -match "warning") {
@@ -65,6 +106,13 @@ $BootstrapSize = (Get-Item $OmegaMinimal).Length
 Write-Host "✅ C Bootstrap built" -ForegroundColor Green
 Write-Host "   Size: $BootstrapSize bytes"
 Write-Host "   Location: $OmegaMinimal"
+
+Write-Host "   Compiling: bootstrap/omega_link.c → $OmegaLink"
+gcc $CFlags.Split(" ") -o $OmegaLink $LinkerSources
+if ($LASTEXITCODE -ne 0 -or -not (Test-Path $OmegaLink)) {
+    Write-Host "❌ Linker compilation failed" -ForegroundColor Red
+    exit 1
+}
 Write-Host ""
 
 # ============================================================================
@@ -114,13 +162,10 @@ Write-Host ""
 
 Write-Host "🔗 STAGE 3: Link Object Files" -ForegroundColor Yellow
 
-$ObjectFiles = @(
-    "$TargetDir\lexer.o",
-    "$TargetDir\parser.o",
-    "$TargetDir\semantic.o",
-    "$TargetDir\codegen.o",
-    "$TargetDir\optimizer.o"
-)
+# One object per stage 2 module, named the same way
+$ObjectFiles = $Modules | ForEach-Object {
+    "$TargetDir\" + [System.IO.Path]::GetFileNameWithoutExtension($_) + ".o"
+}
 
 # Check all object files exist
 foreach ($obj in $ObjectFiles) {
@@ -134,14 +179,10 @@ $OmegaInitial = "$TargetDir\omega.exe"
 
 Write-Host "   Linking: Object files → $OmegaInitial"
 
-# Link by concatenating object files
-$CombinedContent = @()
-foreach ($obj in $ObjectFiles) {
-    $CombinedContent += (Get-Content $obj -Encoding Byte)
-}
-[System.IO.File]::WriteAllBytes($OmegaInitial, $CombinedContent)
+# Resolves imports across modules and indexes every global symbol
+& $OmegaLink --output $OmegaInitial $ObjectFiles
 
-if (-not (Test-Path $OmegaInitial)) {
+if ($LASTEXITCODE -ne 0 -or -not (Test-Path $OmegaInitial)) {
     Write-Host "❌ Linking failed" -ForegroundColor Red
     exit 1
 }
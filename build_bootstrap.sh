@@ -17,6 +17,35 @@ NC='\033[0m' # No Color
 BOOTSTRAP_DIR="bootstrap"
 TARGET_DIR="target"
 OMEGA_MINIMAL="$BOOTSTRAP_DIR/omega_minimal"
+BOOTSTRAP_SOURCES=(
+    "$BOOTSTRAP_DIR/omega_minimal.c"
+    "$BOOTSTRAP_DIR/omega_lexer.c"
+    "$BOOTSTRAP_DIR/omega_intern.c"
+    "$BOOTSTRAP_DIR/omega_keccak.c"
+    "$BOOTSTRAP_DIR/omega_utf8.c"
+    "$BOOTSTRAP_DIR/omega_modules.c"
+    "$BOOTSTRAP_DIR/omega_watch.c"
+    "$BOOTSTRAP_DIR/omega_interface.c"
+    "$BOOTSTRAP_DIR/omega_hash.c"
+    "$BOOTSTRAP_DIR/omega_layout.c"
+    "$BOOTSTRAP_DIR/omega_peephole.c"
+    "$BOOTSTRAP_DIR/omega_callgraph.c"
+    "$BOOTSTRAP_DIR/omega_scope.c"
+    "$BOOTSTRAP_DIR/omega_pipeline.c"
+    "$BOOTSTRAP_DIR/omega_loader.c"
+    "$BOOTSTRAP_DIR/omega_parsecache.c"
+    "$BOOTSTRAP_DIR/omega_profile.c"
+    "$BOOTSTRAP_DIR/omega_trace.c"
+    "$BOOTSTRAP_DIR/omega_object.c"
+    "$BOOTSTRAP_DIR/omega_codegen.c"
+)
+OMEGA_LINK="$BOOTSTRAP_DIR/omega_link"
+LINKER_SOURCES=(
+    "$BOOTSTRAP_DIR/omega_link.c"
+    "$BOOTSTRAP_DIR/omega_object.c"
+    "$BOOTSTRAP_DIR/omega_interface.c"
+    "$BOOTSTRAP_DIR/omega_hash.c"
+)
 BUILD_MODE="${1:-release}"
 
 # Ensure directories exist
@@ -38,12 +67,29 @@ echo -e "${YELLOW}📦 STAGE 1: Build C Bootstrap Compiler${NC}"
 echo "   Compiling: bootstrap/omega_minimal.c → $OMEGA_MINIMAL"
 
 if [ "$BUILD_MODE" = "debug" ]; then
-    CFLAGS="-std=c99 -Wall -Wextra -g -O0"
+    CFLAGS="-std=c99 -Wall -Wextra -pthread -g -O0"
 else
-    CFLAGS="-std=c99 -Wall -Wextra -O2"
+    CFLAGS="-std=c99 -Wall -Wextra -pthread -O2"
+fi
+# Keep frame pointers so --profile can walk the stack
+CFLAGS="$CFLAGS -fno-omit-frame-pointer"
+# Key the parse cache to these exact sources, so a lexer or parser change
+# never reads entries written by an older build
+hash_sources() {
+    if command -v sha256sum >/dev/null 2>&1; then
+        cat "$@" | sha256sum
+    else
+        cat "$@" | shasum -a 256
+    fi | cut -c1-16
+}
+FRONTEND_HASH=$(hash_sources "${BOOTSTRAP_SOURCES[@]}" "$BOOTSTRAP_DIR"/*.h)
+CFLAGS="$CFLAGS -DOMEGA_FRONTEND_HASH=$FRONTEND_HASH"
+# OMEGA_TRACE=1 compiles in trace events (written when OMEGA_TRACE_FILE is set)
+if [ "${OMEGA_TRACE:-0}" != "0" ]; then
+    CFLAGS="$CFLAGS -DOMEGA_TRACE"
 fi
 
-gcc $CFLAGS -o "$OMEGA_MINIMAL" "$BOOTSTRAP_DIR/omega_minimal.c" 2>&1 | {
+gcc $CFLAGS -o "$OMEGA_MINIMAL" "${BOOTSTRAP_SOURCES[@]}" 2>&1 | {
     while IFS= read -r line; do
         if [[ $line == *"error"* ]]; then
             echo -e "${RED}   ❌ $line${NC}"
@@ -62,6 +108,12 @@ BOOTSTRAP_SIZE=$(stat -f%z "$OMEGA_MINIMAL" 2>/dev/null || stat -c%s "$OMEGA_MIN
 echo -e "${GREEN}✅ C Bootstrap built${NC}"
 echo "   Size: ${BOOTSTRAP_SIZE} bytes"
 echo "   Location: $OMEGA_MINIMAL"
+
+echo "   Compiling: bootstrap/omega_link.c → $OMEGA_LINK"
+if ! gcc $CFLAGS -o "$OMEGA_LINK" "${LINKER_SOURCES[@]}"; then
+    echo -e "${RED}❌ Linker compilation failed${NC}"
+    exit 1
+fi
 echo ""
 
 # ============================================================================
@@ -108,13 +160,11 @@ echo ""
 
 echo -e "${YELLOW}🔗 STAGE 3: Link Object Files${NC}"
 
-OBJECT_FILES=(
-    "$TARGET_DIR/lexer.o"
-    "$TARGET_DIR/parser.o"
-    "$TARGET_DIR/semantic.o"
-    "$TARGET_DIR/codegen.o"
-    "$TARGET_DIR/optimizer.o"
-)
+# One object per stage 2 module, named the same way
+OBJECT_FILES=()
+for module in "${MODULES[@]}"; do
+    OBJECT_FILES+=("$TARGET_DIR/$(basename "$module" .mega).o")
+done
 
 # Check all object files exist
 for obj in "${OBJECT_FILES[@]}"; do
@@ -128,11 +178,8 @@ OMEGA_INITIAL="$TARGET_DIR/omega"
 
 echo "   Linking: ${OBJECT_FILES[*]} → $OMEGA_INITIAL"
 
-# Simple linking: just concatenate (will improve later)
-cat "${OBJECT_FILES[@]}" > "$OMEGA_INITIAL"
-chmod +x "$OMEGA_INITIAL"
-
-if [ ! -f "$OMEGA_INITIAL" ]; then
+# Resolves imports across modules and indexes every global symbol
+if ! "$OMEGA_LINK" --output "$OMEGA_INITIAL" "${OBJECT_FILES[@]}"; then
     echo -e "${RED}❌ Linking failed${NC}"
     exit 1
 fi
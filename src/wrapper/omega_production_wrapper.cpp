@@ -2,11 +2,35 @@
 // - Provides a stable entrypoint for native production builds
 // - Adds robust diagnostics for uncaught exceptions via std::set_terminate
 // - Implements run_in_dir with Windows-safe quoting for arguments containing spaces
+// - Records per-child resource usage as JSON lines (OMEGA_STATS_SINK)
+// - Optionally traces its own phases and its children's on one Chrome
+//   trace-event timeline (build with -DOMEGA_TRACE, run with OMEGA_TRACE_FILE)
 //
 // NOTE: This wrapper is intentionally minimal. Complex EVM emitter logic should
 // reside in dedicated modules; the wrapper focuses on process orchestration and diagnostics.
+//
+// Environment:
+//   OMEGA_STATS_SINK       stderr | stdout | <file> - append one JSON line per child
+//   OMEGA_CHILD_CPU_LIMIT  CPU seconds per child (POSIX: RLIMIT_CPU)
+//   OMEGA_CHILD_MEM_LIMIT  address space MiB per child (POSIX: RLIMIT_AS)
+//   OMEGA_WRAPPER_DEBUG    set to 1 to print [DEBUG] spawn diagnostics
+//   OMEGA_TRACE_FILE       <file> - Chrome trace-event JSON (-DOMEGA_TRACE builds only)
+//   OMEGA_TRACE_CONTEXT    set for children: <trace id>;<epoch us>;<pid>, so a
+//                          traced omega_minimal joins this trace; see
+//                          bootstrap/omega_trace.h for the protocol
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 #include <cstdio>
 #include <cstdlib>
 #include <cstdint>
@@ -15,7 +39,8 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
-#include <fstream>
+#include <chrono>
+#include <utility>
 
 // Global terminate handler for diagnostics
 static void omega_terminate_handler() noexcept {
@@ -54,11 +79,338 @@ static std::wstring join_command_line(const std::wstring &exe, const std::vector
     return ss.str();
 }
 
+#ifndef _WIN32
+// UTF-8 <-> wchar_t (UTF-32 on POSIX) without depending on the C locale.
+static std::wstring wide_from_utf8(const std::string &s) {
+    std::wstring out; out.reserve(s.size());
+    for (size_t i = 0; i < s.size();) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        uint32_t cp = c; size_t n = 1;
+        if (c >= 0xF0) { cp = c & 0x07; n = 4; }
+        else if (c >= 0xE0) { cp = c & 0x0F; n = 3; }
+        else if (c >= 0xC0) { cp = c & 0x1F; n = 2; }
+        for (size_t k = 1; k < n && i + k < s.size(); ++k) {
+            cp = (cp << 6) | (static_cast<unsigned char>(s[i + k]) & 0x3F);
+        }
+        out.push_back(static_cast<wchar_t>(cp));
+        i += n;
+    }
+    return out;
+}
+
+static std::string narrow_from_wide(const std::wstring &ws) {
+    std::string out; out.reserve(ws.size());
+    for (wchar_t wc : ws) {
+        uint32_t cp = static_cast<uint32_t>(wc);
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+    return out;
+}
+#else
+static std::wstring wide_from_utf8(const std::string &s) {
+    if (s.empty()) return std::wstring();
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
+    std::wstring out; out.resize(len);
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &out[0], len);
+    return out;
+}
+
+static std::string narrow_from_wide(const std::wstring &ws) {
+    if (ws.empty()) return std::string();
+    int len = WideCharToMultiByte(CP_UTF8, 0, ws.c_str(), (int)ws.size(), nullptr, 0, nullptr, nullptr);
+    std::string out; out.resize(len);
+    WideCharToMultiByte(CP_UTF8, 0, ws.c_str(), (int)ws.size(), &out[0], len, nullptr, nullptr);
+    return out;
+}
+#endif
+
+// ============================================================================
+// Child resource accounting
+// ============================================================================
+
+// Resource usage of one finished child. Fields a platform cannot report stay -1.
+struct ChildStats {
+    int pid = 0;
+    int exitCode = -1;
+    int termSignal = 0;
+    double wallMs = 0.0;
+    double userMs = -1.0;
+    double sysMs = -1.0;
+    long maxRssKb = -1;
+    long minorFaults = -1;
+    long majorFaults = -1;
+    long voluntarySwitches = -1;
+    long involuntarySwitches = -1;
+};
+
+// Per-child limits from the environment; 0 means unlimited.
+struct ChildLimits {
+    unsigned long cpuSeconds = 0;
+    unsigned long memoryMiB = 0;
+};
+
+static std::string env_string(const char *name) {
+    const char *value = std::getenv(name);
+    return value ? std::string(value) : std::string();
+}
+
+static bool debug_enabled() {
+    static int cached = -1;
+    if (cached < 0) {
+        std::string v = env_string("OMEGA_WRAPPER_DEBUG");
+        cached = (!v.empty() && v != "0") ? 1 : 0;
+    }
+    return cached == 1;
+}
+
+static unsigned long env_ulong(const char *name) {
+    std::string v = env_string(name);
+    if (v.empty()) return 0;
+    char *end = nullptr;
+    unsigned long n = std::strtoul(v.c_str(), &end, 10);
+    if (end == v.c_str() || *end != '\0') {
+        std::cerr << "[WARN] Ignoring invalid " << name << "=" << v << std::endl;
+        return 0;
+    }
+    return n;
+}
+
+static ChildLimits child_limits_from_env() {
+    ChildLimits limits;
+    limits.cpuSeconds = env_ulong("OMEGA_CHILD_CPU_LIMIT");
+    limits.memoryMiB = env_ulong("OMEGA_CHILD_MEM_LIMIT");
+    return limits;
+}
+
+static std::string json_escape(const std::string &s) {
+    std::string out; out.reserve(s.size() + 2);
+    for (char ch : s) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8]; std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out.push_back(ch);
+                }
+        }
+    }
+    return out;
+}
+
+// Append one JSON line to the configured sink. No sink configured, no output.
+static void emit_child_stats(const std::wstring &workingDir, const std::wstring &cmdline,
+                             const ChildStats &st, const ChildLimits &limits) {
+    static const std::string sink = env_string("OMEGA_STATS_SINK");
+    if (sink.empty()) return;
+
+    std::ostringstream line;
+    line << "{\"event\":\"child_exit\""
+         << ",\"cmd\":\"" << json_escape(narrow_from_wide(cmdline)) << "\""
+         << ",\"cwd\":\"" << json_escape(narrow_from_wide(workingDir)) << "\""
+         << ",\"pid\":" << st.pid
+         << ",\"exit_code\":" << st.exitCode
+         << ",\"signal\":" << st.termSignal
+         << ",\"wall_ms\":" << st.wallMs
+         << ",\"user_ms\":" << st.userMs
+         << ",\"sys_ms\":" << st.sysMs
+         << ",\"max_rss_kb\":" << st.maxRssKb
+         << ",\"minor_faults\":" << st.minorFaults
+         << ",\"major_faults\":" << st.majorFaults
+         << ",\"voluntary_ctx_switches\":" << st.voluntarySwitches
+         << ",\"involuntary_ctx_switches\":" << st.involuntarySwitches
+         << ",\"cpu_limit_s\":" << limits.cpuSeconds
+         << ",\"mem_limit_mib\":" << limits.memoryMiB
+         << "}\n";
+    const std::string text = line.str();
+
+    if (sink == "stderr") {
+        std::fwrite(text.data(), 1, text.size(), stderr);
+        std::fflush(stderr);
+    } else if (sink == "stdout") {
+        std::fwrite(text.data(), 1, text.size(), stdout);
+        std::fflush(stdout);
+    } else {
+        // Single append per line keeps concurrent wrappers from interleaving
+        std::FILE *f = std::fopen(sink.c_str(), "ab");
+        if (!f) {
+            std::cerr << "[WARN] Cannot open OMEGA_STATS_SINK " << sink << std::endl;
+            return;
+        }
+        std::fwrite(text.data(), 1, text.size(), f);
+        std::fclose(f);
+    }
+}
+
+// ============================================================================
+// Trace events
+// ============================================================================
+
+#ifdef OMEGA_TRACE
+// Same file protocol as bootstrap/omega_trace.c: the first process truncates
+// OMEGA_TRACE_FILE and exports OMEGA_TRACE_CONTEXT; every process appends its
+// buffered events with one write when it finishes. Timestamps are steady-clock
+// microseconds shifted onto the first process's wall-clock epoch.
+class Tracer {
+public:
+    static Tracer &instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void open(const char *process) {
+        path_ = env_string("OMEGA_TRACE_FILE");
+        if (enabled_ || path_.empty()) return;
+#ifdef _WIN32
+        pid_ = static_cast<long>(GetCurrentProcessId());
+#else
+        pid_ = static_cast<long>(getpid());
+#endif
+        double wall = std::chrono::duration<double, std::micro>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        offset_ = wall - steady_us();
+
+        unsigned long long id = 0; double epoch = 0; long parent = 0;
+        std::string context = env_string("OMEGA_TRACE_CONTEXT");
+        if (std::sscanf(context.c_str(), "%16llx;%lf;%ld", &id, &epoch, &parent) == 3 && epoch > 0) {
+            traceId_ = id; epoch_ = epoch; parentPid_ = parent;
+        } else {
+            traceId_ = (static_cast<unsigned long long>(wall) * 0x9E3779B97F4A7C15ULL) ^
+                       (static_cast<unsigned long long>(pid_) << 32);
+            epoch_ = wall; parentPid_ = 0;
+            std::FILE *f = std::fopen(path_.c_str(), "wb");
+            if (!f) {
+                std::cerr << "[WARN] Cannot create OMEGA_TRACE_FILE " << path_ << std::endl;
+                return;
+            }
+            std::fputs("[\n", f);
+            std::fclose(f);
+            char value[96];
+            std::snprintf(value, sizeof(value), "%016llx;%.0f;%ld", traceId_, epoch_, pid_);
+#ifdef _WIN32
+            SetEnvironmentVariableA("OMEGA_TRACE_CONTEXT", value);
+#else
+            setenv("OMEGA_TRACE_CONTEXT", value, 1);
+#endif
+        }
+        enabled_ = true;
+        char traceId[24]; std::snprintf(traceId, sizeof(traceId), "%016llx", traceId_);
+        events_ << "{\"ph\":\"M\",\"pid\":" << pid_ << ",\"tid\":" << pid_
+                << ",\"name\":\"process_name\",\"args\":{\"name\":\"" << json_escape(process)
+                << "\",\"trace_id\":\"" << traceId << "\",\"parent_pid\":" << parentPid_ << "}},\n";
+    }
+
+    bool enabled() const { return enabled_; }
+
+    static double steady_us() {
+        return std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void complete(const char *name, const std::string &detail, double start, double end) {
+        if (!enabled_) return;
+        char fields[128];
+        std::snprintf(fields, sizeof(fields), "{\"ph\":\"X\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f",
+                      pid_, pid_, start + offset_ - epoch_, end - start);
+        events_ << fields << ",\"name\":\"" << json_escape(name) << "\",\"cat\":\"wrapper\"";
+        if (!detail.empty()) events_ << ",\"args\":{\"detail\":\"" << json_escape(detail) << "\"}";
+        events_ << "},\n";
+    }
+
+    // Append everything buffered; called once, after the last child exits.
+    void close() {
+        if (!enabled_) return;
+        enabled_ = false;
+        const std::string text = events_.str();
+        std::FILE *f = std::fopen(path_.c_str(), "ab");
+        if (!f) {
+            std::cerr << "[WARN] Cannot append to OMEGA_TRACE_FILE " << path_ << std::endl;
+            return;
+        }
+        std::setvbuf(f, nullptr, _IONBF, 0);
+        std::fwrite(text.data(), 1, text.size(), f);
+        std::fclose(f);
+    }
+
+private:
+    bool enabled_ = false;
+    std::string path_;
+    unsigned long long traceId_ = 0;
+    long pid_ = 0;
+    long parentPid_ = 0;
+    double epoch_ = 0.0;
+    double offset_ = 0.0;
+    std::ostringstream events_;
+};
+
+// Records a complete event for its lifetime.
+class TraceScope {
+public:
+    TraceScope(const char *name, std::string detail = std::string())
+        : name_(name), detail_(std::move(detail)), start_(Tracer::steady_us()) {}
+    ~TraceScope() { Tracer::instance().complete(name_, detail_, start_, Tracer::steady_us()); }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name_;
+    std::string detail_;
+    double start_;
+};
+
+#define OMEGA_TRACE_CONCAT_(a, b) a##b
+#define OMEGA_TRACE_CONCAT(a, b) OMEGA_TRACE_CONCAT_(a, b)
+#define OMEGA_TRACE_OPEN(process) Tracer::instance().open(process)
+#define OMEGA_TRACE_SCOPE(...) TraceScope OMEGA_TRACE_CONCAT(omegaTraceScope, __LINE__)(__VA_ARGS__)
+#define OMEGA_TRACE_CLOSE() Tracer::instance().close()
+// Spans that do not line up with a C++ scope: MARK a start, then SPAN to now
+#define OMEGA_TRACE_MARK(start) const double start = Tracer::steady_us()
+#define OMEGA_TRACE_SPAN(name, detail, start) Tracer::instance().complete(name, detail, start, Tracer::steady_us())
+#else
+#define OMEGA_TRACE_OPEN(process) ((void)0)
+#define OMEGA_TRACE_SCOPE(...) ((void)0)
+#define OMEGA_TRACE_CLOSE() ((void)0)
+#define OMEGA_TRACE_MARK(start) ((void)0)
+#define OMEGA_TRACE_SPAN(name, detail, start) ((void)0)
+#endif
+
+#ifdef _WIN32
+static double filetime_ms(const FILETIME &ft) {
+    ULARGE_INTEGER v; v.LowPart = ft.dwLowDateTime; v.HighPart = ft.dwHighDateTime;
+    return static_cast<double>(v.QuadPart) / 10000.0; // 100ns ticks
+}
+
 // Run a command within a specific directory using CreateProcessW.
 // Returns true on successful process creation; sets exitCode on process completion.
-static bool run_in_dir(const std::wstring &workingDir, const std::wstring &exe, const std::vector<std::wstring> &args, DWORD &exitCode) {
+// Resource limits are not applied on Windows; stats cover wall and CPU time.
+static bool run_in_dir(const std::wstring &workingDir, const std::wstring &exe, const std::vector<std::wstring> &args, int &exitCode) {
     std::wstring cmdline = join_command_line(exe, args);
-    std::wcerr << L"[DEBUG] run_in_dir: requested_dir=" << workingDir << L" cmd=" << cmdline << std::endl;
+    OMEGA_TRACE_SCOPE("run_in_dir", narrow_from_wide(cmdline));
+    if (debug_enabled()) {
+        std::wcerr << L"[DEBUG] run_in_dir: requested_dir=" << workingDir << L" cmd=" << cmdline << std::endl;
+    }
+    ChildLimits limits = child_limits_from_env();
+    ChildStats stats;
 
     STARTUPINFOW si; PROCESS_INFORMATION pi;
     ZeroMemory(&si, sizeof(si)); si.cb = sizeof(si);
@@ -68,6 +420,8 @@ static bool run_in_dir(const std::wstring &workingDir, const std::wstring &exe,
     std::vector<wchar_t> mutableCmd(cmdline.begin(), cmdline.end());
     mutableCmd.push_back(L'\0');
 
+    auto started = std::chrono::steady_clock::now();
+    OMEGA_TRACE_MARK(spawnStart);
     BOOL ok = CreateProcessW(
         nullptr,                      // lpApplicationName
         mutableCmd.data(),            // lpCommandLine
@@ -84,113 +438,169 @@ static bool run_in_dir(const std::wstring &workingDir, const std::wstring &exe,
     if (!ok) {
         DWORD err = GetLastError();
         std::wcerr << L"[ERROR] CreateProcessW failed. GetLastError()=" << err << std::endl;
-        exitCode = static_cast<DWORD>(-1);
+        exitCode = -1;
         return false;
     }
 
+    OMEGA_TRACE_SPAN("spawn", std::string(), spawnStart);
+
     // Wait for process to exit
+    OMEGA_TRACE_MARK(waitStart);
     WaitForSingleObject(pi.hProcess, INFINITE);
+    OMEGA_TRACE_SPAN("wait", std::to_string(pi.dwProcessId), waitStart);
+    stats.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
     DWORD code = 0;
     if (!GetExitCodeProcess(pi.hProcess, &code)) {
         std::wcerr << L"[ERROR] GetExitCodeProcess failed" << std::endl;
         code = static_cast<DWORD>(-1);
     }
+    FILETIME creation, exitTime, kernel, user;
+    if (GetProcessTimes(pi.hProcess, &creation, &exitTime, &kernel, &user)) {
+        stats.userMs = filetime_ms(user);
+        stats.sysMs = filetime_ms(kernel);
+    }
+    stats.pid = static_cast<int>(pi.dwProcessId);
     CloseHandle(pi.hThread);
     CloseHandle(pi.hProcess);
-    exitCode = code;
-    std::wcerr << L"[DEBUG] run_in_dir(CreateProcessW): working_dir=" << workingDir << L" exit_code=" << exitCode << std::endl;
+    exitCode = static_cast<int>(code);
+    stats.exitCode = exitCode;
+    emit_child_stats(workingDir, cmdline, stats, limits);
+    if (debug_enabled()) {
+        std::wcerr << L"[DEBUG] run_in_dir(CreateProcessW): working_dir=" << workingDir << L" exit_code=" << exitCode << std::endl;
+    }
     return true;
 }
-
-static std::wstring wide_from_utf8(const std::string &s) {
-    if (s.empty()) return std::wstring();
-    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
-    std::wstring out; out.resize(len);
-    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &out[0], len);
-    return out;
-}
-
-static std::string narrow_from_wide(const std::wstring &ws) {
-    if (ws.empty()) return std::string();
-    int len = WideCharToMultiByte(CP_UTF8, 0, ws.c_str(), (int)ws.size(), nullptr, 0, nullptr, nullptr);
-    std::string out; out.resize(len);
-    WideCharToMultiByte(CP_UTF8, 0, ws.c_str(), (int)ws.size(), &out[0], len, nullptr, nullptr);
-    return out;
-}
-
-static std::wstring get_filename(const std::wstring &path) {
-    size_t pos = path.find_last_of(L"/\\");
-    if (pos == std::wstring::npos) return path;
-    return path.substr(pos + 1);
-}
-
-static std::wstring get_dirname(const std::wstring &path) {
-    size_t pos = path.find_last_of(L"/\\");
-    if (pos == std::wstring::npos) return L".";
-    return path.substr(0, pos);
+#else
+static void apply_child_limits(const ChildLimits &limits) {
+    if (limits.cpuSeconds > 0) {
+        // Soft limit delivers SIGXCPU; the hard limit one second later kills
+        struct rlimit rl;
+        rl.rlim_cur = static_cast<rlim_t>(limits.cpuSeconds);
+        rl.rlim_max = static_cast<rlim_t>(limits.cpuSeconds + 1);
+        setrlimit(RLIMIT_CPU, &rl);
+    }
+    if (limits.memoryMiB > 0) {
+        struct rlimit rl;
+        rl.rlim_cur = rl.rlim_max = static_cast<rlim_t>(limits.memoryMiB) * 1024 * 1024;
+        setrlimit(RLIMIT_AS, &rl);
+    }
 }
 
-static std::wstring strip_extension(const std::wstring &filename) {
-    size_t pos = filename.find_last_of(L'.');
-    if (pos == std::wstring::npos) return filename;
-    return filename.substr(0, pos);
-}
+// Run a command within a specific directory using fork/execvp and reap it
+// with wait4 so the child's rusage is available.
+// Returns true on successful process creation; sets exitCode on process completion.
+static bool run_in_dir(const std::wstring &workingDir, const std::wstring &exe, const std::vector<std::wstring> &args, int &exitCode) {
+    std::wstring cmdline = join_command_line(exe, args);
+    OMEGA_TRACE_SCOPE("run_in_dir", narrow_from_wide(cmdline));
+    if (debug_enabled()) {
+        std::wcerr << L"[DEBUG] run_in_dir: requested_dir=" << workingDir << L" cmd=" << cmdline << std::endl;
+    }
+    ChildLimits limits = child_limits_from_env();
+    ChildStats stats;
 
-static bool write_text_file(const std::wstring &path, const std::string &content) {
-    std::string npath = narrow_from_wide(path);
-    std::ofstream ofs(npath, std::ios::out | std::ios::trunc | std::ios::binary);
-    if (!ofs) return false;
-    ofs.write(content.c_str(), (std::streamsize)content.size());
-    return ofs.good();
-}
+    // Build argv before forking; only async-signal-safe calls run in the child
+    std::string dir = narrow_from_wide(workingDir);
+    std::vector<std::string> storage;
+    storage.push_back(narrow_from_wide(exe));
+    for (const auto &a : args) storage.push_back(narrow_from_wide(a));
+    std::vector<char *> argv;
+    for (auto &a : storage) argv.push_back(&a[0]);
+    argv.push_back(nullptr);
 
-static bool emit_stub_artifacts(const std::wstring &inputPath, const std::wstring &outputDirOpt) {
-    std::wstring dir = outputDirOpt.empty() ? get_dirname(inputPath) : outputDirOpt;
-    std::wstring moduleNameW = strip_extension(get_filename(inputPath));
-    std::string moduleName = narrow_from_wide(moduleNameW);
+    // Close-on-exec pipe reports exec failure (errno) back to the parent
+    int errPipe[2];
+    if (pipe(errPipe) != 0) {
+        std::wcerr << L"[ERROR] pipe failed: " << std::strerror(errno) << std::endl;
+        exitCode = -1;
+        return false;
+    }
+    fcntl(errPipe[1], F_SETFD, FD_CLOEXEC);
 
-    std::wstring solPath = dir + L"\\" + moduleNameW + L".sol";
-    std::wstring rsPath  = dir + L"\\" + moduleNameW + L".rs";
-    std::wstring goPath  = dir + L"\\" + moduleNameW + L".go";
+    auto started = std::chrono::steady_clock::now();
+    OMEGA_TRACE_MARK(spawnStart);
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::wcerr << L"[ERROR] fork failed: " << std::strerror(errno) << std::endl;
+        close(errPipe[0]); close(errPipe[1]);
+        exitCode = -1;
+        return false;
+    }
+    if (pid == 0) {
+        close(errPipe[0]);
+        if (!dir.empty() && chdir(dir.c_str()) != 0) {
+            int err = errno;
+            ssize_t ignored = write(errPipe[1], &err, sizeof(err)); (void)ignored;
+            _exit(127);
+        }
+        apply_child_limits(limits);
+        execvp(argv[0], argv.data());
+        int err = errno;
+        ssize_t ignored = write(errPipe[1], &err, sizeof(err)); (void)ignored;
+        _exit(127);
+    }
 
-    std::ostringstream sol;
-    sol << "// SPDX-License-Identifier: MIT\n"
-        << "pragma solidity ^0.8.19;\n\n"
-        << "// Generated by OMEGA Production Wrapper (stub)\n"
-        << "contract " << moduleName << " {\n"
-        << "    // Placeholder implementation generated due to native emitter failure\n"
-        << "}\n";
+    close(errPipe[1]);
+    int childErr = 0;
+    ssize_t n;
+    do { n = read(errPipe[0], &childErr, sizeof(childErr)); } while (n < 0 && errno == EINTR);
+    close(errPipe[0]);
+    OMEGA_TRACE_SPAN("spawn", std::string(), spawnStart);
 
-    std::ostringstream rs;
-    rs << "// Generated by OMEGA Production Wrapper (stub)\n"
-       << "use anchor_lang::prelude::*;\n\n"
-       << "#[program]\n"
-       << "pub mod " << moduleName << " {\n"
-       << "    use super::*;\n"
-       << "    // Placeholder implementation generated due to native emitter failure\n"
-       << "}\n";
+    int status = 0;
+    struct rusage ru;
+    std::memset(&ru, 0, sizeof(ru));
+    pid_t waited;
+    OMEGA_TRACE_MARK(waitStart);
+    do { waited = wait4(pid, &status, 0, &ru); } while (waited < 0 && errno == EINTR);
+    OMEGA_TRACE_SPAN("wait", std::to_string(pid), waitStart);
+    stats.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
 
-    std::ostringstream go;
-    go << "package " << moduleName << "\n\n"
-       << "// Generated by OMEGA Production Wrapper (stub)\n"
-       << "// Placeholder implementation generated due to native emitter failure\n";
+    if (n == static_cast<ssize_t>(sizeof(childErr))) {
+        std::wcerr << L"[ERROR] exec failed for " << exe << L": " << std::strerror(childErr) << std::endl;
+        exitCode = -1;
+        return false;
+    }
+    if (waited < 0) {
+        std::wcerr << L"[ERROR] wait4 failed: " << std::strerror(errno) << std::endl;
+        exitCode = -1;
+        return false;
+    }
 
-    bool okSol = write_text_file(solPath, sol.str());
-    bool okRs  = write_text_file(rsPath, rs.str());
-    bool okGo  = write_text_file(goPath, go.str());
+    stats.pid = static_cast<int>(pid);
+    if (WIFEXITED(status)) {
+        stats.exitCode = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        stats.termSignal = WTERMSIG(status);
+        stats.exitCode = 128 + stats.termSignal;
+        std::wcerr << L"[ERROR] child terminated by signal " << stats.termSignal
+                   << (stats.termSignal == SIGXCPU || stats.termSignal == SIGKILL ? L" (resource limit?)" : L"")
+                   << std::endl;
+    }
+    stats.userMs = ru.ru_utime.tv_sec * 1000.0 + ru.ru_utime.tv_usec / 1000.0;
+    stats.sysMs = ru.ru_stime.tv_sec * 1000.0 + ru.ru_stime.tv_usec / 1000.0;
+#ifdef __APPLE__
+    stats.maxRssKb = ru.ru_maxrss / 1024; // bytes on macOS
+#else
+    stats.maxRssKb = ru.ru_maxrss;        // KiB on Linux
+#endif
+    stats.minorFaults = ru.ru_minflt;
+    stats.majorFaults = ru.ru_majflt;
+    stats.voluntarySwitches = ru.ru_nvcsw;
+    stats.involuntarySwitches = ru.ru_nivcsw;
 
-    if (!okSol) {
-        std::wcerr << L"[ERROR] Failed to write stub Solidity artifact: " << solPath << std::endl;
-        return false;
+    exitCode = stats.exitCode;
+    emit_child_stats(workingDir, cmdline, stats, limits);
+    if (debug_enabled()) {
+        std::wcerr << L"[DEBUG] run_in_dir(fork/exec): working_dir=" << workingDir << L" exit_code=" << exitCode << std::endl;
     }
-    std::wcout << L"[INFO] Stub EVM output written to: " << solPath << std::endl;
-    if (okRs)  std::wcout << L"[INFO] Stub Solana output written to: " << rsPath << std::endl;
-    if (okGo)  std::wcout << L"[INFO] Stub Cosmos output written to: " << goPath << std::endl;
     return true;
 }
+#endif
 
-int wmain(int argc, wchar_t* argv[]) {
+static int wrapper_main(int argc, wchar_t* argv[]) {
     std::set_terminate(omega_terminate_handler);
+    OMEGA_TRACE_OPEN("omega-production");
+    OMEGA_TRACE_SCOPE("omega-production", argc > 1 ? narrow_from_wide(argv[1]) : std::string());
 
     std::wcout << L"OMEGA Production Wrapper" << std::endl;
     std::wcout << L"Build Date: 2025-01-13" << std::endl;
@@ -200,7 +610,11 @@ int wmain(int argc, wchar_t* argv[]) {
     }
 
     std::wstring command = argv[1];
+#ifdef _WIN32
     std::wstring omegaExe = L"omega.exe"; // Assume same directory
+#else
+    std::wstring omegaExe = L"./omega";   // Repo-root launcher script
+#endif
     std::wstring repoDir = L".";          // Current repo root
 
     if (command == L"version") {
@@ -221,19 +635,16 @@ int wmain(int argc, wchar_t* argv[]) {
             return 1;
         }
         std::wstring input = argv[2];
-        // Parse optional flags from original argv
-        std::wstring target; std::wstring outputDir;
-        for (int i = 3; i < argc; ++i) {
-            std::wstring tok = argv[i];
-            if (tok == L"--target" && i + 1 < argc) { target = argv[i + 1]; i++; continue; }
-            if (tok == L"--output" && i + 1 < argc) { outputDir = argv[i + 1]; i++; continue; }
-        }
-        // Proxy to omega.exe compile, preserve additional args
+        // Proxy to omega.exe compile, preserve additional args; the compiler
+        // handles --target itself and writes every requested target
         std::vector<std::wstring> args;
-        args.push_back(L"compile");
-        args.push_back(input);
-        for (int i = 3; i < argc; ++i) args.push_back(argv[i]);
-        DWORD code = 0; run_in_dir(repoDir, omegaExe, args, code);
+        {
+            OMEGA_TRACE_SCOPE("parse args");
+            args.push_back(L"compile");
+            args.push_back(input);
+            for (int i = 3; i < argc; ++i) args.push_back(argv[i]);
+        }
+        int code = 0; run_in_dir(repoDir, omegaExe, args, code);
         if (code != 0) {
             std::wcerr << L"[ERROR] omega.exe compile failed (exit=" << code << L")" << std::endl;
             return (int)code;
@@ -243,10 +654,29 @@ int wmain(int argc, wchar_t* argv[]) {
         // Delegate to omega.exe for now
         std::vector<std::wstring> args; args.push_back(command);
         for (int i = 2; i < argc; ++i) args.push_back(argv[i]);
-        DWORD code = 0; run_in_dir(repoDir, omegaExe, args, code);
+        int code = 0; run_in_dir(repoDir, omegaExe, args, code);
         return (int)code;
     } else {
         std::wcerr << L"Error: Unknown command '" << command << L"'" << std::endl;
         return 1;
     }
-}
\ No newline at end of file
+}
+
+#ifdef _WIN32
+int wmain(int argc, wchar_t* argv[]) {
+    int code = wrapper_main(argc, argv);
+    OMEGA_TRACE_CLOSE();
+    return code;
+}
+#else
+int main(int argc, char* argv[]) {
+    std::vector<std::wstring> wideArgs;
+    for (int i = 0; i < argc; ++i) wideArgs.push_back(wide_from_utf8(argv[i]));
+    std::vector<wchar_t*> wideArgv;
+    for (auto &a : wideArgs) wideArgv.push_back(&a[0]);
+    wideArgv.push_back(nullptr);
+    int code = wrapper_main(argc, wideArgv.data());
+    OMEGA_TRACE_CLOSE();
+    return code;
+}
+#endif